@@ -6,6 +6,7 @@
 package org.h2.command;
 
 import java.sql.SQLException;
+import java.sql.Statement;
 import java.util.ArrayList;
 import java.util.Set;
 import org.h2.api.ErrorCode;
@@ -21,6 +22,7 @@
 import org.h2.result.ResultWithGeneratedKeys;
 import org.h2.result.ResultWithPaddedStrings;
 import org.h2.util.Utils;
+import org.h2.value.Value;
 
 /**
  * Represents a SQL statement. This object is only used on the server side.
@@ -29,7 +31,7 @@ public abstract class Command implements CommandInterface {
     /**
      * The session.
      */
-    protected final SessionLocal session;
+    protected SessionLocal session;
 
     /**
      * The last start time.
@@ -297,6 +299,44 @@ public ResultWithGeneratedKeys executeUpdate(Object generatedKeysRequest) {
         }
     }
 
+    @Override
+    public long[] executeBatchUpdate(ArrayList<Value[]> batchParameters, ArrayList<DbException> exceptions) {
+        return executeBatchUpdate(this, batchParameters, exceptions);
+    }
+
+    /**
+     * Execute the statement once for each set of parameter values with
+     * separate invocations of {@link #executeUpdate(Object)}.
+     *
+     * @param command
+     *            the command
+     * @param batchParameters
+     *            the sets of parameter values
+     * @param exceptions
+     *            the list to add exceptions of failed executions to
+     * @return the update counts, {@link Statement#EXECUTE_FAILED} for failed
+     *         executions
+     */
+    public static long[] executeBatchUpdate(CommandInterface command, ArrayList<Value[]> batchParameters,
+            ArrayList<DbException> exceptions) {
+        ArrayList<? extends ParameterInterface> parameters = command.getParameters();
+        int size = batchParameters.size();
+        long[] result = new long[size];
+        for (int i = 0; i < size; i++) {
+            Value[] set = batchParameters.get(i);
+            for (int j = 0, l = set.length; j < l; j++) {
+                parameters.get(j).setValue(set[j], false);
+            }
+            try {
+                result[i] = command.executeUpdate(false).getUpdateCount();
+            } catch (DbException e) {
+                exceptions.add(e);
+                result[i] = Statement.EXECUTE_FAILED;
+            }
+        }
+        return result;
+    }
+
     private void commitIfNonTransactional() {
         if (!isTransactional()) {
             boolean autoCommit = session.getAutoCommit();
@@ -364,6 +404,26 @@ public void setCanReuse(boolean canReuse) {
         this.canReuse = canReuse;
     }
 
+    /**
+     * Check if this command can be moved to another session of the same user
+     * with the same settings, when it is not used by its session any more.
+     *
+     * @return true if it can
+     */
+    public boolean isShareable() {
+        return false;
+    }
+
+    /**
+     * Move this command to another session. This method may only be called if
+     * the command is shareable and can be reused.
+     *
+     * @param session the new session
+     */
+    public void setSession(SessionLocal session) {
+        this.session = session;
+    }
+
     public abstract Set<DbObject> getDependencies();
 
     /**
@@ -13,6 +13,7 @@
 import org.h2.api.ErrorCode;
 import org.h2.command.ddl.DefineCommand;
 import org.h2.command.dml.DataChangeStatement;
+import org.h2.command.query.Select;
 import org.h2.engine.Database;
 import org.h2.engine.DbObject;
 import org.h2.engine.DbSettings;
@@ -29,7 +30,9 @@
 import org.h2.result.ResultWithGeneratedKeys;
 import org.h2.table.Column;
 import org.h2.table.DataChangeDeltaTable.ResultOption;
+import org.h2.table.DualTable;
 import org.h2.table.Table;
+import org.h2.table.TableType;
 import org.h2.table.TableView;
 import org.h2.util.StringUtils;
 import org.h2.util.Utils;
@@ -302,6 +305,31 @@ void clearCTE() {
         clearCTE(session, prepared);
     }
 
+    @Override
+    public boolean isShareable() {
+        if (!(prepared instanceof Select) || !prepared.isCacheable() || prepared.getCteCleanups() != null) {
+            return false;
+        }
+        for (DbObject object : getDependencies()) {
+            if (object instanceof Table) {
+                Table table = (Table) object;
+                // views, linked tables, and meta data tables may depend on the
+                // session that prepared the command
+                if (table.isTemporary()
+                        || table.getTableType() != TableType.TABLE && !(table instanceof DualTable)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    @Override
+    public void setSession(SessionLocal session) {
+        super.setSession(session);
+        prepared.setSession(session);
+    }
+
     @Override
     public Set<DbObject> getDependencies() {
         HashSet<DbObject> dependencies = new HashSet<>();
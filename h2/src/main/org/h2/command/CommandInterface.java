@@ -7,8 +7,10 @@
 
 import java.util.ArrayList;
 import org.h2.expression.ParameterInterface;
+import org.h2.message.DbException;
 import org.h2.result.ResultInterface;
 import org.h2.result.ResultWithGeneratedKeys;
+import org.h2.value.Value;
 
 /**
  * Represents a SQL statement.
@@ -585,6 +587,20 @@ public interface CommandInterface extends AutoCloseable {
      */
     ResultWithGeneratedKeys executeUpdate(Object generatedKeysRequest);
 
+    /**
+     * Execute the statement once for each set of parameter values. Generated
+     * keys are not returned.
+     *
+     * @param batchParameters
+     *            the sets of parameter values
+     * @param exceptions
+     *            the list to add exceptions of failed executions to, in the
+     *            order of executions
+     * @return the update counts, {@link java.sql.Statement#EXECUTE_FAILED}
+     *         for failed executions
+     */
+    long[] executeBatchUpdate(ArrayList<Value[]> batchParameters, ArrayList<DbException> exceptions);
+
     /**
      * Stop the command execution, release all locks and resources
      */
@@ -6,6 +6,7 @@
 package org.h2.command;
 
 import java.io.IOException;
+import java.sql.Statement;
 import java.util.ArrayList;
 import org.h2.engine.Constants;
 import org.h2.engine.GeneratedKeysMode;
@@ -258,6 +259,50 @@ public ResultWithGeneratedKeys executeUpdate(Object generatedKeysRequest) {
         }
     }
 
+    @Override
+    public long[] executeBatchUpdate(ArrayList<Value[]> batchParameters, ArrayList<DbException> exceptions) {
+        if (session.getClientVersion() < Constants.TCP_PROTOCOL_VERSION_21) {
+            return Command.executeBatchUpdate(this, batchParameters, exceptions);
+        }
+        synchronized (session) {
+            int size = batchParameters.size();
+            long[] result = new long[size];
+            boolean autoCommit = false;
+            for (int i = 0, count = 0; i < transferList.size(); i++) {
+                prepareIfRequired();
+                Transfer transfer = transferList.get(i);
+                try {
+                    session.traceOperation("COMMAND_EXECUTE_BATCH_UPDATE", id);
+                    transfer.writeInt(SessionRemote.COMMAND_EXECUTE_BATCH_UPDATE).writeInt(id).writeInt(size);
+                    for (Value[] set : batchParameters) {
+                        transfer.writeInt(set.length);
+                        for (Value v : set) {
+                            transfer.writeValue(v);
+                        }
+                    }
+                    session.done(transfer);
+                    // only exceptions of the last server are reported
+                    exceptions.clear();
+                    for (int j = 0; j < size; j++) {
+                        if (transfer.readBoolean()) {
+                            result[j] = transfer.readRowCount();
+                        } else {
+                            exceptions.add(SessionRemote.readException(transfer));
+                            result[j] = Statement.EXECUTE_FAILED;
+                        }
+                    }
+                    autoCommit = transfer.readBoolean();
+                } catch (IOException e) {
+                    session.removeServer(e, i--, ++count);
+                }
+            }
+            session.setAutoCommitFromServer(autoCommit);
+            session.autoCommitIfCluster();
+            session.readSessionState();
+            return result;
+        }
+    }
+
     private void checkParameters() {
         if (cmdType != EXPLAIN) {
             for (ParameterInterface p : parameters) {
@@ -1291,6 +1291,10 @@ private Prepared parseBackup() {
         BackupCommand command = new BackupCommand(session);
         read(TO);
         command.setFileName(readExpression());
+        if (readIf("INCREMENTAL")) {
+            read(FROM);
+            command.setBaseFileName(readExpression());
+        }
         return command;
     }
 
@@ -2863,6 +2867,9 @@ private Explain parseExplain() {
         Explain command = new Explain(session);
         if (readIf("ANALYZE")) {
             command.setExecuteCommand(true);
+            if (readIf("VERBOSE")) {
+                command.setVerbose(true);
+            }
         } else {
             if (readIf("PLAN")) {
                 readIf(FOR);
@@ -7805,7 +7812,7 @@ private Prepared parseCreate() {
             return parseCreateSynonym(orReplace);
         } else {
             boolean hash = false, primaryKey = false;
-            boolean unique = false, spatial = false;
+            boolean unique = false, spatial = false, minMax = false;
             String indexName = null;
             Schema oldSchema = null;
             boolean ifNotExists = false;
@@ -7828,6 +7835,8 @@ private Prepared parseCreate() {
                     hash = true;
                 } else if (!unique && readIf("SPATIAL")) {
                     spatial = true;
+                } else if (!unique && readIf("MINMAX")) {
+                    minMax = true;
                 }
                 read("INDEX");
                 if (!isToken(ON)) {
@@ -7842,7 +7851,7 @@ private Prepared parseCreate() {
             String comment = readCommentIf();
             if (!readIf(OPEN_PAREN)) {
                 // PostgreSQL compatibility
-                if (hash || spatial) {
+                if (hash || spatial || minMax) {
                     throw getSyntaxError();
                 }
                 read(USING);
@@ -7850,6 +7859,8 @@ private Prepared parseCreate() {
                     // default
                 } else if (readIf("HASH")) {
                     hash = true;
+                } else if (!unique && readIf("MINMAX")) {
+                    minMax = true;
                 } else {
                     read("RTREE");
                     spatial = true;
@@ -7862,6 +7873,7 @@ private Prepared parseCreate() {
             command.setTableName(tableName);
             command.setHash(hash);
             command.setSpatial(spatial);
+            command.setMinMax(minMax);
             command.setIndexName(indexName);
             command.setComment(comment);
             IndexColumn[] columns;
@@ -7874,17 +7886,18 @@ private Prepared parseCreate() {
                 read(CLOSE_PAREN);
             } else {
                 columns = parseIndexColumnList();
-                if (unique) {
+                if (unique || primaryKey) {
                     uniqueColumnCount = columns.length;
-                    if (readIf("INCLUDE")) {
-                        read(OPEN_PAREN);
-                        IndexColumn[] columnsToInclude = parseIndexColumnList();
-                        int nonUniqueCount = columnsToInclude.length;
-                        columns = Arrays.copyOf(columns, uniqueColumnCount + nonUniqueCount);
-                        System.arraycopy(columnsToInclude, 0, columns, uniqueColumnCount, nonUniqueCount);
+                }
+                if ((unique || !primaryKey && !hash && !minMax) && readIf("INCLUDE")) {
+                    read(OPEN_PAREN);
+                    IndexColumn[] columnsToInclude = parseIndexColumnList();
+                    int keyColumnCount = columns.length, includedColumnCount = columnsToInclude.length;
+                    columns = Arrays.copyOf(columns, keyColumnCount + includedColumnCount);
+                    System.arraycopy(columnsToInclude, 0, columns, keyColumnCount, includedColumnCount);
+                    if (!unique) {
+                        command.setIncludedColumnCount(includedColumnCount);
                     }
-                } else if (primaryKey) {
-                    uniqueColumnCount = columns.length;
                 }
             }
             command.setIndexColumns(columns);
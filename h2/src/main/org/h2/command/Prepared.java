@@ -12,6 +12,7 @@
 import org.h2.api.ErrorCode;
 import org.h2.engine.Database;
 import org.h2.engine.DbObject;
+import org.h2.engine.QueryStatisticsData;
 import org.h2.engine.SessionLocal;
 import org.h2.expression.Expression;
 import org.h2.expression.Parameter;
@@ -335,9 +336,15 @@ void trace(long startTimeNanos, long rowCount) {
         }
         // startTime_nanos can be zero for the command that actually turns on
         // statistics
-        if (session.getDatabase().getQueryStatistics() && startTimeNanos != 0) {
+        Database database = session.getDatabase();
+        if (database.getQueryStatistics() && startTimeNanos != 0) {
             long deltaTimeNanos = System.nanoTime() - startTimeNanos;
-            session.getDatabase().getQueryStatisticsData().update(toString(), deltaTimeNanos, rowCount);
+            QueryStatisticsData statistics = database.getQueryStatisticsData();
+            statistics.update(toString(), deltaTimeNanos, rowCount);
+            if (deltaTimeNanos >= database.getSettings().slowQueryTime * 1_000_000L) {
+                statistics.addSlowQuery(session.getId(), toString(), deltaTimeNanos, rowCount,
+                        getPlanSQL(HasSQL.TRACE_SQL_FLAGS | HasSQL.ADD_PLAN_INFORMATION));
+            }
         }
     }
 
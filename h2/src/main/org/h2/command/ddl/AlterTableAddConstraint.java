@@ -391,7 +391,7 @@ private static Index getIndex(Table t, IndexColumn[] cols, boolean unique) {
     }
 
     private static boolean canUseIndex(Index index, Table table, IndexColumn[] cols, boolean unique) {
-        if (index.getTable() != table) {
+        if (index.getTable() != table || index.getIndexType().isMinMax()) {
             return false;
         }
         int allowedColumns;
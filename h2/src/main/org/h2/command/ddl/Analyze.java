@@ -5,20 +5,25 @@
  */
 package org.h2.command.ddl;
 
+import java.util.ArrayList;
+import java.util.concurrent.ThreadLocalRandom;
+
 import org.h2.command.CommandInterface;
-import org.h2.engine.Constants;
 import org.h2.engine.Database;
 import org.h2.engine.Right;
 import org.h2.engine.SessionLocal;
 import org.h2.index.Cursor;
+import org.h2.mvstore.db.MVTable;
 import org.h2.result.Row;
 import org.h2.schema.Schema;
 import org.h2.table.Column;
+import org.h2.table.ColumnStatistics;
 import org.h2.table.Table;
 import org.h2.table.TableType;
-import org.h2.util.IntIntHashMap;
+import org.h2.util.HyperLogLog;
 import org.h2.value.DataType;
 import org.h2.value.Value;
+import org.h2.value.ValueNull;
 
 /**
  * This class represents the statements
@@ -28,22 +33,37 @@ public class Analyze extends DefineCommand {
 
     private static final class SelectivityData {
 
-        private long count, distinctCount;
-        private final IntIntHashMap distinctHashes;
+        /**
+         * The maximum number of sampled values used to build the histogram.
+         */
+        private static final int MAX_SAMPLE_SIZE = 10_000;
+
+        private long count, nullCount;
+        private final HyperLogLog distinctValues;
+        private final ArrayList<Value> sample;
 
-        SelectivityData() {
-            distinctHashes = new IntIntHashMap(false);
+        SelectivityData(boolean collectSample) {
+            distinctValues = new HyperLogLog();
+            sample = collectSample ? new ArrayList<>() : null;
         }
 
         void add(Value v) {
             count++;
-            int size = distinctHashes.size();
-            if (size >= Constants.SELECTIVITY_DISTINCT_COUNT) {
-                distinctHashes.clear();
-                distinctCount += size;
+            distinctValues.add(v.hashCode());
+            if (v == ValueNull.INSTANCE) {
+                nullCount++;
+            } else if (sample != null) {
+                // reservoir sampling
+                long nonNullCount = count - nullCount;
+                if (nonNullCount <= MAX_SAMPLE_SIZE) {
+                    sample.add(v);
+                } else {
+                    long i = ThreadLocalRandom.current().nextLong(nonNullCount);
+                    if (i < MAX_SAMPLE_SIZE) {
+                        sample.set((int) i, v);
+                    }
+                }
             }
-            // the value -1 is not supported
-            distinctHashes.put(v.hashCode(), 1);
         }
 
         int getSelectivity() {
@@ -51,7 +71,7 @@ int getSelectivity() {
             if (count == 0) {
                 s = 0;
             } else {
-                s = (int) (100 * (distinctCount + distinctHashes.size()) / count);
+                s = (int) (100 * Math.min(distinctValues.getCount(), count) / count);
                 if (s <= 0) {
                     s = 1;
                 }
@@ -59,6 +79,15 @@ int getSelectivity() {
             return s;
         }
 
+        ColumnStatistics getStatistics(SessionLocal session, int valueType, int size) {
+            long distinctCount = Math.min(distinctValues.getCount(), count);
+            if (nullCount > 0) {
+                distinctCount--;
+            }
+            return ColumnStatistics.create(session, valueType, count, nullCount, distinctCount,
+                    sample.toArray(new Value[0]), size);
+        }
+
     }
 
     /**
@@ -122,13 +151,15 @@ public static void analyzeTable(SessionLocal session, Table table, int sample, b
         if (columnCount == 0) {
             return;
         }
+        Database db = session.getDatabase();
+        int histogramSize = db.getSettings().analyzeHistogramSize;
         Cursor cursor = table.getScanIndex(session).find(session, null, null);
         if (cursor.next()) {
             SelectivityData[] array = new SelectivityData[columnCount];
             for (int i = 0; i < columnCount; i++) {
-                Column col = columns[i];
-                if (!DataType.isLargeObject(col.getType().getValueType())) {
-                    array[i] = new SelectivityData();
+                int valueType = columns[i].getType().getValueType();
+                if (!DataType.isLargeObject(valueType)) {
+                    array[i] = new SelectivityData(histogramSize > 0 && ColumnStatistics.isSupported(valueType));
                 }
             }
             int rowNumber = 0;
@@ -142,17 +173,27 @@ public static void analyzeTable(SessionLocal session, Table table, int sample, b
                 }
             } while ((sample <= 0 || ++rowNumber < sample) && cursor.next());
             for (int i = 0; i < columnCount; i++) {
+                Column col = columns[i];
                 SelectivityData selectivity = array[i];
                 if (selectivity != null) {
-                    columns[i].setSelectivity(selectivity.getSelectivity());
+                    col.setSelectivity(selectivity.getSelectivity());
+                    col.setStatistics(selectivity.sample != null
+                            ? selectivity.getStatistics(session, col.getType().getValueType(), histogramSize)
+                            : null);
+                } else {
+                    col.setStatistics(null);
                 }
             }
         } else {
             for (int i = 0; i < columnCount; i++) {
                 columns[i].setSelectivity(0);
+                columns[i].setStatistics(null);
             }
         }
-        session.getDatabase().updateMeta(session, table);
+        if (table instanceof MVTable && table.isPersistData()) {
+            db.getStore().saveStatistics((MVTable) table);
+        }
+        db.updateMeta(session, table);
     }
 
     public void setTop(int top) {
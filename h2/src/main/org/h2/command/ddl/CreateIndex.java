@@ -27,7 +27,8 @@ public class CreateIndex extends SchemaCommand {
     private String indexName;
     private IndexColumn[] indexColumns;
     private int uniqueColumnCount;
-    private boolean primaryKey, hash, spatial;
+    private int includedColumnCount;
+    private boolean primaryKey, hash, spatial, minMax;
     private boolean ifTableExists;
     private boolean ifNotExists;
     private String comment;
@@ -96,8 +97,11 @@ public long update() {
             indexType = IndexType.createPrimaryKey(persistent, hash);
         } else if (uniqueColumnCount > 0) {
             indexType = IndexType.createUnique(persistent, hash);
+        } else if (minMax) {
+            indexType = IndexType.createMinMax(persistent);
         } else {
             indexType = IndexType.createNonUnique(persistent, hash, spatial);
+            indexType.setIncludedColumnCount(includedColumnCount);
         }
         IndexColumn.mapColumns(indexColumns, table);
         table.addIndex(session, indexName, id, indexColumns, uniqueColumnCount, indexType, create, comment);
@@ -112,6 +116,10 @@ public void setUniqueColumnCount(int uniqueColumnCount) {
         this.uniqueColumnCount = uniqueColumnCount;
     }
 
+    public void setIncludedColumnCount(int includedColumnCount) {
+        this.includedColumnCount = includedColumnCount;
+    }
+
     public void setHash(boolean b) {
         this.hash = b;
     }
@@ -120,6 +128,10 @@ public void setSpatial(boolean b) {
         this.spatial = b;
     }
 
+    public void setMinMax(boolean b) {
+        this.minMax = b;
+    }
+
     public void setComment(String comment) {
         this.comment = comment;
     }
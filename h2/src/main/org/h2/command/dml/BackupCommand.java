@@ -5,11 +5,20 @@
  */
 package org.h2.command.dml;
 
+import java.io.DataInputStream;
+import java.io.DataOutputStream;
+import java.io.EOFException;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
 import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
 import java.util.zip.ZipEntry;
+import java.util.zip.ZipInputStream;
 import java.util.zip.ZipOutputStream;
 import org.h2.api.ErrorCode;
 import org.h2.command.CommandInterface;
@@ -19,6 +28,7 @@
 import org.h2.engine.SessionLocal;
 import org.h2.expression.Expression;
 import org.h2.message.DbException;
+import org.h2.mvstore.Chunk;
 import org.h2.mvstore.MVStore;
 import org.h2.mvstore.db.Store;
 import org.h2.result.ResultInterface;
@@ -29,11 +39,25 @@
 /**
  * This class represents the statement
  * BACKUP
+ *
+ * <p>
+ * A backup contains the list of chunks of the database file before the data.
+ * An incremental backup contains only the chunks that are not listed in the
+ * previous backup and the header of the file. Chunks are immutable, so these
+ * chunks can be written over the file restored from the previous backups.
+ * </p>
  */
 public class BackupCommand extends Prepared {
 
+    /**
+     * The size of the buffer used to copy chunks.
+     */
+    private static final int COPY_BUFFER_SIZE = 64 * 1024;
+
     private Expression fileNameExpr;
 
+    private Expression baseFileNameExpr;
+
     public BackupCommand(SessionLocal session) {
         super(session);
     }
@@ -42,19 +66,42 @@ public void setFileName(Expression fileName) {
         this.fileNameExpr = fileName;
     }
 
+    /**
+     * Set the name of the previous backup for an incremental backup.
+     *
+     * @param baseFileName the file name of the previous backup
+     */
+    public void setBaseFileName(Expression baseFileName) {
+        this.baseFileNameExpr = baseFileName;
+    }
+
     @Override
     public long update() {
         String name = fileNameExpr.getValue(session).getString();
+        String baseName = baseFileNameExpr != null ? baseFileNameExpr.getValue(session).getString() : null;
         session.getUser().checkAdmin();
-        backupTo(name);
+        backupTo(name, baseName);
         return 0;
     }
 
-    private void backupTo(String fileName) {
+    private void backupTo(String fileName, String baseFileName) {
         Database db = session.getDatabase();
         if (!db.isPersistent()) {
             throw DbException.get(ErrorCode.DATABASE_IS_NOT_PERSISTENT);
         }
+        HashMap<String, HashSet<ChunkPosition>> baseChunks = null;
+        if (baseFileName != null) {
+            if (!FileUtils.exists(baseFileName)) {
+                throw DbException.get(ErrorCode.FILE_NOT_FOUND_1, baseFileName);
+            }
+            try {
+                // the previous backup is read before the new file is created,
+                // these files may be the same
+                baseChunks = readChunkLists(baseFileName);
+            } catch (IOException e) {
+                throw DbException.convertIOException(e, baseFileName);
+            }
+        }
         try {
             Store store = db.getStore();
             store.flush();
@@ -73,12 +120,26 @@ private void backupTo(String fileName) {
                     ArrayList<String> fileList = FileLister.getDatabaseFiles(dir, name, true);
                     for (String n : fileList) {
                         if (n.endsWith(Constants.SUFFIX_MV_FILE)) {
+                            String entryName = getEntryName(base, n);
+                            HashSet<ChunkPosition> previous = null;
+                            if (baseChunks != null) {
+                                previous = baseChunks.get(entryName);
+                                if (previous == null) {
+                                    throw DbException.get(ErrorCode.FILE_NOT_FOUND_1,
+                                            baseFileName + '/' + entryName + Constants.SUFFIX_BACKUP_CHUNKS);
+                                }
+                            }
                             MVStore s = store.getMvStore();
                             boolean before = s.getReuseSpace();
                             s.setReuseSpace(false);
                             try {
-                                InputStream in = store.getInputStream();
-                                backupFile(out, base, n, in);
+                                if (previous == null) {
+                                    backupChunkList(out, entryName, getChunkPositions(s));
+                                    InputStream in = store.getInputStream();
+                                    backupFile(out, entryName, in);
+                                } else {
+                                    backupIncrement(out, entryName, store, previous);
+                                }
                             } finally {
                                 s.setReuseSpace(before);
                             }
@@ -92,20 +153,128 @@ private void backupTo(String fileName) {
         }
     }
 
-    private static void backupFile(ZipOutputStream out, String base, String fn,
-            InputStream in) throws IOException {
+    private static String getEntryName(String base, String fn) {
         String f = FileUtils.toRealPath(fn);
         base = FileUtils.toRealPath(base);
         if (!f.startsWith(base)) {
             throw DbException.getInternalError(f + " does not start with " + base);
         }
         f = f.substring(base.length());
-        f = correctFileName(f);
-        out.putNextEntry(new ZipEntry(f));
+        return correctFileName(f);
+    }
+
+    private static void backupFile(ZipOutputStream out, String entryName,
+            InputStream in) throws IOException {
+        out.putNextEntry(new ZipEntry(entryName));
         IOUtils.copyAndCloseInput(in, out);
         out.closeEntry();
     }
 
+    private static ArrayList<ChunkPosition> getChunkPositions(MVStore store) {
+        List<Chunk> chunks = store.getWrittenChunks();
+        ArrayList<ChunkPosition> list = new ArrayList<>(chunks.size());
+        for (Chunk c : chunks) {
+            list.add(new ChunkPosition(c.id, c.version, c.block, c.len));
+        }
+        return list;
+    }
+
+    private static void backupChunkList(ZipOutputStream out, String entryName, ArrayList<ChunkPosition> chunks)
+            throws IOException {
+        out.putNextEntry(new ZipEntry(entryName + Constants.SUFFIX_BACKUP_CHUNKS));
+        DataOutputStream data = new DataOutputStream(out);
+        data.writeInt(chunks.size());
+        for (ChunkPosition c : chunks) {
+            data.writeInt(c.id);
+            data.writeLong(c.version);
+            data.writeLong(c.block);
+            data.writeInt(c.len);
+        }
+        data.flush();
+        out.closeEntry();
+    }
+
+    /**
+     * Read the lists of chunks of a backup. The lists are stored before the
+     * data, so only the beginning of the file is read.
+     *
+     * @param fileName the file name of the backup
+     * @return the sets of chunks by names of the files
+     */
+    private static HashMap<String, HashSet<ChunkPosition>> readChunkLists(String fileName) throws IOException {
+        HashMap<String, HashSet<ChunkPosition>> map = new HashMap<>();
+        try (ZipInputStream in = new ZipInputStream(FileUtils.newInputStream(fileName))) {
+            for (ZipEntry entry; (entry = in.getNextEntry()) != null;) {
+                String entryName = entry.getName();
+                if (!entryName.endsWith(Constants.SUFFIX_BACKUP_CHUNKS)) {
+                    break;
+                }
+                DataInputStream data = new DataInputStream(in);
+                int count = data.readInt();
+                HashSet<ChunkPosition> set = new HashSet<>();
+                for (int i = 0; i < count; i++) {
+                    set.add(new ChunkPosition(data.readInt(), data.readLong(), data.readLong(), data.readInt()));
+                }
+                map.put(entryName.substring(0, entryName.length() - Constants.SUFFIX_BACKUP_CHUNKS.length()), set);
+            }
+        }
+        return map;
+    }
+
+    /**
+     * Write the header of the file and the chunks that are not in the previous
+     * backup. The entry contains the length of the file followed by the
+     * positions, the lengths, and the data of the written areas, and ends with
+     * the position -1.
+     */
+    private static void backupIncrement(ZipOutputStream out, String entryName, Store store,
+            HashSet<ChunkPosition> previous) throws IOException {
+        FileChannel fc = store.getFileChannel();
+        int offset = store.getFileHeaderLength();
+        // the header is read before the list of chunks, so it can't point to
+        // chunks written after the list was created
+        ByteBuffer header = ByteBuffer.allocate(offset + 2 * MVStore.BLOCK_SIZE);
+        readFully(fc, 0L, header);
+        ArrayList<ChunkPosition> chunks = getChunkPositions(store.getMvStore());
+        long length = fc.size();
+        backupChunkList(out, entryName, chunks);
+        out.putNextEntry(new ZipEntry(entryName + Constants.SUFFIX_BACKUP_INCREMENT));
+        DataOutputStream data = new DataOutputStream(out);
+        data.writeLong(length);
+        data.writeLong(0L);
+        data.writeInt(header.capacity());
+        data.write(header.array());
+        ByteBuffer buff = ByteBuffer.allocate(COPY_BUFFER_SIZE);
+        for (ChunkPosition c : chunks) {
+            if (previous.contains(c)) {
+                continue;
+            }
+            long pos = offset + c.block * MVStore.BLOCK_SIZE;
+            int len = c.len * MVStore.BLOCK_SIZE;
+            data.writeLong(pos);
+            data.writeInt(len);
+            for (int done = 0, l; done < len; done += l) {
+                l = Math.min(COPY_BUFFER_SIZE, len - done);
+                buff.clear().limit(l);
+                readFully(fc, pos + done, buff);
+                data.write(buff.array(), 0, l);
+            }
+        }
+        data.writeLong(-1L);
+        data.flush();
+        out.closeEntry();
+    }
+
+    private static void readFully(FileChannel fc, long pos, ByteBuffer buff) throws IOException {
+        do {
+            int l = fc.read(buff, pos);
+            if (l < 0) {
+                throw new EOFException();
+            }
+            pos += l;
+        } while (buff.hasRemaining());
+    }
+
     @Override
     public boolean isTransactional() {
         return true;
@@ -140,4 +309,40 @@ public int getType() {
         return CommandInterface.BACKUP;
     }
 
+    /**
+     * The position of a chunk in the database file.
+     */
+    private static final class ChunkPosition {
+
+        private final int id;
+
+        private final long version;
+
+        private final long block;
+
+        private final int len;
+
+        ChunkPosition(int id, long version, long block, int len) {
+            this.id = id;
+            this.version = version;
+            this.block = block;
+            this.len = len;
+        }
+
+        @Override
+        public int hashCode() {
+            return id ^ Long.hashCode(block);
+        }
+
+        @Override
+        public boolean equals(Object obj) {
+            if (!(obj instanceof ChunkPosition)) {
+                return false;
+            }
+            ChunkPosition other = (ChunkPosition) obj;
+            return id == other.id && version == other.version && block == other.block && len == other.len;
+        }
+
+    }
+
 }
@@ -16,11 +16,14 @@
 import org.h2.engine.SessionLocal;
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionColumn;
+import org.h2.mvstore.FileStore;
+import org.h2.mvstore.MVStore;
 import org.h2.mvstore.db.Store;
 import org.h2.result.LocalResult;
 import org.h2.result.ResultInterface;
 import org.h2.table.Column;
 import org.h2.util.HasSQL;
+import org.h2.util.StringUtils;
 import org.h2.value.TypeInfo;
 import org.h2.value.ValueVarchar;
 
@@ -30,9 +33,14 @@
  */
 public class Explain extends Prepared {
 
+    private static final int PROFILE_TIME = 0, PROFILE_CACHE_HITS = 1, PROFILE_CACHE_MISSES = 2,
+            PROFILE_READ_BYTES = 3, PROFILE_LOCK_WAIT = 4, PROFILE_SPILLED_ROWS = 5, PROFILE_SPILLED_BYTES = 6,
+            PROFILE_SIZE = 7;
+
     private Prepared command;
     private LocalResult result;
     private boolean executeCommand;
+    private boolean verbose;
 
     public Explain(SessionLocal session) {
         super(session);
@@ -55,6 +63,17 @@ public void setExecuteCommand(boolean executeCommand) {
         this.executeCommand = executeCommand;
     }
 
+    /**
+     * Enable collection of the number of rows and the elapsed time of each
+     * table filter and query stage, and of additional statistics of the
+     * executed command.
+     *
+     * @param verbose whether detailed statistics should be collected
+     */
+    public void setVerbose(boolean verbose) {
+        this.verbose = verbose;
+    }
+
     @Override
     public ResultInterface queryMeta() {
         return query(-1);
@@ -82,10 +101,23 @@ public ResultInterface query(long maxrows) {
                     store = db.getStore();
                     store.statisticsStart();
                 }
-                if (command.isQuery()) {
-                    command.query(maxrows);
-                } else {
-                    command.update();
+                long[] profile = null;
+                if (verbose) {
+                    profile = startProfile(db);
+                }
+                // with query statistics the plain plan must not change
+                session.setQueryProfiling(verbose);
+                try {
+                    if (command.isQuery()) {
+                        command.query(maxrows);
+                    } else {
+                        command.update();
+                    }
+                } finally {
+                    session.setQueryProfiling(null);
+                }
+                if (profile != null) {
+                    endProfile(db, profile);
                 }
                 plan = command.getPlanSQL(sqlFlags);
                 Map<String, Integer> statistics = null;
@@ -115,6 +147,9 @@ public ResultInterface query(long maxrows) {
                         plan += "\n/*\n" + buff.toString() + "*/";
                     }
                 }
+                if (profile != null) {
+                    plan += getProfileSQL(profile);
+                }
             } else {
                 plan = command.getPlanSQL(sqlFlags);
             }
@@ -124,6 +159,48 @@ public ResultInterface query(long maxrows) {
         return result;
     }
 
+    private long[] startProfile(Database db) {
+        long[] profile = new long[PROFILE_SIZE];
+        MVStore mvStore = db.getStore().getMvStore();
+        profile[PROFILE_CACHE_HITS] = mvStore.getCacheHits();
+        profile[PROFILE_CACHE_MISSES] = mvStore.getCacheMisses();
+        FileStore fs = mvStore.getFileStore();
+        if (fs != null) {
+            profile[PROFILE_READ_BYTES] = fs.getReadBytes();
+        }
+        profile[PROFILE_LOCK_WAIT] = session.getTransaction().getLockWaitTimeNanos();
+        profile[PROFILE_SPILLED_ROWS] = session.getSpilledRows();
+        profile[PROFILE_SPILLED_BYTES] = session.getSpilledBytes();
+        profile[PROFILE_TIME] = System.nanoTime();
+        return profile;
+    }
+
+    private void endProfile(Database db, long[] profile) {
+        profile[PROFILE_TIME] = System.nanoTime() - profile[PROFILE_TIME];
+        MVStore mvStore = db.getStore().getMvStore();
+        profile[PROFILE_CACHE_HITS] = mvStore.getCacheHits() - profile[PROFILE_CACHE_HITS];
+        profile[PROFILE_CACHE_MISSES] = mvStore.getCacheMisses() - profile[PROFILE_CACHE_MISSES];
+        FileStore fs = mvStore.getFileStore();
+        if (fs != null) {
+            profile[PROFILE_READ_BYTES] = fs.getReadBytes() - profile[PROFILE_READ_BYTES];
+        }
+        profile[PROFILE_LOCK_WAIT] = session.getTransaction().getLockWaitTimeNanos() - profile[PROFILE_LOCK_WAIT];
+        profile[PROFILE_SPILLED_ROWS] = session.getSpilledRows() - profile[PROFILE_SPILLED_ROWS];
+        profile[PROFILE_SPILLED_BYTES] = session.getSpilledBytes() - profile[PROFILE_SPILLED_BYTES];
+    }
+
+    private static String getProfileSQL(long[] profile) {
+        StringBuilder builder = new StringBuilder("\n/*\n");
+        StringUtils.appendMillis(builder.append("time: "), profile[PROFILE_TIME]).append('\n');
+        builder.append("cache hits: ").append(profile[PROFILE_CACHE_HITS])
+                .append(", misses: ").append(profile[PROFILE_CACHE_MISSES]).append('\n');
+        builder.append("read bytes: ").append(profile[PROFILE_READ_BYTES]).append('\n');
+        StringUtils.appendMillis(builder.append("lock wait: "), profile[PROFILE_LOCK_WAIT]).append('\n');
+        builder.append("spilled rows: ").append(profile[PROFILE_SPILLED_ROWS])
+                .append(", bytes: ").append(profile[PROFILE_SPILLED_BYTES]).append('\n');
+        return builder.append("*/").toString();
+    }
+
     private void add(String text) {
         result.addRow(ValueVarchar.get(text));
     }
@@ -192,33 +192,52 @@ private long insertRows() {
                 }
             }
         } else {
-            table.lock(session, true, false);
-            if (insertFromSelect) {
-                query.query(0, this);
-            } else {
-                ResultInterface rows = query.query(0);
-                while (rows.next()) {
-                    Value[] r = rows.currentRow();
-                    try {
-                        addRow(r);
-                    } catch (DbException de) {
-                        if (handleOnDuplicate(de, r)) {
-                            // MySQL returns 2 for updated row
-                            // TODO: detect no-op change
-                            rowNumber++;
-                        } else {
-                            // INSERT IGNORE case
-                            rowNumber--;
-                        }
-                    }
+            // rows can be added in bulk to an empty table if they don't need to
+            // be visible before the commit, or the undo log is disabled
+            boolean bulkLoad = (session.getAutoCommit() || !session.isUndoLogEnabled()) && !ignore
+                    && duplicateKeyAssignmentMap == null && deltaChangeCollector == null && !table.fireRow()
+                    && table.startBulkLoad(session);
+            if (!bulkLoad) {
+                table.lock(session, true, false);
+            }
+            boolean success = false;
+            try {
+                insertFromQuery();
+                success = true;
+            } finally {
+                if (bulkLoad) {
+                    table.finishBulkLoad(session, success);
                 }
-                rows.close();
             }
         }
         table.fire(session, Trigger.INSERT, false);
         return rowNumber;
     }
 
+    private void insertFromQuery() {
+        if (insertFromSelect) {
+            query.query(0, this);
+        } else {
+            ResultInterface rows = query.query(0);
+            while (rows.next()) {
+                Value[] r = rows.currentRow();
+                try {
+                    addRow(r);
+                } catch (DbException de) {
+                    if (handleOnDuplicate(de, r)) {
+                        // MySQL returns 2 for updated row
+                        // TODO: detect no-op change
+                        rowNumber++;
+                    } else {
+                        // INSERT IGNORE case
+                        rowNumber--;
+                    }
+                }
+            }
+            rows.close();
+        }
+    }
+
     @Override
     public void addRow(Value... values) {
         Row newRow = table.getTemplateRow();
@@ -74,6 +74,7 @@ public boolean isTransactional() {
         case SetTypes.TIME_ZONE:
         case SetTypes.VARIABLE_BINARY:
         case SetTypes.TRUNCATE_LARGE_LENGTH:
+        case SetTypes.PARALLELISM:
         case SetTypes.WRITE_DELAY:
             return true;
         default:
@@ -573,6 +574,14 @@ public long update() {
         case SetTypes.TRUNCATE_LARGE_LENGTH:
             session.setTruncateLargeLength(expression.getBooleanValue(session));
             break;
+        case SetTypes.PARALLELISM: {
+            int value = getIntValue();
+            if (value < 1) {
+                throw DbException.getInvalidValueException("PARALLELISM", value);
+            }
+            session.setParallelism(value);
+            break;
+        }
         default:
             throw DbException.getInternalError("type="+type);
         }
@@ -252,7 +252,12 @@ public class SetTypes {
      */
     public static final int TRUNCATE_LARGE_LENGTH = DEFAULT_NULL_ORDERING + 1;
 
-    private static final int COUNT = TRUNCATE_LARGE_LENGTH + 1;
+    /**
+     * The type of a SET PARALLELISM statement.
+     */
+    public static final int PARALLELISM = TRUNCATE_LARGE_LENGTH + 1;
+
+    private static final int COUNT = PARALLELISM + 1;
 
     private static final ArrayList<String> TYPES;
 
@@ -310,6 +315,7 @@ private SetTypes() {
         list.add("VARIABLE_BINARY");
         list.add("DEFAULT_NULL_ORDERING");
         list.add("TRUNCATE_LARGE_LENGTH");
+        list.add("PARALLELISM");
         TYPES = list;
         assert(list.size() == COUNT);
     }
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.command.query;
+
+import java.util.ArrayList;
+
+import org.h2.engine.SessionLocal;
+import org.h2.expression.Alias;
+import org.h2.expression.Expression;
+import org.h2.expression.ExpressionColumn;
+import org.h2.expression.LongVector;
+import org.h2.expression.Parameter;
+import org.h2.expression.RowBatch;
+import org.h2.expression.aggregate.Aggregate;
+import org.h2.expression.analysis.DataAnalysisOperation;
+import org.h2.table.TableFilter;
+
+/**
+ * Gathers the only group of an aggregate query without GROUP BY clause over a
+ * single table. The rows are read in batches, the condition is evaluated for
+ * the whole batch, and then the aggregates are updated with all selected rows
+ * of the batch at once.
+ */
+final class BatchAggregation {
+
+    private final TableFilter filter;
+
+    private final Expression condition;
+
+    private final ArrayList<Aggregate> aggregates = new ArrayList<>();
+
+    private BatchAggregation(TableFilter filter, Expression condition) {
+        this.filter = filter;
+        this.condition = condition;
+    }
+
+    /**
+     * Check whether the group of a query can be gathered in batches.
+     *
+     * @param filter
+     *            the only table filter of the query
+     * @param condition
+     *            the condition, or {@code null}
+     * @param expressions
+     *            the expressions that are updated for each row
+     * @return the batch aggregation, or {@code null} if the query is not
+     *         supported
+     */
+    static BatchAggregation get(TableFilter filter, Expression condition, ArrayList<Expression> expressions) {
+        if (condition != null && !condition.isBatchCapable(filter)) {
+            return null;
+        }
+        BatchAggregation aggregation = new BatchAggregation(filter, condition);
+        for (Expression e : expressions) {
+            if (!aggregation.collect(e)) {
+                return null;
+            }
+        }
+        return aggregation.aggregates.isEmpty() ? null : aggregation;
+    }
+
+    private boolean collect(Expression e) {
+        if (e instanceof Alias) {
+            return collect(e.getNonAliasExpression());
+        } else if (e instanceof Aggregate) {
+            Aggregate aggregate = (Aggregate) e;
+            if (!aggregate.isBatchUpdatable(filter)) {
+                return false;
+            }
+            if (!aggregates.contains(aggregate)) {
+                aggregates.add(aggregate);
+            }
+            return true;
+        } else if (e instanceof ExpressionColumn || e instanceof DataAnalysisOperation) {
+            return false;
+        }
+        int count = e.getSubexpressionCount();
+        if (count == 0) {
+            // subqueries and other expressions without visible
+            // subexpressions are not supported
+            return e.isConstant() || e instanceof Parameter;
+        }
+        for (int i = 0; i < count; i++) {
+            if (!collect(e.getSubexpression(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Read all rows of the table filter and update the group data.
+     *
+     * @param session
+     *            the session
+     * @param groupData
+     *            the group data
+     */
+    void gatherGroup(SessionLocal session, SelectGroups groupData) {
+        Aggregate[] aggregates = this.aggregates.toArray(new Aggregate[0]);
+        RowBatch batch = new RowBatch(filter.getTable().getColumns().length, RowBatch.DEFAULT_CAPACITY);
+        boolean[] selection = condition != null ? new boolean[RowBatch.DEFAULT_CAPACITY] : null;
+        for (boolean hasNext = filter.next(); hasNext;) {
+            session.checkCanceled();
+            batch.clear();
+            boolean hasSpace;
+            do {
+                hasSpace = batch.add(filter.get());
+                hasNext = filter.next();
+            } while (hasSpace && hasNext);
+            if (selection != null) {
+                int size = batch.size();
+                LongVector conditionValues = condition.getValues(session, batch, null);
+                boolean found = false;
+                for (int i = 0; i < size; i++) {
+                    if (selection[i] = conditionValues.isTrue(i)) {
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    continue;
+                }
+            }
+            groupData.nextSource();
+            for (Aggregate aggregate : aggregates) {
+                aggregate.updateBatch(session, groupData, batch, selection);
+            }
+        }
+        groupData.done();
+    }
+
+}
@@ -0,0 +1,401 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.command.query;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Map.Entry;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.RejectedExecutionException;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+import org.h2.engine.SessionLocal;
+import org.h2.expression.Alias;
+import org.h2.expression.Expression;
+import org.h2.expression.ExpressionColumn;
+import org.h2.expression.Parameter;
+import org.h2.expression.aggregate.Aggregate;
+import org.h2.expression.analysis.DataAnalysisOperation;
+import org.h2.index.Cursor;
+import org.h2.message.DbException;
+import org.h2.mvstore.db.MVPrimaryIndex;
+import org.h2.mvstore.db.MVTable;
+import org.h2.result.Row;
+import org.h2.table.Column;
+import org.h2.table.Table;
+import org.h2.table.TableFilter;
+import org.h2.util.IntArray;
+import org.h2.value.CompareMode;
+import org.h2.value.DataType;
+import org.h2.value.Value;
+import org.h2.value.ValueRow;
+
+/**
+ * Gathers the groups of a grouped query over a single table with multiple
+ * threads. The rows of the primary index are split into ranges of keys, the
+ * partial aggregates of each range are computed by a separate thread, and then
+ * the partial aggregates are merged into the group data of the query. The
+ * partitions are gathered by the worker threads of the database shared by all
+ * sessions and by the session thread itself.
+ *
+ * Only queries without a WHERE clause are supported where all GROUP BY
+ * expressions are columns of the table, and all aggregates are mergeable and
+ * have only columns of the table as arguments, because the worker threads
+ * read the values directly from the rows instead of evaluating expressions.
+ */
+final class ParallelAggregation {
+
+    /**
+     * The minimal number of rows for each thread.
+     */
+    private static final int MIN_ROWS_PER_THREAD = 4096;
+
+    private final TableFilter filter;
+
+    private final MVPrimaryIndex index;
+
+    /**
+     * The ids of the columns of the GROUP BY expressions.
+     */
+    private final int[] groupColumnIds;
+
+    private final ArrayList<Aggregate> aggregates = new ArrayList<>();
+
+    /**
+     * The ids of the columns of arguments of each aggregate.
+     */
+    private final ArrayList<int[]> argumentColumnIds = new ArrayList<>();
+
+    /**
+     * References to the GROUP BY columns outside of the group expressions.
+     */
+    private final ArrayList<ExpressionColumn> groupColumns = new ArrayList<>();
+
+    /**
+     * The indexes of values in the group key for each reference in
+     * {@link #groupColumns}.
+     */
+    private final IntArray groupColumnKeyIndexes = new IntArray();
+
+    /**
+     * Whether the worker threads should stop.
+     */
+    volatile boolean aborted;
+
+    private ParallelAggregation(TableFilter filter, MVPrimaryIndex index, int[] groupColumnIds) {
+        this.filter = filter;
+        this.index = index;
+        this.groupColumnIds = groupColumnIds;
+    }
+
+    /**
+     * Check whether the groups of a query can be gathered in parallel.
+     *
+     * @param session
+     *            the session
+     * @param filter
+     *            the only table filter of the query
+     * @param groupExpressions
+     *            the GROUP BY expressions, or {@code null}
+     * @param expressions
+     *            the expressions that are updated for each row
+     * @return the parallel aggregation, or {@code null} if the query is not
+     *         supported
+     */
+    static ParallelAggregation get(SessionLocal session, TableFilter filter, Expression[] groupExpressions,
+            ArrayList<Expression> expressions) {
+        Table table = filter.getTable();
+        // collators are not thread-safe and may treat different values as equal
+        if (!(table instanceof MVTable)
+                || !CompareMode.OFF.equals(session.getDatabase().getCompareMode().getName())) {
+            return null;
+        }
+        int groupCount = groupExpressions != null ? groupExpressions.length : 0;
+        int[] groupColumnIds = new int[groupCount];
+        for (int i = 0; i < groupCount; i++) {
+            int columnId = getColumnId(filter, groupExpressions[i].getNonAliasExpression());
+            if (columnId < 0) {
+                return null;
+            }
+            groupColumnIds[i] = columnId;
+        }
+        ParallelAggregation aggregation = new ParallelAggregation(filter,
+                (MVPrimaryIndex) table.getScanIndex(session), groupColumnIds);
+        for (Expression e : expressions) {
+            if (!aggregation.collect(e)) {
+                return null;
+            }
+        }
+        return aggregation;
+    }
+
+    private static int getColumnId(TableFilter filter, Expression e) {
+        if (e instanceof ExpressionColumn) {
+            ExpressionColumn expressionColumn = (ExpressionColumn) e;
+            if (expressionColumn.getTableFilter() == filter) {
+                Column column = expressionColumn.getColumn();
+                if (!DataType.isLargeObject(column.getType().getValueType())) {
+                    return column.getColumnId();
+                }
+            }
+        }
+        return -1;
+    }
+
+    private boolean collect(Expression e) {
+        if (e instanceof Alias) {
+            return collect(e.getNonAliasExpression());
+        } else if (e instanceof Aggregate) {
+            Aggregate aggregate = (Aggregate) e;
+            if (!aggregate.isMergeable()) {
+                return false;
+            }
+            if (aggregates.contains(aggregate)) {
+                return true;
+            }
+            int count = aggregate.getSubexpressionCount();
+            int[] columnIds = new int[count];
+            for (int i = 0; i < count; i++) {
+                if ((columnIds[i] = getColumnId(filter, aggregate.getSubexpression(i))) < 0) {
+                    return false;
+                }
+            }
+            aggregates.add(aggregate);
+            argumentColumnIds.add(columnIds);
+            return true;
+        } else if (e instanceof ExpressionColumn) {
+            int columnId = getColumnId(filter, e);
+            if (columnId >= 0) {
+                for (int i = 0, l = groupColumnIds.length; i < l; i++) {
+                    if (groupColumnIds[i] == columnId) {
+                        groupColumns.add((ExpressionColumn) e);
+                        groupColumnKeyIndexes.add(i);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        } else if (e instanceof DataAnalysisOperation) {
+            return false;
+        }
+        int count = e.getSubexpressionCount();
+        if (count == 0) {
+            // subqueries and other expressions without visible
+            // subexpressions are not supported
+            return e.isConstant() || e instanceof Parameter;
+        }
+        for (int i = 0; i < count; i++) {
+            if (!collect(e.getSubexpression(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Gather the groups of the query and merge them into the group data.
+     *
+     * @param session
+     *            the session
+     * @param groupData
+     *            the group data
+     * @param parallelism
+     *            the maximum number of threads, including the session thread
+     */
+    void gatherGroup(SessionLocal session, SelectGroups groupData, int parallelism) {
+        long rowCount = index.getRowCountApproximation(session);
+        int count = (int) Math.max(Math.min(parallelism, rowCount / MIN_ROWS_PER_THREAD), 1L);
+        Cursor[] cursors = index.findPartitions(session, count);
+        count = cursors.length;
+        Partition[] partitions = new Partition[count];
+        for (int i = 0; i < count; i++) {
+            partitions[i] = new Partition(session, cursors[i]);
+        }
+        aborted = false;
+        ThreadPoolExecutor executor = session.getDatabase().getParallelExecutor();
+        boolean success = false;
+        try {
+            for (int i = 1; i < count; i++) {
+                try {
+                    executor.execute(partitions[i]);
+                } catch (RejectedExecutionException e) {
+                    // the partition is gathered by the session thread
+                }
+            }
+            // the session thread also gathers partitions that weren't started
+            // by the worker threads yet
+            for (Partition partition : partitions) {
+                partition.gather(true);
+            }
+            for (Partition partition : partitions) {
+                partition.await();
+                Throwable e = partition.exception;
+                if (e != null) {
+                    throw DbException.convert(e);
+                }
+            }
+            success = true;
+        } finally {
+            if (!success) {
+                aborted = true;
+                for (Partition partition : partitions) {
+                    partition.await();
+                }
+            }
+        }
+        Aggregate[] aggregates = this.aggregates.toArray(new Aggregate[0]);
+        int groupColumnCount = groupColumns.size();
+        for (Partition partition : partitions) {
+            for (Entry<ValueRow, Object[]> entry : partition.groups.entrySet()) {
+                ValueRow key = entry.getKey();
+                groupData.nextSource(key);
+                Object[] data = entry.getValue();
+                for (int i = 0; i < aggregates.length; i++) {
+                    aggregates[i].mergePartialData(session, groupData, data[i]);
+                }
+                Value[] keyValues = key.getList();
+                for (int i = 0; i < groupColumnCount; i++) {
+                    ExpressionColumn column = groupColumns.get(i);
+                    if (groupData.getCurrentGroupExprData(column) == null) {
+                        groupData.setCurrentGroupExprData(column, keyValues[groupColumnKeyIndexes.get(i)]);
+                    }
+                }
+            }
+            partition.groups = null;
+        }
+        groupData.done();
+    }
+
+    /**
+     * Computes partial aggregates for a range of rows. A partition is gathered
+     * either by a worker thread of the database or by the session thread,
+     * whichever starts it first.
+     */
+    private final class Partition implements Runnable {
+
+        private final SessionLocal session;
+
+        private final Cursor cursor;
+
+        private final AtomicBoolean started = new AtomicBoolean();
+
+        private final CountDownLatch finished = new CountDownLatch(1);
+
+        /**
+         * The exception thrown while gathering, or {@code null}.
+         */
+        volatile Throwable exception;
+
+        /**
+         * The partial aggregates by group key.
+         */
+        HashMap<ValueRow, Object[]> groups = new HashMap<>();
+
+        Partition(SessionLocal session, Cursor cursor) {
+            this.session = session;
+            this.cursor = cursor;
+        }
+
+        @Override
+        public void run() {
+            gather(false);
+        }
+
+        /**
+         * Read all rows of the range and update the partial aggregates, unless
+         * another thread has already started it.
+         *
+         * @param sessionThread
+         *            whether the current thread is the session thread
+         */
+        void gather(boolean sessionThread) {
+            if (!started.compareAndSet(false, true)) {
+                return;
+            }
+            try {
+                if (!aborted) {
+                    gatherRows(sessionThread);
+                }
+            } catch (Throwable e) {
+                exception = e;
+                aborted = true;
+            } finally {
+                finished.countDown();
+            }
+        }
+
+        /**
+         * Wait until the partition is gathered. If it wasn't started yet, it
+         * is skipped.
+         */
+        void await() {
+            if (started.compareAndSet(false, true)) {
+                finished.countDown();
+                return;
+            }
+            while (true) {
+                try {
+                    finished.await();
+                    return;
+                } catch (InterruptedException e) {
+                    // continue waiting, the worker thread still uses the cursor
+                }
+            }
+        }
+
+        private void gatherRows(boolean sessionThread) {
+            int[] groupColumnIds = ParallelAggregation.this.groupColumnIds;
+            Aggregate[] aggregates = ParallelAggregation.this.aggregates.toArray(new Aggregate[0]);
+            int[][] argumentColumnIds = ParallelAggregation.this.argumentColumnIds.toArray(new int[0][]);
+            int groupCount = groupColumnIds.length, aggregateCount = aggregates.length;
+            Value[][] arguments = new Value[aggregateCount][];
+            for (int i = 0; i < aggregateCount; i++) {
+                arguments[i] = new Value[argumentColumnIds[i].length];
+            }
+            HashMap<ValueRow, Object[]> groups = this.groups;
+            for (int rowNumber = 1; cursor.next(); rowNumber++) {
+                if ((rowNumber & 4095) == 0) {
+                    if (aborted) {
+                        return;
+                    }
+                    if (sessionThread) {
+                        session.checkCanceled();
+                    }
+                }
+                Row row = cursor.get();
+                ValueRow key;
+                if (groupCount == 0) {
+                    key = ValueRow.EMPTY;
+                } else {
+                    Value[] keyValues = new Value[groupCount];
+                    for (int i = 0; i < groupCount; i++) {
+                        keyValues[i] = row.getValue(groupColumnIds[i]);
+                    }
+                    key = ValueRow.get(keyValues);
+                }
+                Object[] data = groups.get(key);
+                if (data == null) {
+                    data = new Object[aggregateCount];
+                    for (int i = 0; i < aggregateCount; i++) {
+                        data[i] = aggregates[i].createPartialData();
+                    }
+                    groups.put(key, data);
+                }
+                for (int i = 0; i < aggregateCount; i++) {
+                    int[] columnIds = argumentColumnIds[i];
+                    Value[] values = arguments[i];
+                    for (int j = 0; j < columnIds.length; j++) {
+                        values[j] = row.getValue(columnIds[j]);
+                    }
+                    aggregates[i].updatePartialData(session, data[i], values);
+                }
+            }
+        }
+
+    }
+
+}
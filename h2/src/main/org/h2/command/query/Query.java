@@ -503,6 +503,16 @@ private void closeLastResult() {
         }
     }
 
+    @Override
+    public void setSession(SessionLocal currentSession) {
+        if (currentSession != session) {
+            // the result may contain uncommitted rows of the previous session
+            closeLastResult();
+            lastResult = null;
+        }
+        super.setSession(currentSession);
+    }
+
     /**
      * Initialize the order by list. This call may extend the expressions list.
      *
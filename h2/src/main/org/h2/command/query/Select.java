@@ -27,7 +27,9 @@
 import org.h2.expression.ExpressionColumn;
 import org.h2.expression.ExpressionList;
 import org.h2.expression.ExpressionVisitor;
+import org.h2.expression.LongVector;
 import org.h2.expression.Parameter;
+import org.h2.expression.RowBatch;
 import org.h2.expression.Wildcard;
 import org.h2.expression.analysis.DataAnalysisOperation;
 import org.h2.expression.analysis.Window;
@@ -40,6 +42,7 @@
 import org.h2.index.ViewIndex;
 import org.h2.message.DbException;
 import org.h2.mode.DefaultNullOrdering;
+import org.h2.mvstore.db.MVTable;
 import org.h2.result.LazyResult;
 import org.h2.result.LocalResult;
 import org.h2.result.ResultInterface;
@@ -154,8 +157,48 @@ public class Select extends Query {
 
     private boolean isGroupWindowStage2;
 
+    /**
+     * Whether {@link #parallelAggregation} was already initialized.
+     */
+    private boolean parallelAggregationChecked;
+
+    /**
+     * Parallel execution of a grouped query, or {@code null} if it is not
+     * supported for this query.
+     */
+    private ParallelAggregation parallelAggregation;
+
+    /**
+     * Whether {@link #batchAggregation} was already initialized.
+     */
+    private boolean batchAggregationChecked;
+
+    /**
+     * Batch execution of an aggregate query, or {@code null} if it is not
+     * supported for this query.
+     */
+    private BatchAggregation batchAggregation;
+
     private HashMap<String, Window> windows;
 
+    /**
+     * The time of the last profiled execution before the result was finished,
+     * in nanoseconds, or -1 if the last execution was not profiled.
+     */
+    private long executionTimeNanos = -1L;
+
+    /**
+     * The number of rows of the result of the last profiled execution before
+     * it was finished, or -1 if unknown.
+     */
+    private long executionRowCount;
+
+    /**
+     * The time of the last profiled sort of the result, in nanoseconds, or -1
+     * if the result was not sorted.
+     */
+    private long sortTimeNanos;
+
     public Select(SessionLocal session, Select parentSelect) {
         super(session);
         this.parentSelect = parentSelect;
@@ -368,7 +411,7 @@ private Index getGroupSortedIndex() {
                 if (index.getIndexType().isScan()) {
                     continue;
                 }
-                if (index.getIndexType().isHash()) {
+                if (index.getIndexType().isHash() || index.getIndexType().isMinMax()) {
                     // does not allow scanning entries
                     continue;
                 }
@@ -485,13 +528,70 @@ private void queryGroupWindow(int columnCount, LocalResult result, long offset,
     private void queryGroup(int columnCount, LocalResult result, long offset, boolean quickOffset) {
         initGroupData(columnCount);
         try {
-            gatherGroup(columnCount, DataAnalysisOperation.STAGE_GROUP);
+            int parallelism = session.getParallelism();
+            ParallelAggregation parallel;
+            BatchAggregation batch;
+            if (parallelism > 1 && (parallel = getParallelAggregation(columnCount)) != null) {
+                parallel.gatherGroup(session, groupData, parallelism);
+            } else if ((batch = getBatchAggregation(columnCount)) != null) {
+                batch.gatherGroup(session, groupData);
+            } else {
+                gatherGroup(columnCount, DataAnalysisOperation.STAGE_GROUP);
+            }
             processGroupResult(columnCount, result, offset, quickOffset, true);
         } finally {
             groupData.reset();
         }
     }
 
+    private ParallelAggregation getParallelAggregation(int columnCount) {
+        if (!parallelAggregationChecked) {
+            parallelAggregationChecked = true;
+            if (condition == null && !isForUpdate && filters.size() == 1 && topTableFilter.getJoin() == null
+                    && topTableFilter.getNestedJoin() == null) {
+                Expression[] groupExpressions = null;
+                if (groupIndex != null) {
+                    int count = groupIndex.length;
+                    groupExpressions = new Expression[count];
+                    for (int i = 0; i < count; i++) {
+                        groupExpressions[i] = expressions.get(groupIndex[i]);
+                    }
+                }
+                parallelAggregation = ParallelAggregation.get(session, topTableFilter, groupExpressions,
+                        getAggregatedExpressions(columnCount));
+            }
+        }
+        return parallelAggregation;
+    }
+
+    private BatchAggregation getBatchAggregation(int columnCount) {
+        if (!batchAggregationChecked) {
+            batchAggregationChecked = true;
+            if (groupIndex == null && isBatchEvaluationSupported()) {
+                batchAggregation = BatchAggregation.get(topTableFilter, condition,
+                        getAggregatedExpressions(columnCount));
+            }
+        }
+        return batchAggregation;
+    }
+
+    /**
+     * Returns the same expressions as updated in {@link #updateAgg(int, int)}.
+     *
+     * @param columnCount number of columns
+     * @return the expressions
+     */
+    private ArrayList<Expression> getAggregatedExpressions(int columnCount) {
+        ArrayList<Expression> list = new ArrayList<>(columnCount);
+        for (int i = 0; i < columnCount; i++) {
+            if ((groupByExpression == null || !groupByExpression[i])
+                    && (groupByCopies == null || groupByCopies[i] < 0)) {
+                list.add(expressions.get(i));
+            }
+        }
+        return list;
+    }
+
     private void initGroupData(int columnCount) {
         if (groupData == null) {
             setGroupData(SelectGroups.getInstance(session, expressions, isGroupQuery, groupIndex));
@@ -632,7 +732,7 @@ private Index getSortIndex() {
                     // can't use the scan index
                     continue;
                 }
-                if (index.getIndexType().isHash()) {
+                if (index.getIndexType().isHash() || index.getIndexType().isMinMax()) {
                     continue;
                 }
                 IndexColumn[] indexCols = index.getIndexColumns();
@@ -724,6 +824,11 @@ private LazyResult queryFlat(int columnCount, ResultTarget result, long offset,
         if (limitRows < 0 || sort != null && !sortUsingIndex || withTies && !quickOffset) {
             limitRows = Long.MAX_VALUE;
         }
+        if (limitRows == Long.MAX_VALUE && condition != null && isBatchEvaluationSupported()
+                && condition.isBatchCapable(topTableFilter)) {
+            lazyResult.addRowsInBatches(result);
+            return null;
+        }
         Value[] row = null;
         while (result.getRowCount() < limitRows && lazyResult.next()) {
             row = lazyResult.currentRow();
@@ -743,6 +848,51 @@ private LazyResult queryFlat(int columnCount, ResultTarget result, long offset,
         return null;
     }
 
+    /**
+     * Check whether the rows of this query may be evaluated in batches. Only
+     * queries over a single table without FOR UPDATE clause are supported.
+     *
+     * @return whether batch evaluation may be used
+     */
+    private boolean isBatchEvaluationSupported() {
+        return session.getDatabase().getSettings().optimizeBatchEvaluation && !isForUpdate && filters.size() == 1
+                && topTableFilter.getJoin() == null && topTableFilter.getNestedJoin() == null
+                // rows of other tables may be reused by their cursors
+                && topTableFilter.getTable() instanceof MVTable
+                // batches contain whole rows, they would be read for each
+                // index entry
+                && !isIndexCovering();
+    }
+
+    /**
+     * Check whether the index of the top table filter contains all columns
+     * used by this query, so the rows of the table don't need to be read.
+     *
+     * @return whether the index covers the query
+     */
+    private boolean isIndexCovering() {
+        Index index = topTableFilter.getIndex();
+        if (index == null) {
+            return false;
+        }
+        Table table = topTableFilter.getTable();
+        HashSet<Column> columns = new HashSet<>();
+        ExpressionVisitor visitor = ExpressionVisitor.getColumnsVisitor(columns, table);
+        if (condition != null) {
+            condition.isEverything(visitor);
+        }
+        for (Expression e : expressions) {
+            e.isEverything(visitor);
+        }
+        for (Column column : columns) {
+            int columnId = column.getColumnId();
+            if (columnId != -1 && columnId != table.getMainIndexColumn() && index.getColumnIndex(column) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     private static void skipOffset(LazyResultSelect lazyResult, long offset, boolean quickOffset) {
         if (quickOffset) {
             while (offset > 0 && lazyResult.skip()) {
@@ -764,6 +914,9 @@ private void queryQuick(int columnCount, ResultTarget result, boolean skipResult
 
     @Override
     protected ResultInterface queryWithoutCache(long maxRows, ResultTarget target) {
+        boolean profiling = session.isQueryProfiling();
+        long startNanos = profiling ? System.nanoTime() : 0L;
+        executionTimeNanos = -1L;
         disableLazyForJoinSubqueries(topTableFilter);
         OffsetFetch offsetFetch = getOffsetFetch(maxRows);
         long offset = offsetFetch.offset;
@@ -804,6 +957,14 @@ protected ResultInterface queryWithoutCache(long maxRows, ResultTarget target) {
         if (!lazy && (fetch >= 0 || offset > 0)) {
             result = createLocalResult(result);
         }
+        if (result != null && sort != null && !sortUsingIndex && !isAnyDistinct() && fetch > 0 && !fetchPercent
+                && !withTies) {
+            // keep only the first rows instead of sorting of all rows
+            long topRows = offset + fetch;
+            if (topRows > 0 && topRows <= session.getDatabase().getMaxMemoryRows()) {
+                result.setTopRows((int) topRows);
+            }
+        }
         topTableFilter.startQuery(session);
         topTableFilter.reset();
         topTableFilter.lock(session);
@@ -847,7 +1008,18 @@ protected ResultInterface queryWithoutCache(long maxRows, ResultTarget target) {
                 return lazyResult;
             }
         }
+        if (profiling) {
+            executionTimeNanos = System.nanoTime() - startNanos;
+            executionRowCount = result != null ? result.getRowCount() : -1L;
+            sortTimeNanos = -1L;
+        }
         if (result != null) {
+            if (profiling && sort != null && !sortUsingIndex) {
+                startNanos = System.nanoTime();
+                result = finishResult(result, offset, fetch, fetchPercent, target);
+                sortTimeNanos = System.nanoTime() - startNanos;
+                return result;
+            }
             return finishResult(result, offset, fetch, fetchPercent, target);
         }
         return null;
@@ -1470,10 +1642,42 @@ public String getPlanSQL(int sqlFlags) {
                 }
             }
             // builder.append("\n/* cost: " + cost + " */");
+            if (executionTimeNanos >= 0L) {
+                getProfileSQL(builder);
+            }
         }
         return builder.toString();
     }
 
+    private void getProfileSQL(StringBuilder builder) {
+        String stage;
+        if (isQuickAggregateQuery) {
+            stage = "direct lookup";
+        } else if (isWindowQuery) {
+            stage = "window";
+        } else if (isGroupQuery) {
+            stage = "group";
+        } else if (isDistinctQuery) {
+            stage = "distinct";
+        } else {
+            stage = "select";
+        }
+        long timeNanos = executionTimeNanos;
+        if (topTableFilter != null) {
+            // the time of table filters is shown separately, if it was
+            // measured
+            timeNanos = Math.max(timeNanos - topTableFilter.getTimeNanos(), 0L);
+        }
+        builder.append("\n/* ").append(stage).append(": ");
+        if (executionRowCount >= 0L) {
+            builder.append("rows: ").append(executionRowCount).append(", ");
+        }
+        StringUtils.appendMillis(builder.append("time: "), timeNanos).append(" */");
+        if (sortTimeNanos >= 0L) {
+            StringUtils.appendMillis(builder.append("\n/* sort: time: "), sortTimeNanos).append(" */");
+        }
+    }
+
     private static boolean getPlanFromFilter(StringBuilder builder, int sqlFlags, TableFilter f, boolean isJoin) {
         do {
             if (isJoin) {
@@ -1851,6 +2055,73 @@ protected boolean skipNextRow() {
             return false;
         }
 
+        /**
+         * Read all remaining rows and add them to the result. The condition
+         * is evaluated for batches of rows, the selected columns are evaluated
+         * for batches too if possible, or row by row otherwise.
+         *
+         * @param result the result
+         */
+        void addRowsInBatches(ResultTarget result) {
+            SessionLocal session = getSession();
+            int columnCount = this.columnCount;
+            boolean batchedColumns = true;
+            int[] valueTypes = new int[columnCount];
+            for (int i = 0; i < columnCount; i++) {
+                Expression expr = expressions.get(i);
+                if (!expr.isBatchCapable(topTableFilter)) {
+                    batchedColumns = false;
+                }
+                valueTypes[i] = expr.getType().getValueType();
+            }
+            RowBatch batch = new RowBatch(topTableFilter.getTable().getColumns().length, RowBatch.DEFAULT_CAPACITY);
+            LongVector[] columns = new LongVector[columnCount];
+            boolean[] selection = new boolean[RowBatch.DEFAULT_CAPACITY];
+            for (boolean hasNext = topTableFilter.next(); hasNext;) {
+                batch.clear();
+                boolean hasSpace;
+                do {
+                    hasSpace = batch.add(topTableFilter.get());
+                    hasNext = topTableFilter.next();
+                } while (hasSpace && hasNext);
+                int size = batch.size();
+                LongVector conditionValues = condition.getValues(session, batch, null);
+                boolean found = false;
+                for (int i = 0; i < size; i++) {
+                    if (selection[i] = conditionValues.isTrue(i)) {
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    continue;
+                }
+                if (batchedColumns) {
+                    for (int i = 0; i < columnCount; i++) {
+                        columns[i] = expressions.get(i).getValues(session, batch, selection);
+                    }
+                }
+                for (int r = 0; r < size; r++) {
+                    if (!selection[r]) {
+                        continue;
+                    }
+                    setCurrentRowNumber(++rowNumber);
+                    Value[] row = new Value[columnCount];
+                    if (batchedColumns) {
+                        for (int i = 0; i < columnCount; i++) {
+                            row[i] = columns[i].getValue(r, valueTypes[i]);
+                        }
+                    } else {
+                        topTableFilter.set(batch.getRow(r));
+                        for (int i = 0; i < columnCount; i++) {
+                            row[i] = expressions.get(i).getValue(session);
+                        }
+                    }
+                    result.addRow(row);
+                }
+            }
+            topTableFilter.set(null);
+        }
+
     }
 
     /**
@@ -91,6 +91,16 @@ public void nextSource() {
                 }
                 currentGroupsKey = ValueRow.get(keyValues);
             }
+            setCurrentGroup();
+        }
+
+        @Override
+        public void nextSource(ValueRow groupKey) {
+            currentGroupsKey = groupKey;
+            setCurrentGroup();
+        }
+
+        private void setCurrentGroup() {
             Object[] values = groupByData.get(currentGroupsKey);
             if (values == null) {
                 values = createRow();
@@ -385,6 +395,18 @@ public void reset() {
      */
     public abstract void nextSource();
 
+    /**
+     * Invoked instead of {@link #nextSource()} to set up data for aggregates
+     * of the group with the specified key computed outside of this instance.
+     * Supported only by grouped data.
+     *
+     * @param groupKey
+     *            the values of group expressions
+     */
+    public void nextSource(ValueRow groupKey) {
+        throw new UnsupportedOperationException();
+    }
+
     /**
      * Invoked after all source rows are evaluated.
      */
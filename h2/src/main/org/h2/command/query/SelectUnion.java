@@ -80,6 +80,13 @@ public boolean isUnion() {
         return true;
     }
 
+    @Override
+    public void setSession(SessionLocal currentSession) {
+        super.setSession(currentSession);
+        left.setSession(currentSession);
+        right.setSession(currentSession);
+    }
+
     public UnionType getUnionType() {
         return unionType;
     }
@@ -5,6 +5,10 @@
  */
 package org.h2.compress;
 
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.HashMap;
+import java.util.Map;
 import java.util.StringTokenizer;
 import java.util.zip.DataFormatException;
 import java.util.zip.Deflater;
@@ -23,11 +27,85 @@
  *  1 (filtered), 2 (huffman only)
  * </li></ul>
  * See also java.util.zip.Deflater for details.
+ * <p>
+ * A preset dictionary may be used to compress small blocks of similar data
+ * better, the same dictionary is required to expand them.
+ * </p>
  */
 public class CompressDeflate implements Compressor {
 
+    /**
+     * The length of sequences counted by
+     * {@link #trainDictionary(Collection, int)}.
+     */
+    private static final int SEQUENCE_LENGTH = 8;
+
     private int level = Deflater.DEFAULT_COMPRESSION;
     private int strategy = Deflater.DEFAULT_STRATEGY;
+    private final byte[] dictionary;
+
+    /**
+     * Creates a new compressor without a dictionary.
+     */
+    public CompressDeflate() {
+        this(null);
+    }
+
+    /**
+     * Creates a new compressor with the specified preset dictionary.
+     *
+     * @param dictionary the dictionary, or {@code null}
+     */
+    public CompressDeflate(byte[] dictionary) {
+        this.dictionary = dictionary;
+    }
+
+    /**
+     * Build a preset dictionary from samples of data, such as serialized rows
+     * of a table. The dictionary contains the most frequent sequences of bytes
+     * in the samples, the most frequent ones are placed at the end of the
+     * dictionary, because they can be referenced with shorter distances.
+     *
+     * @param samples the samples
+     * @param maxLength the maximum length of the dictionary
+     * @return the dictionary
+     */
+    public static byte[] trainDictionary(Collection<byte[]> samples, int maxLength) {
+        HashMap<Long, Integer> counts = new HashMap<>();
+        for (byte[] sample : samples) {
+            for (int i = 0, l = sample.length - SEQUENCE_LENGTH; i <= l;) {
+                Long key = getSequence(sample, i);
+                Integer count = counts.get(key);
+                counts.put(key, count == null ? 1 : count + 1);
+                // don't count overlapping repetitions of the same sequence
+                i += count == null ? 1 : SEQUENCE_LENGTH;
+            }
+        }
+        ArrayList<Map.Entry<Long, Integer>> frequent = new ArrayList<>();
+        for (Map.Entry<Long, Integer> e : counts.entrySet()) {
+            if (e.getValue() > 1) {
+                frequent.add(e);
+            }
+        }
+        frequent.sort((a, b) -> Integer.compare(b.getValue(), a.getValue()));
+        int count = Math.min(frequent.size(), maxLength / SEQUENCE_LENGTH);
+        byte[] dictionary = new byte[count * SEQUENCE_LENGTH];
+        for (int i = 0, pos = dictionary.length; i < count; i++) {
+            long sequence = frequent.get(i).getKey();
+            for (int j = SEQUENCE_LENGTH; --j >= 0; sequence >>>= 8) {
+                dictionary[--pos] = (byte) sequence;
+            }
+        }
+        return dictionary;
+    }
+
+    private static long getSequence(byte[] data, int offset) {
+        long sequence = 0L;
+        for (int i = 0; i < SEQUENCE_LENGTH; i++) {
+            sequence = sequence << 8 | data[offset + i] & 0xff;
+        }
+        return sequence;
+    }
 
     @Override
     public void setOptions(String options) {
@@ -56,6 +134,9 @@ public int compress(byte[] in, int inPos, int inLen, byte[] out, int outPos) {
         Deflater deflater = new Deflater(level);
         deflater.setStrategy(strategy);
         deflater.setInput(in, inPos, inLen);
+        if (dictionary != null) {
+            deflater.setDictionary(dictionary);
+        }
         deflater.finish();
         int compressed = deflater.deflate(out, outPos, out.length - outPos);
         if (compressed == 0) {
@@ -83,6 +164,13 @@ public void expand(byte[] in, int inPos, int inLen, byte[] out, int outPos,
         decompresser.finished();
         try {
             int len = decompresser.inflate(out, outPos, outLen);
+            if (len == 0 && decompresser.needsDictionary()) {
+                if (dictionary == null) {
+                    throw new DataFormatException("dictionary required");
+                }
+                decompresser.setDictionary(dictionary);
+                len = decompresser.inflate(out, outPos, outLen);
+            }
             if (len != outLen) {
                 throw new DataFormatException(len + " " + outLen);
             }
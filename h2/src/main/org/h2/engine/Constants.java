@@ -88,6 +88,12 @@ public class Constants {
      */
     public static final int TCP_PROTOCOL_VERSION_20 = 20;
 
+    /**
+     * The TCP protocol version number 21.
+     * @since 2.0.202 (TODO)
+     */
+    public static final int TCP_PROTOCOL_VERSION_21 = 21;
+
     /**
      * Minimum supported version of TCP protocol.
      */
@@ -96,7 +102,7 @@ public class Constants {
     /**
      * Maximum supported version of TCP protocol.
      */
-    public static final int TCP_PROTOCOL_VERSION_MAX_SUPPORTED = TCP_PROTOCOL_VERSION_20;
+    public static final int TCP_PROTOCOL_VERSION_MAX_SUPPORTED = TCP_PROTOCOL_VERSION_21;
 
     /**
      * The major version of this database.
@@ -430,6 +436,19 @@ public class Constants {
      */
     public static final String START_URL = "jdbc:h2:";
 
+    /**
+     * The suffix of the name of the entry with the list of chunks of a MVStore
+     * file in a backup. It is appended to the name of the MVStore file.
+     */
+    public static final String SUFFIX_BACKUP_CHUNKS = ".chunks";
+
+    /**
+     * The suffix of the name of the entry with the changed chunks of a MVStore
+     * file in an incremental backup. It is appended to the name of the MVStore
+     * file.
+     */
+    public static final String SUFFIX_BACKUP_INCREMENT = ".increment";
+
     /**
      * The file name suffix of file lock files that are used to make sure a
      * database is open by only one process at any time.
@@ -17,6 +17,10 @@
 import java.util.Objects;
 import java.util.Set;
 import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
 import java.util.concurrent.atomic.AtomicLong;
 import java.util.concurrent.atomic.AtomicReference;
 import org.h2.api.DatabaseEventListener;
@@ -174,6 +178,11 @@ public final class Database implements DataHandler, CastDataProvider {
     private boolean readOnly;
     private DatabaseEventListener eventListener;
     private int maxMemoryRows = SysProperties.MAX_MEMORY_ROWS;
+    /**
+     * The estimated size in bytes of rows that results of all sessions keep in
+     * memory.
+     */
+    private final AtomicLong queryMemory = new AtomicLong();
     private int lockMode;
     private int maxLengthInplaceLob;
     private int allowLiterals = Constants.ALLOW_LITERALS_ALL;
@@ -212,6 +221,8 @@ public final class Database implements DataHandler, CastDataProvider {
     private boolean queryStatistics;
     private int queryStatisticsMaxEntries = Constants.QUERY_STATISTICS_MAX_ENTRIES;
     private QueryStatisticsData queryStatisticsData;
+    private final SharedQueryCache sharedQueryCache;
+    private final ThreadPoolExecutor parallelExecutor;
     private RowFactory rowFactory = RowFactory.getRowFactory();
     private boolean ignoreCatalogs;
 
@@ -225,6 +236,9 @@ public Database(ConnectionInfo ci, String cipher) {
         }
         String databaseName = ci.getName();
         this.dbSettings = ci.getDbSettings();
+        sharedQueryCache = dbSettings.sharedQueryCacheSize > 0 && dbSettings.queryCacheSize > 0
+                ? new SharedQueryCache(this, dbSettings.sharedQueryCacheSize) : null;
+        parallelExecutor = createParallelExecutor(ci.getName(), Math.max(dbSettings.maxParallelThreads, 1));
         this.compareMode = CompareMode.getInstance(null, 0);
         this.persistent = ci.isPersistent();
         this.filePasswordHash = ci.getFilePasswordHash();
@@ -1219,6 +1233,7 @@ private void closeImpl(boolean fromShutdownHook) {
             } catch (DbException e) {
                 trace.error(e, "close");
             }
+            parallelExecutor.shutdownNow();
             tempFileDeleter.deleteAll();
             try {
                 if (lobSession != null) {
@@ -1928,6 +1943,62 @@ public void setMaxMemoryRows(int value) {
         this.maxMemoryRows = value;
     }
 
+    /**
+     * Returns the maximum estimated size in bytes of rows that a result keeps
+     * in memory.
+     *
+     * @return the maximum size in bytes, or {@code 0} if only the number of
+     *         rows is limited
+     */
+    public long getMaxQueryMemory() {
+        return dbSettings.maxQueryMemory * 1024L;
+    }
+
+    /**
+     * Returns whether memory of results should be accounted.
+     *
+     * @return whether the size of results or the memory pool is limited
+     */
+    public boolean isQueryMemoryAccounted() {
+        return dbSettings.maxQueryMemory > 0 || dbSettings.queryMemoryPool > 0;
+    }
+
+    /**
+     * Reserve memory of the shared pool for rows of a result. The memory is
+     * reserved even if the pool is exhausted, it must be released with
+     * {@link #releaseQueryMemory(long)} in any case.
+     *
+     * @param bytes
+     *            the estimated size in bytes
+     * @return {@code true} if the pool still has enough memory, {@code false}
+     *         if the rows should be written to disk
+     */
+    boolean reserveQueryMemory(long bytes) {
+        long used = queryMemory.addAndGet(bytes);
+        int pool = dbSettings.queryMemoryPool;
+        return pool <= 0 || used <= pool * 1024L;
+    }
+
+    /**
+     * Release previously reserved memory of the shared pool.
+     *
+     * @param bytes
+     *            the estimated size in bytes
+     */
+    void releaseQueryMemory(long bytes) {
+        queryMemory.addAndGet(-bytes);
+    }
+
+    /**
+     * Returns the estimated size of rows that results of all sessions keep in
+     * memory.
+     *
+     * @return the size in bytes
+     */
+    public long getQueryMemory() {
+        return queryMemory.get();
+    }
+
     public void setLockMode(int lockMode) {
         switch (lockMode) {
         case Constants.LOCK_MODE_OFF:
@@ -2051,6 +2122,38 @@ public void setQueryStatisticsMaxEntries(int n) {
         }
     }
 
+    private static ThreadPoolExecutor createParallelExecutor(String databaseName, int threads) {
+        AtomicInteger threadId = new AtomicInteger();
+        ThreadPoolExecutor executor = new ThreadPoolExecutor(threads, threads, 60L, TimeUnit.SECONDS,
+                new LinkedBlockingQueue<>(), r -> {
+                    Thread t = new Thread(r, "H2 Parallel Query " + databaseName + ' ' + threadId.incrementAndGet());
+                    t.setDaemon(true);
+                    return t;
+                });
+        executor.allowCoreThreadTimeOut(true);
+        return executor;
+    }
+
+    /**
+     * Get the executor for worker threads of parallel queries. Its threads are
+     * shared by all sessions, their number is limited by the
+     * MAX_PARALLEL_THREADS setting.
+     *
+     * @return the executor
+     */
+    public ThreadPoolExecutor getParallelExecutor() {
+        return parallelExecutor;
+    }
+
+    /**
+     * Get the query cache shared by all sessions.
+     *
+     * @return the shared query cache, or {@code null} if it is disabled
+     */
+    public SharedQueryCache getSharedQueryCache() {
+        return sharedQueryCache;
+    }
+
     public QueryStatisticsData getQueryStatisticsData() {
         if (!queryStatistics) {
             return null;
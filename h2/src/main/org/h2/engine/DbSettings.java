@@ -46,12 +46,30 @@ public class DbSettings extends SettingsBase {
      */
     public final int analyzeAuto = get("ANALYZE_AUTO", 2000);
 
+    /**
+     * Database setting <code>ANALYZE_HISTOGRAM_SIZE</code> (default: 32).<br />
+     * The maximum number of buckets of the histogram and of most common values
+     * collected for each column when analyzing a table. The histograms are
+     * used to estimate the number of rows matched by conditions with constant
+     * values. Histograms are not collected if set to 0.
+     */
+    public final int analyzeHistogramSize = get("ANALYZE_HISTOGRAM_SIZE", 32);
+
     /**
      * Database setting <code>ANALYZE_SAMPLE</code> (default: 10000).<br />
      * The default sample size when analyzing a table.
      */
     public final int analyzeSample = get("ANALYZE_SAMPLE", 10_000);
 
+    /**
+     * Database setting <code>AUTO_COMPACT_BANDWIDTH</code> (default: 0).<br />
+     * The maximum number of kilobytes per second written by the background
+     * compaction, 0 means no limit. With a limit the chunks are compacted
+     * incrementally in small steps.<br />
+     * This setting only affects MVStore engine.
+     */
+    public final int autoCompactBandwidth = get("AUTO_COMPACT_BANDWIDTH", 0);
+
     /**
      * Database setting <code>AUTO_COMPACT_FILL_RATE</code>
      * (default: 90, which means 90%, 0 disables auto-compacting).<br />
@@ -136,6 +154,24 @@ public class DbSettings extends SettingsBase {
     public final int estimatedFunctionTableRows = get(
             "ESTIMATED_FUNCTION_TABLE_ROWS", 1000);
 
+    /**
+     * Database setting <code>GROUP_COMMIT_DELAY</code> (default: 0).<br />
+     * The maximum number of microseconds a commit waits for other concurrent
+     * commits to join it, so that their changes are written to the file
+     * together. Concurrent commits are combined even if the delay is 0.
+     */
+    public final int groupCommitDelay = get("GROUP_COMMIT_DELAY", 0);
+
+    /**
+     * Database setting <code>LOB_BLOCK_SIZE</code> (default: 262144).<br />
+     * The maximum size in bytes of a block of LOB data. Larger blocks reduce
+     * the number of map entries and reads for large LOBs. The minimum is 4096.
+     * The setting only affects new LOBs, existing LOBs can be read with any
+     * block size.
+     * This setting only affects MVStore engine.
+     */
+    public final int lobBlockSize = get("LOB_BLOCK_SIZE", 256 * 1024);
+
     /**
      * Database setting <code>LOB_TIMEOUT</code> (default: 300000,
      * which means 5 minutes).<br />
@@ -151,6 +187,25 @@ public class DbSettings extends SettingsBase {
      */
     public final int maxCompactTime = get("MAX_COMPACT_TIME", 200);
 
+    /**
+     * Database setting <code>MAX_PARALLEL_THREADS</code> (default: the number
+     * of processors).<br />
+     * The maximum number of worker threads that all sessions of the database
+     * may use together for parallel queries. If all of them are busy, a query
+     * reads the remaining parts of the data on its own thread.
+     */
+    public final int maxParallelThreads = get("MAX_PARALLEL_THREADS", Runtime.getRuntime().availableProcessors());
+
+    /**
+     * Database setting <code>MAX_QUERY_MEMORY</code> (default: 0).<br />
+     * The maximum estimated size in KB of rows that a result, such as the
+     * result of a sorted or DISTINCT query, keeps in memory. If this size is
+     * exceeded, the rows are written to a temporary file, the same way as when
+     * the number of rows exceeds MAX_MEMORY_ROWS. The default is 0, meaning
+     * only the number of rows is limited.
+     */
+    public final int maxQueryMemory = get("MAX_QUERY_MEMORY", 0);
+
     /**
      * Database setting <code>MAX_QUERY_TIMEOUT</code> (default: 0).<br />
      * The maximum timeout of a query in milliseconds. The default is 0, meaning
@@ -159,6 +214,24 @@ public class DbSettings extends SettingsBase {
      */
     public final int maxQueryTimeout = get("MAX_QUERY_TIMEOUT", 0);
 
+    /**
+     * Database setting <code>OFF_HEAP_CACHE_SIZE</code> (default: 0).<br />
+     * The size of the second level cache of serialized pages outside of the Java
+     * heap in MB, 0 disables this cache.<br />
+     * This setting only affects MVStore engine.
+     */
+    public final int offHeapCacheSize = get("OFF_HEAP_CACHE_SIZE", 0);
+
+    /**
+     * Database setting <code>OPTIMIZE_BATCH_EVALUATION</code> (default:
+     * true).<br />
+     * Evaluate conditions and simple aggregates of queries over a single table
+     * for batches of rows at once. Only comparisons, AND and OR conditions,
+     * and arithmetic operations on columns of BOOLEAN and integer data types
+     * are evaluated this way.
+     */
+    public final boolean optimizeBatchEvaluation = get("OPTIMIZE_BATCH_EVALUATION", true);
+
     /**
      * Database setting <code>OPTIMIZE_DISTINCT</code> (default: true).<br />
      * Improve the performance of simple DISTINCT queries if an index is
@@ -190,6 +263,17 @@ public class DbSettings extends SettingsBase {
     public final boolean optimizeInsertFromSelect = get(
             "OPTIMIZE_INSERT_FROM_SELECT", true);
 
+    /**
+     * Database setting <code>OPTIMIZE_HASH_JOIN</code> (default: false).<br />
+     * Allow the optimizer to use a hash join for a joined table that has
+     * equality join conditions but no usable index on them. The rows of such
+     * table are read once per query into a hash table and then looked up for
+     * each row of the outer tables. If the table has more rows than
+     * MAX_MEMORY_ROWS, they are written to a temporary file ordered by the
+     * join columns. Setting this to "true" is experimental.
+     */
+    public final boolean optimizeHashJoin = get("OPTIMIZE_HASH_JOIN", false);
+
     /**
      * Database setting <code>OPTIMIZE_IN_LIST</code> (default: true).<br />
      * Optimize IN(...) and IN(SELECT ...) comparisons. This includes
@@ -230,6 +314,33 @@ public class DbSettings extends SettingsBase {
      */
     public final int queryCacheSize = get("QUERY_CACHE_SIZE", 8);
 
+    /**
+     * Database setting <code>QUERY_MEMORY_POOL</code> (default: 0).<br />
+     * The maximum estimated size in KB of rows that results of all sessions
+     * keep in memory. The memory of a result is released when its rows are
+     * written to disk or when it is closed. If this size is exceeded, further
+     * results write their rows to temporary files until the memory is
+     * released. The default is 0, meaning no limit.
+     */
+    public final int queryMemoryPool = get("QUERY_MEMORY_POOL", 0);
+
+    /**
+     * Database setting <code>READ_AHEAD</code> (default: 0).<br />
+     * The number of leaf pages that are read asynchronously in advance when
+     * rows of a table or an index are read sequentially. The default is 0,
+     * meaning the read-ahead is disabled.
+     */
+    public final int readAhead = get("READ_AHEAD", 0);
+
+    /**
+     * Database setting <code>REBUILD_INDEX_PARALLELISM</code> (default: 1).<br />
+     * The maximum number of threads used to rebuild an index when the
+     * database is opened. Indexes created with CREATE INDEX use the PARALLELISM
+     * setting of the session instead.<br />
+     * This setting only affects MVStore engine.
+     */
+    public final int rebuildIndexParallelism = get("REBUILD_INDEX_PARALLELISM", 1);
+
     /**
      * Database setting <code>RECOMPILE_ALWAYS</code> (default: false).<br />
      * Always recompile prepared statements.
@@ -244,6 +355,34 @@ public class DbSettings extends SettingsBase {
      */
     public final boolean reuseSpace = get("REUSE_SPACE", true);
 
+    /**
+     * Database setting <code>SERIALIZATION_THREADS</code> (default: 1).<br />
+     * The number of threads that serialize and compress changed pages when
+     * the MVStore stores a chunk. Pages are serialized in parallel only if
+     * there are enough of them. The default is 1, meaning all pages are
+     * serialized by the thread that stores the chunk.
+     */
+    public final int serializationThreads = get("SERIALIZATION_THREADS", 1);
+
+    /**
+     * Database setting <code>SHARED_QUERY_CACHE_SIZE</code> (default: 0).<br />
+     * The maximum number of prepared queries in the cache shared by all
+     * sessions. Queries are moved to this cache when they are evicted from the
+     * query cache of a session or when the session is closed, and other
+     * sessions use them instead of parsing the same statement again. Only
+     * queries on regular tables are shared. If the value is 0 or
+     * <code>QUERY_CACHE_SIZE</code> is 0, the shared cache is disabled.
+     */
+    public final int sharedQueryCacheSize = get("SHARED_QUERY_CACHE_SIZE", 0);
+
+    /**
+     * Database setting <code>SLOW_QUERY_TIME</code> (default: 100).<br />
+     * When query statistics are enabled, statements that take at least this
+     * number of milliseconds are listed with their execution plan in
+     * INFORMATION_SCHEMA.SLOW_QUERIES.
+     */
+    public final int slowQueryTime = get("SLOW_QUERY_TIME", 100);
+
     /**
      * Database setting <code>SHARE_LINKED_CONNECTIONS</code>
      * (default: true).<br />
@@ -5,6 +5,7 @@
  */
 package org.h2.engine;
 
+import java.util.ArrayDeque;
 import java.util.ArrayList;
 import java.util.Comparator;
 import java.util.HashMap;
@@ -23,6 +24,8 @@ public class QueryStatisticsData {
 
     private final HashMap<String, QueryEntry> map = new HashMap<>();
 
+    private final ArrayDeque<SlowQueryEntry> slowQueries = new ArrayDeque<>();
+
     private int maxQueryEntries;
 
     public QueryStatisticsData(int maxQueryEntries) {
@@ -31,6 +34,9 @@ public QueryStatisticsData(int maxQueryEntries) {
 
     public synchronized void setMaxQueryEntries(int maxQueryEntries) {
         this.maxQueryEntries = maxQueryEntries;
+        while (slowQueries.size() > maxQueryEntries) {
+            slowQueries.removeFirst();
+        }
     }
 
     public synchronized List<QueryEntry> getQueries() {
@@ -42,6 +48,34 @@ public synchronized List<QueryEntry> getQueries() {
         return list.subList(0, Math.min(list.size(), maxQueryEntries));
     }
 
+    /**
+     * Get the most recent slow statements, the oldest first.
+     *
+     * @return the list of slow statements
+     */
+    public synchronized List<SlowQueryEntry> getSlowQueries() {
+        return new ArrayList<>(slowQueries);
+    }
+
+    /**
+     * Add a slow statement. Only the newest entries are kept.
+     *
+     * @param sessionId the id of the session
+     * @param sqlStatement the statement that was executed
+     * @param executionTimeNanos the time in nanoseconds the query/update took
+     *            to execute
+     * @param rowCount the query or update row count
+     * @param plan the execution plan with statistics of operators, or
+     *            {@code null}
+     */
+    public synchronized void addSlowQuery(int sessionId, String sqlStatement, long executionTimeNanos,
+            long rowCount, String plan) {
+        slowQueries.addLast(new SlowQueryEntry(sessionId, sqlStatement, executionTimeNanos, rowCount, plan));
+        while (slowQueries.size() > maxQueryEntries) {
+            slowQueries.removeFirst();
+        }
+    }
+
     /**
      * Update query statistics.
      *
@@ -79,6 +113,46 @@ public synchronized void update(String sqlStatement, long executionTimeNanos, lo
         }
     }
 
+    /**
+     * A single execution of a slow statement.
+     */
+    public static final class SlowQueryEntry {
+
+        /**
+         * The id of the session.
+         */
+        public final int sessionId;
+
+        /**
+         * The SQL statement.
+         */
+        public final String sqlStatement;
+
+        /**
+         * The execution time, in nanoseconds.
+         */
+        public final long executionTimeNanos;
+
+        /**
+         * The number of rows.
+         */
+        public final long rowCount;
+
+        /**
+         * The execution plan with statistics of operators, or {@code null}.
+         */
+        public final String plan;
+
+        SlowQueryEntry(int sessionId, String sqlStatement, long executionTimeNanos, long rowCount, String plan) {
+            this.sessionId = sessionId;
+            this.sqlStatement = sqlStatement;
+            this.executionTimeNanos = executionTimeNanos;
+            this.rowCount = rowCount;
+            this.plan = plan;
+        }
+
+    }
+
     /**
      * The collected statistics for one query.
      */
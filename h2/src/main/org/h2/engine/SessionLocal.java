@@ -207,6 +207,30 @@ private static final class RowNumberAndValue {
     private final AtomicReference<State> state = new AtomicReference<>(State.INIT);
     private long startStatement = -1;
 
+    /**
+     * The estimated size in bytes of rows that results of this session keep
+     * in memory.
+     */
+    private long queryMemory;
+
+    /**
+     * Whether queries are profiled: {@code TRUE} in EXPLAIN ANALYZE VERBOSE,
+     * {@code FALSE} in plain EXPLAIN ANALYZE, and {@code null} to follow the
+     * query statistics setting of the database.
+     */
+    private Boolean queryProfiling;
+
+    /**
+     * The number of rows of results written to temporary files.
+     */
+    private long spilledRows;
+
+    /**
+     * The estimated size in bytes of rows of results written to temporary
+     * files.
+     */
+    private long spilledBytes;
+
     /**
      * Isolation level.
      */
@@ -236,6 +260,11 @@ private static final class RowNumberAndValue {
      */
     private boolean variableBinary;
 
+    /**
+     * The maximum number of threads used to execute a query.
+     */
+    private int parallelism = 1;
+
     /**
      * Whether INFORMATION_SCHEMA contains old-style tables.
      */
@@ -608,6 +637,16 @@ public Command prepareLocal(String sql) {
                     return command;
                 }
             }
+            SharedQueryCache sharedCache = database.getSharedQueryCache();
+            if (sharedCache != null) {
+                command = sharedCache.take(new SharedQueryCache.Key(this, sql));
+                if (command != null) {
+                    command.setSession(this);
+                    command.reuse();
+                    addToQueryCache(sql, command);
+                    return command;
+                }
+            }
         }
         Parser parser = new Parser(this);
         try {
@@ -618,12 +657,32 @@ public Command prepareLocal(String sql) {
         }
         if (queryCache != null) {
             if (command.isCacheable()) {
-                queryCache.put(sql, command);
+                addToQueryCache(sql, command);
             }
         }
         return command;
     }
 
+    private void addToQueryCache(String sql, Command command) {
+        SharedQueryCache sharedCache = database.getSharedQueryCache();
+        if (sharedCache != null && queryCache.size() >= queryCacheSize && !queryCache.containsKey(sql)) {
+            // move the least recently used command to the shared cache
+            Iterator<Map.Entry<String, Command>> it = queryCache.entrySet().iterator();
+            Map.Entry<String, Command> eldest = it.next();
+            it.remove();
+            moveToSharedQueryCache(sharedCache, eldest.getKey(), eldest.getValue());
+        }
+        queryCache.put(sql, command);
+    }
+
+    private void moveToSharedQueryCache(SharedQueryCache sharedCache, String sql, Command command) {
+        if (command.canReuse() && command.isShareable()) {
+            // detach the command and discard its cached result
+            command.setSession(null);
+            sharedCache.add(new SharedQueryCache.Key(this, sql), command, modificationMetaID);
+        }
+    }
+
     /**
      * Arranges for the specified database object id to be released
      * at the end of the current transaction.
@@ -651,6 +710,7 @@ public void commit(boolean ddl) {
         beforeCommitOrRollback();
         if (hasTransaction()) {
             try {
+                endBulkLoads(true);
                 markUsedTablesAsUpdated();
                 transaction.commit();
                 removeTemporaryLobs(true);
@@ -671,6 +731,21 @@ public void commit(boolean ddl) {
         }
     }
 
+    /**
+     * Make the rows added in bulk by this session visible, or discard them.
+     *
+     * @param commit whether the transaction is committed
+     */
+    private void endBulkLoads(boolean commit) {
+        if (!locks.isEmpty()) {
+            for (Table t : locks) {
+                if (t instanceof MVTable) {
+                    ((MVTable) t).endBulkLoad(this, commit);
+                }
+            }
+        }
+    }
+
     private void markUsedTablesAsUpdated() {
         // TODO should not rely on locking
         if (!locks.isEmpty()) {
@@ -789,6 +864,8 @@ public void rollback() {
     public void rollbackTo(Savepoint savepoint) {
         int index = savepoint == null ? 0 : savepoint.logIndex;
         if (hasTransaction()) {
+            // rows are added in bulk only by the last statement
+            endBulkLoads(false);
             markUsedTablesAsUpdated();
             if (savepoint == null) {
                 transaction.rollback();
@@ -857,6 +934,14 @@ public void close() {
         // so, we should prevent double-closure
         if (state.getAndSet(State.CLOSED) != State.CLOSED) {
             try {
+                SharedQueryCache sharedCache = database.getSharedQueryCache();
+                if (sharedCache != null && queryCache != null
+                        && modificationMetaID == database.getModificationMetaId()) {
+                    for (Map.Entry<String, Command> e : queryCache.entrySet()) {
+                        moveToSharedQueryCache(sharedCache, e.getKey(), e.getValue());
+                    }
+                    queryCache = null;
+                }
                 database.throwLastBackgroundException();
 
                 database.checkPowerOff();
@@ -879,6 +964,7 @@ public void close() {
                 // want to take the meta lock using the system session.
                 database.unlockMeta(this);
             } finally {
+                releaseQueryMemory(queryMemory);
                 database.removeSession(this);
             }
         }
@@ -1270,10 +1356,18 @@ public void setAllowLiterals(boolean b) {
 
     public void setCurrentSchema(Schema schema) {
         modificationId++;
+        clearQueryCache();
+        this.currentSchemaName = schema.getName();
+    }
+
+    /**
+     * Remove all commands from the query cache of this session. This method
+     * is called when a setting that affects parsing of statements is changed.
+     */
+    private void clearQueryCache() {
         if (queryCache != null) {
             queryCache.clear();
         }
-        this.currentSchemaName = schema.getName();
     }
 
     @Override
@@ -1388,6 +1482,7 @@ public Procedure getProcedure(String name) {
 
     public void setSchemaSearchPath(String[] schemas) {
         modificationId++;
+        clearQueryCache();
         this.schemaSearchPath = schemas;
     }
 
@@ -1717,6 +1812,117 @@ public void endStatement() {
         closeTemporaryResults();
     }
 
+    /**
+     * Reserve memory for rows that a result keeps in memory. The reserved
+     * memory is also accounted in the memory pool of the database.
+     *
+     * @param bytes
+     *            the estimated size in bytes
+     * @return {@code true} if the memory pool of the database still has enough
+     *         memory, {@code false} if the rows should be written to disk
+     */
+    public boolean reserveQueryMemory(long bytes) {
+        queryMemory += bytes;
+        return database.reserveQueryMemory(bytes);
+    }
+
+    /**
+     * Release memory reserved with {@link #reserveQueryMemory(long)}. Each
+     * result releases its own reservation when its rows are written to disk or
+     * when it is closed. Memory that is still reserved when the session is
+     * closed is released automatically.
+     *
+     * @param bytes
+     *            the estimated size in bytes
+     */
+    public void releaseQueryMemory(long bytes) {
+        bytes = Math.min(bytes, queryMemory);
+        if (bytes > 0) {
+            queryMemory -= bytes;
+            database.releaseQueryMemory(bytes);
+        }
+    }
+
+    /**
+     * Returns the estimated size of rows that results of this session keep in
+     * memory.
+     *
+     * @return the size in bytes
+     */
+    public long getQueryMemory() {
+        return queryMemory;
+    }
+
+    /**
+     * Enable or disable profiling of queries regardless of the query
+     * statistics setting of the database.
+     *
+     * @param queryProfiling
+     *            {@code TRUE} to profile queries including the time of each
+     *            table filter, {@code FALSE} to disable profiling, or
+     *            {@code null} to profile queries only when query statistics
+     *            are enabled
+     */
+    public void setQueryProfiling(Boolean queryProfiling) {
+        this.queryProfiling = queryProfiling;
+    }
+
+    /**
+     * Returns whether table filters and queries should collect the number of
+     * rows and the elapsed time of their operations. This is the case in
+     * EXPLAIN ANALYZE VERBOSE, and when query statistics are enabled.
+     *
+     * @return whether queries should be profiled
+     */
+    public boolean isQueryProfiling() {
+        Boolean profiling = queryProfiling;
+        return profiling != null ? profiling : database.getQueryStatistics();
+    }
+
+    /**
+     * Returns whether table filters should measure the time spent reading
+     * each row. This is only done in EXPLAIN ANALYZE VERBOSE, because it is
+     * too expensive for all statements.
+     *
+     * @return whether the time of table filters should be measured
+     */
+    public boolean isQueryTimeProfiling() {
+        return queryProfiling == Boolean.TRUE;
+    }
+
+    /**
+     * Account rows of a result written to a temporary file.
+     *
+     * @param rows
+     *            the number of rows
+     * @param bytes
+     *            the estimated size of rows in bytes
+     */
+    public void addSpilledRows(long rows, long bytes) {
+        spilledRows += rows;
+        spilledBytes += bytes;
+    }
+
+    /**
+     * Returns the number of rows of results written to temporary files by
+     * this session.
+     *
+     * @return the number of rows
+     */
+    public long getSpilledRows() {
+        return spilledRows;
+    }
+
+    /**
+     * Returns the estimated size of rows of results written to temporary files
+     * by this session.
+     *
+     * @return the size in bytes
+     */
+    public long getSpilledBytes() {
+        return spilledBytes;
+    }
+
     /**
      * Clear the view cache for this session.
      */
@@ -1906,6 +2112,7 @@ public BitSet getNonKeywords() {
      * @param nonKeywords set of non-keywords, or {@code null}
      */
     public void setNonKeywords(BitSet nonKeywords) {
+        clearQueryCache();
         this.nonKeywords = nonKeywords;
     }
 
@@ -1938,6 +2145,7 @@ public TimeZoneProvider currentTimeZone() {
     public void setTimeZone(TimeZoneProvider timeZone) {
         if (!timeZone.equals(this.timeZone)) {
             this.timeZone = timeZone;
+            clearQueryCache();
             ValueTimestampTimeZone ts = currentTimestamp;
             if (ts != null) {
                 long dateValue = ts.getDateValue();
@@ -2012,6 +2220,7 @@ public int compareTypeSafe(Value a, Value b) {
      *            throw an exception
      */
     public void setTruncateLargeLength(boolean truncateLargeLength) {
+        clearQueryCache();
         this.truncateLargeLength = truncateLargeLength;
     }
 
@@ -2025,6 +2234,26 @@ public boolean isTruncateLargeLength() {
         return truncateLargeLength;
     }
 
+    /**
+     * Changes the maximum number of threads used to execute a query.
+     *
+     * @param parallelism
+     *            the number of threads, {@code 1} to execute queries in the
+     *            session thread only
+     */
+    public void setParallelism(int parallelism) {
+        this.parallelism = parallelism;
+    }
+
+    /**
+     * Returns the maximum number of threads used to execute a query.
+     *
+     * @return the number of threads
+     */
+    public int getParallelism() {
+        return parallelism;
+    }
+
     /**
      * Changes parsing of a BINARY data type.
      *
@@ -2033,6 +2262,7 @@ public boolean isTruncateLargeLength() {
      *            parse it as is
      */
     public void setVariableBinary(boolean variableBinary) {
+        clearQueryCache();
         this.variableBinary = variableBinary;
     }
 
@@ -2054,6 +2284,7 @@ public boolean isVariableBinary() {
      *            {@code false} to have modern tables
      */
     public void setOldInformationSchema(boolean oldInformationSchema) {
+        clearQueryCache();
         this.oldInformationSchema = oldInformationSchema;
     }
 
@@ -2079,6 +2310,7 @@ public boolean zeroBasedEnums() {
      *            whether quirks mode should be enabled
      */
     public void setQuirksMode(boolean quirksMode) {
+        clearQueryCache();
         this.quirksMode = quirksMode;
     }
 
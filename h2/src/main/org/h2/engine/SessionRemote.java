@@ -73,6 +73,7 @@ public final class SessionRemote extends Session implements DataHandler {
     public static final int LOB_READ = 17;
     public static final int SESSION_PREPARE_READ_PARAMS2 = 18;
     public static final int GET_JDBC_META = 19;
+    public static final int COMMAND_EXECUTE_BATCH_UPDATE = 20;
 
     public static final int STATUS_ERROR = 0;
     public static final int STATUS_OK = 1;
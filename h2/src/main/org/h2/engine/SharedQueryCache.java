@@ -0,0 +1,221 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.engine;
+
+import java.util.ArrayDeque;
+import java.util.Arrays;
+import java.util.BitSet;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Objects;
+
+import org.h2.command.Command;
+import org.h2.util.TimeZoneProvider;
+
+/**
+ * A cache of prepared queries shared by all sessions of a database. Each
+ * session keeps its own cache of commands; commands that are evicted from the
+ * cache of a session, or that are cached by a closed session, are moved to
+ * this cache, so that other sessions can use them instead of parsing and
+ * optimizing the same statement again.
+ * <p>
+ * A command is used by one session at a time: it is removed from this cache
+ * when a session takes it. All commands are removed if the database schema
+ * is modified.
+ */
+public final class SharedQueryCache {
+
+    private final Database database;
+
+    private final int maxSize;
+
+    /**
+     * The idle commands for each key, in the order they were added. The
+     * iteration order of the map is the access order.
+     */
+    private final LinkedHashMap<Key, ArrayDeque<Command>> map = new LinkedHashMap<>(16, 0.75f, true);
+
+    private int size;
+
+    private long modificationMetaId;
+
+    private long hits;
+
+    private long misses;
+
+    /**
+     * Create a new cache.
+     *
+     * @param database the database
+     * @param maxSize the maximum number of cached commands
+     */
+    SharedQueryCache(Database database, int maxSize) {
+        this.database = database;
+        this.maxSize = maxSize;
+        modificationMetaId = database.getModificationMetaId();
+    }
+
+    /**
+     * Take a command from the cache.
+     *
+     * @param key the key
+     * @return the command, or {@code null} if there is no cached command for
+     *         this key
+     */
+    synchronized Command take(Key key) {
+        checkModification();
+        ArrayDeque<Command> commands = map.get(key);
+        if (commands != null) {
+            Command command = commands.pollLast();
+            if (commands.isEmpty()) {
+                map.remove(key);
+            }
+            size--;
+            hits++;
+            return command;
+        }
+        misses++;
+        return null;
+    }
+
+    /**
+     * Add a command that is not used by its session any more. If the cache
+     * is full, the least recently used commands are removed.
+     *
+     * @param key the key
+     * @param command the command
+     * @param commandModificationMetaId the modification id of the database
+     *            meta data when the command was prepared
+     */
+    synchronized void add(Key key, Command command, long commandModificationMetaId) {
+        checkModification();
+        if (commandModificationMetaId != modificationMetaId) {
+            return;
+        }
+        map.computeIfAbsent(key, k -> new ArrayDeque<>()).addLast(command);
+        size++;
+        for (Iterator<ArrayDeque<Command>> it = map.values().iterator(); size > maxSize;) {
+            ArrayDeque<Command> commands = it.next();
+            commands.pollFirst();
+            size--;
+            if (commands.isEmpty()) {
+                it.remove();
+            }
+        }
+    }
+
+    private void checkModification() {
+        long id = database.getModificationMetaId();
+        if (id != modificationMetaId) {
+            map.clear();
+            size = 0;
+            modificationMetaId = id;
+        }
+    }
+
+    /**
+     * Remove all commands.
+     */
+    public synchronized void clear() {
+        map.clear();
+        size = 0;
+    }
+
+    /**
+     * Get the number of cached commands.
+     *
+     * @return the number of commands
+     */
+    public synchronized int getSize() {
+        return size;
+    }
+
+    /**
+     * Get the maximum number of cached commands.
+     *
+     * @return the maximum size
+     */
+    public int getMaxSize() {
+        return maxSize;
+    }
+
+    /**
+     * Get the number of times a cached command was used by a session.
+     *
+     * @return the number of hits
+     */
+    public synchronized long getHits() {
+        return hits;
+    }
+
+    /**
+     * Get the number of times no cached command was found.
+     *
+     * @return the number of misses
+     */
+    public synchronized long getMisses() {
+        return misses;
+    }
+
+    /**
+     * The key of a command: the SQL statement, and the settings of the session
+     * that affect how the statement is parsed, which objects it refers to, and
+     * how its constants are converted during optimization.
+     */
+    static final class Key {
+
+        private final String sql;
+
+        private final User user;
+
+        private final String schemaName;
+
+        private final String[] schemaSearchPath;
+
+        private final BitSet nonKeywords;
+
+        private final TimeZoneProvider timeZone;
+
+        private final int flags;
+
+        private final int hash;
+
+        Key(SessionLocal session, String sql) {
+            this.sql = sql;
+            user = session.getUser();
+            schemaName = session.getCurrentSchemaName();
+            schemaSearchPath = session.getSchemaSearchPath();
+            nonKeywords = session.getNonKeywords();
+            timeZone = session.currentTimeZone();
+            flags = (session.isTruncateLargeLength() ? 1 : 0) | (session.isVariableBinary() ? 2 : 0)
+                    | (session.isOldInformationSchema() ? 4 : 0) | (session.isQuirksMode() ? 8 : 0);
+            hash = Objects.hash(sql, user, schemaName, Arrays.hashCode(schemaSearchPath), nonKeywords, timeZone,
+                    flags);
+        }
+
+        @Override
+        public int hashCode() {
+            return hash;
+        }
+
+        @Override
+        public boolean equals(Object obj) {
+            if (obj == this) {
+                return true;
+            }
+            if (!(obj instanceof Key)) {
+                return false;
+            }
+            Key other = (Key) obj;
+            return hash == other.hash && sql.equals(other.sql) && user == other.user
+                    && schemaName.equals(other.schemaName) && Arrays.equals(schemaSearchPath, other.schemaSearchPath)
+                    && Objects.equals(nonKeywords, other.nonKeywords) && timeZone.equals(other.timeZone)
+                    && flags == other.flags;
+        }
+
+    }
+
+}
@@ -192,6 +192,15 @@ public class SysProperties {
     public static final int LOB_CLIENT_MAX_SIZE_MEMORY =
             Utils.getProperty("h2.lobClientMaxSizeMemory", 1024 * 1024);
 
+    /**
+     * System property <code>h2.lobReadBlockSize</code> (default:
+     * 1048576).<br />
+     * The maximum number of bytes of a LOB transferred in one request when
+     * using the server mode.
+     */
+    public static final int LOB_READ_BLOCK_SIZE =
+            Utils.getProperty("h2.lobReadBlockSize", 1024 * 1024);
+
     /**
      * System property <code>h2.maxFileRetry</code> (default: 16).<br />
      * Number of times to retry file delete and rename. in Windows, files can't
@@ -99,6 +99,16 @@ public int getCost() {
         return expr.getCost();
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        return expr.isBatchCapable(filter);
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        return expr.getValues(session, batch, selection);
+    }
+
     @Override
     public String getTableName() {
         if (aliasColumnName) {
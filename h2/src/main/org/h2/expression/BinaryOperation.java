@@ -9,6 +9,7 @@
 import org.h2.expression.IntervalOperation.IntervalOpType;
 import org.h2.expression.function.DateTimeFunction;
 import org.h2.message.DbException;
+import org.h2.table.TableFilter;
 import org.h2.value.DataType;
 import org.h2.value.TypeInfo;
 import org.h2.value.Value;
@@ -99,6 +100,10 @@ public Value getValue(SessionLocal session) {
         if (convertRight) {
             r = r.convertTo(type, session);
         }
+        return evaluate(l, r);
+    }
+
+    private Value evaluate(Value l, Value r) {
         switch (opType) {
         case PLUS:
             if (l == ValueNull.INSTANCE || r == ValueNull.INSTANCE) {
@@ -125,6 +130,84 @@ public Value getValue(SessionLocal session) {
         }
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        return LongVector.isInteger(type) && LongVector.isInteger(left.getType())
+                && LongVector.isInteger(right.getType()) && left.isBatchCapable(filter)
+                && right.isBatchCapable(filter);
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        int size = batch.size();
+        LongVector l = left.getValues(session, batch, selection);
+        LongVector r = right.getValues(session, batch, selection);
+        LongVector result = new LongVector(size);
+        long[] values = result.values;
+        boolean[] nulls = result.nulls;
+        int valueType = type.getValueType();
+        long min, max;
+        switch (valueType) {
+        case Value.TINYINT:
+            min = Byte.MIN_VALUE;
+            max = Byte.MAX_VALUE;
+            break;
+        case Value.SMALLINT:
+            min = Short.MIN_VALUE;
+            max = Short.MAX_VALUE;
+            break;
+        case Value.INTEGER:
+            min = Integer.MIN_VALUE;
+            max = Integer.MAX_VALUE;
+            break;
+        default:
+            min = Long.MIN_VALUE;
+            max = Long.MAX_VALUE;
+        }
+        boolean isBigint = valueType == Value.BIGINT;
+        for (int i = 0; i < size; i++) {
+            if (!LongVector.isSelected(selection, i)) {
+                continue;
+            }
+            if (l.nulls[i] || r.nulls[i]) {
+                nulls[i] = true;
+                continue;
+            }
+            long a = l.values[i], b = r.values[i], v;
+            try {
+                switch (opType) {
+                case PLUS:
+                    v = isBigint ? Math.addExact(a, b) : a + b;
+                    break;
+                case MINUS:
+                    v = isBigint ? Math.subtractExact(a, b) : a - b;
+                    break;
+                case MULTIPLY:
+                    v = isBigint ? Math.multiplyExact(a, b) : a * b;
+                    break;
+                case DIVIDE:
+                    if (b == 0L || isBigint && a == Long.MIN_VALUE && b == -1L) {
+                        throw new ArithmeticException();
+                    }
+                    v = a / b;
+                    break;
+                default:
+                    throw DbException.getInternalError("type=" + opType);
+                }
+                if (v < min || v > max) {
+                    throw new ArithmeticException();
+                }
+            } catch (ArithmeticException e) {
+                // let the scalar operation throw the same exception
+                v = evaluate(LongVector.getValue(a, left.getType().getValueType()).convertTo(type, session),
+                        LongVector.getValue(b, right.getType().getValueType()).convertTo(type, session))
+                        .getLong();
+            }
+            values[i] = v;
+        }
+        return result;
+    }
+
     @Override
     public Expression optimize(SessionLocal session) {
         left = left.optimize(session);
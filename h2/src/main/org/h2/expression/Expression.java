@@ -491,6 +491,41 @@ public Expression getSubexpression(int index) {
         throw new IndexOutOfBoundsException();
     }
 
+    /**
+     * Returns whether this expression can be evaluated for batches of rows of
+     * the specified table filter with
+     * {@link #getValues(SessionLocal, RowBatch, boolean[])}. Only expressions of
+     * BOOLEAN and integer data types may be evaluated this way.
+     *
+     * @param filter
+     *            the only table filter of the query
+     * @return whether batch evaluation is supported
+     * @see LongVector#isSupported(TypeInfo)
+     */
+    public boolean isBatchCapable(TableFilter filter) {
+        return false;
+    }
+
+    /**
+     * Evaluates this expression for the selected rows of a batch. Values for
+     * rows that aren't selected are undefined. Rows are selected in the same
+     * way as they would be evaluated by {@link #getValue(SessionLocal)}, so
+     * for example the right side of an AND condition is evaluated only for
+     * rows where the left side is not FALSE.
+     *
+     * @param session
+     *            the session
+     * @param batch
+     *            the batch of rows
+     * @param selection
+     *            the selected rows, or {@code null} if all rows are selected
+     * @return the values, the returned vector must not be modified
+     * @see #isBatchCapable(TableFilter)
+     */
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        throw DbException.getInternalError(getTraceSQL());
+    }
+
     /**
      * Return the resulting value of when operand for the current row.
      *
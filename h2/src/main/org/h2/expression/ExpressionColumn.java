@@ -424,6 +424,16 @@ public int getCost() {
         return 2;
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        return columnResolver == filter && column.getColumnId() >= 0 && LongVector.isSupported(column.getType());
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        return batch.getColumn(column);
+    }
+
     @Override
     public void createIndexConditions(SessionLocal session, TableFilter filter) {
         TableFilter tf = getTableFilter();
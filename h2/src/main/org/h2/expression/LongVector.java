@@ -0,0 +1,155 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.expression;
+
+import org.h2.message.DbException;
+import org.h2.value.TypeInfo;
+import org.h2.value.Value;
+import org.h2.value.ValueBigint;
+import org.h2.value.ValueBoolean;
+import org.h2.value.ValueInteger;
+import org.h2.value.ValueNull;
+import org.h2.value.ValueSmallint;
+import org.h2.value.ValueTinyint;
+
+/**
+ * Values of an expression for a batch of rows. Values of BOOLEAN data type are
+ * represented as {@code 1} and {@code 0}, values of integer data types are
+ * stored as is.
+ *
+ * @see Expression#getValues(org.h2.engine.SessionLocal, RowBatch, boolean[])
+ */
+public final class LongVector {
+
+    /**
+     * The values, undefined for NULL values.
+     */
+    public final long[] values;
+
+    /**
+     * Whether the value is NULL.
+     */
+    public final boolean[] nulls;
+
+    /**
+     * Creates a new vector.
+     *
+     * @param capacity
+     *            the number of values
+     */
+    public LongVector(int capacity) {
+        values = new long[capacity];
+        nulls = new boolean[capacity];
+    }
+
+    /**
+     * Returns whether the value at the specified index is TRUE.
+     *
+     * @param index
+     *            the index
+     * @return whether the value is TRUE
+     */
+    public boolean isTrue(int index) {
+        return !nulls[index] && values[index] != 0L;
+    }
+
+    /**
+     * Returns whether the value at the specified index is FALSE.
+     *
+     * @param index
+     *            the index
+     * @return whether the value is FALSE
+     */
+    public boolean isFalse(int index) {
+        return !nulls[index] && values[index] == 0L;
+    }
+
+    /**
+     * Returns the value at the specified index.
+     *
+     * @param index
+     *            the index
+     * @param valueType
+     *            the data type of the value
+     * @return the value
+     */
+    public Value getValue(int index, int valueType) {
+        return nulls[index] ? ValueNull.INSTANCE : getValue(values[index], valueType);
+    }
+
+    /**
+     * Converts the primitive representation to a value.
+     *
+     * @param v
+     *            the primitive representation
+     * @param valueType
+     *            the data type of the value
+     * @return the value
+     */
+    public static Value getValue(long v, int valueType) {
+        switch (valueType) {
+        case Value.BOOLEAN:
+            return ValueBoolean.get(v != 0L);
+        case Value.TINYINT:
+            return ValueTinyint.get((byte) v);
+        case Value.SMALLINT:
+            return ValueSmallint.get((short) v);
+        case Value.INTEGER:
+            return ValueInteger.get((int) v);
+        case Value.BIGINT:
+            return ValueBigint.get(v);
+        default:
+            throw DbException.getInternalError("type=" + valueType);
+        }
+    }
+
+    /**
+     * Returns whether values of the specified data type can be stored in a
+     * vector.
+     *
+     * @param type
+     *            the data type
+     * @return whether the data type is supported
+     */
+    public static boolean isSupported(TypeInfo type) {
+        switch (type.getValueType()) {
+        case Value.BOOLEAN:
+        case Value.TINYINT:
+        case Value.SMALLINT:
+        case Value.INTEGER:
+        case Value.BIGINT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Returns whether the specified data type is supported and it is an
+     * integer data type.
+     *
+     * @param type
+     *            the data type
+     * @return whether the data type is a supported integer data type
+     */
+    public static boolean isInteger(TypeInfo type) {
+        return type.getValueType() != Value.BOOLEAN && isSupported(type);
+    }
+
+    /**
+     * Returns whether a row is selected.
+     *
+     * @param selection
+     *            the selected rows, or {@code null} if all rows are selected
+     * @param index
+     *            the index of the row
+     * @return whether the row is selected
+     */
+    public static boolean isSelected(boolean[] selection, int index) {
+        return selection == null || selection[index];
+    }
+
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.expression;
+
+import java.util.Arrays;
+
+import org.h2.result.Row;
+import org.h2.table.Column;
+import org.h2.value.Value;
+import org.h2.value.ValueNull;
+
+/**
+ * A batch of rows of a table filter for evaluation of expressions with
+ * {@link Expression#getValues(org.h2.engine.SessionLocal, RowBatch, boolean[])}.
+ * Values of columns are extracted into vectors on first access and are cached
+ * until the batch is cleared.
+ */
+public final class RowBatch {
+
+    /**
+     * The default number of rows in a batch.
+     */
+    public static final int DEFAULT_CAPACITY = 1024;
+
+    private final Row[] rows;
+
+    private int size;
+
+    private final LongVector[] columns;
+
+    private final boolean[] loaded;
+
+    /**
+     * Creates a new batch.
+     *
+     * @param columnCount
+     *            the number of columns in the table
+     * @param capacity
+     *            the maximum number of rows
+     */
+    public RowBatch(int columnCount, int capacity) {
+        rows = new Row[capacity];
+        columns = new LongVector[columnCount];
+        loaded = new boolean[columnCount];
+    }
+
+    /**
+     * Adds a row to this batch.
+     *
+     * @param row
+     *            the row
+     * @return whether more rows can be added
+     */
+    public boolean add(Row row) {
+        rows[size++] = row;
+        return size < rows.length;
+    }
+
+    /**
+     * Returns the number of rows.
+     *
+     * @return the number of rows
+     */
+    public int size() {
+        return size;
+    }
+
+    /**
+     * Returns the specified row.
+     *
+     * @param index
+     *            the index of the row
+     * @return the row
+     */
+    public Row getRow(int index) {
+        return rows[index];
+    }
+
+    /**
+     * Removes all rows from this batch.
+     */
+    public void clear() {
+        Arrays.fill(rows, 0, size, null);
+        Arrays.fill(loaded, false);
+        size = 0;
+    }
+
+    /**
+     * Returns values of the specified column. The returned vector must not be
+     * modified.
+     *
+     * @param column
+     *            the column of BOOLEAN or integer data type
+     * @return the values
+     */
+    public LongVector getColumn(Column column) {
+        int columnId = column.getColumnId();
+        LongVector vector = columns[columnId];
+        if (!loaded[columnId]) {
+            if (vector == null) {
+                columns[columnId] = vector = new LongVector(rows.length);
+            }
+            long[] values = vector.values;
+            boolean[] nulls = vector.nulls;
+            boolean isBoolean = column.getType().getValueType() == Value.BOOLEAN;
+            for (int i = 0; i < size; i++) {
+                Row row = rows[i];
+                Value v = row.getValue(columnId);
+                if (v == ValueNull.INSTANCE) {
+                    nulls[i] = true;
+                } else {
+                    nulls[i] = false;
+                    // the value of the main index column may be stored only
+                    // as the key of the row
+                    values[i] = v == null ? row.getKey() : isBoolean ? v.getBoolean() ? 1L : 0L : v.getLong();
+                }
+            }
+            loaded[columnId] = true;
+        }
+        return vector;
+    }
+
+}
@@ -5,6 +5,8 @@
  */
 package org.h2.expression;
 
+import java.util.Arrays;
+
 import org.h2.engine.SessionLocal;
 import org.h2.expression.condition.Comparison;
 import org.h2.index.IndexCondition;
@@ -165,4 +167,24 @@ public int getCost() {
         return 0;
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        TypeInfo type = getType();
+        return LongVector.isSupported(type)
+                && (value == ValueNull.INSTANCE || value.getValueType() == type.getValueType());
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        int size = batch.size();
+        LongVector vector = new LongVector(size);
+        if (value == ValueNull.INSTANCE) {
+            Arrays.fill(vector.nulls, true);
+        } else {
+            Arrays.fill(vector.values, value.getValueType() == Value.BOOLEAN ? value.getBoolean() ? 1L : 0L
+                    : value.getLong());
+        }
+        return vector;
+    }
+
 }
@@ -19,6 +19,7 @@
 import org.h2.api.ErrorCode;
 import org.h2.command.query.QueryOrderBy;
 import org.h2.command.query.Select;
+import org.h2.command.query.SelectGroups;
 import org.h2.engine.Constants;
 import org.h2.engine.Database;
 import org.h2.engine.SessionLocal;
@@ -26,6 +27,8 @@
 import org.h2.expression.ExpressionColumn;
 import org.h2.expression.ExpressionVisitor;
 import org.h2.expression.ExpressionWithFlags;
+import org.h2.expression.LongVector;
+import org.h2.expression.RowBatch;
 import org.h2.expression.ValueExpression;
 import org.h2.expression.aggregate.AggregateDataCollecting.NullCollectionMode;
 import org.h2.expression.analysis.Window;
@@ -242,6 +245,177 @@ public int getFlags() {
         return flags;
     }
 
+    /**
+     * Returns whether partial results of this aggregate computed over disjoint
+     * sets of rows can be merged without changing the result. This is
+     * possible only for aggregates without DISTINCT, FILTER, WITHIN GROUP, and
+     * OVER clauses.
+     *
+     * @return whether partial results can be merged
+     * @see #createPartialData()
+     */
+    public boolean isMergeable() {
+        return over == null && filterCondition == null && orderByList == null && !distinct
+                && aggregateType != AggregateType.HISTOGRAM;
+    }
+
+    /**
+     * Creates a new partial result of this aggregate. Partial results may be
+     * updated concurrently by different threads, but each partial result must
+     * be used by only one thread.
+     *
+     * @return the new partial result
+     * @see #isMergeable()
+     */
+    public Object createPartialData() {
+        return createAggregateData();
+    }
+
+    /**
+     * Adds a row to the partial result.
+     *
+     * @param session
+     *            the session
+     * @param partialData
+     *            the partial result
+     * @param arguments
+     *            the values of arguments of this aggregate for the row
+     */
+    public void updatePartialData(SessionLocal session, Object partialData, Value[] arguments) {
+        updateData(session, (AggregateData) partialData, arguments.length == 0 ? null : arguments[0], arguments);
+    }
+
+    /**
+     * Merges the partial result into the data of the current group.
+     *
+     * @param session
+     *            the session
+     * @param groupData
+     *            the group data
+     * @param partialData
+     *            the partial result, must not be used after invocation of
+     *            this method
+     */
+    public void mergePartialData(SessionLocal session, SelectGroups groupData, Object partialData) {
+        Object data = getGroupData(groupData, true);
+        if (data == null) {
+            groupData.setCurrentGroupExprData(this, partialData);
+        } else {
+            ((AggregateData) data).merge(session, (AggregateData) partialData);
+        }
+    }
+
+    /**
+     * Returns whether this aggregate can be updated with a batch of rows of
+     * the specified table filter.
+     *
+     * @param filter
+     *            the table filter
+     * @return whether {@link #updateBatch(SessionLocal, SelectGroups, RowBatch, boolean[])}
+     *         can be used
+     */
+    public boolean isBatchUpdatable(TableFilter filter) {
+        if (over != null || filterCondition != null || orderByList != null || distinct) {
+            return false;
+        }
+        switch (aggregateType) {
+        case COUNT_ALL:
+            return true;
+        case COUNT:
+        case MIN:
+        case MAX:
+            return args[0].isBatchCapable(filter);
+        case SUM:
+            return LongVector.isInteger(args[0].getType()) && args[0].isBatchCapable(filter);
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Updates the data of the current group with the selected rows of the
+     * batch.
+     *
+     * @param session
+     *            the session
+     * @param groupData
+     *            the group data
+     * @param batch
+     *            the batch of rows
+     * @param selection
+     *            the selected rows, or {@code null} if all rows are selected
+     * @see #isBatchUpdatable(TableFilter)
+     */
+    public void updateBatch(SessionLocal session, SelectGroups groupData, RowBatch batch, boolean[] selection) {
+        AggregateData data = (AggregateData) getGroupData(groupData, false);
+        int size = batch.size();
+        if (aggregateType == AggregateType.COUNT_ALL) {
+            long count = 0L;
+            for (int i = 0; i < size; i++) {
+                if (LongVector.isSelected(selection, i)) {
+                    count++;
+                }
+            }
+            ((AggregateDataCount) data).addCount(count);
+            return;
+        }
+        LongVector vector = args[0].getValues(session, batch, selection);
+        long[] values = vector.values;
+        boolean[] nulls = vector.nulls;
+        switch (aggregateType) {
+        case COUNT: {
+            long count = 0L;
+            for (int i = 0; i < size; i++) {
+                if (LongVector.isSelected(selection, i) && !nulls[i]) {
+                    count++;
+                }
+            }
+            ((AggregateDataCount) data).addCount(count);
+            break;
+        }
+        case SUM: {
+            long sum = 0L;
+            boolean found = false;
+            for (int i = 0; i < size; i++) {
+                if (LongVector.isSelected(selection, i) && !nulls[i]) {
+                    long v = values[i], s = sum + v;
+                    if (((sum ^ s) & (v ^ s)) < 0) {
+                        // overflow, pass the partial sum to the data
+                        data.add(session, ValueBigint.get(sum));
+                        s = v;
+                    }
+                    sum = s;
+                    found = true;
+                }
+            }
+            if (found) {
+                data.add(session, ValueBigint.get(sum));
+            }
+            break;
+        }
+        case MIN:
+        case MAX: {
+            boolean min = aggregateType == AggregateType.MIN, found = false;
+            long m = 0L;
+            for (int i = 0; i < size; i++) {
+                if (LongVector.isSelected(selection, i) && !nulls[i]) {
+                    long v = values[i];
+                    if (!found || (min ? v < m : v > m)) {
+                        m = v;
+                        found = true;
+                    }
+                }
+            }
+            if (found) {
+                data.add(session, LongVector.getValue(m, args[0].getType().getValueType()));
+            }
+            break;
+        }
+        default:
+            throw DbException.getInternalError("type=" + aggregateType);
+        }
+    }
+
     private void sortWithOrderBy(Value[] array) {
         final SortOrder sortOrder = orderBySort;
         Arrays.sort(array,
@@ -21,6 +21,16 @@ abstract class AggregateData {
      */
     abstract void add(SessionLocal session, Value v);
 
+    /**
+     * Merge the state of another instance of the same aggregate into this
+     * aggregate. The result is the same as if all values added to the other
+     * instance were added to this instance after its own values.
+     *
+     * @param session the session
+     * @param other the other aggregate data of the same kind
+     */
+    abstract void merge(SessionLocal session, AggregateData other);
+
     /**
      * Get the aggregate result.
      *
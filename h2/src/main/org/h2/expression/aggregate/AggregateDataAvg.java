@@ -62,6 +62,22 @@ void add(SessionLocal session, Value v) {
         }
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        AggregateDataAvg o = (AggregateDataAvg) other;
+        if (o.count == 0) {
+            return;
+        }
+        count += o.count;
+        doubleValue += o.doubleValue;
+        if (o.decimalValue != null) {
+            decimalValue = decimalValue == null ? o.decimalValue : decimalValue.add(o.decimalValue);
+        }
+        if (o.integerValue != null) {
+            integerValue = integerValue == null ? o.integerValue : integerValue.add(o.integerValue);
+        }
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         if (count == 0) {
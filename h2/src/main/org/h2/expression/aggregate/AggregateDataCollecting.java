@@ -87,6 +87,28 @@ void add(SessionLocal session, Value v) {
         if (nullCollectionMode == NullCollectionMode.IGNORED && isNull(v)) {
             return;
         }
+        Collection<Value> c = getCollection(session);
+        if (nullCollectionMode == NullCollectionMode.EXCLUDED && isNull(v)) {
+            return;
+        }
+        c.add(v);
+    }
+
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        AggregateDataCollecting o = (AggregateDataCollecting) other;
+        if (o.shared != null) {
+            setSharedArgument(o.shared);
+        }
+        Collection<Value> c = o.values;
+        if (c != null) {
+            // an empty collection means that only excluded NULL values were
+            // processed
+            getCollection(session).addAll(c);
+        }
+    }
+
+    private Collection<Value> getCollection(SessionLocal session) {
         Collection<Value> c = values;
         if (c == null) {
             if (distinct) {
@@ -100,10 +122,7 @@ void add(SessionLocal session, Value v) {
             }
             values = c;
         }
-        if (nullCollectionMode == NullCollectionMode.EXCLUDED && isNull(v)) {
-            return;
-        }
-        c.add(v);
+        return c;
     }
 
     private boolean isNull(Value v) {
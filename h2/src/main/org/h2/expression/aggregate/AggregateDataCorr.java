@@ -51,6 +51,34 @@ void add(SessionLocal session, Value yValue, Value xValue) {
         }
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        AggregateDataCorr o = (AggregateDataCorr) other;
+        long otherCount = o.count;
+        if (otherCount == 0) {
+            return;
+        }
+        sumY += o.sumY;
+        sumX += o.sumX;
+        sumYX += o.sumYX;
+        if (count == 0) {
+            count = otherCount;
+            meanY = o.meanY;
+            m2y = o.m2y;
+            meanX = o.meanX;
+            m2x = o.m2x;
+            return;
+        }
+        long n = count + otherCount;
+        double delta = o.meanY - meanY;
+        m2y += o.m2y + delta * delta * count * otherCount / n;
+        meanY += delta * otherCount / n;
+        delta = o.meanX - meanX;
+        m2x += o.m2x + delta * delta * count * otherCount / n;
+        meanX += delta * otherCount / n;
+        count = n;
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         if (count < 1) {
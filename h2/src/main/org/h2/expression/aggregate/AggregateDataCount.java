@@ -30,6 +30,21 @@ void add(SessionLocal session, Value v) {
         }
     }
 
+    /**
+     * Adds the specified number of rows.
+     *
+     * @param count
+     *            the number of rows
+     */
+    void addCount(long count) {
+        this.count += count;
+    }
+
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        count += ((AggregateDataCount) other).count;
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         return ValueBigint.get(count);
@@ -39,6 +39,15 @@ void add(SessionLocal session, Value yValue, Value xValue) {
         count++;
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        AggregateDataCovar o = (AggregateDataCovar) other;
+        sumY += o.sumY;
+        sumX += o.sumX;
+        sumYX += o.sumYX;
+        count += o.count;
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         double v;
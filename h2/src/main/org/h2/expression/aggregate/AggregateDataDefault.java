@@ -100,6 +100,14 @@ void add(SessionLocal session, Value v) {
         }
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        Value v = ((AggregateDataDefault) other).value;
+        if (v != null) {
+            add(session, v);
+        }
+    }
+
     @SuppressWarnings("incomplete-switch")
     @Override
     Value getValue(SessionLocal session) {
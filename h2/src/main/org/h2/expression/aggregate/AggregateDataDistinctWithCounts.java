@@ -5,7 +5,9 @@
  */
 package org.h2.expression.aggregate;
 
+import java.util.Map.Entry;
 import java.util.TreeMap;
+
 import org.h2.engine.SessionLocal;
 import org.h2.value.Value;
 import org.h2.value.ValueNull;
@@ -44,15 +46,39 @@ void add(SessionLocal session, Value v) {
         if (values == null) {
             values = new TreeMap<>(session.getDatabase().getCompareMode());
         }
+        LongDataCounter a = getCounter(v);
+        if (a != null) {
+            a.count++;
+        }
+    }
+
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        TreeMap<Value, LongDataCounter> otherValues = ((AggregateDataDistinctWithCounts) other).values;
+        if (otherValues == null) {
+            return;
+        }
+        if (values == null) {
+            values = new TreeMap<>(session.getDatabase().getCompareMode());
+        }
+        for (Entry<Value, LongDataCounter> entry : otherValues.entrySet()) {
+            LongDataCounter a = getCounter(entry.getKey());
+            if (a != null) {
+                a.count += entry.getValue().count;
+            }
+        }
+    }
+
+    private LongDataCounter getCounter(Value v) {
         LongDataCounter a = values.get(v);
         if (a == null) {
             if (values.size() >= maxDistinctCount) {
-                return;
+                return null;
             }
             a = new LongDataCounter();
             values.put(v, a);
         }
-        a.count++;
+        return a;
     }
 
     @Override
@@ -64,6 +64,11 @@ void add(SessionLocal session, Value v) {
         envelope = GeometryUtils.union(envelope, v.convertToGeometry(null).getEnvelopeNoCopy());
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        envelope = GeometryUtils.union(envelope, ((AggregateDataEnvelope) other).envelope);
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         return ValueGeometry.fromEnvelope(envelope);
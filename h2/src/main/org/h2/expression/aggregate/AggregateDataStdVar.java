@@ -50,6 +50,27 @@ void add(SessionLocal session, Value v) {
         }
     }
 
+    @Override
+    void merge(SessionLocal session, AggregateData other) {
+        AggregateDataStdVar o = (AggregateDataStdVar) other;
+        long otherCount = o.count;
+        if (otherCount == 0) {
+            return;
+        }
+        if (count == 0) {
+            count = otherCount;
+            mean = o.mean;
+            m2 = o.m2;
+            return;
+        }
+        // Chan's parallel algorithm, see the same article
+        long n = count + otherCount;
+        double delta = o.mean - mean;
+        m2 += o.m2 + delta * delta * count * otherCount / n;
+        mean += delta * otherCount / n;
+        count = n;
+    }
+
     @Override
     Value getValue(SessionLocal session) {
         double v;
@@ -10,7 +10,9 @@
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionColumn;
 import org.h2.expression.ExpressionVisitor;
+import org.h2.expression.LongVector;
 import org.h2.expression.Parameter;
+import org.h2.expression.RowBatch;
 import org.h2.expression.TypedValueExpression;
 import org.h2.expression.ValueExpression;
 import org.h2.expression.aggregate.Aggregate;
@@ -465,6 +467,77 @@ public int getCost() {
         return left.getCost() + right.getCost() + 1;
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        if (compareType > NOT_EQUAL_NULL_SAFE || whenOperand) {
+            return false;
+        }
+        TypeInfo l = left.getType(), r = right.getType();
+        return (LongVector.isInteger(l) && LongVector.isInteger(r)
+                || l.getValueType() == Value.BOOLEAN && r.getValueType() == Value.BOOLEAN)
+                && left.isBatchCapable(filter) && right.isBatchCapable(filter);
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        int size = batch.size();
+        LongVector l = left.getValues(session, batch, selection);
+        boolean nullSafe = (compareType & ~1) == EQUAL_NULL_SAFE;
+        boolean[] rightSelection = selection;
+        if (!nullSafe) {
+            // do not evaluate right if not necessary
+            rightSelection = new boolean[size];
+            for (int i = 0; i < size; i++) {
+                rightSelection[i] = LongVector.isSelected(selection, i) && !l.nulls[i];
+            }
+        }
+        LongVector r = right.getValues(session, batch, rightSelection);
+        LongVector result = new LongVector(size);
+        long[] values = result.values;
+        boolean[] nulls = result.nulls;
+        for (int i = 0; i < size; i++) {
+            if (!LongVector.isSelected(selection, i)) {
+                continue;
+            }
+            boolean ln = l.nulls[i];
+            if (nullSafe) {
+                boolean equal = ln ? r.nulls[i] : !r.nulls[i] && l.values[i] == r.values[i];
+                values[i] = equal == (compareType == EQUAL_NULL_SAFE) ? 1L : 0L;
+                continue;
+            }
+            if (ln || r.nulls[i]) {
+                nulls[i] = true;
+                continue;
+            }
+            long a = l.values[i], b = r.values[i];
+            boolean v;
+            switch (compareType) {
+            case EQUAL:
+                v = a == b;
+                break;
+            case NOT_EQUAL:
+                v = a != b;
+                break;
+            case SMALLER:
+                v = a < b;
+                break;
+            case BIGGER:
+                v = a > b;
+                break;
+            case SMALLER_EQUAL:
+                v = a <= b;
+                break;
+            case BIGGER_EQUAL:
+                v = a >= b;
+                break;
+            default:
+                throw DbException.getInternalError("compareType=" + compareType);
+            }
+            values[i] = v ? 1L : 0L;
+        }
+        return result;
+    }
+
     /**
      * Get the other expression if this is an equals comparison and the other
      * expression matches.
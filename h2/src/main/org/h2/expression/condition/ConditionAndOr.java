@@ -8,6 +8,8 @@
 import org.h2.engine.SessionLocal;
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionVisitor;
+import org.h2.expression.LongVector;
+import org.h2.expression.RowBatch;
 import org.h2.expression.TypedValueExpression;
 import org.h2.expression.ValueExpression;
 import org.h2.message.DbException;
@@ -312,6 +314,51 @@ public int getCost() {
         return left.getCost() + right.getCost();
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        return left.getType().getValueType() == Value.BOOLEAN && right.getType().getValueType() == Value.BOOLEAN
+                && left.isBatchCapable(filter) && right.isBatchCapable(filter);
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        int size = batch.size();
+        LongVector l = left.getValues(session, batch, selection);
+        boolean and = andOrType == AND;
+        // do not evaluate right if the result is already known
+        boolean[] rightSelection = new boolean[size];
+        for (int i = 0; i < size; i++) {
+            rightSelection[i] = LongVector.isSelected(selection, i) && !(and ? l.isFalse(i) : l.isTrue(i));
+        }
+        LongVector r = right.getValues(session, batch, rightSelection);
+        LongVector result = new LongVector(size);
+        long[] values = result.values;
+        boolean[] nulls = result.nulls;
+        for (int i = 0; i < size; i++) {
+            if (!LongVector.isSelected(selection, i)) {
+                continue;
+            }
+            if (and) {
+                if (!rightSelection[i] || r.isFalse(i)) {
+                    values[i] = 0L;
+                } else if (l.nulls[i] || r.nulls[i]) {
+                    nulls[i] = true;
+                } else {
+                    values[i] = 1L;
+                }
+            } else {
+                if (!rightSelection[i] || r.isTrue(i)) {
+                    values[i] = 1L;
+                } else if (l.nulls[i] || r.nulls[i]) {
+                    nulls[i] = true;
+                } else {
+                    values[i] = 0L;
+                }
+            }
+        }
+        return result;
+    }
+
     @Override
     public int getSubexpressionCount() {
         return 2;
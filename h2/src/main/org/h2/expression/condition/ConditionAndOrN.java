@@ -13,6 +13,8 @@
 import org.h2.engine.SessionLocal;
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionVisitor;
+import org.h2.expression.LongVector;
+import org.h2.expression.RowBatch;
 import org.h2.message.DbException;
 import org.h2.table.ColumnResolver;
 import org.h2.table.TableFilter;
@@ -328,6 +330,52 @@ public int getCost() {
         return cost;
     }
 
+    @Override
+    public boolean isBatchCapable(TableFilter filter) {
+        for (Expression e : expressions) {
+            if (e.getType().getValueType() != Value.BOOLEAN || !e.isBatchCapable(filter)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    @Override
+    public LongVector getValues(SessionLocal session, RowBatch batch, boolean[] selection) {
+        int size = batch.size();
+        boolean and = andOrType == ConditionAndOr.AND;
+        LongVector result = new LongVector(size);
+        long[] values = result.values;
+        // nulls of the result are used as hasNull flags of undecided rows
+        boolean[] nulls = result.nulls;
+        // rows with unknown result
+        boolean[] current = new boolean[size];
+        for (int i = 0; i < size; i++) {
+            current[i] = LongVector.isSelected(selection, i);
+        }
+        long decided = and ? 0L : 1L;
+        for (Expression e : expressions) {
+            LongVector v = e.getValues(session, batch, current);
+            for (int i = 0; i < size; i++) {
+                if (current[i]) {
+                    if (v.nulls[i]) {
+                        nulls[i] = true;
+                    } else if (v.values[i] == decided) {
+                        values[i] = decided;
+                        nulls[i] = false;
+                        current[i] = false;
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < size; i++) {
+            if (current[i] && !nulls[i]) {
+                values[i] = 1L - decided;
+            }
+        }
+        return result;
+    }
+
     @Override
     public int getSubexpressionCount() {
         return expressions.size();
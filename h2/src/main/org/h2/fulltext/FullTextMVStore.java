@@ -0,0 +1,841 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.fulltext;
+
+import java.nio.ByteBuffer;
+import java.sql.Connection;
+import java.sql.DatabaseMetaData;
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.PriorityQueue;
+import java.util.StringTokenizer;
+
+import org.h2.api.Trigger;
+import org.h2.engine.Database;
+import org.h2.engine.SessionLocal;
+import org.h2.jdbc.JdbcConnection;
+import org.h2.mvstore.DataUtils;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVStoreException;
+import org.h2.mvstore.WriteBuffer;
+import org.h2.mvstore.db.ValueDataType;
+import org.h2.mvstore.tx.Transaction;
+import org.h2.mvstore.tx.TransactionMap;
+import org.h2.mvstore.type.BasicDataType;
+import org.h2.mvstore.type.LongDataType;
+import org.h2.mvstore.type.StringDataType;
+import org.h2.tools.SimpleResultSet;
+import org.h2.util.StringUtils;
+import org.h2.util.Utils;
+import org.h2.value.Value;
+import org.h2.value.ValueInteger;
+import org.h2.value.ValueRow;
+import org.h2.value.ValueVarchar;
+import org.h2.value.VersionedValue;
+
+/**
+ * This class implements the full text search with an inverted index stored in
+ * maps of the MVStore of the database. The index is modified within the
+ * transaction that modifies the rows, so changes become visible to other
+ * sessions on commit and are discarded on rollback.
+ * <p>
+ * A search returns the rows that contain all words of the query, ordered by
+ * their BM25 relevance score. Unlike the usual BM25 definition, the length of
+ * a document is the number of its distinct words rather than the number of
+ * its words, so the average length is known from the sizes of the maps
+ * without reading all documents. Keys of the posting lists are stored with
+ * front coding of words and delta coding of document ids.
+ * Most methods can be called using SQL statements as well.
+ */
+public class FullTextMVStore extends FullText {
+
+    private static final String TRIGGER_PREFIX = "FTM_";
+    private static final String SCHEMA = "FTM";
+    private static final String MAP_PREFIX = "fulltext.";
+    private static final String LAST_DOCUMENT_ID = "lastDocumentId";
+
+    /**
+     * The BM25 term frequency saturation parameter.
+     */
+    private static final double K1 = 1.2;
+
+    /**
+     * The BM25 document length normalization parameter.
+     */
+    private static final double B = 0.75;
+
+    /**
+     * Initializes full text search functionality for this database. This adds
+     * the following Java functions to the database:
+     * <ul>
+     * <li>FTM_CREATE_INDEX(schemaNameString, tableNameString,
+     * columnListString)</li>
+     * <li>FTM_SEARCH(queryString, limitInt, offsetInt): result set</li>
+     * <li>FTM_REINDEX()</li>
+     * <li>FTM_DROP_ALL()</li>
+     * </ul>
+     * It also adds a schema FTM to the database where bookkeeping information
+     * is stored. This function may be called from a Java application, or by
+     * using the SQL statements:
+     *
+     * <pre>
+     * CREATE ALIAS IF NOT EXISTS FTM_INIT FOR
+     *      &quot;org.h2.fulltext.FullTextMVStore.init&quot;;
+     * CALL FTM_INIT();
+     * </pre>
+     *
+     * @param conn the connection
+     */
+    public static void init(Connection conn) throws SQLException {
+        try (Statement stat = conn.createStatement()) {
+            stat.execute("CREATE SCHEMA IF NOT EXISTS " + SCHEMA);
+            stat.execute("CREATE TABLE IF NOT EXISTS " + SCHEMA +
+                    ".INDEXES(ID INT AUTO_INCREMENT PRIMARY KEY, " +
+                    "SCHEMA VARCHAR, `TABLE` VARCHAR, COLUMNS VARCHAR, " +
+                    "UNIQUE(SCHEMA, `TABLE`))");
+            String className = FullTextMVStore.class.getName();
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_CREATE_INDEX FOR '" + className + ".createIndex'");
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_DROP_INDEX FOR '" + className + ".dropIndex'");
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_SEARCH FOR '" + className + ".search'");
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_SEARCH_DATA FOR '" + className + ".searchData'");
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_REINDEX FOR '" + className + ".reindex'");
+            stat.execute("CREATE ALIAS IF NOT EXISTS FTM_DROP_ALL FOR '" + className + ".dropAll'");
+        }
+    }
+
+    /**
+     * Create a new full text index for a table and column list. Each table may
+     * only have one index at any time.
+     *
+     * @param conn the connection
+     * @param schema the schema name of the table (case sensitive)
+     * @param table the table name (case sensitive)
+     * @param columnList the column list (null for all columns)
+     */
+    public static void createIndex(Connection conn, String schema,
+            String table, String columnList) throws SQLException {
+        init(conn);
+        PreparedStatement prep = conn.prepareStatement("INSERT INTO " + SCHEMA
+                + ".INDEXES(SCHEMA, `TABLE`, COLUMNS) VALUES(?, ?, ?)");
+        prep.setString(1, schema);
+        prep.setString(2, table);
+        prep.setString(3, columnList);
+        prep.execute();
+        createTrigger(conn, schema, table);
+        indexExistingRows(conn, schema, table, true);
+    }
+
+    /**
+     * Drop an existing full text index for a table. This method returns
+     * silently if no index for this table exists.
+     *
+     * @param conn the connection
+     * @param schema the schema name of the table (case sensitive)
+     * @param table the table name (case sensitive)
+     */
+    public static void dropIndex(Connection conn, String schema, String table)
+            throws SQLException {
+        init(conn);
+        PreparedStatement prep = conn.prepareStatement("SELECT ID FROM " + SCHEMA
+                + ".INDEXES WHERE SCHEMA=? AND `TABLE`=?");
+        prep.setString(1, schema);
+        prep.setString(2, table);
+        ResultSet rs = prep.executeQuery();
+        if (!rs.next()) {
+            return;
+        }
+        // the rows are still indexed with the current settings
+        indexExistingRows(conn, schema, table, false);
+        prep = conn.prepareStatement("DELETE FROM " + SCHEMA + ".INDEXES WHERE ID=?");
+        prep.setInt(1, rs.getInt(1));
+        prep.execute();
+        createOrDropTrigger(conn, schema, table, false);
+    }
+
+    /**
+     * Re-creates the full text index for this database. Calling this method is
+     * usually not needed, as the index is kept up-to-date automatically.
+     *
+     * @param conn the connection
+     */
+    public static void reindex(Connection conn) throws SQLException {
+        init(conn);
+        removeAllTriggers(conn, TRIGGER_PREFIX);
+        clearMaps(conn);
+        Statement stat = conn.createStatement();
+        ResultSet rs = stat.executeQuery("SELECT * FROM " + SCHEMA + ".INDEXES");
+        while (rs.next()) {
+            String schema = rs.getString("SCHEMA");
+            String table = rs.getString("TABLE");
+            createTrigger(conn, schema, table);
+            indexExistingRows(conn, schema, table, true);
+        }
+    }
+
+    /**
+     * Drops all full text indexes from the database.
+     *
+     * @param conn the connection
+     */
+    public static void dropAll(Connection conn) throws SQLException {
+        Statement stat = conn.createStatement();
+        stat.execute("DROP SCHEMA IF EXISTS " + SCHEMA + " CASCADE");
+        removeAllTriggers(conn, TRIGGER_PREFIX);
+        clearMaps(conn);
+    }
+
+    /**
+     * Searches from the full text index for this database. Only rows that
+     * contain all words of the query are returned, the rows with the highest
+     * scores are returned first.
+     * The returned result set has the following column:
+     * <ul><li>QUERY (varchar): the query to use to get the data.
+     * The query does not include 'SELECT * FROM '. Example:
+     * PUBLIC.TEST WHERE ID = 1
+     * </li><li>SCORE (float) the BM25 relevance score.
+     * </li></ul>
+     *
+     * @param conn the connection
+     * @param text the search query
+     * @param limit the maximum number of rows or 0 for no limit
+     * @param offset the offset or 0 for no offset
+     * @return the result set
+     */
+    public static ResultSet search(Connection conn, String text, int limit,
+            int offset) throws SQLException {
+        return search(conn, text, limit, offset, false);
+    }
+
+    /**
+     * Searches from the full text index for this database. The result contains
+     * the primary key data as an array. The returned result set has the
+     * following columns:
+     * <ul>
+     * <li>SCHEMA (varchar): the schema name. Example: PUBLIC</li>
+     * <li>TABLE (varchar): the table name. Example: TEST</li>
+     * <li>COLUMNS (array of varchar): comma separated list of quoted column
+     * names. The column names are quoted if necessary. Example: (ID)</li>
+     * <li>KEYS (array of values): comma separated list of values.
+     * Example: (1)</li>
+     * <li>SCORE (float) the BM25 relevance score.</li>
+     * </ul>
+     *
+     * @param conn the connection
+     * @param text the search query
+     * @param limit the maximum number of rows or 0 for no limit
+     * @param offset the offset or 0 for no offset
+     * @return the result set
+     */
+    public static ResultSet searchData(Connection conn, String text, int limit,
+            int offset) throws SQLException {
+        return search(conn, text, limit, offset, true);
+    }
+
+    /**
+     * Convert an exception to a fulltext exception.
+     *
+     * @param e the original exception
+     * @return the converted SQL exception
+     */
+    protected static SQLException convertException(Exception e) {
+        return new SQLException("Error while indexing document", "FULLTEXT", e);
+    }
+
+    /**
+     * Create the trigger.
+     *
+     * @param conn the database connection
+     * @param schema the schema name
+     * @param table the table name
+     */
+    private static void createTrigger(Connection conn, String schema,
+            String table) throws SQLException {
+        createOrDropTrigger(conn, schema, table, true);
+    }
+
+    private static void createOrDropTrigger(Connection conn,
+            String schema, String table, boolean create) throws SQLException {
+        try (Statement stat = conn.createStatement()) {
+            String trigger = StringUtils.quoteIdentifier(schema) + "."
+                    + StringUtils.quoteIdentifier(TRIGGER_PREFIX + table);
+            stat.execute("DROP TRIGGER IF EXISTS " + trigger);
+            if (create) {
+                // the index is modified in the transaction of the user
+                // connection, so the trigger is not needed on rollback
+                StringBuilder builder = new StringBuilder(
+                        "CREATE TRIGGER IF NOT EXISTS ");
+                builder.append(trigger).
+                        append(" AFTER INSERT, UPDATE, DELETE ON ");
+                StringUtils.quoteIdentifier(builder, schema).
+                        append('.');
+                StringUtils.quoteIdentifier(builder, table).
+                        append(" FOR EACH ROW CALL \"").
+                        append(FullTextMVStore.FullTextTrigger.class.getName()).
+                        append('"');
+                stat.execute(builder.toString());
+            }
+        }
+    }
+
+    /**
+     * Add the existing data to the index, or remove it from the index.
+     *
+     * @param conn the database connection
+     * @param schema the schema name
+     * @param table the table name
+     * @param insert whether the rows should be added
+     */
+    private static void indexExistingRows(Connection conn, String schema,
+            String table, boolean insert) throws SQLException {
+        FullTextMVStore.FullTextTrigger existing = new FullTextMVStore.FullTextTrigger();
+        existing.init(conn, schema, null, table, false, Trigger.INSERT);
+        String sql = "SELECT * FROM " + StringUtils.quoteIdentifier(schema)
+                + "." + StringUtils.quoteIdentifier(table);
+        ResultSet rs = conn.createStatement().executeQuery(sql);
+        int columnCount = rs.getMetaData().getColumnCount();
+        Maps maps = new Maps(getSession(conn));
+        while (rs.next()) {
+            Object[] row = new Object[columnCount];
+            for (int i = 0; i < columnCount; i++) {
+                row[i] = rs.getObject(i + 1);
+            }
+            if (insert) {
+                existing.insert(maps, row);
+            } else {
+                existing.delete(maps, row);
+            }
+        }
+    }
+
+    private static void clearMaps(Connection conn) throws SQLException {
+        SessionLocal session = getSession(conn);
+        if (Maps.exist(session)) {
+            Maps maps = new Maps(session);
+            maps.documents.clear();
+            maps.keys.clear();
+            maps.postings.clear();
+        }
+    }
+
+    private static SessionLocal getSession(Connection conn) {
+        return (SessionLocal) ((JdbcConnection) conn).getSession();
+    }
+
+    /**
+     * Get the number of occurrences of each word in the text.
+     *
+     * @param setting the fulltext settings
+     * @param words the map of words to their numbers of occurrences
+     * @param text the text
+     */
+    static void countWords(FullTextSettings setting, HashMap<String, Integer> words, String text) {
+        StringTokenizer tokenizer = new StringTokenizer(text, setting.getWhitespaceChars());
+        while (tokenizer.hasMoreTokens()) {
+            String word = setting.convertWord(tokenizer.nextToken());
+            if (word != null) {
+                words.merge(word, 1, Integer::sum);
+            }
+        }
+    }
+
+    /**
+     * Do the search.
+     *
+     * @param conn the database connection
+     * @param text the query
+     * @param limit the limit
+     * @param offset the offset
+     * @param data whether the raw data should be returned
+     * @return the result set
+     */
+    protected static ResultSet search(Connection conn, String text, int limit,
+            int offset, boolean data) throws SQLException {
+        SimpleResultSet result = createResultSet(data);
+        if (conn.getMetaData().getURL().startsWith("jdbc:columnlist:")) {
+            // this is just to query the result set columns
+            return result;
+        }
+        if (text == null || StringUtils.isWhitespaceOrEmpty(text)) {
+            return result;
+        }
+        SessionLocal session = getSession(conn);
+        if (!Maps.exist(session)) {
+            return result;
+        }
+        HashMap<String, Integer> queryWords = new HashMap<>();
+        countWords(FullTextSettings.getInstance(conn), queryWords, text);
+        int wordCount = queryWords.size();
+        if (wordCount == 0) {
+            return result;
+        }
+        try {
+            Maps maps = new Maps(session);
+            MVMap<Posting, VersionedValue<Long>> postingMap = maps.postings.map;
+            long documentCount = maps.documents.map.sizeAsLong();
+            if (documentCount == 0) {
+                return result;
+            }
+            double averageLength = (double) postingMap.sizeAsLong() / documentCount;
+            // the numbers of documents with each word are estimated from the
+            // positions of keys, they may include uncommitted changes
+            String[] words = queryWords.keySet().toArray(new String[0]);
+            long[] documentFrequencies = new long[wordCount];
+            for (int i = 0; i < wordCount; i++) {
+                String word = words[i];
+                documentFrequencies[i] = getPosition(postingMap, new Posting(word, Long.MAX_VALUE))
+                        - getPosition(postingMap, new Posting(word, Long.MIN_VALUE));
+            }
+            // iterate over the shortest posting list, look up the other words
+            Integer[] order = new Integer[wordCount];
+            for (int i = 0; i < wordCount; i++) {
+                order[i] = i;
+            }
+            Arrays.sort(order, Comparator.comparingLong((Integer i) -> documentFrequencies[i]));
+            double[] idf = new double[wordCount];
+            for (int i = 0; i < wordCount; i++) {
+                long df = documentFrequencies[order[i]];
+                idf[i] = Math.log(1 + (documentCount - df + 0.5) / (df + 0.5));
+            }
+            int maxHits = limit > 0 ? limit + offset : Integer.MAX_VALUE;
+            PriorityQueue<Hit> hits = new PriorityQueue<>(Comparator.comparingDouble((Hit h) -> h.score));
+            long[] frequencies = new long[wordCount];
+            String first = words[order[0]];
+            Iterator<Map.Entry<Posting, Long>> it = maps.postings.entryIterator(new Posting(first, Long.MIN_VALUE),
+                    new Posting(first, Long.MAX_VALUE));
+            loop: while (it.hasNext()) {
+                Map.Entry<Posting, Long> entry = it.next();
+                long docId = entry.getKey().docId;
+                frequencies[0] = entry.getValue();
+                for (int i = 1; i < wordCount; i++) {
+                    Long frequency = maps.postings.get(new Posting(words[order[i]], docId));
+                    if (frequency == null) {
+                        continue loop;
+                    }
+                    frequencies[i] = frequency;
+                }
+                Value document = maps.documents.get(docId);
+                if (document == null) {
+                    continue;
+                }
+                int length = ((ValueRow) document).getList()[2].getInt();
+                double norm = K1 * (1 - B + B * length / averageLength);
+                double score = 0;
+                for (int i = 0; i < wordCount; i++) {
+                    double tf = frequencies[i];
+                    score += idf[i] * tf * (K1 + 1) / (tf + norm);
+                }
+                if (hits.size() < maxHits) {
+                    hits.add(new Hit(docId, score));
+                } else if (hits.peek().score < score) {
+                    hits.poll();
+                    hits.add(new Hit(docId, score));
+                }
+            }
+            ArrayList<Hit> list = new ArrayList<>(hits);
+            list.sort((a, b) -> Double.compare(b.score, a.score));
+            HashMap<Integer, String[]> indexes = getIndexes(conn);
+            for (int i = offset, size = list.size(); i < size; i++) {
+                Hit hit = list.get(i);
+                Value[] document = ((ValueRow) maps.documents.get(hit.docId)).getList();
+                String[] index = indexes.get(document[0].getInt());
+                if (index == null) {
+                    continue;
+                }
+                String key = document[1].getString();
+                if (data) {
+                    String[][] columnData = parseKey(conn, key);
+                    result.addRow(index[0], index[1], columnData[0], columnData[1], hit.score);
+                } else {
+                    String query = StringUtils.quoteIdentifier(index[0]) + "."
+                            + StringUtils.quoteIdentifier(index[1]) + " WHERE " + key;
+                    result.addRow(query, hit.score);
+                }
+            }
+        } catch (MVStoreException e) {
+            throw convertException(e);
+        }
+        return result;
+    }
+
+    private static long getPosition(MVMap<Posting, VersionedValue<Long>> map, Posting key) {
+        long index = map.getKeyIndex(key);
+        return index >= 0 ? index : -index - 1;
+    }
+
+    private static HashMap<Integer, String[]> getIndexes(Connection conn) throws SQLException {
+        HashMap<Integer, String[]> indexes = new HashMap<>();
+        Statement stat = conn.createStatement();
+        ResultSet rs = stat.executeQuery("SELECT ID, SCHEMA, `TABLE` FROM " + SCHEMA + ".INDEXES");
+        while (rs.next()) {
+            indexes.put(rs.getInt(1), new String[] { rs.getString(2), rs.getString(3) });
+        }
+        return indexes;
+    }
+
+    /**
+     * A document found by the search.
+     */
+    private static final class Hit {
+
+        final long docId;
+
+        final double score;
+
+        Hit(long docId, double score) {
+            this.docId = docId;
+            this.score = score;
+        }
+
+    }
+
+    /**
+     * The maps of the inverted index opened in the transaction of a session.
+     */
+    static final class Maps {
+
+        /**
+         * Key: document id, value: index id, key condition of the row, and
+         * number of distinct words.
+         */
+        final TransactionMap<Long, Value> documents;
+
+        /**
+         * The map with the last used document id. It is not transactional, so
+         * ids of rolled back or deleted documents are never reused.
+         */
+        final MVMap<String, Long> counters;
+
+        /**
+         * Key: index id and key condition of the row, value: document id.
+         */
+        final TransactionMap<String, Long> keys;
+
+        /**
+         * Key: word and document id, value: the number of occurrences of the
+         * word in the document.
+         */
+        final TransactionMap<Posting, Long> postings;
+
+        Maps(SessionLocal session) {
+            Database db = session.getDatabase();
+            Transaction t = session.getTransaction();
+            documents = t.openMap(MAP_PREFIX + "documents", LongDataType.INSTANCE, new ValueDataType(db, null));
+            keys = t.openMap(MAP_PREFIX + "keys", StringDataType.INSTANCE, LongDataType.INSTANCE);
+            postings = t.openMap(MAP_PREFIX + "postings", PostingDataType.INSTANCE, LongDataType.INSTANCE);
+            counters = db.getStore().getMvStore().openMap(MAP_PREFIX + "counters",
+                    new MVMap.Builder<String, Long>().keyType(StringDataType.INSTANCE)
+                            .valueType(LongDataType.INSTANCE));
+        }
+
+        /**
+         * Get a new document id.
+         *
+         * @return the document id
+         */
+        long nextDocumentId() {
+            synchronized (counters) {
+                Long count = counters.get(LAST_DOCUMENT_ID);
+                long docId = count != null ? count + 1 : 1;
+                counters.put(LAST_DOCUMENT_ID, docId);
+                return docId;
+            }
+        }
+
+        /**
+         * Check whether the maps were created.
+         *
+         * @param session the session
+         * @return whether the maps exist
+         */
+        static boolean exist(SessionLocal session) {
+            return session.getDatabase().getStore().getMvStore().hasMap(MAP_PREFIX + "documents");
+        }
+
+    }
+
+    /**
+     * A key of a posting list.
+     */
+    static final class Posting {
+
+        /**
+         * The word.
+         */
+        final String word;
+
+        /**
+         * The document id.
+         */
+        final long docId;
+
+        Posting(String word, long docId) {
+            this.word = word;
+            this.docId = docId;
+        }
+
+    }
+
+    /**
+     * The data type of keys of posting lists. Keys of a page are sorted, so
+     * each word is stored as the length of the prefix shared with the
+     * previous word and the remaining characters, and each document id of
+     * the same word as the difference with the previous document id.
+     */
+    public static final class PostingDataType extends BasicDataType<Posting> {
+
+        /**
+         * The instance.
+         */
+        public static final PostingDataType INSTANCE = new PostingDataType();
+
+        private PostingDataType() {
+        }
+
+        @Override
+        public int compare(Posting a, Posting b) {
+            int comp = a.word.compareTo(b.word);
+            return comp != 0 ? comp : Long.compare(a.docId, b.docId);
+        }
+
+        @Override
+        public int getMemory(Posting obj) {
+            return 48 + 2 * obj.word.length();
+        }
+
+        @Override
+        public void write(WriteBuffer buff, Posting obj) {
+            int len = obj.word.length();
+            buff.putVarInt(len).putStringData(obj.word, len).putVarLong(obj.docId);
+        }
+
+        @Override
+        public Posting read(ByteBuffer buff) {
+            String word = DataUtils.readString(buff);
+            return new Posting(word, DataUtils.readVarLong(buff));
+        }
+
+        @Override
+        public void write(WriteBuffer buff, Object storage, int len) {
+            Posting[] keys = cast(storage);
+            Posting previous = null;
+            for (int i = 0; i < len; i++) {
+                Posting key = keys[i];
+                String word = key.word;
+                int shared = 0;
+                if (previous != null) {
+                    String previousWord = previous.word;
+                    int max = Math.min(word.length(), previousWord.length());
+                    while (shared < max && word.charAt(shared) == previousWord.charAt(shared)) {
+                        shared++;
+                    }
+                }
+                int suffix = word.length() - shared;
+                buff.putVarInt(shared).putVarInt(suffix).putStringData(word.substring(shared), suffix);
+                if (previous != null && suffix == 0 && shared == previous.word.length()) {
+                    buff.putVarLong(key.docId - previous.docId);
+                } else {
+                    buff.putVarLong(key.docId);
+                }
+                previous = key;
+            }
+        }
+
+        @Override
+        public void read(ByteBuffer buff, Object storage, int len) {
+            Posting[] keys = cast(storage);
+            Posting previous = null;
+            for (int i = 0; i < len; i++) {
+                int shared = DataUtils.readVarInt(buff);
+                int suffix = DataUtils.readVarInt(buff);
+                String word = DataUtils.readString(buff, suffix);
+                long docId = DataUtils.readVarLong(buff);
+                if (previous != null) {
+                    String previousWord = previous.word;
+                    if (suffix == 0 && shared == previousWord.length()) {
+                        word = previousWord;
+                        docId += previous.docId;
+                    } else {
+                        word = previousWord.substring(0, shared) + word;
+                    }
+                }
+                keys[i] = previous = new Posting(word, docId);
+            }
+        }
+
+        @Override
+        public Posting[] createStorage(int size) {
+            return new Posting[size];
+        }
+
+    }
+
+    /**
+     * Trigger updates the index when a inserting, updating, or deleting a row.
+     */
+    public static final class FullTextTrigger implements Trigger {
+
+        private FullTextSettings setting;
+        private int indexId;
+        private int[] keys;
+        private int[] indexColumns;
+        private String[] columns;
+        private int[] columnTypes;
+
+        /**
+         * INTERNAL
+         */
+        @Override
+        public void init(Connection conn, String schemaName, String triggerName,
+                String tableName, boolean before, int type) throws SQLException {
+            setting = FullTextSettings.getInstance(conn);
+            ArrayList<String> keyList = Utils.newSmallArrayList();
+            DatabaseMetaData meta = conn.getMetaData();
+            ResultSet rs = meta.getColumns(null,
+                    StringUtils.escapeMetaDataPattern(schemaName),
+                    StringUtils.escapeMetaDataPattern(tableName),
+                    null);
+            ArrayList<String> columnList = Utils.newSmallArrayList();
+            ArrayList<Integer> typeList = Utils.newSmallArrayList();
+            while (rs.next()) {
+                columnList.add(rs.getString("COLUMN_NAME"));
+                typeList.add(rs.getInt("DATA_TYPE"));
+            }
+            columns = columnList.toArray(new String[0]);
+            columnTypes = new int[columns.length];
+            for (int i = 0; i < columnTypes.length; i++) {
+                columnTypes[i] = typeList.get(i);
+            }
+            rs = meta.getPrimaryKeys(null,
+                    StringUtils.escapeMetaDataPattern(schemaName),
+                    tableName);
+            while (rs.next()) {
+                keyList.add(rs.getString("COLUMN_NAME"));
+            }
+            if (keyList.isEmpty()) {
+                throw throwException("No primary key for table " + tableName);
+            }
+            ArrayList<String> indexList = Utils.newSmallArrayList();
+            PreparedStatement prep = conn.prepareStatement(
+                    "SELECT ID, COLUMNS FROM " + SCHEMA
+                    + ".INDEXES WHERE SCHEMA=? AND `TABLE`=?");
+            prep.setString(1, schemaName);
+            prep.setString(2, tableName);
+            rs = prep.executeQuery();
+            if (rs.next()) {
+                indexId = rs.getInt(1);
+                String cols = rs.getString(2);
+                if (cols != null) {
+                    Collections.addAll(indexList,
+                            StringUtils.arraySplit(cols, ',', true));
+                }
+            }
+            if (indexList.isEmpty()) {
+                indexList.addAll(columnList);
+            }
+            keys = new int[keyList.size()];
+            setColumns(keys, keyList, columnList);
+            indexColumns = new int[indexList.size()];
+            setColumns(indexColumns, indexList, columnList);
+        }
+
+        /**
+         * INTERNAL
+         */
+        @Override
+        public void fire(Connection conn, Object[] oldRow, Object[] newRow)
+                throws SQLException {
+            if (oldRow != null && newRow != null && !hasChanged(oldRow, newRow, indexColumns)) {
+                return;
+            }
+            Maps maps = new Maps(getSession(conn));
+            if (oldRow != null) {
+                delete(maps, oldRow);
+            }
+            if (newRow != null) {
+                insert(maps, newRow);
+            }
+        }
+
+        /**
+         * Add a row to the index.
+         *
+         * @param maps the maps of the index
+         * @param row the row
+         */
+        void insert(Maps maps, Object[] row) throws SQLException {
+            HashMap<String, Integer> words = getWords(row);
+            String key = getKey(row);
+            try {
+                long docId = maps.nextDocumentId();
+                maps.documents.put(docId, ValueRow.get(new Value[] { ValueInteger.get(indexId),
+                        ValueVarchar.get(key), ValueInteger.get(words.size()) }));
+                maps.keys.put(indexId + ":" + key, docId);
+                for (Map.Entry<String, Integer> entry : words.entrySet()) {
+                    maps.postings.put(new Posting(entry.getKey(), docId), (long) entry.getValue());
+                }
+            } catch (MVStoreException e) {
+                throw convertException(e);
+            }
+        }
+
+        /**
+         * Delete a row from the index.
+         *
+         * @param maps the maps of the index
+         * @param row the row
+         */
+        void delete(Maps maps, Object[] row) throws SQLException {
+            try {
+                Long docId = maps.keys.remove(indexId + ":" + getKey(row));
+                if (docId != null) {
+                    maps.documents.remove(docId);
+                    for (String word : getWords(row).keySet()) {
+                        maps.postings.remove(new Posting(word, docId));
+                    }
+                }
+            } catch (MVStoreException e) {
+                throw convertException(e);
+            }
+        }
+
+        private HashMap<String, Integer> getWords(Object[] row) throws SQLException {
+            HashMap<String, Integer> words = new HashMap<>();
+            for (int index : indexColumns) {
+                countWords(setting, words, asString(row[index], columnTypes[index]));
+            }
+            return words;
+        }
+
+        private String getKey(Object[] row) throws SQLException {
+            StringBuilder builder = new StringBuilder();
+            for (int i = 0, l = keys.length; i < l; i++) {
+                if (i > 0) {
+                    builder.append(" AND ");
+                }
+                int columnIndex = keys[i];
+                StringUtils.quoteIdentifier(builder, columns[columnIndex]);
+                Object o = row[columnIndex];
+                if (o == null) {
+                    builder.append(" IS NULL");
+                } else {
+                    builder.append('=').append(quoteSQL(o, columnTypes[columnIndex]));
+                }
+            }
+            return builder.toString();
+        }
+
+    }
+
+}
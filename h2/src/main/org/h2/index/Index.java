@@ -13,6 +13,8 @@
 import org.h2.engine.Constants;
 import org.h2.engine.DbObject;
 import org.h2.engine.SessionLocal;
+import org.h2.expression.Expression;
+import org.h2.expression.condition.Comparison;
 import org.h2.message.DbException;
 import org.h2.message.Trace;
 import org.h2.result.Row;
@@ -21,6 +23,7 @@
 import org.h2.result.SortOrder;
 import org.h2.schema.SchemaObject;
 import org.h2.table.Column;
+import org.h2.table.ColumnStatistics;
 import org.h2.table.IndexColumn;
 import org.h2.table.Table;
 import org.h2.table.TableFilter;
@@ -174,9 +177,11 @@ public String getCreateSQLForCopy(Table targetTable, String quotedName) {
     private StringBuilder getColumnListSQL(StringBuilder builder, int sqlFlags) {
         builder.append('(');
         int length = indexColumns.length;
-        if (uniqueColumnColumn > 0 && uniqueColumnColumn < length) {
-            IndexColumn.writeColumns(builder, indexColumns, 0, uniqueColumnColumn, sqlFlags).append(") INCLUDE(");
-            IndexColumn.writeColumns(builder, indexColumns, uniqueColumnColumn, length, sqlFlags);
+        int keyColumnCount = uniqueColumnColumn > 0 ? uniqueColumnColumn
+                : length - indexType.getIncludedColumnCount();
+        if (keyColumnCount > 0 && keyColumnCount < length) {
+            IndexColumn.writeColumns(builder, indexColumns, 0, keyColumnCount, sqlFlags).append(") INCLUDE(");
+            IndexColumn.writeColumns(builder, indexColumns, keyColumnCount, length, sqlFlags);
         } else {
             IndexColumn.writeColumns(builder, indexColumns, 0, length, sqlFlags);
         }
@@ -543,6 +548,79 @@ protected StringBuilder getDuplicatePrimaryKeyMessage(int mainIndexColumn) {
         return builder;
     }
 
+    /**
+     * Estimate the fraction of rows matched by the conditions with constant
+     * values on the specified column using the statistics of the column.
+     *
+     * @param column the column
+     * @param tableFilter the table filter, or {@code null}
+     * @param equality {@code true} for equality conditions, {@code false} for
+     *            range conditions
+     * @return the fraction of rows, or -1 if it cannot be estimated
+     */
+    private static double getStatisticsFraction(Column column, TableFilter tableFilter, boolean equality) {
+        ColumnStatistics statistics = column.getStatistics();
+        if (statistics == null || tableFilter == null) {
+            return -1d;
+        }
+        SessionLocal session = tableFilter.getSession();
+        Value min = null, max = null;
+        boolean found = false;
+        try {
+            for (IndexCondition condition : tableFilter.getIndexConditions()) {
+                if (condition.getColumn() != column) {
+                    continue;
+                }
+                int compareType = condition.getCompareType();
+                if (compareType == Comparison.IN_LIST) {
+                    if (!equality) {
+                        continue;
+                    }
+                    double f = 0d;
+                    for (Expression e : condition.getExpressionList()) {
+                        if (!e.isConstant()) {
+                            return -1d;
+                        }
+                        f += statistics.getEqualFraction(session, column.convert(session, e.getValue(session)));
+                    }
+                    return Math.min(f, 1d);
+                }
+                Expression e = condition.getExpression();
+                if (e == null || !e.isConstant()) {
+                    continue;
+                }
+                Value v = column.convert(session, e.getValue(session));
+                switch (compareType) {
+                case Comparison.EQUAL:
+                case Comparison.EQUAL_NULL_SAFE:
+                    if (equality) {
+                        return statistics.getEqualFraction(session, v);
+                    }
+                    break;
+                case Comparison.BIGGER_EQUAL:
+                case Comparison.BIGGER:
+                    if (!equality && v != ValueNull.INSTANCE) {
+                        min = v;
+                        found = true;
+                    }
+                    break;
+                case Comparison.SMALLER_EQUAL:
+                case Comparison.SMALLER:
+                    if (!equality && v != ValueNull.INSTANCE) {
+                        max = v;
+                        found = true;
+                    }
+                    break;
+                default:
+                }
+            }
+        } catch (DbException ex) {
+            // a value cannot be converted to the data type of the column
+            return -1d;
+        }
+        return found ? statistics.getRangeFraction(session, min, max) : -1d;
+    }
+
     /**
      * Calculate the cost for the given mask as if this index was a typical
      * b-tree range index. This is the estimated cost required to search one
@@ -566,6 +644,9 @@ protected final long getCostRangeIndex(int[] masks, long rowCount, TableFilter[]
         if (masks != null) {
             int i = 0, len = columns.length;
             boolean tryAdditional = false;
+            TableFilter tableFilter = filters == null ? null : filters[filter];
+            // the fraction of rows estimated from column statistics, or -1
+            double fraction = 1d;
             while (i < len) {
                 Column column = columns[i++];
                 int index = column.getColumnId();
@@ -582,6 +663,20 @@ protected final long getCostRangeIndex(int[] masks, long rowCount, TableFilter[]
                         distinctRows = 1;
                     }
                     rowsCost = 2 + Math.max(rowCount / distinctRows, 1);
+                    if (fraction >= 0d) {
+                        double f = getStatisticsFraction(column, tableFilter, true);
+                        if (f >= 0d) {
+                            fraction *= f;
+                            rowsCost = 2 + Math.max((long) (rowCount * fraction), 1);
+                        } else {
+                            fraction = -1d;
+                        }
+                    }
+                } else if ((mask & IndexCondition.RANGE) != 0 && fraction >= 0d
+                        && (fraction = getStatisticsFraction(column, tableFilter, false)) >= 0d) {
+                    rowsCost = 2 + (long) (rowsCost * fraction);
+                    tryAdditional = true;
+                    break;
                 } else if ((mask & IndexCondition.RANGE) == IndexCondition.RANGE) {
                     rowsCost = 2 + rowsCost / 4;
                     tryAdditional = true;
@@ -10,9 +10,11 @@
  */
 public class IndexType {
 
-    private boolean primaryKey, persistent, unique, hash, scan, spatial;
+    private boolean primaryKey, persistent, unique, hash, scan, spatial, minMax;
     private boolean belongsToConstraint;
 
+    private int includedColumnCount;
+
     /**
      * Create a primary key index.
      *
@@ -71,6 +73,20 @@ public static IndexType createNonUnique(boolean persistent, boolean hash,
         return type;
     }
 
+    /**
+     * Create a min/max skip index. Such an index contains the ranges of values
+     * for blocks of rows.
+     *
+     * @param persistent if the index is persistent
+     * @return the index type
+     */
+    public static IndexType createMinMax(boolean persistent) {
+        IndexType type = new IndexType();
+        type.persistent = persistent;
+        type.minMax = true;
+        return type;
+    }
+
     /**
      * Create a scan pseudo-index.
      *
@@ -103,6 +119,25 @@ public boolean getBelongsToConstraint() {
         return belongsToConstraint;
     }
 
+    /**
+     * Sets the number of non-key columns of a non-unique index. These columns
+     * are listed in the INCLUDE clause after the key columns.
+     *
+     * @param includedColumnCount the number of included columns
+     */
+    public void setIncludedColumnCount(int includedColumnCount) {
+        this.includedColumnCount = includedColumnCount;
+    }
+
+    /**
+     * Get the number of non-key columns of a non-unique index.
+     *
+     * @return the number of included columns
+     */
+    public int getIncludedColumnCount() {
+        return includedColumnCount;
+    }
+
     /**
      * Is this a hash index?
      *
@@ -121,6 +156,15 @@ public boolean isSpatial() {
         return spatial;
     }
 
+    /**
+     * Is this a min/max skip index?
+     *
+     * @return true if it is a min/max skip index
+     */
+    public boolean isMinMax() {
+        return minMax;
+    }
+
     /**
      * Is this index persistent?
      *
@@ -170,6 +214,9 @@ public String getSQL() {
             if (spatial) {
                 buff.append("SPATIAL ");
             }
+            if (minMax) {
+                buff.append("MINMAX ");
+            }
             buff.append("INDEX");
         }
         return buff.toString();
@@ -29,6 +29,7 @@
 
 import org.h2.api.ErrorCode;
 import org.h2.command.CommandInterface;
+import org.h2.engine.GeneratedKeysMode;
 import org.h2.expression.ParameterInterface;
 import org.h2.message.DbException;
 import org.h2.message.TraceObject;
@@ -1255,12 +1256,13 @@ public int[] executeBatch() throws SQLException {
                 batchParameters = new ArrayList<>();
             }
             batchIdentities = new MergedResult();
-            int size = batchParameters.size();
-            int[] result = new int[size];
             SQLException exception = new SQLException();
             checkClosed();
+            long[] updateCounts = executeBatchInternal(exception);
+            int size = updateCounts.length;
+            int[] result = new int[size];
             for (int i = 0; i < size; i++) {
-                long updateCount = executeBatchElement(batchParameters.get(i), exception);
+                long updateCount = updateCounts[i];
                 result[i] = updateCount <= Integer.MAX_VALUE ? (int) updateCount : SUCCESS_NO_INFO;
             }
             batchParameters = null;
@@ -1289,13 +1291,9 @@ public long[] executeLargeBatch() throws SQLException {
                 batchParameters = new ArrayList<>();
             }
             batchIdentities = new MergedResult();
-            int size = batchParameters.size();
-            long[] result = new long[size];
             SQLException exception = new SQLException();
             checkClosed();
-            for (int i = 0; i < size; i++) {
-                result[i] = executeBatchElement(batchParameters.get(i), exception);
-            }
+            long[] result = executeBatchInternal(exception);
             batchParameters = null;
             exception = exception.getNextException();
             if (exception != null) {
@@ -1307,6 +1305,42 @@ public long[] executeLargeBatch() throws SQLException {
         }
     }
 
+    private long[] executeBatchInternal(SQLException exception) {
+        int size = batchParameters.size();
+        long[] result;
+        if (GeneratedKeysMode.valueOf(generatedKeysRequest) == GeneratedKeysMode.NONE) {
+            /*
+             * Generated keys are not requested, all parameter sets can be
+             * passed to the command at once, remote commands send them to the
+             * server in one request.
+             */
+            ArrayList<DbException> exceptions = new ArrayList<>();
+            closeOldResultSet();
+            synchronized (session) {
+                try {
+                    setExecutingStatement(command);
+                    result = command.executeBatchUpdate(batchParameters, exceptions);
+                } finally {
+                    setExecutingStatement(null);
+                }
+            }
+            for (long updateCount : result) {
+                if (updateCount != Statement.EXECUTE_FAILED) {
+                    this.updateCount = updateCount;
+                }
+            }
+            for (DbException e : exceptions) {
+                exception.setNextException(logAndConvert(e));
+            }
+        } else {
+            result = new long[size];
+            for (int i = 0; i < size; i++) {
+                result[i] = executeBatchElement(batchParameters.get(i), exception);
+            }
+        }
+        return result;
+    }
+
     private long executeBatchElement(Value[] set, SQLException exception) {
         ArrayList<? extends ParameterInterface> parameters = command.getParameters();
         for (int i = 0, l = set.length; i < l; i++) {
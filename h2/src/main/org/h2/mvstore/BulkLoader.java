@@ -0,0 +1,317 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+
+import org.h2.mvstore.type.DataType;
+
+/**
+ * Builds the tree of an empty map from entries with ascending keys. Full leaf
+ * pages are created from the entries, and full internal pages are created from
+ * the completed pages of the level below, so pages are never copied or split.
+ * <p>
+ * The tree is not visible to readers of the map and is kept in memory until it
+ * is published with {@link #publish()}, which replaces the empty root page of
+ * the map with the root page of the tree. If the loader is not published, the
+ * tree is simply discarded.
+ *
+ * @param <K> the key class
+ * @param <V> the value class
+ */
+public final class BulkLoader<K,V> {
+
+    private final MVMap<K,V> map;
+
+    private final MVStore store;
+
+    private final DataType<K> keyType;
+
+    private final DataType<V> valueType;
+
+    private final int keysPerPage;
+
+    private final int pageSplitSize;
+
+    /**
+     * The entries of the current leaf.
+     */
+    private K[] keys;
+
+    private V[] values;
+
+    private int count;
+
+    private int memory;
+
+    private K lastKey;
+
+    /**
+     * The estimated memory of the completed pages.
+     */
+    private long pageMemory;
+
+    /**
+     * The incomplete internal pages of each level, starting from the level
+     * above the leaves.
+     */
+    private final ArrayList<Level<K,V>> levels = new ArrayList<>();
+
+    /**
+     * The root page of the complete tree, or {@code null} if the loader isn't
+     * finished.
+     */
+    private Page<K,V> root;
+
+    /**
+     * Creates a new bulk loader.
+     *
+     * @param map the map, it must be empty
+     */
+    public BulkLoader(MVMap<K,V> map) {
+        if (map.getRoot().getTotalCount() != 0) {
+            throw DataUtils.newIllegalArgumentException("Map {0} is not empty", map.getName());
+        }
+        this.map = map;
+        store = map.getStore();
+        keyType = map.getKeyType();
+        valueType = map.getValueType();
+        keysPerPage = store.getKeysPerPage();
+        pageSplitSize = store.getPageSplitSize();
+        newLeaf();
+    }
+
+    /**
+     * Add an entry. The key must be larger than the keys of all previously
+     * added entries.
+     *
+     * @param key the key
+     * @param value the value
+     * @throws IllegalArgumentException if the key is not larger than the
+     *             previous key, or the loader is finished
+     */
+    public void add(K key, V value) {
+        if (root != null) {
+            throw DataUtils.newIllegalArgumentException("Bulk load is finished");
+        }
+        if (lastKey != null && map.compare(key, lastKey) <= 0) {
+            throw DataUtils.newIllegalArgumentException(
+                    "Key {0} is not larger than the previous key {1}", key, lastKey);
+        }
+        if (count == keysPerPage || count > 0 && memory > pageSplitSize) {
+            addPage(0, keys[0], createLeaf());
+            newLeaf();
+        }
+        keys[count] = key;
+        values[count++] = value;
+        memory += keyType.getMemory(key) + valueType.getMemory(value);
+        lastKey = key;
+    }
+
+    /**
+     * Get the last added key.
+     *
+     * @return the last key, or {@code null} if nothing was added
+     */
+    public K getLastKey() {
+        return lastKey;
+    }
+
+    /**
+     * Get the estimated memory of the tree.
+     *
+     * @return the estimated memory in bytes
+     */
+    public long getMemory() {
+        return pageMemory + memory;
+    }
+
+    /**
+     * Complete the tree. No more entries can be added after this call.
+     */
+    public void finish() {
+        if (root == null) {
+            root = createRoot();
+        }
+    }
+
+    /**
+     * Get a cursor over the entries of the tree. The loader is finished.
+     *
+     * @return the cursor
+     */
+    public Cursor<K,V> cursor() {
+        finish();
+        return new Cursor<>(new RootReference<>(root, map.getVersion()), null, null);
+    }
+
+    /**
+     * Finish the loader and make the tree visible in the map, if the map is
+     * still empty.
+     *
+     * @return whether the tree was published, {@code false} if the map isn't
+     *         empty
+     */
+    public boolean publish() {
+        finish();
+        if (!map.replaceEmptyRoot(root)) {
+            return false;
+        }
+        store.registerUnsavedMemory((int) Math.min(getMemory(), Integer.MAX_VALUE));
+        return true;
+    }
+
+    private Page<K,V> createLeaf() {
+        return Page.createLeaf(map, Arrays.copyOf(keys, count), Arrays.copyOf(values, count), 0);
+    }
+
+    private void newLeaf() {
+        keys = keyType.createStorage(keysPerPage);
+        values = valueType.createStorage(keysPerPage);
+        count = 0;
+        memory = 0;
+    }
+
+    /**
+     * Add a completed page to the specified level.
+     *
+     * @param levelIndex the index of the level of internal pages
+     * @param firstKey the first key of the page
+     * @param page the page
+     */
+    private void addPage(int levelIndex, K firstKey, Page<K,V> page) {
+        pageMemory += page.getMemory();
+        if (levelIndex == levels.size()) {
+            levels.add(new Level<>(keyType, keysPerPage));
+        }
+        Level<K,V> level = levels.get(levelIndex);
+        if (level.count == keysPerPage || level.count > 1 && level.memory > pageSplitSize) {
+            K levelFirstKey = level.firstKey;
+            Page<K,V> node = level.createNode(map, null, null);
+            level.clear();
+            addPage(levelIndex + 1, levelFirstKey, node);
+        }
+        level.add(firstKey, page, keyType);
+    }
+
+    /**
+     * Create the root page from the remaining entries and the incomplete pages
+     * of each level.
+     *
+     * @return the root page
+     */
+    private Page<K,V> createRoot() {
+        Page<K,V> page = null;
+        K firstKey = null;
+        if (count > 0) {
+            page = createLeaf();
+            firstKey = keys[0];
+            pageMemory += page.getMemory();
+        }
+        memory = 0;
+        for (Level<K,V> level : levels) {
+            if (level.count == 0) {
+                continue;
+            }
+            if (level.count == 1 && page == null) {
+                page = level.children[0];
+            } else {
+                page = level.createNode(map, firstKey, page);
+                pageMemory += page.getMemory();
+            }
+            firstKey = level.firstKey;
+        }
+        levels.clear();
+        return page != null ? page : map.createEmptyLeaf();
+    }
+
+    /**
+     * The incomplete internal page of a level.
+     */
+    private static final class Level<K,V> {
+
+        /**
+         * The first key of the first child.
+         */
+        K firstKey;
+
+        /**
+         * The first keys of children except the first one.
+         */
+        final K[] keys;
+
+        /**
+         * The children. References to children are created for each internal
+         * page, they are cleared once the page is saved.
+         */
+        final Page<K,V>[] children;
+
+        int count;
+
+        long totalCount;
+
+        int memory;
+
+        @SuppressWarnings("unchecked")
+        Level(DataType<K> keyType, int keysPerPage) {
+            keys = keyType.createStorage(keysPerPage);
+            children = new Page[keysPerPage];
+        }
+
+        void add(K key, Page<K,V> page, DataType<K> keyType) {
+            if (count == 0) {
+                firstKey = key;
+            } else {
+                keys[count - 1] = key;
+                memory += keyType.getMemory(key);
+            }
+            children[count++] = page;
+            totalCount += page.getTotalCount();
+        }
+
+        /**
+         * Create an internal page with the children of this level.
+         *
+         * @param map the map
+         * @param lastKey the first key of the additional last child
+         * @param last the additional last child, or {@code null}
+         * @return the page
+         */
+        Page<K,V> createNode(MVMap<K,V> map, K lastKey, Page<K,V> last) {
+            int childCount = count;
+            K[] nodeKeys;
+            Page.PageReference<K,V>[] nodeChildren;
+            long nodeTotalCount = totalCount;
+            if (last != null) {
+                nodeKeys = map.getKeyType().createStorage(childCount);
+                System.arraycopy(keys, 0, nodeKeys, 0, childCount - 1);
+                nodeKeys[childCount - 1] = lastKey;
+                nodeChildren = Page.createRefStorage(childCount + 1);
+                nodeChildren[childCount] = new Page.PageReference<>(last);
+                nodeTotalCount += last.getTotalCount();
+            } else {
+                nodeKeys = Arrays.copyOf(keys, childCount - 1);
+                nodeChildren = Page.createRefStorage(childCount);
+            }
+            for (int i = 0; i < childCount; i++) {
+                nodeChildren[i] = new Page.PageReference<>(children[i]);
+            }
+            return Page.createNode(map, nodeKeys, nodeChildren, nodeTotalCount, 0);
+        }
+
+        void clear() {
+            Arrays.fill(keys, null);
+            Arrays.fill(children, null);
+            firstKey = null;
+            count = 0;
+            totalCount = 0;
+            memory = 0;
+        }
+
+    }
+
+}
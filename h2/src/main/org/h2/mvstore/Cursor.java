@@ -24,6 +24,26 @@
     private V lastValue;
     private Page<K,V> lastPage;
 
+    /**
+     * The number of child pages to read in advance, or 0 if disabled.
+     */
+    private final int readAhead;
+
+    /**
+     * The number of leaf pages reached by sequential traversal.
+     */
+    private int leafCount;
+
+    /**
+     * The parent page with requested read-ahead of child pages.
+     */
+    private Page<K,V> readAheadPage;
+
+    /**
+     * The index of the next child page of the {@link #readAheadPage} that
+     * wasn't requested for read-ahead yet.
+     */
+    private int readAheadIndex;
 
     public Cursor(RootReference<K,V> rootReference, K from, K to) {
         this(rootReference, from, to, false);
@@ -40,6 +60,7 @@ public Cursor(RootReference<K,V> rootReference, K from, K to, boolean reverse) {
         this.cursorPos = traverseDown(lastPage, from, reverse);
         this.to = to;
         this.reverse = reverse;
+        this.readAhead = lastPage.map.store.getReadAhead();
     }
 
     @Override
@@ -61,7 +82,11 @@ public boolean hasNext() {
                 } else {
                     // traverse down to the leaf taking the leftmost path
                     while (!page.isLeaf()) {
+                        Page<K,V> parent = page;
                         page = page.getChildPage(index);
+                        if (readAhead > 0 && page.isLeaf()) {
+                            readAhead(parent, index);
+                        }
                         index = reverse ? upperBound(page) - 1 : 0;
                         if (keeper == null) {
                             cursorPos = new CursorPos<>(page, index, cursorPos);
@@ -172,6 +197,42 @@ static <K,V> CursorPos<K,V> traverseDown(Page<K,V> page, K key, boolean reverse)
         return cursorPos;
     }
 
+    /**
+     * Request the read-ahead of the next child pages when the cursor moves to
+     * the next leaf page sequentially.
+     *
+     * @param parent the parent page
+     * @param index the index of the current leaf page in the parent page
+     */
+    private void readAhead(Page<K,V> parent, int index) {
+        // a short scan may only touch a couple of leaf pages
+        if (++leafCount < 2) {
+            return;
+        }
+        int increment = reverse ? -1 : 1;
+        if (parent != readAheadPage) {
+            readAheadPage = parent;
+            readAheadIndex = index + increment;
+        }
+        // request the next pages when a half of requested pages was visited
+        if ((readAheadIndex - index) * increment > readAhead / 2) {
+            return;
+        }
+        if (reverse) {
+            int from = Math.max(readAheadIndex - readAhead + 1, 0);
+            if (from <= readAheadIndex) {
+                parent.map.store.readAhead(parent, from, readAheadIndex + 1);
+            }
+            readAheadIndex = from - 1;
+        } else {
+            int to = Math.min(readAheadIndex + readAhead, parent.map.getChildPageCount(parent));
+            if (readAheadIndex < to) {
+                parent.map.store.readAhead(parent, readAheadIndex, to);
+            }
+            readAheadIndex = to;
+        }
+    }
+
     private static <K,V> int upperBound(Page<K,V> page) {
         return page.isLeaf() ? page.getKeyCount() : page.map.getChildPageCount(page);
     }
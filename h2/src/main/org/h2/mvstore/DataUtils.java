@@ -139,6 +139,12 @@ public final class DataUtils {
      */
     public static final int PAGE_HAS_PAGE_NO = 8;
 
+    /**
+     * The bit mask for pages compressed with a codec registered in the store.
+     * The id of the codec precedes the compressed data.
+     */
+    public static final int PAGE_COMPRESSED_CODEC = 2 + 16;
+
     /**
      * The maximum length of a variable size int.
      */
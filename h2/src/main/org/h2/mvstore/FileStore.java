@@ -5,13 +5,16 @@
  */
 package org.h2.mvstore;
 
+import java.io.EOFException;
 import java.io.IOException;
 import java.nio.ByteBuffer;
 import java.nio.channels.FileChannel;
 import java.nio.channels.FileLock;
 import java.nio.channels.OverlappingFileLockException;
+import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.atomic.AtomicLong;
 import org.h2.mvstore.cache.FilePathCache;
+import org.h2.store.fs.FileBase;
 import org.h2.store.fs.FilePath;
 import org.h2.store.fs.encrypt.FileEncrypt;
 import org.h2.store.fs.encrypt.FilePathEncrypt;
@@ -100,6 +103,49 @@ public ByteBuffer readFully(long pos, int len) {
         return dst;
     }
 
+    /**
+     * Read from the file asynchronously. If the file supports asynchronous
+     * reads, multiple reads may be outstanding at the same time, otherwise
+     * the data is read synchronously.
+     *
+     * @param pos the read position
+     * @param len the number of bytes to read
+     * @return the future with the byte buffer
+     */
+    public CompletableFuture<ByteBuffer> readFullyAsync(long pos, int len) {
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<>();
+        if (file instanceof FileBase) {
+            readFullyAsync((FileBase) file, pos, ByteBuffer.allocate(len), future);
+        } else {
+            try {
+                future.complete(readFully(pos, len));
+            } catch (MVStoreException e) {
+                future.completeExceptionally(e);
+            }
+        }
+        return future;
+    }
+
+    private void readFullyAsync(FileBase f, long pos, ByteBuffer dst, CompletableFuture<ByteBuffer> future) {
+        f.readAsync(dst, pos).whenComplete((len, e) -> {
+            if (e == null && len < 0) {
+                e = new EOFException();
+            }
+            if (e != null) {
+                future.completeExceptionally(DataUtils.newMVStoreException(DataUtils.ERROR_READING_FAILED,
+                        "Reading from file {0} failed at {1}, read {2}, remaining {3}", f, pos, dst.position(),
+                        dst.remaining(), e));
+            } else if (dst.hasRemaining()) {
+                readFullyAsync(f, pos + len, dst, future);
+            } else {
+                dst.rewind();
+                readCount.incrementAndGet();
+                readBytes.addAndGet(dst.capacity());
+                future.complete(dst);
+            }
+        });
+    }
+
     /**
      * Write to the file.
      *
@@ -50,6 +50,11 @@
     private final DataType<V> valueType;
     private final int keysPerPage;
     private final boolean singleWriter;
+    /**
+     * The id of the page codec registered in the store, or 0 to use the
+     * compression of the store.
+     */
+    private final int pageCodec;
     private final K[] keysBuffer;
     private final V[] valuesBuffer;
 
@@ -79,8 +84,15 @@ protected MVMap(Map<String, Object> config, DataType<K> keyType, DataType<V> val
                 DataUtils.readHexLong(config, "createVersion", 0),
                 new AtomicReference<>(),
                 ((MVStore) config.get("store")).getKeysPerPage(),
-                config.containsKey("singleWriter") && (Boolean) config.get("singleWriter")
+                config.containsKey("singleWriter") && (Boolean) config.get("singleWriter"),
+                DataUtils.readHexInt(config, "pageCodec", 0)
         );
+        if (pageCodec != 0) {
+            if (!store.hasPageCodec(pageCodec)) {
+                throw DataUtils.newIllegalArgumentException("Page codec {0} is not registered", pageCodec);
+            }
+            store.requirePageCodecFormat();
+        }
         setInitialRoot(createEmptyLeaf(), store.getCurrentVersion());
     }
 
@@ -88,17 +100,18 @@ protected MVMap(Map<String, Object> config, DataType<K> keyType, DataType<V> val
     @SuppressWarnings("CopyConstructorMissesField")
     protected MVMap(MVMap<K, V> source) {
         this(source.store, source.keyType, source.valueType, source.id, source.createVersion,
-                new AtomicReference<>(source.root.get()), source.keysPerPage, source.singleWriter);
+                new AtomicReference<>(source.root.get()), source.keysPerPage, source.singleWriter,
+                source.pageCodec);
     }
 
     // meta map constructor
     MVMap(MVStore store, int id, DataType<K> keyType, DataType<V> valueType) {
-        this(store, keyType, valueType, id, 0, new AtomicReference<>(), store.getKeysPerPage(), false);
+        this(store, keyType, valueType, id, 0, new AtomicReference<>(), store.getKeysPerPage(), false, 0);
         setInitialRoot(createEmptyLeaf(), store.getCurrentVersion());
     }
 
     private MVMap(MVStore store, DataType<K> keyType, DataType<V> valueType, int id, long createVersion,
-            AtomicReference<RootReference<K,V>> root, int keysPerPage, boolean singleWriter) {
+            AtomicReference<RootReference<K,V>> root, int keysPerPage, boolean singleWriter, int pageCodec) {
         this.store = store;
         this.id = id;
         this.createVersion = createVersion;
@@ -109,6 +122,7 @@ private MVMap(MVStore store, DataType<K> keyType, DataType<V> valueType, int id,
         this.keysBuffer = singleWriter ? keyType.createStorage(keysPerPage) : null;
         this.valuesBuffer = singleWriter ? valueType.createStorage(keysPerPage) : null;
         this.singleWriter = singleWriter;
+        this.pageCodec = pageCodec;
         this.avgKeySize = keyType.isMemoryEstimationAllowed() ? new AtomicLong() : null;
         this.avgValSize = valueType.isMemoryEstimationAllowed() ? new AtomicLong() : null;
 
@@ -491,6 +505,30 @@ RootReference<K,V> clearIt() {
         }
     }
 
+    /**
+     * Replace the root page of the empty map. This method is used by
+     * {@link BulkLoader}.
+     *
+     * @param rootPage the new root page
+     * @return whether the root page was replaced, {@code false} if the map
+     *         isn't empty
+     */
+    final boolean replaceEmptyRoot(Page<K,V> rootPage) {
+        beforeWrite();
+        RootReference<K,V> rootReference = lockRoot(getRoot(), 1);
+        Page<K,V> newRootPage = rootReference.root;
+        try {
+            if (newRootPage.getTotalCount() != 0) {
+                return false;
+            }
+            store.registerUnsavedMemory(newRootPage.removePage(rootReference.version));
+            newRootPage = rootPage;
+            return true;
+        } finally {
+            unlockRoot(newRootPage);
+        }
+    }
+
     /**
      * Close the map. Accessing the data is still possible (to allow concurrent
      * reads), but it is marked as closed.
@@ -619,6 +657,16 @@ boolean isSingleWriter() {
         return singleWriter;
     }
 
+    /**
+     * Returns the id of the page codec of this map.
+     *
+     * @return the id of the codec, or 0 if the compression of the store is
+     *         used
+     */
+    int getPageCodec() {
+        return pageCodec;
+    }
+
     /**
      * Read a page.
      *
@@ -1107,6 +1155,9 @@ protected String asString(String name) {
         if (type != null) {
             DataUtils.appendMap(buff, "type", type);
         }
+        if (pageCodec != 0) {
+            DataUtils.appendMap(buff, "pageCodec", pageCodec);
+        }
         return buff.toString();
     }
 
@@ -1551,6 +1602,7 @@ public M create(MVStore store, Map<String, Object> config) {
      */
     public static class Builder<K, V> extends BasicBuilder<MVMap<K, V>, K, V> {
         private boolean singleWriter;
+        private int pageCodec;
 
         public Builder() {}
 
@@ -1577,9 +1629,26 @@ public Builder<K,V> singleWriter() {
             return this;
         }
 
+        /**
+         * Set up this Builder to produce MVMap, which compresses its pages
+         * with the specified codec instead of the compression of the store.
+         * The codec must be registered in the store.
+         *
+         * @param id the id of the codec
+         * @return this Builder for chained execution
+         * @see MVStore.Builder#pageCodec(int, java.util.function.Supplier)
+         */
+        public Builder<K,V> pageCodec(int id) {
+            pageCodec = id;
+            return this;
+        }
+
         @Override
         protected MVMap<K, V> create(Map<String, Object> config) {
             config.put("singleWriter", singleWriter);
+            if (pageCodec != 0) {
+                config.put("pageCodec", pageCodec);
+            }
             Object type = config.get("type");
             if(type == null || type.equals("rtree")) {
                 return new MVMap<>(config, getKeyType(), getValueType());
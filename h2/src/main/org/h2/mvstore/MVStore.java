@@ -19,6 +19,7 @@
 import java.util.HashMap;
 import java.util.HashSet;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
 import java.util.LinkedList;
 import java.util.List;
 import java.util.Map;
@@ -26,7 +27,9 @@
 import java.util.Queue;
 import java.util.Set;
 import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
 import java.util.concurrent.ExecutionException;
 import java.util.concurrent.Future;
 import java.util.concurrent.LinkedBlockingQueue;
@@ -38,6 +41,7 @@
 import java.util.concurrent.atomic.AtomicIntegerFieldUpdater;
 import java.util.concurrent.atomic.AtomicLong;
 import java.util.concurrent.atomic.AtomicReference;
+import java.util.concurrent.locks.LockSupport;
 import java.util.concurrent.locks.ReentrantLock;
 import java.util.function.Predicate;
 import java.util.function.Supplier;
@@ -45,6 +49,7 @@
 import org.h2.compress.CompressLZF;
 import org.h2.compress.Compressor;
 import org.h2.mvstore.cache.CacheLongKeyLIRS;
+import org.h2.mvstore.cache.OffHeapPageCache;
 import org.h2.mvstore.type.StringDataType;
 import org.h2.util.MathUtils;
 import org.h2.util.Utils;
@@ -150,6 +155,9 @@ public class MVStore implements AutoCloseable {
     private static final String HDR_BLOCK = "block";
     private static final String HDR_VERSION = "version";
     private static final String HDR_CLEAN = "clean";
+    private static final String HDR_CHECKPOINT = "checkpoint";
+    private static final String HDR_CHECKPOINT_LENGTH = "checkpointLen";
+    private static final String HDR_CHECKPOINT_FLETCHER = "checkpointFletcher";
     private static final String HDR_FLETCHER = "fletcher";
 
     /**
@@ -163,12 +171,19 @@ public class MVStore implements AutoCloseable {
      * The block size (physical sector size) of the disk. The store header is
      * written twice, one copy in each block, to ensure it survives a crash.
      */
-    static final int BLOCK_SIZE = 4 * 1024;
+    public static final int BLOCK_SIZE = 4 * 1024;
 
     private static final int FORMAT_WRITE_MIN = 2;
-    private static final int FORMAT_WRITE_MAX = 2;
+    private static final int FORMAT_WRITE_MAX = 3;
     private static final int FORMAT_READ_MIN = 2;
-    private static final int FORMAT_READ_MAX = 2;
+    private static final int FORMAT_READ_MAX = 3;
+
+    /**
+     * The format of files with pages compressed with a page codec. Older
+     * versions would read such pages as pages compressed with LZF, so the read
+     * format is raised when a map with a page codec is opened.
+     */
+    private static final int FORMAT_PAGE_CODEC = 3;
 
     /**
      * Store is open.
@@ -194,6 +209,34 @@ public class MVStore implements AutoCloseable {
 
     private static final int PIPE_LENGTH = 1;
 
+    /**
+     * The minimal number of pages for each thread of parallel page
+     * serialization.
+     */
+    private static final int MIN_PAGES_PER_SERIALIZATION_THREAD = 32;
+
+    /**
+     * The minimal number of chunks for a checkpoint of chunk metadata.
+     * Metadata of fewer chunks is read fast enough from the layout map.
+     */
+    private static final int MIN_CHECKPOINT_CHUNKS = 256;
+
+    /**
+     * The maximum number of bytes read at once by the read-ahead.
+     */
+    private static final int MAX_READ_AHEAD_LENGTH = 1024 * 1024;
+
+    /**
+     * The maximum number of pending read-ahead requests, further requests are
+     * discarded.
+     */
+    private static final int MAX_READ_AHEAD_REQUESTS = 16;
+
+    /**
+     * The maximum number of outstanding file reads of the read-ahead.
+     */
+    private static final int MAX_READ_AHEAD_READS = 8;
+
 
     /**
      * Lock which governs access to major store operations: store(), close(), ...
@@ -238,6 +281,13 @@ public class MVStore implements AutoCloseable {
      */
     private final CacheLongKeyLIRS<Page<?,?>> cache;
 
+    /**
+     * The second level cache of serialized pages outside of the heap, or
+     * {@code null} if not used. Pages that are evicted from the page cache can
+     * be deserialized again without reading from the file.
+     */
+    private final OffHeapPageCache offHeapCache;
+
     /**
      * Cache for chunks "Table of Content" used to translate page's
      * sequential number within containing chunk into byte position
@@ -284,6 +334,12 @@ public class MVStore implements AutoCloseable {
 
     private int lastChunkId;
 
+    /**
+     * The id of the last chunk when the checkpoint of chunk metadata was
+     * written.
+     */
+    private int checkpointChunkId;
+
     private int versionsToKeep = 5;
 
     /**
@@ -296,6 +352,54 @@ public class MVStore implements AutoCloseable {
 
     private Compressor compressorHigh;
 
+    /**
+     * The compressors that are not currently used by threads that read, store,
+     * or serialize pages.
+     */
+    private final Queue<PageCompressors> pageCompressorsPool = new ConcurrentLinkedQueue<>();
+
+    /**
+     * The factories of registered page codecs by their ids.
+     */
+    private final Map<Integer, Supplier<? extends Compressor>> pageCodecs;
+
+    /**
+     * The number of threads that serialize and compress changed pages before
+     * they are written to a chunk.
+     */
+    private final int serializationThreads;
+
+    /**
+     * The executor for additional threads for serialization of pages, or
+     * {@code null} if not started yet.
+     */
+    private ThreadPoolExecutor pageSerializationExecutor;
+
+    /**
+     * The number of child pages that are read in advance by cursors during
+     * sequential traversal, or 0 if disabled.
+     */
+    private final int readAhead;
+
+    /**
+     * The executor for the read-ahead of pages, or {@code null} if not started
+     * yet.
+     */
+    private volatile ThreadPoolExecutor readAheadExecutor;
+
+    /**
+     * The outstanding reads of the read-ahead by positions of their pages.
+     * Threads that need one of these pages wait for its read instead of
+     * reading the page again.
+     */
+    private final ConcurrentHashMap<Long, PendingRead> pendingReads = new ConcurrentHashMap<>();
+
+    /**
+     * The time spent in phases of reading of the store header and the chunk
+     * metadata, in nanoseconds.
+     */
+    private volatile Map<String, Long> startupTimes = Collections.emptyMap();
+
     private final boolean recoveryMode;
 
     public final UncaughtExceptionHandler backgroundExceptionHandler;
@@ -354,9 +458,61 @@ public class MVStore implements AutoCloseable {
      */
     private int autoCommitDelay;
 
+    /**
+     * The sequence number of the last request of {@link #commit()}.
+     */
+    private final AtomicLong commitRequests = new AtomicLong();
+
+    /**
+     * The last request of {@link #commit()} whose changes are known to be
+     * stored.
+     */
+    private volatile long storedCommitRequest;
+
+    /**
+     * The number of threads inside of {@link #commit()}.
+     */
+    private final AtomicInteger pendingCommits = new AtomicInteger();
+
+    /**
+     * The maximum delay in microseconds to wait for other concurrent commits.
+     */
+    private volatile int groupCommitDelay;
+
     private final int autoCompactFillRate;
     private long autoCompactLastFileOpCount;
 
+    /**
+     * The maximum number of bytes per second written by the background
+     * compaction, or 0 if it is not limited.
+     */
+    private final long autoCompactBandwidth;
+
+    /**
+     * The number of bytes the background compaction may write now.
+     */
+    private long compactAllowance;
+
+    /**
+     * The time when {@link #compactAllowance} was updated.
+     */
+    private long compactAllowanceTime;
+
+    /**
+     * The number of pages rewritten by the compaction.
+     */
+    private volatile long compactRewrittenPageCount;
+
+    /**
+     * The estimated number of bytes in pages rewritten by the compaction.
+     */
+    private volatile long compactRewrittenBytes;
+
+    /**
+     * The number of bytes written while the compaction moved chunks.
+     */
+    private volatile long compactMovedBytes;
+
     private volatile MVStoreException panicException;
 
     private long lastTimeAbsolute;
@@ -376,6 +532,12 @@ public class MVStore implements AutoCloseable {
     MVStore(Map<String, Object> config) {
         recoveryMode = config.containsKey("recoveryMode");
         compressionLevel = DataUtils.getConfigParam(config, "compress", 0);
+        serializationThreads = Math.max(DataUtils.getConfigParam(config, "serializationThreads", 1), 1);
+        readAhead = Math.max(DataUtils.getConfigParam(config, "readAhead", 0), 0);
+        @SuppressWarnings("unchecked")
+        Map<Integer, Supplier<? extends Compressor>> codecs =
+                (Map<Integer, Supplier<? extends Compressor>>) config.get("pageCodecs");
+        pageCodecs = codecs != null ? codecs : Collections.emptyMap();
         String fileName = (String) config.get("fileName");
         FileStore fileStore = (FileStore) config.get("fileStore");
         if (fileStore == null) {
@@ -403,6 +565,7 @@ public class MVStore implements AutoCloseable {
                 if (o != null) {
                     cc.segmentCount = (Integer)o;
                 }
+                cc.readBufferSize = DataUtils.getConfigParam(config, "cacheReadBufferSize", 16);
             }
             cc2 = new CacheLongKeyLIRS.Config();
             cc2.maxMemory = 1024L * 1024L;
@@ -414,6 +577,10 @@ public class MVStore implements AutoCloseable {
             cache = null;
         }
         chunksToC = cc2 == null ? null : new CacheLongKeyLIRS<>(cc2);
+        int offHeapMb = this.fileStore == null ? 0 : DataUtils.getConfigParam(config, "offHeapCacheSize", 0);
+        offHeapCache = offHeapMb > 0
+                ? new OffHeapPageCache(offHeapMb * 1024L * 1024L, config.containsKey("compressOffHeapCache"))
+                : null;
 
         pgSplitSize = DataUtils.getConfigParam(config, "pageSplitSize", pgSplitSize);
         // Make sure pages will fit into cache
@@ -432,6 +599,7 @@ public class MVStore implements AutoCloseable {
             kb = DataUtils.getConfigParam(config, "autoCommitBufferSize", kb);
             autoCommitMemory = kb * 1024;
             autoCompactFillRate = DataUtils.getConfigParam(config, "autoCompactFillRate", 90);
+            autoCompactBandwidth = DataUtils.getConfigParam(config, "autoCompactBandwidth", 0) * 1024L;
             char[] encryptionKey = (char[]) config.get("encryptionKey");
             // there is no need to lock store here, since it is not opened (or even created) yet,
             // just to make some assertions happy, when they ensure single-threaded access
@@ -447,7 +615,9 @@ public class MVStore implements AutoCloseable {
                         creationTime = getTimeAbsolute();
                         storeHeader.put(HDR_H, 2);
                         storeHeader.put(HDR_BLOCK_SIZE, BLOCK_SIZE);
-                        storeHeader.put(HDR_FORMAT, FORMAT_WRITE_MAX);
+                        // the format is raised only when a map with a page
+                        // codec is opened
+                        storeHeader.put(HDR_FORMAT, FORMAT_WRITE_MIN);
                         storeHeader.put(HDR_CREATED, creationTime);
                         setLastChunk(null);
                         writeStoreHeader();
@@ -478,6 +648,7 @@ public class MVStore implements AutoCloseable {
         } else {
             autoCommitMemory = 0;
             autoCompactFillRate = 0;
+            autoCompactBandwidth = 0;
             meta = openMetaMap();
         }
         onVersionChange(currentVersion);
@@ -821,6 +992,8 @@ private void markMetaChanged() {
     }
 
     private void readStoreHeader() {
+        HashMap<String, Long> times = new LinkedHashMap<>();
+        long time = System.nanoTime();
         Chunk newest = null;
         boolean assumeCleanShutdown = true;
         boolean validStoreHeader = false;
@@ -891,6 +1064,12 @@ private void readStoreHeader() {
                     "The read format {0} is smaller than the supported format {1}",
                     format, FORMAT_READ_MIN);
         }
+        // the checkpoint is only valid until the next chunk is stored
+        long checkpointBlock = DataUtils.readHexLong(storeHeader, HDR_CHECKPOINT, 0);
+        int checkpointLength = DataUtils.readHexInt(storeHeader, HDR_CHECKPOINT_LENGTH, 0);
+        int checkpointFletcher = DataUtils.readHexInt(storeHeader, HDR_CHECKPOINT_FLETCHER, 0);
+        removeChunkCheckpoint();
+        time = recordStartupTime(times, "header", time);
 
         assumeCleanShutdown = assumeCleanShutdown && newest != null && !recoveryMode;
         if (assumeCleanShutdown) {
@@ -955,25 +1134,41 @@ private void readStoreHeader() {
                     newest = test;
                 }
             }
+            time = recordStartupTime(times, "recovery", time);
         }
 
+        String[] checkpoint = recoveryMode ? null
+                : readChunkCheckpoint(checkpointBlock, checkpointLength, checkpointFletcher);
+        boolean checkpointLoaded = false;
         if (assumeCleanShutdown) {
             // quickly check latest 20 chunks referenced in meta table
             Queue<Chunk> chunksToVerify = new PriorityQueue<>(20, Collections.reverseOrder(chunkComparator));
             try {
                 setLastChunk(newest);
-                // load the chunk metadata: although meta's root page resides in the lastChunk,
-                // traversing meta map might recursively load another chunk(s)
-                Cursor<String, String> cursor = layout.cursor(DataUtils.META_CHUNK);
-                while (cursor.hasNext() && cursor.next().startsWith(DataUtils.META_CHUNK)) {
-                    Chunk c = Chunk.fromString(cursor.getValue());
-                    assert c.version <= currentVersion;
-                    // might be there already, due to meta traversal
-                    // see readPage() ... getChunkIfFound()
-                    chunks.putIfAbsent(c.id, c);
-                    chunksToVerify.offer(c);
-                    if (chunksToVerify.size() == 20) {
-                        chunksToVerify.poll();
+                checkpointLoaded = isCheckpointOf(checkpoint, newest);
+                if (checkpointLoaded) {
+                    for (String line : checkpoint) {
+                        Chunk c = Chunk.fromString(line);
+                        chunks.putIfAbsent(c.id, c);
+                        chunksToVerify.offer(c);
+                        if (chunksToVerify.size() == 20) {
+                            chunksToVerify.poll();
+                        }
+                    }
+                } else {
+                    // load the chunk metadata: although meta's root page resides in the lastChunk,
+                    // traversing meta map might recursively load another chunk(s)
+                    Cursor<String, String> cursor = layout.cursor(DataUtils.META_CHUNK);
+                    while (cursor.hasNext() && cursor.next().startsWith(DataUtils.META_CHUNK)) {
+                        Chunk c = Chunk.fromString(cursor.getValue());
+                        assert c.version <= currentVersion;
+                        // might be there already, due to meta traversal
+                        // see readPage() ... getChunkIfFound()
+                        chunks.putIfAbsent(c.id, c);
+                        chunksToVerify.offer(c);
+                        if (chunksToVerify.size() == 20) {
+                            chunksToVerify.poll();
+                        }
                     }
                 }
                 Chunk c;
@@ -986,7 +1181,9 @@ private void readStoreHeader() {
                 }
             } catch(MVStoreException ignored) {
                 assumeCleanShutdown = false;
+                checkpointLoaded = false;
             }
+            time = recordStartupTime(times, checkpointLoaded ? "checkpoint" : "layout", time);
         }
 
         if (!assumeCleanShutdown) {
@@ -1005,7 +1202,7 @@ private void readStoreHeader() {
                     validChunksById.put(chunk.id, chunk);
                 }
                 quickRecovery = findLastChunkWithCompleteValidChunkSet(lastChunkCandidates, validChunksByLocation,
-                        validChunksById, false);
+                        validChunksById, false, checkpoint);
             }
 
             if (!quickRecovery) {
@@ -1027,13 +1224,17 @@ private void readStoreHeader() {
                     validChunksById.put(chunk.id, chunk);
                 }
                 if (!findLastChunkWithCompleteValidChunkSet(lastChunkCandidates, validChunksByLocation,
-                        validChunksById, true) && lastChunk != null) {
+                        validChunksById, true, checkpoint) && lastChunk != null) {
                     throw DataUtils.newMVStoreException(
                             DataUtils.ERROR_FILE_CORRUPT,
                             "File is corrupted - unable to recover a valid set of chunks");
 
                 }
             }
+            // the chunk metadata was loaded from the checkpoint if it was
+            // written after the last valid chunk
+            checkpointLoaded = isCheckpointOf(checkpoint, lastChunk);
+            time = recordStartupTime(times, "recovery", time);
         }
 
         fileStore.clear();
@@ -1048,7 +1249,131 @@ private void readStoreHeader() {
                 deadChunks.offer(c);
             }
         }
+        long lengthInUse = fileStore.getFileLengthInUse();
+        if (checkpointLoaded && !fileStore.isReadOnly() && fileStore.size() > lengthInUse) {
+            // remove the checkpoint, an interrupted write of a new chunk after
+            // it would make the search for the last chunk slower
+            fileStore.truncate(lengthInUse);
+        }
         assert validateFileLength("on open");
+        recordStartupTime(times, "freeSpace", time);
+        startupTimes = Collections.unmodifiableMap(times);
+    }
+
+    private static long recordStartupTime(HashMap<String, Long> times, String phase, long start) {
+        long now = System.nanoTime();
+        times.merge(phase, now - start, Long::sum);
+        return now;
+    }
+
+    /**
+     * Read the checkpoint of chunk metadata.
+     *
+     * @param block the first block of the checkpoint, or 0 if there is none
+     * @param length the length of the checkpoint in bytes
+     * @param fletcher the checksum of the checkpoint
+     * @return the metadata of chunks, the last chunk first, or {@code null}
+     *         if there is no valid checkpoint
+     */
+    private String[] readChunkCheckpoint(long block, int length, int fletcher) {
+        if (block < 2 || length <= 0 || block * BLOCK_SIZE + length > fileStore.size()) {
+            return null;
+        }
+        try {
+            byte[] bytes = new byte[length];
+            fileStore.readFully(block * BLOCK_SIZE, length).get(bytes);
+            if (DataUtils.getFletcher32(bytes, 0, length) != fletcher) {
+                return null;
+            }
+            return new String(bytes, StandardCharsets.ISO_8859_1).split("\n");
+        } catch (Exception e) {
+            return null;
+        }
+    }
+
+    /**
+     * Check whether the checkpoint was written when the specified chunk was
+     * the last one. Only such checkpoint contains the same metadata as the
+     * layout map of this chunk.
+     *
+     * @param checkpoint the checkpoint, or {@code null}
+     * @param last the last chunk, or {@code null}
+     * @return whether the checkpoint can be used instead of the layout map
+     */
+    private static boolean isCheckpointOf(String[] checkpoint, Chunk last) {
+        if (checkpoint == null || last == null) {
+            return false;
+        }
+        try {
+            Chunk c = Chunk.fromString(checkpoint[0]);
+            return c.id == last.id && c.version == last.version && c.block == last.block;
+        } catch (MVStoreException e) {
+            return false;
+        }
+    }
+
+    /**
+     * Write the metadata of all chunks after the end of the used space of the
+     * file, so it can be loaded with a single read when the store is opened.
+     * The location is stored in the store header. This space is not marked as
+     * used and may be overwritten by new chunks, the checkpoint is only used
+     * if no chunks were stored after it.
+     */
+    private void writeChunkCheckpoint() {
+        Chunk last = lastChunk;
+        if (chunks.size() < MIN_CHECKPOINT_CHUNKS || last == null) {
+            return;
+        }
+        StringBuilder buff = new StringBuilder();
+        buff.append(last.asString()).append('\n');
+        for (Chunk c : chunks.values()) {
+            if (c != last) {
+                buff.append(c.asString()).append('\n');
+            }
+        }
+        byte[] bytes = buff.toString().getBytes(StandardCharsets.ISO_8859_1);
+        long block = (getFileLengthInUse() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        ByteBuffer data = ByteBuffer.allocate(MathUtils.roundUpInt(bytes.length, BLOCK_SIZE));
+        data.put(bytes);
+        data.rewind();
+        write(block * BLOCK_SIZE, data);
+        storeHeader.put(HDR_CHECKPOINT, block);
+        storeHeader.put(HDR_CHECKPOINT_LENGTH, bytes.length);
+        storeHeader.put(HDR_CHECKPOINT_FLETCHER, DataUtils.getFletcher32(bytes, 0, bytes.length));
+        checkpointChunkId = last.id;
+    }
+
+    private void removeChunkCheckpoint() {
+        storeHeader.remove(HDR_CHECKPOINT);
+        storeHeader.remove(HDR_CHECKPOINT_LENGTH);
+        storeHeader.remove(HDR_CHECKPOINT_FLETCHER);
+    }
+
+    /**
+     * Write the checkpoint of chunk metadata and the store header if the store
+     * is idle and chunks were stored since the last checkpoint, so it can be
+     * used even if the store isn't closed properly. Called by the background
+     * thread.
+     */
+    private void writeChunkCheckpointIfIdle() throws InterruptedException {
+        Chunk last = lastChunk;
+        if (last == null || last.id == checkpointChunkId || chunks.size() < MIN_CHECKPOINT_CHUNKS
+                || !isIdle() || !storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
+            return;
+        }
+        try {
+            if (!hasUnsavedChanges()) {
+                saveChunkLock.lock();
+                try {
+                    writeChunkCheckpoint();
+                    writeStoreHeader();
+                } finally {
+                    saveChunkLock.unlock();
+                }
+            }
+        } finally {
+            storeLock.unlock();
+        }
     }
 
     private MVStoreException getUnsupportedWriteFormatException(long format, int expectedFormat, String s) {
@@ -1062,7 +1387,7 @@ private MVStoreException getUnsupportedWriteFormatException(long format, int exp
     private boolean findLastChunkWithCompleteValidChunkSet(Chunk[] lastChunkCandidates,
             Map<Long, Chunk> validChunksByLocation,
             Map<Integer, Chunk> validChunksById,
-            boolean afterFullScan) {
+            boolean afterFullScan, String[] checkpoint) {
         // Try candidates for "last chunk" in order from newest to oldest
         // until suitable is found. Suitable one should have meta map
         // where all chunk references point to valid locations.
@@ -1070,48 +1395,25 @@ private boolean findLastChunkWithCompleteValidChunkSet(Chunk[] lastChunkCandidat
             boolean verified = true;
             try {
                 setLastChunk(chunk);
-                // load the chunk metadata: although meta's root page resides in the lastChunk,
-                // traversing meta map might recursively load another chunk(s)
-                Cursor<String, String> cursor = layout.cursor(DataUtils.META_CHUNK);
-                while (cursor.hasNext() && cursor.next().startsWith(DataUtils.META_CHUNK)) {
-                    Chunk c = Chunk.fromString(cursor.getValue());
-                    assert c.version <= currentVersion;
-                    // might be there already, due to meta traversal
-                    // see readPage() ... getChunkIfFound()
-                    Chunk test = chunks.putIfAbsent(c.id, c);
-                    if (test != null) {
-                        c = test;
-                    }
-                    assert chunks.get(c.id) == c;
-                    if ((test = validChunksByLocation.get(c.block)) == null || test.id != c.id) {
-                        if ((test = validChunksById.get(c.id)) != null) {
-                            // We do not have a valid chunk at that location,
-                            // but there is a copy of same chunk from original
-                            // location.
-                            // Chunk header at original location does not have
-                            // any dynamic (occupancy) metadata, so it can't be
-                            // used here as is, re-point our chunk to original
-                            // location instead.
-                            c.block = test.block;
-                        } else if (c.isLive() && (afterFullScan || readChunkHeaderAndFooter(c.block, c.id) == null)) {
-                            // chunk reference is invalid
-                            // this "last chunk" candidate is not suitable
+                if (isCheckpointOf(checkpoint, chunk)) {
+                    // the checkpoint has the same chunk metadata as the
+                    // layout map of this chunk
+                    for (String line : checkpoint) {
+                        if (!addReferencedChunk(Chunk.fromString(line), validChunksByLocation, validChunksById,
+                                afterFullScan)) {
                             verified = false;
                             break;
                         }
                     }
-                    if (!c.isLive()) {
-                        // we can just remove entry from meta, referencing to this chunk,
-                        // but store maybe R/O, and it's not properly started yet,
-                        // so lets make this chunk "dead" and taking no space,
-                        // and it will be automatically removed later.
-                        c.block = Long.MAX_VALUE;
-                        c.len = Integer.MAX_VALUE;
-                        if (c.unused == 0) {
-                            c.unused = creationTime;
-                        }
-                        if (c.unusedAtVersion == 0) {
-                            c.unusedAtVersion = INITIAL_VERSION;
+                } else {
+                    // load the chunk metadata: although meta's root page resides in the lastChunk,
+                    // traversing meta map might recursively load another chunk(s)
+                    Cursor<String, String> cursor = layout.cursor(DataUtils.META_CHUNK);
+                    while (cursor.hasNext() && cursor.next().startsWith(DataUtils.META_CHUNK)) {
+                        if (!addReferencedChunk(Chunk.fromString(cursor.getValue()), validChunksByLocation,
+                                validChunksById, afterFullScan)) {
+                            verified = false;
+                            break;
                         }
                     }
                 }
@@ -1125,6 +1427,59 @@ private boolean findLastChunkWithCompleteValidChunkSet(Chunk[] lastChunkCandidat
         return false;
     }
 
+    /**
+     * Add a chunk referenced by the candidate for the last chunk, and check
+     * that the reference points to a valid location.
+     *
+     * @param c the referenced chunk
+     * @param validChunksByLocation the valid chunks by their blocks
+     * @param validChunksById the valid chunks by their ids
+     * @param afterFullScan whether all valid chunks were found by a full scan
+     * @return whether the reference is valid
+     */
+    private boolean addReferencedChunk(Chunk c, Map<Long, Chunk> validChunksByLocation,
+            Map<Integer, Chunk> validChunksById, boolean afterFullScan) {
+        assert c.version <= currentVersion;
+        // might be there already, due to meta traversal
+        // see readPage() ... getChunkIfFound()
+        Chunk test = chunks.putIfAbsent(c.id, c);
+        if (test != null) {
+            c = test;
+        }
+        assert chunks.get(c.id) == c;
+        if ((test = validChunksByLocation.get(c.block)) == null || test.id != c.id) {
+            if ((test = validChunksById.get(c.id)) != null) {
+                // We do not have a valid chunk at that location,
+                // but there is a copy of same chunk from original
+                // location.
+                // Chunk header at original location does not have
+                // any dynamic (occupancy) metadata, so it can't be
+                // used here as is, re-point our chunk to original
+                // location instead.
+                c.block = test.block;
+            } else if (c.isLive() && (afterFullScan || readChunkHeaderAndFooter(c.block, c.id) == null)) {
+                // chunk reference is invalid
+                // this "last chunk" candidate is not suitable
+                return false;
+            }
+        }
+        if (!c.isLive()) {
+            // we can just remove entry from meta, referencing to this chunk,
+            // but store maybe R/O, and it's not properly started yet,
+            // so lets make this chunk "dead" and taking no space,
+            // and it will be automatically removed later.
+            c.block = Long.MAX_VALUE;
+            c.len = Integer.MAX_VALUE;
+            if (c.unused == 0) {
+                c.unused = creationTime;
+            }
+            if (c.unusedAtVersion == 0) {
+                c.unusedAtVersion = INITIAL_VERSION;
+            }
+        }
+        return true;
+    }
+
     private void setLastChunk(Chunk last) {
         chunks.clear();
         lastChunk = last;
@@ -1321,6 +1676,7 @@ private void closeStore(boolean normalShutdown, int allowedCompactionTime) {
                                 saveChunkLock.lock();
                                 try {
                                     shrinkFileIfPossible(0);
+                                    writeChunkCheckpoint();
                                     storeHeader.put(HDR_CLEAN, 1);
                                     writeStoreHeader();
                                     sync();
@@ -1346,7 +1702,13 @@ private void closeStore(boolean normalShutdown, int allowedCompactionTime) {
                             }
                         }
                     } finally {
+                        shutdownExecutor(pageSerializationExecutor);
+                        pageSerializationExecutor = null;
+                        shutdownExecutor(readAheadExecutor);
+                        readAheadExecutor = null;
+                        pendingReads.clear();
                         state = STATE_CLOSED;
+                        pageCompressorsPool.clear();
                     }
                 }
             } finally {
@@ -1449,12 +1811,41 @@ private long tryCommit(Predicate<MVStore> check) {
      * when enough changes have accumulated. However, it may still be called to
      * flush all changes to disk.
      * <p>
-     * At most one store operation may run at any time.
+     * At most one store operation may run at any time. Concurrent
+     * invocations of this method are combined: if a store operation was
+     * started after this method was invoked, this method returns after
+     * completion of that operation without storing the data again.
      *
      * @return the new version (incremented if there were changes)
      */
     public long commit() {
-        return commit(x -> true);
+        if (storeLock.isHeldByCurrentThread()) {
+            return commit(x -> true);
+        }
+        long request = commitRequests.incrementAndGet();
+        pendingCommits.incrementAndGet();
+        try {
+            storeLock.lock();
+            try {
+                if (storedCommitRequest < request) {
+                    int delay = groupCommitDelay;
+                    if (delay > 0 && pendingCommits.get() > 1) {
+                        // let other concurrent commits join this one
+                        LockSupport.parkNanos(delay * 1_000L);
+                    }
+                    // all changes of requests up to this one are visible
+                    // to the store operation
+                    long lastRequest = commitRequests.get();
+                    store(true);
+                    storedCommitRequest = lastRequest;
+                }
+            } finally {
+                unlockAndCheckPanicCondition();
+            }
+        } finally {
+            pendingCommits.decrementAndGet();
+        }
+        return currentVersion;
     }
 
     private long commit(Predicate<MVStore> check) {
@@ -1659,6 +2050,9 @@ private void serializeToBuffer(WriteBuffer buff, ArrayList<Page<?, ?>> changed,
         buff.position(headerLength);
 
         long version = c.version;
+        if (serializationThreads > 1) {
+            prepareUnsavedPages(changed);
+        }
         List<Long> toc = new ArrayList<>();
         for (Page<?,?> p : changed) {
             String key = MVMap.getMapRootKey(p.getMapId());
@@ -1741,6 +2135,87 @@ private void serializeToBuffer(WriteBuffer buff, ArrayList<Page<?, ?>> changed,
         }
     }
 
+    /**
+     * Serialize and compress the content of unsaved pages of changed maps with
+     * multiple threads. Positions of pages and references to child pages are
+     * not known yet, so they are written later by a single thread.
+     *
+     * @param changed the roots of changed maps
+     */
+    private void prepareUnsavedPages(ArrayList<Page<?,?>> changed) {
+        ArrayList<Page<?,?>> pages = new ArrayList<>();
+        for (Page<?,?> p : changed) {
+            if (p.getTotalCount() != 0) {
+                p.collectUnsavedRecursive(pages);
+            }
+        }
+        int size = pages.size();
+        int count = Math.min(serializationThreads, size / MIN_PAGES_PER_SERIALIZATION_THREAD);
+        if (count <= 1) {
+            return;
+        }
+        ThreadPoolExecutor executor = pageSerializationExecutor;
+        if (executor == null) {
+            pageSerializationExecutor = executor = new ThreadPoolExecutor(serializationThreads - 1,
+                    serializationThreads - 1, 0L, TimeUnit.MILLISECONDS, new LinkedBlockingQueue<>(), r -> {
+                        Thread thread = new Thread(r, "H2-page-serialization");
+                        thread.setDaemon(true);
+                        return thread;
+                    });
+        }
+        Future<?>[] futures = new Future<?>[count];
+        for (int i = 1; i < count; i++) {
+            int first = i;
+            futures[i] = executor.submit(() -> prepareUnsavedPages(pages, first, count, new WriteBuffer()));
+        }
+        // the current thread serializes its own part of pages
+        Throwable failure = null;
+        try {
+            WriteBuffer buff = getWriteBuffer();
+            prepareUnsavedPages(pages, 0, count, buff);
+            releaseWriteBuffer(buff);
+        } catch (Throwable e) {
+            failure = e;
+        }
+        // other threads may still use the pages, wait for all of them even
+        // if some part has failed
+        boolean interrupted = false;
+        for (int i = 1; i < count; i++) {
+            for (;;) {
+                try {
+                    futures[i].get();
+                } catch (InterruptedException e) {
+                    interrupted = true;
+                    continue;
+                } catch (ExecutionException e) {
+                    if (failure == null) {
+                        failure = e.getCause();
+                    }
+                }
+                break;
+            }
+        }
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+        if (failure != null) {
+            if (failure instanceof RuntimeException) {
+                throw (RuntimeException) failure;
+            } else if (failure instanceof Error) {
+                throw (Error) failure;
+            }
+            throw DataUtils.newMVStoreException(DataUtils.ERROR_INTERNAL, "{0}", failure.toString(), failure);
+        }
+    }
+
+    private void prepareUnsavedPages(ArrayList<Page<?,?>> pages, int first, int step, WriteBuffer buff) {
+        PageCompressors compressors = acquirePageCompressors();
+        for (int i = first, size = pages.size(); i < size; i += step) {
+            pages.get(i).prepareWrite(buff, compressors);
+        }
+        releasePageCompressors(compressors);
+    }
+
     private void storeBuffer(Chunk c, WriteBuffer buff, ArrayList<Page<?,?>> changed) {
         saveChunkLock.lock();
         try {
@@ -1749,6 +2224,8 @@ private void storeBuffer(Chunk c, WriteBuffer buff, ArrayList<Page<?,?>> changed
             write(filePos, buff.getBuffer());
             releaseWriteBuffer(buff);
 
+            // the checkpoint is not valid after a new chunk
+            removeChunkCheckpoint();
             // end of the used space is not necessarily the end of the file
             boolean storeAtEndOfFile = filePos + buff.limit() >= fileStore.size();
             boolean writeStoreHeader = isWriteStoreHeader(c, storeAtEndOfFile);
@@ -2313,7 +2790,7 @@ public boolean compact(int targetFillRate, int write) {
                 try {
                     if (storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
                         try {
-                            return rewriteChunks(write, 100);
+                            return rewriteChunks(write, 100, false);
                         } finally {
                             storeLock.unlock();
                         }
@@ -2326,16 +2803,26 @@ public boolean compact(int targetFillRate, int write) {
         return false;
     }
 
-    private boolean rewriteChunks(int writeLimit, int targetFillRate) {
+    /**
+     * Re-write live pages of chunks with a low fill rate.
+     *
+     * @param writeLimit the approximate number of bytes to re-write
+     * @param targetFillRate only chunks with a lower fill rate are re-written
+     * @param incremental whether only a part of a chunk may be re-written if
+     *            its live pages don't fit into the limit
+     * @return whether any pages were re-written
+     */
+    private boolean rewriteChunks(int writeLimit, int targetFillRate, boolean incremental) {
         serializationLock.lock();
         try {
             TxCounter txCounter = registerVersionUsage();
             try {
                 acceptChunkOccupancyChanges(getTimeSinceCreation(), currentVersion);
-                Iterable<Chunk> old = findOldChunks(writeLimit, targetFillRate);
+                Iterable<Chunk> old = findOldChunks(writeLimit, targetFillRate, incremental);
                 if (old != null) {
                     HashSet<Integer> idSet = createIdSet(old);
-                    return !idSet.isEmpty() && compactRewrite(idSet) > 0;
+                    return !idSet.isEmpty()
+                            && compactRewrite(idSet, incremental ? writeLimit : Long.MAX_VALUE) > 0;
                 }
             } finally {
                 deregisterVersionUsage(txCounter);
@@ -2378,6 +2865,54 @@ private int getChunksFillRate(boolean all) {
         return fillRate;
     }
 
+    /**
+     * Get the number of live bytes in chunks that should be re-written by the
+     * automatic compaction. This value decreases while the compaction
+     * progresses.
+     *
+     * @return the number of bytes
+     */
+    public long getCompactPendingBytes() {
+        long pendingBytes = 0;
+        long time = getTimeSinceCreation();
+        int targetFillRate = autoCompactFillRate;
+        for (Chunk c : chunks.values()) {
+            if (isRewritable(c, time) && c.getFillRate() < targetFillRate) {
+                pendingBytes += c.maxLenLive;
+            }
+        }
+        return pendingBytes;
+    }
+
+    /**
+     * Get the number of pages re-written by the compaction.
+     *
+     * @return the number of pages
+     */
+    public long getCompactRewrittenPageCount() {
+        return compactRewrittenPageCount;
+    }
+
+    /**
+     * Get the estimated number of bytes in pages re-written by the compaction.
+     * The maximum lengths of pages are used for the estimation.
+     *
+     * @return the number of bytes
+     */
+    public long getCompactRewrittenBytes() {
+        return compactRewrittenBytes;
+    }
+
+    /**
+     * Get the number of bytes written while the background compaction moved
+     * chunks.
+     *
+     * @return the number of bytes
+     */
+    public long getCompactMovedBytes() {
+        return compactMovedBytes;
+    }
+
     /**
      * Get data chunks count.
      *
@@ -2387,6 +2922,31 @@ public int getChunkCount() {
         return chunks.size();
     }
 
+    /**
+     * Get the chunks that are completely written to the file. The returned
+     * chunks must not be modified.
+     *
+     * @return the written chunks ordered by their position in the file
+     */
+    public List<Chunk> getWrittenChunks() {
+        ArrayList<Chunk> list = new ArrayList<>();
+        saveChunkLock.lock();
+        try {
+            Chunk last = lastChunk;
+            if (last != null) {
+                for (Chunk c : chunks.values()) {
+                    if (c.isSaved() && c.version <= last.version) {
+                        list.add(c);
+                    }
+                }
+            }
+        } finally {
+            saveChunkLock.unlock();
+        }
+        list.sort(Chunk.PositionComparator.INSTANCE);
+        return list;
+    }
+
     /**
      * Get data pages count.
      *
@@ -2446,7 +3006,7 @@ public int getFillRate() {
         }
     }
 
-    private Iterable<Chunk> findOldChunks(int writeLimit, int targetFillRate) {
+    private Iterable<Chunk> findOldChunks(int writeLimit, int targetFillRate, boolean incremental) {
         assert lastChunk != null;
         long time = getTimeSinceCreation();
 
@@ -2475,7 +3035,8 @@ private Iterable<Chunk> findOldChunks(int writeLimit, int targetFillRate) {
                 chunk.collectPriority = (int) (fillRate * 1000 / age);
                 totalSize += chunk.maxLenLive;
                 queue.offer(chunk);
-                while (totalSize > writeLimit) {
+                // the most desirable chunk may be re-written partially
+                while (totalSize > writeLimit && (!incremental || queue.size() > 1)) {
                     Chunk removed = queue.poll();
                     if (removed == null) {
                         break;
@@ -2492,23 +3053,35 @@ private boolean isRewritable(Chunk chunk, long time) {
         return chunk.isRewritable() && isSeasonedChunk(chunk, time);
     }
 
-    private int compactRewrite(Set<Integer> set) {
+    private int compactRewrite(Set<Integer> set, long writeLimit) {
         assert storeLock.isHeldByCurrentThread();
         assert currentStoreVersion < 0; // we should be able to do tryCommit() -> store()
+        long pageCount = compactRewrittenPageCount;
         acceptChunkOccupancyChanges(getTimeSinceCreation(), currentVersion);
-        int rewrittenPageCount = rewriteChunks(set, false);
+        long rewrittenBytes = rewriteChunks(set, false, writeLimit);
         acceptChunkOccupancyChanges(getTimeSinceCreation(), currentVersion);
-        rewrittenPageCount += rewriteChunks(set, true);
-        return rewrittenPageCount;
+        rewriteChunks(set, true, writeLimit - rewrittenBytes);
+        return (int) (compactRewrittenPageCount - pageCount);
     }
 
-    private int rewriteChunks(Set<Integer> set, boolean secondPass) {
-        int rewrittenPageCount = 0;
+    /**
+     * Re-write live pages of the specified chunks.
+     *
+     * @param set the ids of chunks
+     * @param secondPass whether non-leaf pages should be re-written too
+     * @param writeLimit stop when this number of bytes is re-written
+     * @return the estimated number of re-written bytes
+     */
+    private long rewriteChunks(Set<Integer> set, boolean secondPass, long writeLimit) {
+        long rewrittenBytes = 0;
         for (int chunkId : set) {
             Chunk chunk = chunks.get(chunkId);
             long[] toc = getToC(chunk);
             if (toc != null) {
                 for (int pageNo = 0; (pageNo = chunk.occupancy.nextClearBit(pageNo)) < chunk.pageCount; ++pageNo) {
+                    if (rewrittenBytes >= writeLimit) {
+                        return rewrittenBytes;
+                    }
                     long tocElement = toc[pageNo];
                     int mapId = DataUtils.getPageMapId(tocElement);
                     MVMap<?, ?> map = mapId == layout.getId() ? layout : mapId == meta.getId() ? meta : getMap(mapId);
@@ -2519,7 +3092,12 @@ private int rewriteChunks(Set<Integer> set, boolean secondPass) {
                             serializationLock.unlock();
                             try {
                                 if (map.rewritePage(pagePos)) {
-                                    ++rewrittenPageCount;
+                                    // the real length is not known without
+                                    // reading the page, so use the maximum
+                                    long length = Math.min(DataUtils.getPageMaxLength(tocElement), chunk.maxLen);
+                                    rewrittenBytes += length;
+                                    compactRewrittenBytes += length;
+                                    compactRewrittenPageCount++;
                                     if (map == meta) {
                                         markMetaChanged();
                                     }
@@ -2532,7 +3110,7 @@ private int rewriteChunks(Set<Integer> set, boolean secondPass) {
                 }
             }
         }
-        return rewrittenPageCount;
+        return rewrittenBytes;
     }
 
     private static HashSet<Integer> createIdSet(Iterable<Chunk> toCompact) {
@@ -2561,7 +3139,14 @@ <K,V> Page<K,V> readPage(MVMap<K,V> map, long pos) {
                 Chunk chunk = getChunk(pos);
                 int pageOffset = DataUtils.getPageOffset(pos);
                 try {
-                    ByteBuffer buff = chunk.readBufferForPage(fileStore, pageOffset, pos);
+                    ByteBuffer buff = offHeapCache == null ? null : offHeapCache.get(pos);
+                    if (buff == null) {
+                        PendingRead read = pendingReads.get(pos);
+                        if (read == null || (buff = read.getPageBuffer(pos)) == null) {
+                            buff = chunk.readBufferForPage(fileStore, pageOffset, pos);
+                        }
+                        cacheOffHeap(pos, buff);
+                    }
                     p = Page.read(buff, pos, map);
                 } catch (MVStoreException e) {
                     throw e;
@@ -2581,6 +3166,157 @@ <K,V> Page<K,V> readPage(MVMap<K,V> map, long pos) {
         }
     }
 
+    /**
+     * Get the number of child pages that are read in advance by cursors.
+     *
+     * @return the number of pages, or 0 if the read-ahead is disabled
+     */
+    int getReadAhead() {
+        return fileStore != null && cache != null ? readAhead : 0;
+    }
+
+    /**
+     * Asynchronously read the specified child pages into the cache. Pages that
+     * are cached already are skipped, adjacent pages of the same chunk are read
+     * together. Cursors and lookups that need a page with an outstanding read
+     * wait for this read.
+     *
+     * @param parent the parent page
+     * @param fromIndex the index of the first child page (inclusive)
+     * @param toIndex the index of the last child page (exclusive)
+     */
+    <K,V> void readAhead(Page<K,V> parent, int fromIndex, int toIndex) {
+        long[] positions = new long[toIndex - fromIndex];
+        int count = 0;
+        for (int i = fromIndex; i < toIndex; i++) {
+            long pos = parent.getChildPagePos(i);
+            if (DataUtils.isPageSaved(pos) && DataUtils.getPageMaxLength(pos) != DataUtils.PAGE_LARGE
+                    && !cache.containsKey(pos) && (offHeapCache == null || !offHeapCache.containsKey(pos))) {
+                positions[count++] = pos;
+            }
+        }
+        if (count == 0 || !isOpen()) {
+            return;
+        }
+        long[] pages = Arrays.copyOf(positions, count);
+        ThreadPoolExecutor executor = readAheadExecutor;
+        if (executor == null) {
+            synchronized (this) {
+                executor = readAheadExecutor;
+                if (executor == null) {
+                    readAheadExecutor = executor = new ThreadPoolExecutor(1, 1, 0L, TimeUnit.MILLISECONDS,
+                            new ArrayBlockingQueue<>(MAX_READ_AHEAD_REQUESTS), r -> {
+                                Thread thread = new Thread(r, "H2-read-ahead");
+                                thread.setDaemon(true);
+                                return thread;
+                            }, new ThreadPoolExecutor.DiscardPolicy());
+                }
+            }
+        }
+        executor.execute(() -> readPagesAhead(parent.map, pages));
+    }
+
+    private <K,V> void readPagesAhead(MVMap<K,V> map, long[] pages) {
+        // children are sorted by keys, not by positions
+        Arrays.sort(pages);
+        ArrayDeque<PendingRead> pending = new ArrayDeque<>(MAX_READ_AHEAD_READS);
+        for (int i = 0, count = pages.length; i < count && isOpen();) {
+            long first = pages[i];
+            int chunkId = DataUtils.getPageChunkId(first);
+            int start = DataUtils.getPageOffset(first);
+            int end = start + DataUtils.getPageMaxLength(first);
+            int j = i + 1;
+            for (; j < count; j++) {
+                long pos = pages[j];
+                int offset = DataUtils.getPageOffset(pos);
+                int pageEnd = offset + DataUtils.getPageMaxLength(pos);
+                if (DataUtils.getPageChunkId(pos) != chunkId || offset > end
+                        || pageEnd - start > MAX_READ_AHEAD_LENGTH) {
+                    break;
+                }
+                end = Math.max(end, pageEnd);
+            }
+            if (pending.size() >= MAX_READ_AHEAD_READS) {
+                cachePages(map, pending.poll());
+            }
+            try {
+                Chunk chunk = getChunk(first);
+                long block = chunk.block;
+                long filePos = block * BLOCK_SIZE;
+                int length = (int) Math.min((long) chunk.len * BLOCK_SIZE - start, end - start);
+                // with asynchronous file reads the groups are read in parallel
+                PendingRead read = new PendingRead(chunk, block, Arrays.copyOfRange(pages, i, j), start,
+                        fileStore.readFullyAsync(filePos + start, length));
+                for (long pos : read.pages) {
+                    pendingReads.put(pos, read);
+                }
+                pending.add(read);
+            } catch (Exception ignore) {
+                // these pages will be read again on access
+            }
+            i = j;
+        }
+        for (PendingRead read; (read = pending.poll()) != null;) {
+            cachePages(map, read);
+        }
+    }
+
+    /**
+     * Wait for the read and put its pages into the cache. Pages are
+     * deserialized by the read-ahead thread, not by the threads that complete
+     * asynchronous reads. Pages that were read by other threads meanwhile are
+     * skipped.
+     *
+     * @param map the map
+     * @param read the read
+     */
+    private <K,V> void cachePages(MVMap<K,V> map, PendingRead read) {
+        try {
+            for (long pos : read.pages) {
+                if (!isOpen()) {
+                    break;
+                }
+                if (!cache.containsKey(pos)) {
+                    ByteBuffer pageBuff = read.getPageBuffer(pos);
+                    if (pageBuff == null) {
+                        // these pages will be read again on access
+                        break;
+                    }
+                    try {
+                        cacheOffHeap(pos, pageBuff);
+                        cachePage(Page.read(pageBuff, pos, map));
+                    } catch (Exception ignore) {
+                        // this page will be read again on access
+                    }
+                }
+            }
+        } finally {
+            for (long pos : read.pages) {
+                pendingReads.remove(pos, read);
+            }
+        }
+    }
+
+    /**
+     * Put the serialized page in the off-heap cache, if it is used.
+     *
+     * @param pos the page position
+     * @param buff the buffer with the page at its position, the position of
+     *            the buffer is not changed
+     */
+    private void cacheOffHeap(long pos, ByteBuffer buff) {
+        if (offHeapCache != null) {
+            int start = buff.position();
+            // the buffer may contain more bytes than the page
+            int pageLength = buff.getInt(start);
+            if (pageLength >= 4 && pageLength <= buff.remaining()) {
+                ByteBuffer pageBuff = buff.duplicate();
+                pageBuff.limit(start + pageLength);
+                offHeapCache.put(pos, pageBuff);
+            }
+        }
+    }
+
     private long[] getToC(Chunk chunk) {
         if (chunk.tocPos == 0) {
             // legacy chunk without table of content
@@ -2647,6 +3383,79 @@ Compressor getCompressorFast() {
         return compressorFast;
     }
 
+    /**
+     * Get compressors for pages. The returned instance is used only by the
+     * current thread until it is released.
+     *
+     * @return the compressors
+     */
+    PageCompressors acquirePageCompressors() {
+        PageCompressors compressors = pageCompressorsPool.poll();
+        if (compressors == null) {
+            compressors = new PageCompressors(this);
+        }
+        return compressors;
+    }
+
+    /**
+     * Release compressors for pages, so they can be re-used by other threads.
+     * Compressors released after the store is closed are discarded.
+     *
+     * @param compressors the compressors than can be re-used
+     */
+    void releasePageCompressors(PageCompressors compressors) {
+        if (state != STATE_CLOSED) {
+            pageCompressorsPool.offer(compressors);
+        }
+    }
+
+    /**
+     * Raise the format of the file, so older versions don't read pages
+     * compressed with a page codec. Called when a map with a page codec is
+     * opened.
+     */
+    void requirePageCodecFormat() {
+        if (fileStore == null || fileStore.isReadOnly()) {
+            return;
+        }
+        saveChunkLock.lock();
+        try {
+            if (DataUtils.readHexInt(storeHeader, HDR_FORMAT_READ, 0) < FORMAT_PAGE_CODEC) {
+                storeHeader.put(HDR_FORMAT, FORMAT_PAGE_CODEC);
+                storeHeader.put(HDR_FORMAT_READ, FORMAT_PAGE_CODEC);
+                writeStoreHeader();
+            }
+        } finally {
+            saveChunkLock.unlock();
+        }
+    }
+
+    /**
+     * Check whether a page codec with the specified id is registered.
+     *
+     * @param id the id of the codec
+     * @return whether the codec is registered
+     */
+    boolean hasPageCodec(int id) {
+        return pageCodecs.containsKey(id);
+    }
+
+    /**
+     * Creates a new compressor of a registered page codec.
+     *
+     * @param id the id of the codec
+     * @return the new compressor
+     * @throws MVStoreException if the codec is not registered
+     */
+    Compressor createPageCodec(int id) {
+        Supplier<? extends Compressor> factory = pageCodecs.get(id);
+        if (factory == null) {
+            throw DataUtils.newMVStoreException(DataUtils.ERROR_UNSUPPORTED_FORMAT,
+                    "Page codec {0} is not registered", id);
+        }
+        return factory.get();
+    }
+
     Compressor getCompressorHigh() {
         if (compressorHigh == null) {
             compressorHigh = new CompressDeflate();
@@ -3021,6 +3830,9 @@ private void clearCaches() {
         if (cache != null) {
             cache.clear();
         }
+        if (offHeapCache != null) {
+            offHeapCache.clear();
+        }
         if (chunksToC != null) {
             chunksToC.clear();
         }
@@ -3050,6 +3862,19 @@ public FileStore getFileStore() {
         return fileStore;
     }
 
+    /**
+     * Get the time spent in phases of reading of the store header and the
+     * metadata of chunks when the store was opened, in nanoseconds. The phases
+     * are "header", "checkpoint" if the metadata was loaded from the checkpoint
+     * after a clean shutdown, "layout" if it was loaded from the layout map,
+     * "recovery" if the shutdown was not clean, and "freeSpace".
+     *
+     * @return the times by phases
+     */
+    public Map<String, Long> getStartupTimes() {
+        return startupTimes;
+    }
+
     /**
      * Get the store header. This data is for informational purposes only. The
      * data is subject to change in future versions. The data should not be
@@ -3190,15 +4015,24 @@ void writeInBackground() {
                     compact(-getTargetFillRate(), autoCommitMemory);
                 }
             }
+            writeChunkCheckpointIfIdle();
             int fillRate = getFillRate();
+            boolean throttled = autoCompactBandwidth > 0;
             if (fileStore.isFragmented() && fillRate < autoCompactFillRate) {
-                if (storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
+                int moveSize = autoCommitMemory;
+                if (isIdle()) {
+                    moveSize *= 4;
+                }
+                if (throttled) {
+                    moveSize = (int) Math.min(moveSize, getCompactAllowance(time));
+                }
+                if (moveSize > 0 && storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
                     try {
-                        int moveSize = autoCommitMemory;
-                        if (isIdle()) {
-                            moveSize *= 4;
-                        }
+                        long writeBytes = fileStore.getWriteBytes();
                         compactMoveChunks(101, moveSize);
+                        long movedBytes = fileStore.getWriteBytes() - writeBytes;
+                        compactMovedBytes += movedBytes;
+                        compactAllowance -= movedBytes;
                     } finally {
                         unlockAndCheckPanicCondition();
                     }
@@ -3207,15 +4041,20 @@ void writeInBackground() {
                 int chunksFillRate = getRewritableChunksFillRate();
                 chunksFillRate = isIdle() ? 100 - (100 - chunksFillRate) / 2 : chunksFillRate;
                 if (chunksFillRate < getTargetFillRate()) {
-                    if (storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
+                    int writeLimit = autoCommitMemory * fillRate / Math.max(chunksFillRate, 1);
+                    if (!isIdle()) {
+                        writeLimit /= 4;
+                    }
+                    if (throttled) {
+                        writeLimit = (int) Math.min(writeLimit, getCompactAllowance(time));
+                    }
+                    if (writeLimit > 0 && storeLock.tryLock(10, TimeUnit.MILLISECONDS)) {
                         try {
-                            int writeLimit = autoCommitMemory * fillRate / Math.max(chunksFillRate, 1);
-                            if (!isIdle()) {
-                                writeLimit /= 4;
-                            }
-                            if (rewriteChunks(writeLimit, chunksFillRate)) {
+                            long rewrittenBytes = compactRewrittenBytes;
+                            if (rewriteChunks(writeLimit, chunksFillRate, throttled)) {
                                 dropUnusedChunks();
                             }
+                            compactAllowance -= compactRewrittenBytes - rewrittenBytes;
                         } finally {
                             storeLock.unlock();
                         }
@@ -3256,7 +4095,8 @@ private void doMaintenance(int targetFillRate) {
                     try {
                         int writeLimit = autoCommitMemory * targetFillRate / Math.max(projectedFillRate, 1);
                         if (projectedFillRate < fillRate) {
-                            if ((!rewriteChunks(writeLimit, targetFillRate) || dropUnusedChunks() == 0) && cnt > 0) {
+                            if ((!rewriteChunks(writeLimit, targetFillRate, false) || dropUnusedChunks() == 0)
+                                    && cnt > 0) {
                                 break;
                             }
                         }
@@ -3273,6 +4113,24 @@ private void doMaintenance(int targetFillRate) {
         }
     }
 
+    /**
+     * Get the number of bytes the background compaction may write now. The
+     * allowance grows with the configured bandwidth, but unused allowance is
+     * not accumulated for more than one second to avoid bursts.
+     *
+     * @param time the time since creation of the store
+     * @return the number of bytes
+     */
+    private long getCompactAllowance(long time) {
+        long elapsed = time - compactAllowanceTime;
+        if (elapsed > 0) {
+            compactAllowanceTime = time;
+            compactAllowance = Math.min(compactAllowance + autoCompactBandwidth * Math.min(elapsed, 1_000) / 1_000,
+                    autoCompactBandwidth);
+        }
+        return Math.max(compactAllowance, 0);
+    }
+
     private int getTargetFillRate() {
         int targetRate = autoCompactFillRate;
         // use a lower fill rate if there were any file operations since the last time
@@ -3414,6 +4272,27 @@ public boolean isBackgroundThread() {
         return Thread.currentThread() == backgroundWriterThread.get();
     }
 
+    /**
+     * Set the maximum time to wait for other concurrent commits before the
+     * changes are stored, see {@link #commit()}. Concurrent commits are
+     * combined even with zero delay if they were waiting for the current store
+     * operation.
+     *
+     * @param micros the maximum delay in microseconds, 0 to disable waiting
+     */
+    public void setGroupCommitDelay(int micros) {
+        groupCommitDelay = micros;
+    }
+
+    /**
+     * Get the maximum time to wait for other concurrent commits.
+     *
+     * @return the delay in microseconds
+     */
+    public int getGroupCommitDelay() {
+        return groupCommitDelay;
+    }
+
     /**
      * Get the auto-commit delay.
      *
@@ -3492,6 +4371,15 @@ public CacheLongKeyLIRS<Page<?,?>> getCache() {
         return cache;
     }
 
+    /**
+     * Get the off-heap cache of serialized pages.
+     *
+     * @return the cache, or {@code null} if it is not used
+     */
+    public OffHeapPageCache getOffHeapCache() {
+        return offHeapCache;
+    }
+
     /**
      * Whether the store is read-only.
      *
@@ -3509,6 +4397,33 @@ public int getTocCacheHitRatio() {
         return getCacheHitRatio(chunksToC);
     }
 
+    /**
+     * Get the number of hits of the page cache.
+     *
+     * @return the number of cache hits
+     */
+    public long getCacheHits() {
+        return cache == null ? 0L : cache.getHits();
+    }
+
+    /**
+     * Get the number of misses of the page cache.
+     *
+     * @return the number of cache misses
+     */
+    public long getCacheMisses() {
+        return cache == null ? 0L : cache.getMisses();
+    }
+
+    /**
+     * Get the number of pages evicted from the page cache.
+     *
+     * @return the number of evictions
+     */
+    public long getCacheEvictions() {
+        return cache == null ? 0L : cache.getEvictions();
+    }
+
     private static int getCacheHitRatio(CacheLongKeyLIRS<?> cache) {
         if (cache == null) {
             return 0;
@@ -3630,6 +4545,11 @@ private int dropUnusedChunks() {
                                 cache.remove(pagePos);
                             }
                         }
+                        if (offHeapCache != null) {
+                            // the id of the chunk may be reused, so entries
+                            // are removed even if the ToC is not cached
+                            offHeapCache.removeChunk(chunk.id);
+                        }
 
                         if (layout.remove(Chunk.getMetaKey(chunk.id)) != null) {
                             markMetaChanged();
@@ -3718,6 +4638,68 @@ public String toString() {
         }
     }
 
+    /**
+     * An outstanding file read of the read-ahead.
+     */
+    private static final class PendingRead {
+
+        /**
+         * The chunk.
+         */
+        final Chunk chunk;
+
+        /**
+         * The block of the chunk when the read was started.
+         */
+        final long block;
+
+        /**
+         * The positions of the pages.
+         */
+        final long[] pages;
+
+        /**
+         * The offset of the read within the chunk.
+         */
+        final int start;
+
+        /**
+         * The future with the data.
+         */
+        final CompletableFuture<ByteBuffer> future;
+
+        PendingRead(Chunk chunk, long block, long[] pages, int start, CompletableFuture<ByteBuffer> future) {
+            this.chunk = chunk;
+            this.block = block;
+            this.pages = pages;
+            this.start = start;
+            this.future = future;
+        }
+
+        /**
+         * Wait for the read and get the data of the specified page.
+         *
+         * @param pos the position of the page
+         * @return the buffer with the page at its position, or {@code null} if
+         *         the read failed or the chunk was moved meanwhile
+         */
+        ByteBuffer getPageBuffer(long pos) {
+            ByteBuffer buff;
+            try {
+                buff = future.join();
+            } catch (Exception e) {
+                return null;
+            }
+            if (chunk.block != block) {
+                return null;
+            }
+            buff = buff.duplicate();
+            buff.position(DataUtils.getPageOffset(pos) - start);
+            return buff;
+        }
+
+    }
+
     /**
      * A background writer thread to automatically store changes from time to
      * time.
@@ -3888,6 +4870,21 @@ public Builder autoCompactFillRate(int percent) {
             return set("autoCompactFillRate", percent);
         }
 
+        /**
+         * Limit the number of bytes written by the background compaction. If
+         * the limit is set, live pages of chunks with the lowest fill rate are
+         * re-written in small steps, possibly only a part of a chunk at once,
+         * so the compaction doesn't compete for I/O with other operations.
+         * <p>
+         * The default value is 0, the compaction is not limited.
+         *
+         * @param kb the number of kilobytes per second
+         * @return this
+         */
+        public Builder autoCompactBandwidth(int kb) {
+            return set("autoCompactBandwidth", kb);
+        }
+
         /**
          * Use the following file name. If the file does not exist, it is
          * automatically created. The parent directory already must exist.
@@ -3959,6 +4956,28 @@ public Builder cacheSize(int mb) {
             return set("cacheSize", mb);
         }
 
+        /**
+         * Set the size of the second level cache of serialized pages in MB.
+         * This cache keeps its data outside of the Java heap, in direct
+         * buffers. The default is 0, meaning this cache is not used.
+         *
+         * @param mb the cache size in megabytes
+         * @return this
+         */
+        public Builder offHeapCacheSize(int mb) {
+            return set("offHeapCacheSize", mb);
+        }
+
+        /**
+         * Compress pages in the off-heap cache using the LZF algorithm. This
+         * is only useful if pages are not compressed in the file.
+         *
+         * @return this
+         */
+        public Builder compressOffHeapCache() {
+            return set("compressOffHeapCache", 1);
+        }
+
         /**
          * Set the read cache concurrency. The default is 16, meaning 16
          * segments are used.
@@ -3970,6 +4989,20 @@ public Builder cacheConcurrency(int concurrency) {
             return set("cacheConcurrency", concurrency);
         }
 
+        /**
+         * Set the size of the read buffer of each cache segment. Cache hits
+         * are recorded in this buffer without synchronization, and they are
+         * applied to the cache when the buffer is full. The default is 16, 0
+         * means cache hits are applied immediately with synchronization on the
+         * segment.
+         *
+         * @param size the read buffer size (0 or a power of 2)
+         * @return this
+         */
+        public Builder cacheReadBufferSize(int size) {
+            return set("cacheReadBufferSize", size);
+        }
+
         /**
          * Compress data before writing using the LZF algorithm. This will save
          * about 50% of the disk space, but will slow down read and write
@@ -4000,6 +5033,60 @@ public Builder compressHigh() {
             return set("compress", 2);
         }
 
+        /**
+         * Register a page codec. Maps that are opened with
+         * {@link MVMap.Builder#pageCodec(int)} compress their pages with this
+         * codec, its id is stored in the header of each page. A codec must be
+         * registered with the same id each time a store with such pages is
+         * opened, and older versions can't open such files. The factory is
+         * invoked for each thread that compresses or reads pages, the created
+         * compressors are not used concurrently by multiple threads.
+         *
+         * @param id the positive id of the codec
+         * @param factory the factory of compressors
+         * @return this
+         */
+        public Builder pageCodec(int id, Supplier<? extends Compressor> factory) {
+            if (id <= 0) {
+                throw DataUtils.newIllegalArgumentException("Page codec id {0} is not positive", id);
+            }
+            @SuppressWarnings("unchecked")
+            HashMap<Integer, Supplier<? extends Compressor>> codecs =
+                    (HashMap<Integer, Supplier<? extends Compressor>>) config.get("pageCodecs");
+            if (codecs == null) {
+                codecs = new HashMap<>();
+                config.put("pageCodecs", codecs);
+            }
+            codecs.put(id, factory);
+            return this;
+        }
+
+        /**
+         * Set the number of threads that serialize and compress changed pages
+         * when a new chunk is stored. Pages are serialized in parallel only if
+         * there are enough of them. The default is 1, meaning all pages are
+         * serialized by the thread that stores the chunk.
+         *
+         * @param threads the number of threads
+         * @return this
+         */
+        public Builder serializationThreads(int threads) {
+            return set("serializationThreads", threads);
+        }
+
+        /**
+         * Set the number of child pages that are read in advance by cursors.
+         * When a cursor moves to the next leaf page of the same parent page
+         * sequentially, the following leaf pages are read asynchronously into
+         * the cache. The default is 0, meaning the read-ahead is disabled.
+         *
+         * @param pages the number of pages
+         * @return this
+         */
+        public Builder readAhead(int pages) {
+            return set("readAhead", pages);
+        }
+
         /**
          * Set the amount of memory a page should contain at most, in bytes,
          * before it is split. The default is 16 KB for persistent stores and 4
@@ -82,6 +82,18 @@
      */
     private K[] keys;
 
+    /**
+     * Keys and values of this unsaved page serialized and possibly compressed
+     * in advance by {@link #prepareWrite(WriteBuffer, PageCompressors)},
+     * or {@code null}.
+     */
+    private byte[] preparedContent;
+
+    /**
+     * The compression flag of {@link #preparedContent}.
+     */
+    private byte preparedCompressType;
+
     /**
      * Updater for pos field, which can be updated when page is saved,
      * but can be concurrently marked as removed
@@ -376,6 +388,8 @@ protected final Page<K,V> clone() {
         } catch (CloneNotSupportedException impossible) {
             throw new RuntimeException(impossible);
         }
+        // the content of the clone may be changed
+        clone.preparedContent = null;
         return clone;
     }
 
@@ -614,12 +628,17 @@ private void read(ByteBuffer buff) {
         }
         boolean compressed = (type & DataUtils.PAGE_COMPRESSED) != 0;
         if (compressed) {
+            MVStore store = map.getStore();
+            PageCompressors compressors = null;
             Compressor compressor;
-            if ((type & DataUtils.PAGE_COMPRESSED_HIGH) ==
+            if ((type & DataUtils.PAGE_COMPRESSED_CODEC) == DataUtils.PAGE_COMPRESSED_CODEC) {
+                compressors = store.acquirePageCompressors();
+                compressor = compressors.getCodec(DataUtils.readVarInt(buff));
+            } else if ((type & DataUtils.PAGE_COMPRESSED_HIGH) ==
                     DataUtils.PAGE_COMPRESSED_HIGH) {
-                compressor = map.getStore().getCompressorHigh();
+                compressor = store.getCompressorHigh();
             } else {
-                compressor = map.getStore().getCompressorFast();
+                compressor = store.getCompressorFast();
             }
             int lenAdd = DataUtils.readVarInt(buff);
             int compLen = buff.remaining();
@@ -636,6 +655,9 @@ private void read(ByteBuffer buff) {
             buff = ByteBuffer.allocate(l);
             compressor.expand(comp, pos, compLen, buff.array(),
                     buff.arrayOffset(), l);
+            if (compressors != null) {
+                store.releasePageCompressors(compressors);
+            }
         }
         map.getKeyType().read(buff, keys, keyCount);
         if (isLeaf()) {
@@ -704,44 +726,23 @@ protected final int write(Chunk chunk, WriteBuffer buff, List<Long> toc) {
         buff.put((byte)type);
         int childrenPos = buff.position();
         writeChildren(buff, true);
-        int compressStart = buff.position();
-        map.getKeyType().write(buff, keys, keyCount);
-        writeValues(buff);
         MVStore store = map.getStore();
-        int expLen = buff.position() - compressStart;
-        if (expLen > 16) {
-            int compressionLevel = store.getCompressionLevel();
-            if (compressionLevel > 0) {
-                Compressor compressor;
-                int compressType;
-                if (compressionLevel == 1) {
-                    compressor = store.getCompressorFast();
-                    compressType = DataUtils.PAGE_COMPRESSED;
-                } else {
-                    compressor = store.getCompressorHigh();
-                    compressType = DataUtils.PAGE_COMPRESSED_HIGH;
-                }
-                byte[] comp = new byte[expLen * 2];
-                ByteBuffer byteBuffer = buff.getBuffer();
-                int pos = 0;
-                byte[] exp;
-                if (byteBuffer.hasArray()) {
-                    exp = byteBuffer.array();
-                    pos = byteBuffer.arrayOffset()  + compressStart;
-                } else {
-                    exp = Utils.newBytes(expLen);
-                    buff.position(compressStart).get(exp);
-                }
-                int compLen = compressor.compress(exp, pos, expLen, comp, 0);
-                int plus = DataUtils.getVarIntLen(expLen - compLen);
-                if (compLen + plus < expLen) {
-                    buff.position(typePos)
-                        .put((byte) (type | compressType));
-                    buff.position(compressStart)
-                        .putVarInt(expLen - compLen)
-                        .put(comp, 0, compLen);
-                }
-            }
+        int compressType;
+        byte[] content = preparedContent;
+        if (content != null) {
+            preparedContent = null;
+            buff.put(content);
+            compressType = preparedCompressType;
+        } else {
+            PageCompressors compressors = store.acquirePageCompressors();
+            compressType = writeContent(buff, compressors);
+            store.releasePageCompressors(compressors);
+        }
+        if (compressType != 0) {
+            int end = buff.position();
+            buff.position(typePos)
+                .put((byte) (type | compressType));
+            buff.position(end);
         }
         int pageLength = buff.position() - start;
         long tocElement = DataUtils.getTocElement(getMapId(), start, buff.position() - start, type);
@@ -777,6 +778,83 @@ protected final int write(Chunk chunk, WriteBuffer buff, List<Long> toc) {
         return childrenPos;
     }
 
+    /**
+     * Write keys and values of this page to the buffer, and compress them if
+     * compression is enabled and reduces their size.
+     *
+     * @param buff the target buffer
+     * @param compressors the compressors
+     * @return the compression flag of the page type, or 0 if the data is not
+     *         compressed
+     */
+    private int writeContent(WriteBuffer buff, PageCompressors compressors) {
+        int compressStart = buff.position();
+        map.getKeyType().write(buff, keys, getKeyCount());
+        writeValues(buff);
+        int expLen = buff.position() - compressStart;
+        if (expLen > 16) {
+            int codec = map.getPageCodec();
+            int compressionLevel = map.getStore().getCompressionLevel();
+            if (codec != 0 || compressionLevel > 0) {
+                Compressor compressor;
+                int compressType;
+                if (codec != 0) {
+                    compressor = compressors.getCodec(codec);
+                    compressType = DataUtils.PAGE_COMPRESSED_CODEC;
+                } else if (compressionLevel == 1) {
+                    compressor = compressors.getFast();
+                    compressType = DataUtils.PAGE_COMPRESSED;
+                } else {
+                    compressor = compressors.getHigh();
+                    compressType = DataUtils.PAGE_COMPRESSED_HIGH;
+                }
+                byte[] comp = new byte[expLen * 2];
+                ByteBuffer byteBuffer = buff.getBuffer();
+                int pos = 0;
+                byte[] exp;
+                if (byteBuffer.hasArray()) {
+                    exp = byteBuffer.array();
+                    pos = byteBuffer.arrayOffset()  + compressStart;
+                } else {
+                    exp = Utils.newBytes(expLen);
+                    buff.position(compressStart).get(exp);
+                }
+                int compLen = compressor.compress(exp, pos, expLen, comp, 0);
+                int plus = DataUtils.getVarIntLen(expLen - compLen);
+                if (codec != 0) {
+                    plus += DataUtils.getVarIntLen(codec);
+                }
+                if (compLen + plus < expLen) {
+                    buff.position(compressStart);
+                    if (codec != 0) {
+                        buff.putVarInt(codec);
+                    }
+                    buff.putVarInt(expLen - compLen)
+                        .put(comp, 0, compLen);
+                    return compressType;
+                }
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Serialize and compress keys and values of this unsaved page in advance,
+     * so the following {@link #write(Chunk, WriteBuffer, List)} only needs to
+     * copy them. This method may be invoked concurrently for different pages,
+     * the compressors must not be shared between threads.
+     *
+     * @param buff the temporary buffer
+     * @param compressors the compressors of the current thread
+     */
+    final void prepareWrite(WriteBuffer buff, PageCompressors compressors) {
+        buff.clear();
+        preparedCompressType = (byte) writeContent(buff, compressors);
+        byte[] content = new byte[buff.position()];
+        buff.position(0).get(content);
+        preparedContent = content;
+    }
+
     /**
      * Write values that the buffer contains to the buff.
      *
@@ -801,6 +879,14 @@ protected final int write(Chunk chunk, WriteBuffer buff, List<Long> toc) {
      */
     abstract void writeUnsavedRecursive(Chunk chunk, WriteBuffer buff, List<Long> toc);
 
+    /**
+     * Collect this page and all its children that will be stored by
+     * {@link #writeUnsavedRecursive(Chunk, WriteBuffer, List)}.
+     *
+     * @param pages the target list
+     */
+    abstract void collectUnsavedRecursive(List<Page<?,?>> pages);
+
     /**
      * Unlink the children recursively after all data is written.
      */
@@ -1321,6 +1407,24 @@ void writeUnsavedRecursive(Chunk chunk, WriteBuffer buff, List<Long> toc) {
             }
         }
 
+        @Override
+        void collectUnsavedRecursive(List<Page<?,?>> pages) {
+            if (!isSaved()) {
+                pages.add(this);
+                collectUnsavedChildren(pages);
+            }
+        }
+
+        void collectUnsavedChildren(List<Page<?,?>> pages) {
+            int len = getRawChildPageCount();
+            for (int i = 0; i < len; i++) {
+                Page<K,V> p = children[i].getPage();
+                if (p != null) {
+                    p.collectUnsavedRecursive(pages);
+                }
+            }
+        }
+
         void writeChildrenRecursive(Chunk chunk, WriteBuffer buff, List<Long> toc) {
             int len = getRawChildPageCount();
             for (int i = 0; i < len; i++) {
@@ -1393,6 +1497,15 @@ void writeUnsavedRecursive(Chunk chunk, WriteBuffer buff, List<Long> toc) {
             }
         }
 
+        @Override
+        void collectUnsavedRecursive(List<Page<?,?>> pages) {
+            if (complete) {
+                super.collectUnsavedRecursive(pages);
+            } else if (!isSaved()) {
+                collectUnsavedChildren(pages);
+            }
+        }
+
         @Override
         public boolean isComplete() {
             return complete;
@@ -1605,6 +1718,13 @@ void writeUnsavedRecursive(Chunk chunk, WriteBuffer buff, List<Long> toc) {
             }
         }
 
+        @Override
+        void collectUnsavedRecursive(List<Page<?,?>> pages) {
+            if (!isSaved()) {
+                pages.add(this);
+            }
+        }
+
         @Override
         void releaseSavedPages() {}
 
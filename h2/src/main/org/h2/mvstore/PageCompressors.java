@@ -0,0 +1,80 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore;
+
+import java.util.HashMap;
+
+import org.h2.compress.CompressDeflate;
+import org.h2.compress.CompressLZF;
+import org.h2.compress.Compressor;
+
+/**
+ * Compressors that are used to read and write pages. Compressors are not
+ * thread-safe, so each thread acquires an instance of this class from the
+ * pool of the store and releases it when done.
+ */
+final class PageCompressors {
+
+    private final MVStore store;
+
+    private Compressor fast;
+
+    private Compressor high;
+
+    private HashMap<Integer, Compressor> codecs;
+
+    /**
+     * Creates a new set of compressors.
+     *
+     * @param store the store
+     */
+    PageCompressors(MVStore store) {
+        this.store = store;
+    }
+
+    /**
+     * Returns the compressor for compression level 1.
+     *
+     * @return the compressor
+     */
+    Compressor getFast() {
+        if (fast == null) {
+            fast = new CompressLZF();
+        }
+        return fast;
+    }
+
+    /**
+     * Returns the compressor for higher compression levels.
+     *
+     * @return the compressor
+     */
+    Compressor getHigh() {
+        if (high == null) {
+            high = new CompressDeflate();
+        }
+        return high;
+    }
+
+    /**
+     * Returns the compressor of the specified page codec.
+     *
+     * @param id the id of the codec
+     * @return the compressor
+     */
+    Compressor getCodec(int id) {
+        if (codecs == null) {
+            codecs = new HashMap<>();
+        }
+        Compressor compressor = codecs.get(id);
+        if (compressor == null) {
+            compressor = store.createPageCodec(id);
+            codecs.put(id, compressor);
+        }
+        return compressor;
+    }
+
+}
@@ -12,6 +12,9 @@
 import java.util.List;
 import java.util.Map;
 import java.util.Set;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+import java.util.concurrent.atomic.LongAdder;
 import org.h2.mvstore.DataUtils;
 
 /**
@@ -39,6 +42,11 @@
  * of other entries have been moved to the front (8 per segment by default).
  * Write access and moving entries to the top of the stack is synchronized per
  * segment.
+ * <p>
+ * If a read buffer is configured, cache hits don't synchronize on the segment.
+ * Accessed entries are recorded in a small lossy ring buffer instead, and the
+ * buffer is applied to the stack and queues of the segment when it is full, or
+ * before the next write access to the segment.
  *
  * @author Thomas Mueller
  * @param <V> the value type
@@ -58,6 +66,7 @@
     private final int stackMoveDistance;
     private final int nonResidentQueueSize;
     private final int nonResidentQueueSizeHigh;
+    private final int readBufferSize;
 
     /**
      * Create a new cache with the given memory size.
@@ -75,6 +84,10 @@ public CacheLongKeyLIRS(Config config) {
         this.segmentCount = config.segmentCount;
         this.segmentMask = segmentCount - 1;
         this.stackMoveDistance = config.stackMoveDistance;
+        DataUtils.checkArgument(
+                config.readBufferSize == 0 || Integer.bitCount(config.readBufferSize) == 1,
+                "The read buffer size must be 0 or a power of 2, is {0}", config.readBufferSize);
+        this.readBufferSize = config.readBufferSize;
         segments = new Segment[segmentCount];
         clear();
         // use the high bits for the segment
@@ -88,7 +101,7 @@ public void clear() {
         long max = getMaxItemSize();
         for (int i = 0; i < segmentCount; i++) {
             segments[i] = new Segment<>(max, stackMoveDistance, 8, nonResidentQueueSize,
-                                        nonResidentQueueSizeHigh);
+                                        nonResidentQueueSizeHigh, readBufferSize);
         }
     }
 
@@ -162,6 +175,7 @@ public V put(long key, V value, int memory) {
         // concurrent resizes (concurrent reads read
         // from the old segment)
         synchronized (s) {
+            s.drainReadBuffer();
             s = resizeIfNeeded(s, segmentIndex);
             return s.put(key, hash, value, memory);
         }
@@ -209,6 +223,7 @@ public V remove(long key) {
         // concurrent resizes (concurrent reads read
         // from the old segment)
         synchronized (s) {
+            s.drainReadBuffer();
             s = resizeIfNeeded(s, segmentIndex);
             return s.remove(key, hash);
         }
@@ -376,7 +391,7 @@ public int sizeHot() {
     public long getHits() {
         long x = 0;
         for (Segment<V> s : segments) {
-            x += s.hits;
+            x += s.hits.sum();
         }
         return x;
     }
@@ -387,9 +402,23 @@ public long getHits() {
      * @return the cache misses
      */
     public long getMisses() {
-        int x = 0;
+        long x = 0;
+        for (Segment<V> s : segments) {
+            x += s.misses.sum();
+        }
+        return x;
+    }
+
+    /**
+     * Get the number of evictions, that is, the number of times a resident
+     * entry became non-resident to free memory.
+     *
+     * @return the number of evictions
+     */
+    public long getEvictions() {
+        long x = 0;
         for (Segment<V> s : segments) {
-            x += s.misses;
+            x += s.evictions.sum();
         }
         return x;
     }
@@ -522,12 +551,17 @@ public void trimNonResidentQueue() {
         /**
          * The number of cache hits.
          */
-        long hits;
+        LongAdder hits = new LongAdder();
 
         /**
          * The number of cache misses.
          */
-        long misses;
+        LongAdder misses = new LongAdder();
+
+        /**
+         * The number of evicted entries.
+         */
+        LongAdder evictions = new LongAdder();
 
         /**
          * The map array. The size is always a power of 2.
@@ -602,6 +636,24 @@ public void trimNonResidentQueue() {
          */
         private int stackMoveCounter;
 
+        /**
+         * The ring buffer of recently accessed entries that were not moved in
+         * the stack and queues yet, or {@code null} if accesses are applied
+         * immediately. The size is always a power of 2.
+         */
+        private final AtomicReferenceArray<Entry<V>> readBuffer;
+
+        /**
+         * The number of accesses recorded in the read buffer.
+         */
+        private final AtomicLong readCounter;
+
+        /**
+         * The value of {@link #readCounter} when the read buffer was applied
+         * last time.
+         */
+        private long drainedReadCounter;
+
         /**
          * Create a new cache segment.
          *  @param maxMemory the maximum memory to use
@@ -610,9 +662,10 @@ public void trimNonResidentQueue() {
          * @param len the number of hash table buckets (must be a power of 2)
          * @param nonResidentQueueSize the non-resident queue size low watermark factor
          * @param nonResidentQueueSizeHigh  the non-resident queue size high watermark factor
+         * @param readBufferSize the size of the read buffer (0 or a power of 2)
          */
         Segment(long maxMemory, int stackMoveDistance, int len,
-                int nonResidentQueueSize, int nonResidentQueueSizeHigh) {
+                int nonResidentQueueSize, int nonResidentQueueSizeHigh, int readBufferSize) {
             setMaxMemory(maxMemory);
             this.stackMoveDistance = stackMoveDistance;
             this.nonResidentQueueSize = nonResidentQueueSize;
@@ -632,6 +685,13 @@ public void trimNonResidentQueue() {
             @SuppressWarnings("unchecked")
             Entry<V>[] e = new Entry[len];
             entries = e;
+            if (readBufferSize > 0) {
+                readBuffer = new AtomicReferenceArray<>(readBufferSize);
+                readCounter = new AtomicLong();
+            } else {
+                readBuffer = null;
+                readCounter = null;
+            }
         }
 
         /**
@@ -644,9 +704,11 @@ public void trimNonResidentQueue() {
          */
         Segment(Segment<V> old, int len) {
             this(old.maxMemory, old.stackMoveDistance, len,
-                    old.nonResidentQueueSize, old.nonResidentQueueSizeHigh);
+                    old.nonResidentQueueSize, old.nonResidentQueueSizeHigh,
+                    old.readBuffer != null ? old.readBuffer.length() : 0);
             hits = old.hits;
             misses = old.misses;
+            evictions = old.evictions;
             Entry<V> s = old.stack.stackPrev;
             while (s != old.stack) {
                 Entry<V> e = new Entry<>(s);
@@ -710,19 +772,60 @@ private void addToMap(Entry<V> e) {
          * @param e the entry
          * @return the value, or null if there is no resident entry
          */
-        synchronized V get(Entry<V> e) {
+        V get(Entry<V> e) {
+            if (readBuffer == null) {
+                return getAndAccess(e);
+            }
+            V value = e == null ? null : e.getValue();
+            if (value == null) {
+                misses.increment();
+            } else {
+                hits.increment();
+                int last = readBuffer.length() - 1;
+                int index = (int) readCounter.getAndIncrement() & last;
+                // if the buffer wasn't applied yet, older accesses are lost
+                readBuffer.lazySet(index, e);
+                if (index == last) {
+                    drainReadBuffer();
+                }
+            }
+            return value;
+        }
+
+        private synchronized V getAndAccess(Entry<V> e) {
             V value = e == null ? null : e.getValue();
             if (value == null) {
                 // the entry was not found
                 // or it was a non-resident entry
-                misses++;
+                misses.increment();
             } else {
                 access(e);
-                hits++;
+                hits.increment();
             }
             return value;
         }
 
+        /**
+         * Apply the accesses recorded in the read buffer, if any.
+         */
+        synchronized void drainReadBuffer() {
+            if (readBuffer == null) {
+                return;
+            }
+            long counter = readCounter.get();
+            if (counter == drainedReadCounter) {
+                return;
+            }
+            drainedReadCounter = counter;
+            for (int i = 0, l = readBuffer.length(); i < l; i++) {
+                Entry<V> e = readBuffer.getAndSet(i, null);
+                // the entry may be removed or replaced after the access
+                if (e != null && find(e.key, getHash(e.key)) == e) {
+                    access(e);
+                }
+            }
+        }
+
         /**
          * Access an item, moving the entry to the top of the stack or front of
          * the queue if found.
@@ -899,6 +1002,7 @@ private void evictBlock() {
                 removeFromQueue(e);
                 e.reference = new WeakReference<>(e.value);
                 e.value = null;
+                evictions.increment();
                 addToQueue(queue2, e);
                 // the size of the non-resident-cold entries needs to be limited
                 trimNonResidentQueue();
@@ -1032,6 +1136,7 @@ private void removeFromQueue(Entry<V> e) {
          * @return the key list
          */
         synchronized List<Long> keys(boolean cold, boolean nonResident) {
+            drainReadBuffer();
             ArrayList<Long> keys = new ArrayList<>();
             if (cold) {
                 Entry<V> start = nonResident ? queue2 : queue;
@@ -1166,7 +1271,15 @@ boolean isHot() {
         }
 
         V getValue() {
-            return value == null ? reference.get() : value;
+            V v = value;
+            if (v == null) {
+                // reference may be not visible yet for unsynchronized readers
+                WeakReference<V> r = reference;
+                if (r != null) {
+                    v = r.get();
+                }
+            }
+            return v;
         }
 
         int getMemory() {
@@ -1206,5 +1319,13 @@ public static class Config {
          * as a factor of the number of all other entries in the map
          */
         public final int nonResidentQueueSizeHigh = 12;
+
+        /**
+         * The number of accesses per segment that are recorded without
+         * synchronization before they are applied to the stack and queues of
+         * the segment (0 or a power of 2). Accesses are applied immediately if
+         * 0 is specified.
+         */
+        public int readBufferSize;
     }
 }
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore.cache;
+
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.LongAdder;
+import java.util.concurrent.locks.StampedLock;
+
+import org.h2.compress.CompressLZF;
+import org.h2.mvstore.DataUtils;
+
+/**
+ * A cache for serialized pages that keeps their data in direct buffers outside
+ * of the Java heap. It is meant to be used as a second level cache below the
+ * cache of deserialized pages, so that a large working set can be cached
+ * without garbage collection cost.
+ * <p>
+ * The memory is split into a number of regions, and entries are appended to
+ * the current region. If all regions are used, the oldest region is cleared
+ * and reused, so entries are evicted in the order they were added. Only the
+ * index of entries is kept on the heap.
+ * <p>
+ * The keys are page positions. The keys of entries are also grouped by the
+ * chunk of the page, so all entries of a chunk can be removed when the chunk
+ * is dropped.
+ * <p>
+ * This implementation is multi-threading safe. Entries are added and removed
+ * under a lock, entries are read without locking.
+ */
+public class OffHeapPageCache {
+
+    /**
+     * The length of the header of each entry: the length of data and the
+     * stored length.
+     */
+    private static final int HEADER_LENGTH = 8;
+
+    private static final int MAX_REGION_COUNT = 64;
+
+    private static final int MIN_REGION_SIZE = 1024 * 1024;
+
+    /**
+     * The compressor used to expand entries, it doesn't have a state.
+     */
+    private static final CompressLZF EXPANDER = new CompressLZF();
+
+    private final long maxMemory;
+
+    private final int regionSize;
+
+    private final int maxEntryLength;
+
+    /**
+     * The regions, they are allocated on first use.
+     */
+    private final ByteBuffer[] regions;
+
+    /**
+     * A lock for each region. The write lock is acquired when the region is
+     * cleared, readers validate an optimistic stamp after copying the data.
+     */
+    private final StampedLock[] locks;
+
+    private final int[] generations;
+
+    private final long[][] regionKeys;
+
+    private final int[] regionKeyCounts;
+
+    private final int[] regionUsed;
+
+    /**
+     * The positions of entries: the low 16 bits of the generation of the
+     * region, the region, and the offset within the region.
+     */
+    private final ConcurrentHashMap<Long, Long> index = new ConcurrentHashMap<>();
+
+    /**
+     * The keys of entries by the chunk id of the page position.
+     */
+    private final HashMap<Integer, HashSet<Long>> chunkKeys = new HashMap<>();
+
+    /**
+     * The compressor, or {@code null} if entries are not compressed.
+     */
+    private final CompressLZF compressor;
+
+    private int current;
+
+    private int currentPosition;
+
+    private volatile long usedMemory;
+
+    private final LongAdder hits = new LongAdder();
+
+    private final LongAdder misses = new LongAdder();
+
+    /**
+     * Create a new cache.
+     *
+     * @param maxMemory the maximum memory to use, in bytes
+     * @param compress whether entries should be compressed
+     */
+    public OffHeapPageCache(long maxMemory, boolean compress) {
+        int regionCount = (int) Math.max(Math.min(maxMemory / MIN_REGION_SIZE, MAX_REGION_COUNT),
+                (maxMemory + Integer.MAX_VALUE - 1) / Integer.MAX_VALUE);
+        regionCount = Math.max(regionCount, 1);
+        regionSize = (int) Math.max(maxMemory / regionCount, HEADER_LENGTH);
+        this.maxMemory = (long) regionSize * regionCount;
+        maxEntryLength = regionSize / 4;
+        regions = new ByteBuffer[regionCount];
+        locks = new StampedLock[regionCount];
+        for (int i = 0; i < regionCount; i++) {
+            locks[i] = new StampedLock();
+        }
+        generations = new int[regionCount];
+        regionKeys = new long[regionCount][];
+        regionKeyCounts = new int[regionCount];
+        regionUsed = new int[regionCount];
+        compressor = compress ? new CompressLZF() : null;
+    }
+
+    /**
+     * Get a copy of the data of an entry.
+     *
+     * @param key the key
+     * @return the data, or {@code null} if there is no such entry
+     */
+    public ByteBuffer get(long key) {
+        Long value = index.get(key);
+        if (value != null) {
+            long v = value;
+            int region = (int) (v >>> 32) & 0xffff;
+            StampedLock lock = locks[region];
+            long stamp = lock.tryOptimisticRead();
+            if (stamp != 0 && (generations[region] & 0xffff) == (int) (v >>> 48)) {
+                ByteBuffer buff = regions[region].duplicate();
+                int pos = (int) v;
+                buff.position(pos);
+                int length = buff.getInt();
+                int storedLength = buff.getInt();
+                // lengths may be inconsistent if the region was cleared
+                // concurrently
+                if (length >= 0 && length <= maxEntryLength && storedLength >= 0 && storedLength <= length
+                        && pos + HEADER_LENGTH + storedLength <= regionSize) {
+                    byte[] data = new byte[storedLength];
+                    buff.get(data);
+                    if (lock.validate(stamp)) {
+                        hits.increment();
+                        if (storedLength != length) {
+                            byte[] expanded = new byte[length];
+                            EXPANDER.expand(data, 0, storedLength, expanded, 0, length);
+                            data = expanded;
+                        }
+                        return ByteBuffer.wrap(data);
+                    }
+                }
+            }
+        }
+        misses.increment();
+        return null;
+    }
+
+    /**
+     * Check whether there is an entry with the specified key. The entry may
+     * be evicted concurrently.
+     *
+     * @param key the key
+     * @return whether the entry exists
+     */
+    public boolean containsKey(long key) {
+        return index.containsKey(key);
+    }
+
+    /**
+     * Add an entry, if there is no entry with this key yet. The data between
+     * the position and the limit of the buffer is copied, the position of the
+     * buffer is not changed.
+     *
+     * @param key the key
+     * @param buff the data
+     */
+    public void put(long key, ByteBuffer buff) {
+        int length = buff.remaining();
+        if (length > maxEntryLength || index.containsKey(key)) {
+            return;
+        }
+        byte[] data = new byte[length];
+        buff.duplicate().get(data);
+        synchronized (this) {
+            if (index.containsKey(key)) {
+                return;
+            }
+            int storedLength = length;
+            if (compressor != null) {
+                byte[] comp = new byte[length * 2];
+                int compLength = compressor.compress(data, 0, length, comp, 0);
+                if (compLength < length) {
+                    data = comp;
+                    storedLength = compLength;
+                }
+            }
+            int entryLength = HEADER_LENGTH + storedLength;
+            if (currentPosition + entryLength > regionSize) {
+                current = (current + 1) % regions.length;
+                currentPosition = 0;
+                clearRegion(current);
+            }
+            int region = current;
+            ByteBuffer target = regions[region];
+            if (target == null) {
+                regions[region] = target = ByteBuffer.allocateDirect(regionSize);
+            }
+            target = target.duplicate();
+            target.position(currentPosition);
+            target.putInt(length).putInt(storedLength).put(data, 0, storedLength);
+            long[] keys = regionKeys[region];
+            int count = regionKeyCounts[region];
+            if (keys == null) {
+                regionKeys[region] = keys = new long[64];
+            } else if (count == keys.length) {
+                regionKeys[region] = keys = Arrays.copyOf(keys, count * 2);
+            }
+            keys[count] = key;
+            regionKeyCounts[region] = count + 1;
+            chunkKeys.computeIfAbsent(DataUtils.getPageChunkId(key), k -> new HashSet<>()).add(key);
+            index.put(key, ((long) (generations[region] & 0xffff) << 48) | ((long) region << 32)
+                    | currentPosition);
+            currentPosition += entryLength;
+            regionUsed[region] += entryLength;
+            usedMemory += entryLength;
+        }
+    }
+
+    private void clearRegion(int region) {
+        StampedLock lock = locks[region];
+        long stamp = lock.writeLock();
+        try {
+            generations[region]++;
+        } finally {
+            lock.unlockWrite(stamp);
+        }
+        long[] keys = regionKeys[region];
+        for (int i = 0, count = regionKeyCounts[region]; i < count; i++) {
+            Long key = keys[i];
+            Long value = index.get(key);
+            if (value != null && ((int) (value >>> 32) & 0xffff) == region && index.remove(key, value)) {
+                removeChunkKey(key);
+            }
+        }
+        regionKeyCounts[region] = 0;
+        usedMemory -= regionUsed[region];
+        regionUsed[region] = 0;
+    }
+
+    /**
+     * Remove an entry. Its memory is reclaimed when its region is reused.
+     *
+     * @param key the key
+     */
+    public synchronized void remove(long key) {
+        if (index.remove(key) != null) {
+            removeChunkKey(key);
+        }
+    }
+
+    /**
+     * Remove all entries of pages of a chunk. Their memory is reclaimed when
+     * their regions are reused.
+     *
+     * @param chunkId the chunk id
+     */
+    public synchronized void removeChunk(int chunkId) {
+        HashSet<Long> keys = chunkKeys.remove(chunkId);
+        if (keys != null) {
+            for (Long key : keys) {
+                index.remove(key);
+            }
+        }
+    }
+
+    private void removeChunkKey(long key) {
+        int chunkId = DataUtils.getPageChunkId(key);
+        HashSet<Long> keys = chunkKeys.get(chunkId);
+        if (keys != null && keys.remove(key) && keys.isEmpty()) {
+            chunkKeys.remove(chunkId);
+        }
+    }
+
+    /**
+     * Remove all entries.
+     */
+    public synchronized void clear() {
+        for (int i = 0; i < regions.length; i++) {
+            clearRegion(i);
+        }
+        index.clear();
+        chunkKeys.clear();
+        current = 0;
+        currentPosition = 0;
+    }
+
+    /**
+     * Get the maximum memory used by this cache.
+     *
+     * @return the maximum memory, in bytes
+     */
+    public long getMaxMemory() {
+        return maxMemory;
+    }
+
+    /**
+     * Get the memory used by entries, including removed entries whose memory
+     * was not reclaimed yet.
+     *
+     * @return the used memory, in bytes
+     */
+    public long getUsedMemory() {
+        return usedMemory;
+    }
+
+    /**
+     * Get the number of cache hits.
+     *
+     * @return the number of hits
+     */
+    public long getHits() {
+        return hits.sum();
+    }
+
+    /**
+     * Get the number of cache misses.
+     *
+     * @return the number of misses
+     */
+    public long getMisses() {
+        return misses.sum();
+    }
+
+}
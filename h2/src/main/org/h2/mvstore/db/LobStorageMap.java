@@ -104,6 +104,7 @@ public LobStorageMap(Database database) {
              */
             MVMap<Long, byte[]> dataMap = openLobDataMap(txStore);
             streamStore = new StreamStore(dataMap);
+            streamStore.setMaxBlockSize(Math.max(database.getSettings().lobBlockSize, 4 * 1024));
             // garbage collection of the last blocks
             if (!database.isReadOnly()) {
                 // don't re-use block ids, except at the very end
@@ -0,0 +1,392 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore.db;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collection;
+import java.util.List;
+import java.util.PriorityQueue;
+
+import org.h2.engine.Database;
+import org.h2.expression.Expression;
+import org.h2.message.DbException;
+import org.h2.mvstore.Cursor;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVMap.Builder;
+import org.h2.mvstore.type.LongDataType;
+import org.h2.result.ResultExternal;
+import org.h2.result.RowFactory.DefaultRowFactory;
+import org.h2.result.SortOrder;
+import org.h2.util.Task;
+import org.h2.value.CompareMode;
+import org.h2.value.Value;
+import org.h2.value.ValueRow;
+
+/**
+ * Sorted temporary result that uses an external merge sort.
+ *
+ * <p>
+ * This result is used for sorted results without DISTINCT. Each batch of added
+ * rows is sorted in memory and appended to a separate map (a sorted run), so
+ * the rows are written sequentially. The runs are merged when rows are read.
+ * Batches of added rows may be sorted in parallel, each thread produces its own
+ * run. If there are too many runs of the same size, they are merged into a
+ * larger run, so each row is merged only a few times.
+ * </p>
+ */
+class MVExternalSortTempResult extends MVTempResult {
+
+    /**
+     * The minimal number of rows for each thread.
+     */
+    private static final int MIN_ROWS_PER_THREAD = 4096;
+
+    /**
+     * The number of runs of the same level that are merged into a single run of
+     * the next level.
+     */
+    private static final int MAX_RUNS = 128;
+
+    /**
+     * The sort order.
+     */
+    private final SortOrder sort;
+
+    /**
+     * The maximum number of threads used for sorting of runs.
+     */
+    private final int parallelism;
+
+    /**
+     * The builder for maps with runs.
+     */
+    private final Builder<Long, ValueRow> builder;
+
+    /**
+     * The sorted runs. Only the root result adds runs.
+     */
+    private final ArrayList<MVMap<Long, ValueRow>> runs;
+
+    /**
+     * The merge levels of the runs. Runs of added rows have level 0, a run
+     * merged from runs of level n has level n + 1. The levels never increase
+     * from older to newer runs.
+     */
+    private final ArrayList<Integer> levels;
+
+    /**
+     * The counter for names of maps with runs.
+     */
+    private int runId;
+
+    /**
+     * Rows added with {@link #addRow(Value[])} that are not written to a run
+     * yet.
+     */
+    private ArrayList<Value[]> buffer;
+
+    /**
+     * The runs ordered by their next rows for the {@link #next()} method.
+     */
+    private PriorityQueue<Run> queue;
+
+    /**
+     * Creates a shallow copy of the result.
+     *
+     * @param parent
+     *                   parent result
+     */
+    private MVExternalSortTempResult(MVExternalSortTempResult parent) {
+        super(parent);
+        this.sort = parent.sort;
+        this.parallelism = 1;
+        this.builder = parent.builder;
+        this.runs = parent.runs;
+        this.levels = parent.levels;
+    }
+
+    /**
+     * Creates a new external sort temporary result.
+     *
+     * @param database
+     *            database
+     * @param expressions
+     *            column expressions
+     * @param visibleColumnCount
+     *            count of visible columns
+     * @param resultColumnCount
+     *            the number of columns including visible columns and additional
+     *            virtual columns for ORDER BY clause
+     * @param sort
+     *            sort order
+     * @param parallelism
+     *            the maximum number of threads used for sorting
+     */
+    MVExternalSortTempResult(Database database, Expression[] expressions, int visibleColumnCount,
+            int resultColumnCount, SortOrder sort, int parallelism) {
+        super(database, expressions, visibleColumnCount, resultColumnCount);
+        this.sort = sort;
+        // collators are not thread-safe
+        this.parallelism = CompareMode.OFF.equals(database.getCompareMode().getName()) ? parallelism : 1;
+        ValueDataType valueType = new ValueDataType(database, new int[resultColumnCount]);
+        valueType.setRowFactory(DefaultRowFactory.INSTANCE.createRowFactory(database, database.getCompareMode(),
+                database, expressions, null, false));
+        builder = new MVMap.Builder<Long, ValueRow>().keyType(LongDataType.INSTANCE).valueType(valueType)
+                .singleWriter();
+        runs = new ArrayList<>();
+        levels = new ArrayList<>();
+    }
+
+    @Override
+    public int addRow(Value[] values) {
+        assert parent == null;
+        if (buffer == null) {
+            buffer = new ArrayList<>();
+        }
+        buffer.add(values);
+        if (buffer.size() >= MIN_ROWS_PER_THREAD) {
+            flush();
+        }
+        return ++rowCount;
+    }
+
+    @Override
+    public int addRows(Collection<Value[]> rows) {
+        assert parent == null;
+        Value[][] array = rows.toArray(new Value[0][]);
+        addRuns(array);
+        rowCount += array.length;
+        return rowCount;
+    }
+
+    private void flush() {
+        if (buffer != null) {
+            addRuns(buffer.toArray(new Value[0][]));
+            buffer = null;
+        }
+    }
+
+    /**
+     * Sort the rows and write them as one or more runs.
+     *
+     * @param rows
+     *            the rows
+     */
+    private void addRuns(Value[][] rows) {
+        int length = rows.length;
+        if (length == 0) {
+            return;
+        }
+        int count = Math.max(Math.min(parallelism, length / MIN_ROWS_PER_THREAD), 1);
+        int[] bounds = new int[count + 1];
+        for (int i = 1; i <= count; i++) {
+            bounds[i] = (int) ((long) length * i / count);
+        }
+        if (count == 1) {
+            Arrays.sort(rows, sort);
+        } else {
+            SortTask[] tasks = new SortTask[count];
+            for (int i = 0; i < count; i++) {
+                tasks[i] = new SortTask(rows, bounds[i], bounds[i + 1]);
+            }
+            int started = 1;
+            try {
+                for (; started < count; started++) {
+                    tasks[started].execute("H2 Sort " + started);
+                }
+                tasks[0].call();
+            } finally {
+                for (int i = 1; i < started; i++) {
+                    tasks[i].join();
+                }
+            }
+            for (int i = 1; i < count; i++) {
+                Exception e = tasks[i].getException();
+                if (e != null) {
+                    throw DbException.convert(e);
+                }
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            MVMap<Long, ValueRow> run = openRun();
+            long key = 0L;
+            for (int j = bounds[i], end = bounds[i + 1]; j < end; j++) {
+                run.append(key++, ValueRow.get(rows[j]));
+            }
+            runs.add(run);
+            levels.add(0);
+        }
+        for (;;) {
+            int size = runs.size();
+            int level = levels.get(size - 1), from = size - 1;
+            while (from > 0 && levels.get(from - 1) == level) {
+                from--;
+            }
+            if (size - from < MAX_RUNS) {
+                break;
+            }
+            mergeRuns(from, level + 1);
+        }
+    }
+
+    private MVMap<Long, ValueRow> openRun() {
+        return store.openMap("run" + runId++, builder);
+    }
+
+    /**
+     * Merge the newest runs into a single run. The order of equal rows is
+     * preserved, because the merged runs are the last ones.
+     *
+     * @param from
+     *            the index of the first run to merge
+     * @param level
+     *            the level of the merged run
+     */
+    private void mergeRuns(int from, int level) {
+        MVMap<Long, ValueRow> merged = openRun();
+        List<MVMap<Long, ValueRow>> sourceRuns = runs.subList(from, runs.size());
+        PriorityQueue<Run> sources = openQueue(sourceRuns);
+        long key = 0L;
+        for (Value[] row; (row = next(sources)) != null;) {
+            merged.append(key++, ValueRow.get(row));
+        }
+        for (MVMap<Long, ValueRow> run : sourceRuns) {
+            store.removeMap(run);
+        }
+        sourceRuns.clear();
+        levels.subList(from, levels.size()).clear();
+        runs.add(merged);
+        levels.add(level);
+    }
+
+    private PriorityQueue<Run> openQueue(List<MVMap<Long, ValueRow>> list) {
+        int count = list.size();
+        PriorityQueue<Run> queue = new PriorityQueue<>(Math.max(count, 1), (a, b) -> {
+            int comp = sort.compare(a.current, b.current);
+            // rows from earlier runs go first to keep the order of equal rows
+            return comp != 0 ? comp : Integer.compare(a.index, b.index);
+        });
+        for (int i = 0; i < count; i++) {
+            Run run = new Run(list.get(i).cursor(null), i);
+            if (run.next()) {
+                queue.offer(run);
+            }
+        }
+        return queue;
+    }
+
+    private static Value[] next(PriorityQueue<Run> queue) {
+        Run run = queue.poll();
+        if (run == null) {
+            return null;
+        }
+        Value[] row = run.current;
+        if (run.next()) {
+            queue.offer(run);
+        }
+        return row;
+    }
+
+    @Override
+    public boolean contains(Value[] values) {
+        throw DbException.getUnsupportedException("contains()");
+    }
+
+    @Override
+    public synchronized ResultExternal createShallowCopy() {
+        if (parent != null) {
+            return parent.createShallowCopy();
+        }
+        if (closed) {
+            return null;
+        }
+        flush();
+        childCount++;
+        return new MVExternalSortTempResult(this);
+    }
+
+    @Override
+    public Value[] next() {
+        if (queue == null) {
+            flush();
+            queue = openQueue(runs);
+        }
+        return next(queue);
+    }
+
+    @Override
+    public int removeRow(Value[] values) {
+        throw DbException.getUnsupportedException("removeRow()");
+    }
+
+    @Override
+    public void reset() {
+        queue = null;
+    }
+
+    /**
+     * A sorted run with a cursor.
+     */
+    private static final class Run {
+
+        private final Cursor<Long, ValueRow> cursor;
+
+        /**
+         * The index of the run.
+         */
+        final int index;
+
+        /**
+         * The current row.
+         */
+        Value[] current;
+
+        Run(Cursor<Long, ValueRow> cursor, int index) {
+            this.cursor = cursor;
+            this.index = index;
+        }
+
+        /**
+         * Read the next row.
+         *
+         * @return whether the row was read
+         */
+        boolean next() {
+            if (!cursor.hasNext()) {
+                current = null;
+                return false;
+            }
+            cursor.next();
+            current = cursor.getValue().getList();
+            return true;
+        }
+
+    }
+
+    /**
+     * Sorts a part of an array of rows.
+     */
+    private final class SortTask extends Task {
+
+        private final Value[][] rows;
+
+        private final int fromIndex, toIndex;
+
+        SortTask(Value[][] rows, int fromIndex, int toIndex) {
+            this.rows = rows;
+            this.fromIndex = fromIndex;
+            this.toIndex = toIndex;
+        }
+
+        @Override
+        public void call() {
+            Arrays.sort(rows, fromIndex, toIndex, sort);
+        }
+
+    }
+
+}
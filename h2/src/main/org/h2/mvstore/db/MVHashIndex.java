@@ -0,0 +1,496 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore.db;
+
+import java.util.Arrays;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Objects;
+
+import org.h2.api.ErrorCode;
+import org.h2.command.query.AllColumnsForPlan;
+import org.h2.engine.Constants;
+import org.h2.engine.Database;
+import org.h2.engine.SessionLocal;
+import org.h2.expression.condition.Comparison;
+import org.h2.index.Cursor;
+import org.h2.index.IndexCondition;
+import org.h2.index.IndexType;
+import org.h2.index.SingleRowCursor;
+import org.h2.message.DbException;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVStoreException;
+import org.h2.mvstore.tx.Transaction;
+import org.h2.mvstore.tx.TransactionMap;
+import org.h2.result.Row;
+import org.h2.result.RowFactory;
+import org.h2.result.SearchRow;
+import org.h2.result.SortOrder;
+import org.h2.table.Column;
+import org.h2.table.IndexColumn;
+import org.h2.table.TableFilter;
+import org.h2.value.CompareMode;
+import org.h2.value.TypeInfo;
+import org.h2.value.Value;
+import org.h2.value.ValueInteger;
+import org.h2.value.ValueNull;
+import org.h2.value.VersionedValue;
+
+/**
+ * A hash index stored in a MVStore. The keys are ordered by a hash code of the
+ * indexed values that does not depend on the JVM, and then by the values and
+ * the row key. Lookups of equal values mostly compare int hash codes instead
+ * of the values, so they are faster than in an ordered index, especially for
+ * wide keys, but the index can be used only for equality conditions.
+ */
+public final class MVHashIndex extends MVIndex<SearchRow, Value> {
+
+    /**
+     * The multi-value table.
+     */
+    private final MVTable mvTable;
+
+    /**
+     * The factory of keys: the hash code in the column 0, and the indexed
+     * values in the following columns.
+     */
+    private final RowFactory keyFactory;
+
+    private final TransactionMap<SearchRow, Value> dataMap;
+
+    public MVHashIndex(Database db, MVTable table, int id, String indexName, IndexColumn[] columns,
+            int uniqueColumnCount, IndexType indexType) {
+        super(table, id, indexName, columns, uniqueColumnCount, indexType);
+        this.mvTable = table;
+        if (!database.isStarting()) {
+            checkIndexColumnTypes(columns);
+        }
+        int columnCount = columns.length + 1;
+        int[] sortTypes = new int[columnCount], indexes = new int[columnCount];
+        TypeInfo[] columnTypes = new TypeInfo[columnCount];
+        columnTypes[0] = TypeInfo.TYPE_INTEGER;
+        for (int i = 0; i < columnCount; i++) {
+            sortTypes[i] = SortOrder.ASCENDING;
+            indexes[i] = i;
+            if (i > 0) {
+                columnTypes[i] = columns[i - 1].column.getType();
+            }
+        }
+        keyFactory = RowFactory.getDefaultRowFactory().createRowFactory(db, db.getCompareMode(), db, sortTypes,
+                indexes, columnTypes, columnCount, true);
+        String mapName = "hash." + getId();
+        RowDataType keyType = keyFactory.getRowDataType();
+        Transaction t = mvTable.getTransactionBegin();
+        dataMap = t.openMap(mapName, keyType, NullValueDataType.INSTANCE);
+        dataMap.map.setVolatile(!table.isPersistData() || !indexType.isPersistent());
+        if (!db.isStarting()) {
+            dataMap.clear();
+        }
+        t.commit();
+        if (!keyType.equals(dataMap.getKeyType())) {
+            throw DbException.getInternalError(
+                    "Incompatible key type, expected " + keyType + " but got "
+                            + dataMap.getKeyType() + " for index " + indexName);
+        }
+    }
+
+    /**
+     * Check whether a hash index can be used for the specified columns. Hash
+     * codes must be equal for all values that are equal to each other, so
+     * only data types with such hash codes are supported, and character
+     * strings are supported only when the database uses the default
+     * collation.
+     *
+     * @param database the database
+     * @param columns the index columns
+     * @param uniqueColumnCount count of unique columns
+     * @return whether a hash index can be used
+     */
+    public static boolean isSupported(Database database, IndexColumn[] columns, int uniqueColumnCount) {
+        if (uniqueColumnCount != 0 && uniqueColumnCount != columns.length) {
+            return false;
+        }
+        for (IndexColumn indexColumn : columns) {
+            switch (indexColumn.column.getType().getValueType()) {
+            case Value.CHAR:
+            case Value.VARCHAR:
+                if (!CompareMode.OFF.equals(database.getCompareMode().getName())) {
+                    return false;
+                }
+                break;
+            case Value.BINARY:
+            case Value.VARBINARY:
+            case Value.BOOLEAN:
+            case Value.TINYINT:
+            case Value.SMALLINT:
+            case Value.INTEGER:
+            case Value.BIGINT:
+            case Value.REAL:
+            case Value.DOUBLE:
+            case Value.DATE:
+            case Value.TIME:
+            case Value.TIMESTAMP:
+            case Value.UUID:
+                break;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Get the hash code of a value. The hash code does not depend on the JVM,
+     * so it can be persisted.
+     *
+     * @param v the value of a supported data type
+     * @return the hash code
+     */
+    private static int hash(Value v) {
+        switch (v.getValueType()) {
+        case Value.NULL:
+            return 0;
+        case Value.CHAR:
+        case Value.VARCHAR:
+            return v.getString().hashCode();
+        case Value.BINARY:
+        case Value.VARBINARY:
+            return Arrays.hashCode(v.getBytesNoCopy());
+        case Value.BOOLEAN:
+            return v.getBoolean() ? 1 : 2;
+        case Value.TINYINT:
+        case Value.SMALLINT:
+        case Value.INTEGER:
+        case Value.BIGINT:
+            return Long.hashCode(v.getLong());
+        default:
+            // hash codes of these values are computed from their fields
+            return v.hashCode();
+        }
+    }
+
+    @Override
+    public void addRowsToBuffer(List<Row> rows, String bufferName) {
+        throw DbException.getInternalError();
+    }
+
+    @Override
+    public void addBufferedRows(List<String> bufferNames) {
+        throw DbException.getInternalError();
+    }
+
+    @Override
+    public void close(SessionLocal session) {
+        // ok
+    }
+
+    @Override
+    public void add(SessionLocal session, Row row) {
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        SearchRow key = convertToKey(row, row.getKey());
+        boolean checkRequired, allowNonRepeatableRead;
+        if (uniqueColumnColumn > 0 && !mayHaveNullDuplicates(row)) {
+            checkRequired = true;
+            allowNonRepeatableRead = session.getTransaction().allowNonRepeatableRead();
+        } else {
+            checkRequired = false;
+            allowNonRepeatableRead = false;
+        }
+        if (checkRequired) {
+            checkUnique(allowNonRepeatableRead, map, key, Long.MIN_VALUE);
+        }
+
+        try {
+            map.put(key, ValueNull.INSTANCE);
+        } catch (MVStoreException e) {
+            throw mvTable.convertException(e);
+        }
+
+        if (checkRequired) {
+            checkUnique(allowNonRepeatableRead, map, key, row.getKey());
+        }
+    }
+
+    private void checkUnique(boolean allowNonRepeatableRead, TransactionMap<SearchRow, Value> map, SearchRow key,
+            long newKey) {
+        SearchRow from = copyKey(key, Long.MIN_VALUE);
+        SearchRow to = copyKey(key, Long.MAX_VALUE);
+        if (!allowNonRepeatableRead) {
+            Iterator<SearchRow> it = map.keyIterator(from, to);
+            while (it.hasNext()) {
+                SearchRow k = it.next();
+                if (newKey != k.getKey() && !map.isDeletedByCurrentTransaction(k)) {
+                    throw getDuplicateKeyException(getKeyString(k));
+                }
+            }
+        }
+        Iterator<SearchRow> it = map.keyIteratorUncommitted(from, to);
+        while (it.hasNext()) {
+            SearchRow k = it.next();
+            if (newKey != k.getKey()) {
+                if (map.getImmediate(k) != null) {
+                    // committed
+                    throw getDuplicateKeyException(getKeyString(k));
+                }
+                throw DbException.get(ErrorCode.CONCURRENT_UPDATE_1, table.getName());
+            }
+        }
+    }
+
+    private String getKeyString(SearchRow key) {
+        StringBuilder builder = new StringBuilder("( /* key:").append(key.getKey()).append(" */ ");
+        for (int i = 1, l = key.getColumnCount(); i < l; i++) {
+            if (i > 1) {
+                builder.append(", ");
+            }
+            key.getValue(i).getSQL(builder, TRACE_SQL_FLAGS);
+        }
+        return builder.append(')').toString();
+    }
+
+    @Override
+    public void remove(SessionLocal session, Row row) {
+        SearchRow key = convertToKey(row, row.getKey());
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        try {
+            if (map.remove(key) == null) {
+                StringBuilder builder = new StringBuilder();
+                getSQL(builder, TRACE_SQL_FLAGS).append(": ").append(row.getKey());
+                throw DbException.get(ErrorCode.ROW_NOT_FOUND_WHEN_DELETING_1, builder.toString());
+            }
+        } catch (MVStoreException e) {
+            throw mvTable.convertException(e);
+        }
+    }
+
+    @Override
+    public void update(SessionLocal session, Row oldRow, Row newRow) {
+        if (!rowsAreEqual(oldRow, newRow)) {
+            super.update(session, oldRow, newRow);
+        }
+    }
+
+    private boolean rowsAreEqual(SearchRow rowOne, SearchRow rowTwo) {
+        if (rowOne == rowTwo) {
+            return true;
+        }
+        for (int index : columnIds) {
+            Value v1 = rowOne.getValue(index);
+            Value v2 = rowTwo.getValue(index);
+            if (!Objects.equals(v1, v2)) {
+                return false;
+            }
+        }
+        return rowOne.getKey() == rowTwo.getKey();
+    }
+
+    @Override
+    public Cursor find(SessionLocal session, SearchRow first, SearchRow last) {
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        SearchRow from = null, to = null;
+        if (first != null && last != null && isEqualityOnAllColumns(session, first, last)) {
+            SearchRow key = keyFactory.createRow();
+            int h = 0;
+            for (int i = 0, l = columns.length; i < l; i++) {
+                Value v;
+                try {
+                    v = columns[i].convert(session, first.getValue(columnIds[i]));
+                } catch (DbException e) {
+                    // the value cannot be equal to any value of the column
+                    return new SingleRowCursor(null);
+                }
+                key.setValue(i + 1, v);
+                h = 31 * h + hash(v);
+            }
+            key.setValue(0, ValueInteger.get(h));
+            from = copyKey(key, Long.MIN_VALUE);
+            to = copyKey(key, Long.MAX_VALUE);
+        }
+        // otherwise all rows are returned, the condition is checked by the
+        // caller
+        return new MVHashCursor(session, map.keyIterator(from, to), mvTable);
+    }
+
+    private boolean isEqualityOnAllColumns(SessionLocal session, SearchRow first, SearchRow last) {
+        for (int columnId : columnIds) {
+            Value v1 = first.getValue(columnId), v2 = last.getValue(columnId);
+            if (v1 == null || v2 == null || v1 != v2 && session.compare(v1, v2) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private SearchRow convertToKey(SearchRow row, long key) {
+        SearchRow result = keyFactory.createRow();
+        int h = 0;
+        for (int i = 0, l = columns.length; i < l; i++) {
+            Value v = row.getValue(columnIds[i]);
+            result.setValue(i + 1, v);
+            h = 31 * h + hash(v);
+        }
+        result.setValue(0, ValueInteger.get(h));
+        result.setKey(key);
+        return result;
+    }
+
+    private SearchRow copyKey(SearchRow row, long key) {
+        SearchRow result = keyFactory.createRow();
+        result.copyFrom(row);
+        result.setKey(key);
+        return result;
+    }
+
+    @Override
+    public MVTable getTable() {
+        return mvTable;
+    }
+
+    @Override
+    public double getCost(SessionLocal session, int[] masks, TableFilter[] filters, int filter,
+            SortOrder sortOrder, AllColumnsForPlan allColumnsSet) {
+        if (masks == null) {
+            return Long.MAX_VALUE;
+        }
+        for (int columnId : columnIds) {
+            if ((masks[columnId] & IndexCondition.EQUALITY) != IndexCondition.EQUALITY) {
+                return Long.MAX_VALUE;
+            }
+        }
+        if (columns.length > 1 && filters != null) {
+            // only the column of IN condition is set by IndexCursor
+            for (IndexCondition condition : filters[filter].getIndexConditions()) {
+                int compareType = condition.getCompareType();
+                if ((compareType == Comparison.IN_LIST || compareType == Comparison.IN_QUERY)
+                        && getColumnIndex(condition.getColumn()) >= 0) {
+                    return Long.MAX_VALUE;
+                }
+            }
+        }
+        try {
+            long rowCount = dataMap.sizeAsLongMax();
+            // rows are not sorted by the index, and they are always read from
+            // the primary index
+            long cost = getCostRangeIndex(masks, rowCount, filters, filter, null, false, null);
+            if (sortOrder != null) {
+                cost += 100 + (rowCount + Constants.COST_ROW_OFFSET) / 10;
+            }
+            // a lookup compares hash codes instead of values
+            return 8 * cost;
+        } catch (MVStoreException e) {
+            throw DbException.get(ErrorCode.OBJECT_CLOSED, e);
+        }
+    }
+
+    @Override
+    public void remove(SessionLocal session) {
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        if (!map.isClosed()) {
+            Transaction t = session.getTransaction();
+            t.removeMap(map);
+        }
+    }
+
+    @Override
+    public void truncate(SessionLocal session) {
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        map.clear();
+    }
+
+    @Override
+    public boolean needRebuild() {
+        try {
+            return dataMap.sizeAsLongMax() == 0;
+        } catch (MVStoreException e) {
+            throw DbException.get(ErrorCode.OBJECT_CLOSED, e);
+        }
+    }
+
+    @Override
+    public long getRowCount(SessionLocal session) {
+        TransactionMap<SearchRow, Value> map = getMap(session);
+        return map.sizeAsLong();
+    }
+
+    @Override
+    public long getRowCountApproximation(SessionLocal session) {
+        try {
+            return dataMap.sizeAsLongMax();
+        } catch (MVStoreException e) {
+            throw DbException.get(ErrorCode.OBJECT_CLOSED, e);
+        }
+    }
+
+    @Override
+    public long getDiskSpaceUsed() {
+        // TODO estimate disk space usage
+        return 0;
+    }
+
+    /**
+     * Get the map to store the data.
+     *
+     * @param session the session
+     * @return the map
+     */
+    private TransactionMap<SearchRow, Value> getMap(SessionLocal session) {
+        if (session == null) {
+            return dataMap;
+        }
+        Transaction t = session.getTransaction();
+        return dataMap.getInstance(t);
+    }
+
+    @Override
+    public MVMap<SearchRow, VersionedValue<Value>> getMVMap() {
+        return dataMap.map;
+    }
+
+    /**
+     * A cursor. Keys of this index have a different layout than rows of the
+     * table, so the search row is the row of the table.
+     */
+    private static final class MVHashCursor implements Cursor {
+
+        private final SessionLocal session;
+        private final Iterator<SearchRow> it;
+        private final MVTable mvTable;
+        private SearchRow current;
+        private Row row;
+
+        MVHashCursor(SessionLocal session, Iterator<SearchRow> it, MVTable mvTable) {
+            this.session = session;
+            this.it = it;
+            this.mvTable = mvTable;
+        }
+
+        @Override
+        public Row get() {
+            if (row == null && current != null) {
+                row = mvTable.getRow(session, current.getKey());
+            }
+            return row;
+        }
+
+        @Override
+        public SearchRow getSearchRow() {
+            return get();
+        }
+
+        @Override
+        public boolean next() {
+            current = it.hasNext() ? it.next() : null;
+            row = null;
+            return current != null;
+        }
+
+        @Override
+        public boolean previous() {
+            throw DbException.getUnsupportedException("previous");
+        }
+    }
+
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore.db;
+
+import org.h2.engine.Database;
+import org.h2.message.DbException;
+import org.h2.mvstore.Cursor;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVMap.Builder;
+import org.h2.result.ResultExternal;
+import org.h2.result.RowFactory.DefaultRowFactory;
+import org.h2.result.SortOrder;
+import org.h2.value.TypeInfo;
+import org.h2.value.Value;
+import org.h2.value.ValueBigint;
+import org.h2.value.ValueRow;
+
+/**
+ * Temporary storage of the rows of a hash join that has more rows than fit
+ * into memory.
+ *
+ * <p>
+ * The keys of the map are the values of the join columns followed by the key
+ * of the row, so all rows with the same values of the join columns can be read
+ * with one range cursor. The values of the map are the values of the row.
+ * </p>
+ */
+public final class MVHashJoinTempResult extends MVTempResult {
+
+    /**
+     * Map with values of join columns and row keys as keys and rows as values.
+     */
+    private final MVMap<ValueRow, ValueRow> map;
+
+    /**
+     * The number of join columns.
+     */
+    private final int keyColumnCount;
+
+    /**
+     * Cursor for the {@link #next()} method.
+     */
+    private Cursor<ValueRow, ValueRow> cursor;
+
+    /**
+     * Creates a new temporary storage for a hash join.
+     *
+     * @param database
+     *            database
+     * @param keyTypes
+     *            data types of join columns
+     * @param columnTypes
+     *            data types of all columns of the table
+     */
+    public MVHashJoinTempResult(Database database, TypeInfo[] keyTypes, TypeInfo[] columnTypes) {
+        super(database, null, columnTypes.length, columnTypes.length);
+        int keyColumnCount = keyTypes.length;
+        this.keyColumnCount = keyColumnCount;
+        TypeInfo[] types = new TypeInfo[keyColumnCount + 1];
+        System.arraycopy(keyTypes, 0, types, 0, keyColumnCount);
+        types[keyColumnCount] = TypeInfo.TYPE_BIGINT;
+        ValueDataType keyType = new ValueDataType(database,
+                SortOrder.addNullOrdering(database, new int[keyColumnCount + 1]));
+        keyType.setRowFactory(DefaultRowFactory.INSTANCE.createRowFactory(database, database.getCompareMode(),
+                database, null, null, types, types.length, false));
+        ValueDataType valueType = new ValueDataType(database, new int[columnTypes.length]);
+        valueType.setRowFactory(DefaultRowFactory.INSTANCE.createRowFactory(database, database.getCompareMode(),
+                database, null, null, columnTypes, columnTypes.length, false));
+        Builder<ValueRow, ValueRow> builder = new MVMap.Builder<ValueRow, ValueRow>().keyType(keyType)
+                .valueType(valueType).singleWriter();
+        map = store.openMap("tmp", builder);
+    }
+
+    /**
+     * Add a row.
+     *
+     * @param key
+     *            the values of join columns
+     * @param values
+     *            the values of the row
+     * @param rowKey
+     *            the key of the row
+     */
+    public void add(Value[] key, Value[] values, long rowKey) {
+        map.put(getKey(key, ValueBigint.get(rowKey)), ValueRow.get(values));
+        rowCount++;
+    }
+
+    /**
+     * Get a cursor over rows with the specified values of join columns. The
+     * key of the cursor contains the key of the row in its last element.
+     *
+     * @param key
+     *            the values of join columns
+     * @return the cursor
+     */
+    public Cursor<ValueRow, ValueRow> find(Value[] key) {
+        return map.cursor(getKey(key, ValueBigint.MIN), getKey(key, ValueBigint.MAX), false);
+    }
+
+    private ValueRow getKey(Value[] key, ValueBigint rowKey) {
+        Value[] values = new Value[keyColumnCount + 1];
+        System.arraycopy(key, 0, values, 0, keyColumnCount);
+        values[keyColumnCount] = rowKey;
+        return ValueRow.get(values);
+    }
+
+    @Override
+    public int addRow(Value[] values) {
+        throw DbException.getUnsupportedException("addRow()");
+    }
+
+    @Override
+    public boolean contains(Value[] values) {
+        throw DbException.getUnsupportedException("contains()");
+    }
+
+    @Override
+    public ResultExternal createShallowCopy() {
+        return null;
+    }
+
+    @Override
+    public Value[] next() {
+        if (cursor == null) {
+            cursor = map.cursor(null);
+        }
+        if (!cursor.hasNext()) {
+            return null;
+        }
+        cursor.next();
+        return cursor.getValue().getList();
+    }
+
+    @Override
+    public int removeRow(Value[] values) {
+        throw DbException.getUnsupportedException("removeRow()");
+    }
+
+    @Override
+    public void reset() {
+        cursor = null;
+    }
+
+}
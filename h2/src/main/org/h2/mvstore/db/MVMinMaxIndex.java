@@ -0,0 +1,340 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.mvstore.db;
+
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map.Entry;
+
+import org.h2.api.ErrorCode;
+import org.h2.command.query.AllColumnsForPlan;
+import org.h2.engine.Database;
+import org.h2.engine.SessionLocal;
+import org.h2.expression.condition.Comparison;
+import org.h2.index.Cursor;
+import org.h2.index.IndexCondition;
+import org.h2.index.IndexType;
+import org.h2.message.DbException;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVStoreException;
+import org.h2.mvstore.type.LongDataType;
+import org.h2.result.Row;
+import org.h2.result.RowFactory;
+import org.h2.result.SearchRow;
+import org.h2.result.SortOrder;
+import org.h2.table.Column;
+import org.h2.table.IndexColumn;
+import org.h2.table.TableFilter;
+import org.h2.value.Value;
+import org.h2.value.ValueBoolean;
+import org.h2.value.ValueNull;
+import org.h2.value.ValueRow;
+import org.h2.value.VersionedValue;
+
+/**
+ * A skip index that keeps the minimum and maximum values of the indexed
+ * columns for each block of rows with adjacent keys. The rows are read from
+ * the primary index, blocks that cannot contain matching rows are skipped.
+ * <p>
+ * The returned rows may not match the search condition, the condition is
+ * always evaluated for each row by the caller. The ranges of blocks are only
+ * extended, the index is not modified when rows are removed, and it is not
+ * transactional. This index is useful for large tables where values of the
+ * indexed columns are correlated with the order of insertion, such as
+ * timestamps of appended rows.
+ */
+public final class MVMinMaxIndex extends MVIndex<Long, SearchRow> {
+
+    /**
+     * The number of lower bits of a row key that are not used to select the
+     * block of the row.
+     */
+    private static final int BLOCK_BITS = 10;
+
+    private final MVPrimaryIndex mainIndex;
+
+    /**
+     * Key: the block number, value: the minimum value, the maximum value, and
+     * whether there are NULL values for each column.
+     */
+    private final MVMap<Long, Value> map;
+
+    public MVMinMaxIndex(Database db, MVTable table, int id, String indexName, IndexColumn[] columns,
+            MVPrimaryIndex mainIndex, IndexType indexType) {
+        super(table, id, indexName, columns, 0, indexType);
+        this.mainIndex = mainIndex;
+        if (!database.isStarting()) {
+            checkIndexColumnTypes(columns);
+        }
+        map = db.getStore().getMvStore().openMap("index." + getId(),
+                new MVMap.Builder<Long, Value>().keyType(LongDataType.INSTANCE)
+                        .valueType(new ValueDataType(db, null)));
+        map.setVolatile(!table.isPersistData() || !indexType.isPersistent());
+        if (!db.isStarting()) {
+            map.clear();
+        }
+    }
+
+    @Override
+    public RowFactory getRowFactory() {
+        return mainIndex.getRowFactory();
+    }
+
+    @Override
+    public void addRowsToBuffer(List<Row> rows, String bufferName) {
+        throw DbException.getInternalError();
+    }
+
+    @Override
+    public void addBufferedRows(List<String> bufferNames) {
+        throw DbException.getInternalError();
+    }
+
+    @Override
+    public MVMap<Long, VersionedValue<SearchRow>> getMVMap() {
+        return mainIndex.getMVMap();
+    }
+
+    @Override
+    public void close(SessionLocal session) {
+        // nothing to do
+    }
+
+    @Override
+    public void add(SessionLocal session, Row row) {
+        try {
+            extend(row);
+        } catch (MVStoreException e) {
+            throw DbException.get(ErrorCode.OBJECT_CLOSED, e);
+        }
+    }
+
+    /**
+     * Extend the ranges of the block of the row with its values.
+     *
+     * @param row the row
+     */
+    private synchronized void extend(Row row) {
+        long block = row.getKey() >> BLOCK_BITS;
+        int columnCount = columns.length;
+        Value old = map.get(block);
+        Value[] summary;
+        boolean changed;
+        if (old == null) {
+            summary = new Value[columnCount * 3];
+            for (int i = 0; i < columnCount; i++) {
+                summary[i * 3] = ValueNull.INSTANCE;
+                summary[i * 3 + 1] = ValueNull.INSTANCE;
+                summary[i * 3 + 2] = ValueBoolean.FALSE;
+            }
+            changed = true;
+        } else {
+            summary = ((ValueRow) old).getList().clone();
+            changed = false;
+        }
+        for (int i = 0; i < columnCount; i++) {
+            Value v = row.getValue(columnIds[i]);
+            int offset = i * 3;
+            if (v == ValueNull.INSTANCE) {
+                if (summary[offset + 2] != ValueBoolean.TRUE) {
+                    summary[offset + 2] = ValueBoolean.TRUE;
+                    changed = true;
+                }
+            } else {
+                Value min = summary[offset];
+                if (min == ValueNull.INSTANCE || table.compareValues(database, v, min) < 0) {
+                    summary[offset] = v;
+                    changed = true;
+                }
+                Value max = summary[offset + 1];
+                if (max == ValueNull.INSTANCE || table.compareValues(database, v, max) > 0) {
+                    summary[offset + 1] = v;
+                    changed = true;
+                }
+            }
+        }
+        if (changed) {
+            map.put(block, ValueRow.get(summary));
+        }
+    }
+
+    @Override
+    public void remove(SessionLocal session, Row row) {
+        // the ranges are not reduced
+    }
+
+    @Override
+    public void update(SessionLocal session, Row oldRow, Row newRow) {
+        add(session, newRow);
+    }
+
+    @Override
+    public Cursor find(SessionLocal session, SearchRow first, SearchRow last) {
+        return new MVMinMaxCursor(session, first, last);
+    }
+
+    /**
+     * Check whether the block may contain rows in the specified range.
+     *
+     * @param session the session
+     * @param summary the summary of the block
+     * @param first the first row, or {@code null}
+     * @param last the last row, or {@code null}
+     * @return whether the block may contain matching rows
+     */
+    boolean mayContain(SessionLocal session, Value[] summary, SearchRow first, SearchRow last) {
+        for (int i = 0, l = columns.length; i < l; i++) {
+            int columnId = columnIds[i];
+            Value from = first != null ? first.getValue(columnId) : null;
+            Value to = last != null ? last.getValue(columnId) : null;
+            if ((indexColumns[i].sortType & SortOrder.DESCENDING) != 0) {
+                Value temp = from;
+                from = to;
+                to = temp;
+            }
+            if (from == null && to == null) {
+                continue;
+            }
+            int offset = i * 3;
+            if (from == ValueNull.INSTANCE || to == ValueNull.INSTANCE) {
+                if (summary[offset + 2] != ValueBoolean.TRUE) {
+                    return false;
+                }
+                continue;
+            }
+            Value min = summary[offset], max = summary[offset + 1];
+            if (min == ValueNull.INSTANCE || from != null && session.compare(max, from) < 0
+                    || to != null && session.compare(min, to) > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    @Override
+    public double getCost(SessionLocal session, int[] masks, TableFilter[] filters, int filter,
+            SortOrder sortOrder, AllColumnsForPlan allColumnsSet) {
+        if (filters != null && hasInCondition(filters[filter])) {
+            return Double.POSITIVE_INFINITY;
+        }
+        // all rows of selected blocks are read from the primary index
+        return 10 * (getCostRangeIndex(masks, mainIndex.getRowCountApproximation(session), filters, filter,
+                sortOrder, true, allColumnsSet) + (1 << BLOCK_BITS));
+    }
+
+    /**
+     * Check whether the filter has an IN condition on the first indexed
+     * column. The index cursor looks up each value of IN separately, rows of
+     * a block that may contain multiple values would be returned more than
+     * once.
+     *
+     * @param filter the table filter
+     * @return whether there is an IN condition on the first column
+     */
+    private boolean hasInCondition(TableFilter filter) {
+        Column first = columns[0];
+        for (IndexCondition condition : filter.getIndexConditions()) {
+            int compareType = condition.getCompareType();
+            if ((compareType == Comparison.IN_LIST || compareType == Comparison.IN_QUERY)
+                    && condition.getColumn() == first) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    @Override
+    public void remove(SessionLocal session) {
+        if (!map.isClosed()) {
+            map.getStore().removeMap(map);
+        }
+    }
+
+    @Override
+    public void truncate(SessionLocal session) {
+        map.clear();
+    }
+
+    @Override
+    public boolean needRebuild() {
+        try {
+            return map.sizeAsLong() == 0;
+        } catch (MVStoreException e) {
+            throw DbException.get(ErrorCode.OBJECT_CLOSED, e);
+        }
+    }
+
+    @Override
+    public long getRowCount(SessionLocal session) {
+        return mainIndex.getRowCount(session);
+    }
+
+    @Override
+    public long getRowCountApproximation(SessionLocal session) {
+        return mainIndex.getRowCountApproximation(session);
+    }
+
+    @Override
+    public long getDiskSpaceUsed() {
+        // TODO estimate disk space usage
+        return 0;
+    }
+
+    /**
+     * A cursor over the rows of blocks that may contain matching rows.
+     */
+    private final class MVMinMaxCursor implements Cursor {
+
+        private final SessionLocal session;
+
+        private final SearchRow first, last;
+
+        private final Iterator<Entry<Long, Value>> blocks;
+
+        private Cursor current;
+
+        MVMinMaxCursor(SessionLocal session, SearchRow first, SearchRow last) {
+            this.session = session;
+            this.first = first;
+            this.last = last;
+            blocks = map.entrySet().iterator();
+        }
+
+        @Override
+        public Row get() {
+            return current == null ? null : current.get();
+        }
+
+        @Override
+        public SearchRow getSearchRow() {
+            return get();
+        }
+
+        @Override
+        public boolean next() {
+            while (current == null || !current.next()) {
+                current = null;
+                Entry<Long, Value> block;
+                do {
+                    if (!blocks.hasNext()) {
+                        return false;
+                    }
+                    block = blocks.next();
+                } while (!mayContain(session, ((ValueRow) block.getValue()).getList(), first, last));
+                long start = block.getKey() << BLOCK_BITS;
+                current = mainIndex.find(session, start, start | ((1L << BLOCK_BITS) - 1));
+            }
+            return true;
+        }
+
+        @Override
+        public boolean previous() {
+            throw DbException.getUnsupportedException("previous");
+        }
+
+    }
+
+}
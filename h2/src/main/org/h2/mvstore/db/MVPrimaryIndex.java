@@ -17,7 +17,9 @@
 import org.h2.index.IndexType;
 import org.h2.index.SingleRowCursor;
 import org.h2.message.DbException;
+import org.h2.mvstore.BulkLoader;
 import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVStore;
 import org.h2.mvstore.MVStoreException;
 import org.h2.mvstore.tx.Transaction;
 import org.h2.mvstore.tx.TransactionMap;
@@ -43,6 +45,8 @@ public class MVPrimaryIndex extends MVIndex<Long, SearchRow> {
     private final TransactionMap<Long, SearchRow> dataMap;
     private final AtomicLong lastKey = new AtomicLong();
     private int mainIndexColumn = SearchRow.ROWID_INDEX;
+    private BulkLoader<Long, VersionedValue<SearchRow>> bulkLoader;
+    private long maxBulkLoadMemory;
 
     public MVPrimaryIndex(Database db, MVTable table, int id, IndexColumn[] columns, IndexType indexType) {
         super(table, id, table.getName() + "_DATA", columns, 0, indexType);
@@ -85,6 +89,121 @@ public void close(SessionLocal session) {
 
     @Override
     public void add(SessionLocal session, Row row) {
+        prepareRow(session, row);
+        putRow(session, row);
+    }
+
+    private void putRow(SessionLocal session, Row row) {
+        TransactionMap<Long,SearchRow> map = getMap(session);
+        long rowKey = row.getKey();
+        try {
+            Row old = (Row)map.putIfAbsent(rowKey, row);
+            if (old != null) {
+                int errorCode = ErrorCode.CONCURRENT_UPDATE_1;
+                if (map.getImmediate(rowKey) != null || map.getFromSnapshot(rowKey) != null) {
+                    // committed
+                    errorCode = ErrorCode.DUPLICATE_KEY_1;
+                }
+                DbException e = DbException.get(errorCode,
+                        getDuplicatePrimaryKeyMessage(mainIndexColumn).append(' ').append(old).toString());
+                e.setSource(this);
+                throw e;
+            }
+        } catch (MVStoreException e) {
+            throw mvTable.convertException(e);
+        }
+        updateLastKey(rowKey);
+    }
+
+    /**
+     * Start a bulk load. The rows are added as committed rows without undo
+     * log to a tree that is not visible until it is published. The index must
+     * be empty and exclusively locked. The tree is kept in memory, if it
+     * exceeds the size of the cache of the store, the rows are added normally.
+     */
+    void startBulkLoad() {
+        MVStore store = dataMap.map.getStore();
+        bulkLoader = new BulkLoader<>(dataMap.map);
+        maxBulkLoadMemory = Math.max((long) store.getCacheSize() << 20, store.getAutoCommitMemory());
+    }
+
+    /**
+     * Add a row during a bulk load. If the key of the row is not larger than
+     * the keys of previously added rows, or the loaded rows need too much
+     * memory, the bulk load is stopped and all rows are added normally.
+     *
+     * @param session the session
+     * @param row the row
+     */
+    void addBulk(SessionLocal session, Row row) {
+        BulkLoader<Long, VersionedValue<SearchRow>> loader = bulkLoader;
+        if (loader == null) {
+            add(session, row);
+            return;
+        }
+        prepareRow(session, row);
+        long rowKey = row.getKey();
+        Long last = loader.getLastKey();
+        if (last != null && rowKey <= last || loader.getMemory() > maxBulkLoadMemory) {
+            addBulkLoadedRows(session);
+            putRow(session, row);
+            return;
+        }
+        @SuppressWarnings("unchecked")
+        VersionedValue<SearchRow> value = (VersionedValue<SearchRow>) (VersionedValue<?>) row;
+        try {
+            loader.add(rowKey, value);
+        } catch (MVStoreException e) {
+            throw mvTable.convertException(e);
+        }
+        updateLastKey(rowKey);
+    }
+
+    /**
+     * Make the rows of the bulk load visible, if any. If rows were added to
+     * the map meanwhile, the rows of the bulk load are added normally.
+     *
+     * @param session the session
+     */
+    void publishBulkLoad(SessionLocal session) {
+        BulkLoader<Long, VersionedValue<SearchRow>> loader = bulkLoader;
+        if (loader != null) {
+            boolean published;
+            try {
+                published = loader.publish();
+            } catch (MVStoreException e) {
+                throw mvTable.convertException(e);
+            }
+            if (published) {
+                bulkLoader = null;
+            } else {
+                addBulkLoadedRows(session);
+            }
+        }
+    }
+
+    /**
+     * Discard the rows of the bulk load, if any.
+     */
+    void discardBulkLoad() {
+        bulkLoader = null;
+    }
+
+    /**
+     * Stop the bulk load and add its rows normally.
+     *
+     * @param session the session
+     */
+    private void addBulkLoadedRows(SessionLocal session) {
+        BulkLoader<Long, VersionedValue<SearchRow>> loader = bulkLoader;
+        bulkLoader = null;
+        for (org.h2.mvstore.Cursor<Long, VersionedValue<SearchRow>> cursor = loader.cursor(); cursor.hasNext();) {
+            cursor.next();
+            putRow(session, (Row) (VersionedValue<?>) cursor.getValue());
+        }
+    }
+
+    private void prepareRow(SessionLocal session, Row row) {
         if (mainIndexColumn == SearchRow.ROWID_INDEX) {
             if (row.getKey() == 0) {
                 row.setKey(lastKey.incrementAndGet());
@@ -106,25 +225,9 @@ public void add(SessionLocal session, Row row) {
                 }
             }
         }
+    }
 
-        TransactionMap<Long,SearchRow> map = getMap(session);
-        long rowKey = row.getKey();
-        try {
-            Row old = (Row)map.putIfAbsent(rowKey, row);
-            if (old != null) {
-                int errorCode = ErrorCode.CONCURRENT_UPDATE_1;
-                if (map.getImmediate(rowKey) != null || map.getFromSnapshot(rowKey) != null) {
-                    // committed
-                    errorCode = ErrorCode.DUPLICATE_KEY_1;
-                }
-                DbException e = DbException.get(errorCode,
-                        getDuplicatePrimaryKeyMessage(mainIndexColumn).append(' ').append(old).toString());
-                e.setSource(this);
-                throw e;
-            }
-        } catch (MVStoreException e) {
-            throw mvTable.convertException(e);
-        }
+    private void updateLastKey(long rowKey) {
         // because it's possible to directly update the key using the _rowid_
         // syntax
         long last;
@@ -232,6 +335,40 @@ public Cursor find(SessionLocal session, SearchRow first, SearchRow last) {
         return find(session, min, max);
     }
 
+    /**
+     * Split all rows of this index into cursors over adjacent ranges of keys.
+     * All cursors see the same rows as a cursor returned by
+     * {@link #find(SessionLocal, SearchRow, SearchRow)} in the current
+     * statement, and they may be iterated by different threads.
+     *
+     * @param session the session
+     * @param count the desired number of cursors
+     * @return the cursors in ascending order of keys, there are fewer cursors
+     *         than requested if the range of keys is too small
+     */
+    public Cursor[] findPartitions(SessionLocal session, int count) {
+        TransactionMap<Long,SearchRow> map = getMap(session);
+        Long firstKey = map.firstKey(), lastKey = map.lastKey();
+        if (count <= 1 || firstKey == null || lastKey == null) {
+            return new Cursor[] { find(session, null, null) };
+        }
+        long first = firstKey, last = lastKey;
+        // the range may exceed Long.MAX_VALUE, so unsigned arithmetic is used
+        long step = Long.divideUnsigned(last - first, count);
+        if (step == 0L) {
+            return new Cursor[] { find(session, null, null) };
+        }
+        Cursor[] cursors = new Cursor[count];
+        long start = first;
+        for (int i = 0; i < count - 1; i++) {
+            long end = start + step;
+            cursors[i] = new MVStoreCursor(map.entryIterator(start, end - 1));
+            start = end;
+        }
+        cursors[count - 1] = new MVStoreCursor(map.entryIterator(start, last));
+        return cursors;
+    }
+
     private long extractPKFromRow(SearchRow row, long defaultValue) {
         long result;
         if (row == null) {
@@ -366,7 +503,15 @@ public void addBufferedRows(List<String> bufferNames) {
         throw new UnsupportedOperationException();
     }
 
-    private Cursor find(SessionLocal session, Long first, Long last) {
+    /**
+     * Find the rows with keys in the specified range.
+     *
+     * @param session the session
+     * @param first the first key, or {@code null} for no limit
+     * @param last the last key, or {@code null} for no limit
+     * @return the cursor
+     */
+    Cursor find(SessionLocal session, Long first, Long last) {
         TransactionMap<Long,SearchRow> map = getMap(session);
         if (first != null && last != null && first.longValue() == last.longValue()) {
             return new SingleRowCursor(setRowKey((Row) map.getFromSnapshot(first), first));
@@ -28,7 +28,8 @@
  * Sorted temporary result.
  *
  * <p>
- * This result is used for distinct and/or sorted results.
+ * This result is used for distinct results, they may also be sorted. Sorted
+ * results without DISTINCT use {@link MVExternalSortTempResult}.
  * </p>
  */
 class MVSortedTempResult extends MVTempResult {
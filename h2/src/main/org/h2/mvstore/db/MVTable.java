@@ -21,6 +21,7 @@
 import org.h2.message.DbException;
 import org.h2.message.Trace;
 import org.h2.mvstore.DataUtils;
+import org.h2.mvstore.MVStore;
 import org.h2.mvstore.MVStoreException;
 import org.h2.mvstore.tx.Transaction;
 import org.h2.mvstore.tx.TransactionStore;
@@ -29,6 +30,7 @@
 import org.h2.table.IndexColumn;
 import org.h2.table.RegularTable;
 import org.h2.util.DebuggingThreadLocal;
+import org.h2.util.Task;
 import org.h2.util.Utils;
 
 /**
@@ -105,6 +107,17 @@ public String getEventText() {
     private final Store store;
     private final TransactionStore transactionStore;
 
+    /**
+     * The session that adds rows in bulk, or {@code null}.
+     */
+    private volatile SessionLocal bulkLoadSession;
+
+    /**
+     * Whether the rows of the bulk load were added and wait for the commit of
+     * the transaction.
+     */
+    private boolean bulkLoadPending;
+
     public MVTable(CreateTableData data, Store store) {
         super(data);
         nextAnalyze = database.getSettings().analyzeAuto;
@@ -336,6 +349,14 @@ public Index addIndex(SessionLocal session, String indexName, int indexId, Index
         } else if (indexType.isSpatial()) {
             index = new MVSpatialIndex(session.getDatabase(), this, indexId,
                     indexName, cols, uniqueColumnCount, indexType);
+        } else if (indexType.isHash() && MVHashIndex.isSupported(database, cols, uniqueColumnCount)
+                // hash indexes of older versions are ordered indexes
+                && !(database.isStarting() && transactionStore.hasMap("index." + indexId))) {
+            index = new MVHashIndex(session.getDatabase(), this, indexId,
+                    indexName, cols, uniqueColumnCount, indexType);
+        } else if (indexType.isMinMax()) {
+            index = new MVMinMaxIndex(session.getDatabase(), this, indexId,
+                    indexName, cols, primaryIndex, indexType);
         } else {
             index = new MVSecondaryIndex(session.getDatabase(), this, indexId,
                     indexName, cols, uniqueColumnCount, indexType);
@@ -359,7 +380,8 @@ public Index addIndex(SessionLocal session, String indexName, int indexId, Index
 
     private void rebuildIndex(SessionLocal session, MVIndex<?,?> index, String indexName) {
         try {
-            if (!session.getDatabase().isPersistent() || index instanceof MVSpatialIndex) {
+            if (!session.getDatabase().isPersistent() || index instanceof MVSpatialIndex
+                    || index instanceof MVMinMaxIndex || index instanceof MVHashIndex) {
                 // in-memory
                 rebuildIndexBuffered(session, index);
             } else {
@@ -391,13 +413,19 @@ private void rebuildIndexBlockMerge(SessionLocal session, MVIndex<?,?> index) {
         Index scan = getScanIndex(session);
         long remaining = scan.getRowCount(session);
         long total = remaining;
+        int bufferSize = database.getMaxMemoryRows() / 2;
+        String n = getName() + ':' + index.getName();
+        int parallelism = database.isStarting() ? database.getSettings().rebuildIndexParallelism
+                : session.getParallelism();
+        if (parallelism > 1 && total > bufferSize) {
+            rebuildIndexParallel(session, index, total, bufferSize, parallelism, n);
+            return;
+        }
         Cursor cursor = scan.find(session, null, null);
         long i = 0;
         Store store = session.getDatabase().getStore();
 
-        int bufferSize = database.getMaxMemoryRows() / 2;
         ArrayList<Row> buffer = new ArrayList<>(bufferSize);
-        String n = getName() + ':' + index.getName();
         ArrayList<String> bufferNames = Utils.newSmallArrayList();
         while (cursor.next()) {
             Row row = cursor.get();
@@ -427,6 +455,73 @@ private void rebuildIndexBlockMerge(SessionLocal session, MVIndex<?,?> index) {
         }
     }
 
+    /**
+     * Build the sorted runs of rows with multiple threads and merge them into
+     * the index. Each thread reads a range of keys of the primary index.
+     *
+     * @param session the session
+     * @param index the index
+     * @param total the number of rows
+     * @param bufferSize the maximum number of rows to sort in memory
+     * @param parallelism the maximum number of threads, including the session
+     *            thread
+     * @param n the name used for progress reporting
+     */
+    private void rebuildIndexParallel(SessionLocal session, MVIndex<?,?> index, long total, int bufferSize,
+            int parallelism, String n) {
+        Cursor[] cursors = primaryIndex.findPartitions(session, parallelism);
+        int count = cursors.length;
+        // all threads together keep as many rows in memory as one thread
+        int runSize = Math.max(bufferSize / count, 1);
+        AtomicLong progress = new AtomicLong();
+        RunBuilder[] builders = new RunBuilder[count];
+        for (int i = 0; i < count; i++) {
+            builders[i] = new RunBuilder(session, index, cursors[i], runSize, progress, total, n, i == 0);
+        }
+        int started = 1;
+        boolean success = false;
+        ArrayList<String> bufferNames = Utils.newSmallArrayList();
+        try {
+            for (; started < count; started++) {
+                builders[started].execute("H2 Create Index " + started);
+            }
+            builders[0].build();
+            for (int i = 1; i < count; i++) {
+                Exception e = builders[i].getException();
+                if (e != null) {
+                    throw DbException.convert(e);
+                }
+            }
+            long rowCount = 0;
+            for (RunBuilder builder : builders) {
+                rowCount += builder.rowCount;
+                bufferNames.addAll(builder.bufferNames);
+            }
+            if (rowCount != total) {
+                throw DbException.getInternalError("rowcount remaining=" + (total - rowCount) + ' ' + getName());
+            }
+            success = true;
+        } finally {
+            if (!success) {
+                for (int i = 1; i < started; i++) {
+                    builders[i].canceled = true;
+                }
+                for (int i = 1; i < started; i++) {
+                    builders[i].join();
+                }
+                MVStore mvStore = store.getMvStore();
+                for (RunBuilder builder : builders) {
+                    for (String mapName : builder.bufferNames) {
+                        mvStore.removeMap(mapName);
+                    }
+                }
+            }
+        }
+        if (!bufferNames.isEmpty()) {
+            index.addBufferedRows(bufferNames);
+        }
+    }
+
     private void rebuildIndexBuffered(SessionLocal session, Index index) {
         Index scan = getScanIndex(session);
         long remaining = scan.getRowCount(session);
@@ -486,9 +581,72 @@ public long truncate(SessionLocal session) {
         return result;
     }
 
+    @Override
+    public boolean startBulkLoad(SessionLocal session) {
+        if (database.getLockMode() == Constants.LOCK_MODE_OFF || bulkLoadSession != null) {
+            return false;
+        }
+        for (Index index : indexes) {
+            if (index != primaryIndex && !(index instanceof MVDelegateIndex)) {
+                return false;
+            }
+        }
+        if (primaryIndex.getRowCountMax() != 0) {
+            return false;
+        }
+        lock(session, true, true);
+        // rows could be added before the lock was granted
+        if (primaryIndex.getRowCountMax() != 0) {
+            return false;
+        }
+        primaryIndex.startBulkLoad();
+        bulkLoadSession = session;
+        return true;
+    }
+
+    @Override
+    public void finishBulkLoad(SessionLocal session, boolean success) {
+        if (bulkLoadSession == session && !bulkLoadPending) {
+            if (success && session.isUndoLogEnabled()) {
+                bulkLoadPending = true;
+            } else {
+                endBulkLoad(session, success);
+            }
+        }
+    }
+
+    /**
+     * End the bulk load of the specified session, if any. This method is
+     * called when the transaction is committed or rolled back.
+     *
+     * @param session the session
+     * @param commit {@code true} to make the added rows visible,
+     *            {@code false} to discard them
+     */
+    public void endBulkLoad(SessionLocal session, boolean commit) {
+        if (bulkLoadSession == session) {
+            bulkLoadSession = null;
+            bulkLoadPending = false;
+            if (commit) {
+                primaryIndex.publishBulkLoad(session);
+            } else {
+                primaryIndex.discardBulkLoad();
+            }
+        }
+    }
+
     @Override
     public void addRow(SessionLocal session, Row row) {
         syncLastModificationIdWithDatabase();
+        if (bulkLoadSession == session && !bulkLoadPending) {
+            try {
+                primaryIndex.addBulk(session, row);
+            } catch (Throwable e) {
+                throw DbException.convert(e);
+            }
+            analyzeIfRequired(session);
+            return;
+        }
         Transaction t = session.getTransaction();
         long savepoint = t.setSavepoint();
         try {
@@ -669,4 +827,99 @@ public int getMainIndexColumn() {
         return primaryIndex.getMainIndexColumn();
     }
 
+    /**
+     * Reads a range of rows of the primary index, and writes them to temporary
+     * maps in sorted runs.
+     */
+    private final class RunBuilder extends Task {
+
+        private final SessionLocal session;
+
+        private final MVIndex<?,?> index;
+
+        private final Cursor cursor;
+
+        private final int runSize;
+
+        /**
+         * The number of rows read by all threads.
+         */
+        private final AtomicLong progress;
+
+        private final long total;
+
+        private final String progressName;
+
+        private final boolean sessionThread;
+
+        /**
+         * The names of the written temporary maps.
+         */
+        final ArrayList<String> bufferNames = Utils.newSmallArrayList();
+
+        /**
+         * The number of rows read by this thread.
+         */
+        long rowCount;
+
+        /**
+         * Whether the build has failed and this thread should stop. The stop
+         * flag of the task is not used, it is also set when the session thread
+         * waits for the result.
+         */
+        volatile boolean canceled;
+
+        RunBuilder(SessionLocal session, MVIndex<?,?> index, Cursor cursor, int runSize, AtomicLong progress,
+                long total, String progressName, boolean sessionThread) {
+            this.session = session;
+            this.index = index;
+            this.cursor = cursor;
+            this.runSize = runSize;
+            this.progress = progress;
+            this.total = total;
+            this.progressName = progressName;
+            this.sessionThread = sessionThread;
+        }
+
+        @Override
+        public void call() {
+            build();
+        }
+
+        /**
+         * Read all rows of the range and write the sorted runs.
+         */
+        void build() {
+            ArrayList<Row> buffer = new ArrayList<>(runSize);
+            while (cursor.next()) {
+                buffer.add(cursor.get());
+                if ((++rowCount & 1023) == 0) {
+                    long p = progress.addAndGet(1024);
+                    if (sessionThread) {
+                        session.checkCanceled();
+                        database.setProgress(DatabaseEventListener.STATE_CREATE_INDEX, progressName, p, total);
+                    } else if (canceled) {
+                        return;
+                    }
+                }
+                if (buffer.size() >= runSize) {
+                    writeRun(buffer);
+                }
+            }
+            progress.addAndGet(rowCount & 1023);
+            if (!buffer.isEmpty()) {
+                writeRun(buffer);
+            }
+        }
+
+        private void writeRun(ArrayList<Row> buffer) {
+            sortRows(buffer, index);
+            String mapName = store.nextTemporaryMapName();
+            bufferNames.add(mapName);
+            index.addRowsToBuffer(buffer, mapName);
+            buffer.clear();
+        }
+
+    }
+
 }
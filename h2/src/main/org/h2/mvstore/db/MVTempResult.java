@@ -75,14 +75,21 @@ public void close() throws Exception {
      *            virtual columns for ORDER BY and DISTINCT ON clauses
      * @param sort
      *            sort order, or {@code null}
+     * @param parallelism
+     *            the maximum number of threads that may be used to sort rows
      * @return temporary result
      */
     public static ResultExternal of(Database database, Expression[] expressions, boolean distinct,
-            int[] distinctIndexes, int visibleColumnCount, int resultColumnCount, SortOrder sort) {
-        return distinct || distinctIndexes != null || sort != null
-                ? new MVSortedTempResult(database, expressions, distinct, distinctIndexes, visibleColumnCount,
-                        resultColumnCount, sort)
-                : new MVPlainTempResult(database, expressions, visibleColumnCount, resultColumnCount);
+            int[] distinctIndexes, int visibleColumnCount, int resultColumnCount, SortOrder sort,
+            int parallelism) {
+        if (distinct || distinctIndexes != null) {
+            return new MVSortedTempResult(database, expressions, distinct, distinctIndexes, visibleColumnCount,
+                    resultColumnCount, sort);
+        } else if (sort != null) {
+            return new MVExternalSortTempResult(database, expressions, visibleColumnCount, resultColumnCount, sort,
+                    parallelism);
+        }
+        return new MVPlainTempResult(database, expressions, visibleColumnCount, resultColumnCount);
     }
 
     private final Database database;
@@ -10,6 +10,7 @@
 import java.util.ArrayList;
 import java.util.BitSet;
 import java.util.HashMap;
+import java.util.Iterator;
 import java.util.List;
 import java.util.Map;
 import java.util.concurrent.ConcurrentHashMap;
@@ -22,17 +23,23 @@
 import org.h2.message.DbException;
 import org.h2.mvstore.DataUtils;
 import org.h2.mvstore.FileStore;
+import org.h2.mvstore.MVMap;
 import org.h2.mvstore.MVStore;
 import org.h2.mvstore.MVStoreException;
 import org.h2.mvstore.MVStoreTool;
 import org.h2.mvstore.tx.Transaction;
 import org.h2.mvstore.tx.TransactionStore;
+import org.h2.mvstore.type.LongDataType;
 import org.h2.mvstore.type.MetaType;
 import org.h2.store.InDoubtTransaction;
 import org.h2.store.fs.FileChannelInputStream;
 import org.h2.store.fs.FileUtils;
+import org.h2.store.fs.encrypt.FileEncrypt;
+import org.h2.table.Column;
+import org.h2.table.ColumnStatistics;
 import org.h2.util.StringUtils;
 import org.h2.util.Utils;
+import org.h2.value.Value;
 
 /**
  * A store with open tables.
@@ -77,6 +84,19 @@ static char[] decodePassword(byte[] key) {
 
     private final String fileName;
 
+    /**
+     * The data type of persisted column statistics.
+     */
+    private final ValueDataType statisticsType;
+
+    /**
+     * The map with statistics of columns collected by ANALYZE, it is opened
+     * on demand.
+     * Key: the table id in the upper and the column id in the lower 32 bits,
+     * value: the statistics.
+     */
+    private MVMap<Long, Value> statisticsMap;
+
     /**
      * Creates the store.
      *
@@ -107,6 +127,22 @@ public Store(Database db) {
                 if (autoCompactFillRate <= 100) {
                     builder.autoCompactFillRate(autoCompactFillRate);
                 }
+                int autoCompactBandwidth = db.getSettings().autoCompactBandwidth;
+                if (autoCompactBandwidth > 0) {
+                    builder.autoCompactBandwidth(autoCompactBandwidth);
+                }
+                int readAhead = db.getSettings().readAhead;
+                if (readAhead > 0) {
+                    builder.readAhead(readAhead);
+                }
+                int serializationThreads = db.getSettings().serializationThreads;
+                if (serializationThreads > 1) {
+                    builder.serializationThreads(serializationThreads);
+                }
+            }
+            int offHeapCacheSize = db.getSettings().offHeapCacheSize;
+            if (offHeapCacheSize > 0) {
+                builder.offHeapCacheSize(offHeapCacheSize);
             }
             if (key != null) {
                 encrypted = true;
@@ -133,9 +169,11 @@ public Store(Database db) {
                 mvStore.setReuseSpace(false);
             }
             mvStore.setVersionsToKeep(0);
+            mvStore.setGroupCommitDelay(db.getSettings().groupCommitDelay);
             this.transactionStore = new TransactionStore(mvStore,
                     new MetaType<>(db, mvStore.backgroundExceptionHandler), new ValueDataType(db, null),
                     db.getLockTimeout());
+            statisticsType = new ValueDataType(db, null);
         } catch (MVStoreException e) {
             throw convertMVStoreException(e);
         }
@@ -195,6 +233,9 @@ public MVTable createTable(CreateTableData data) {
         try {
             MVTable table = new MVTable(data, this);
             tableMap.put(table.getMapName(), table);
+            if (table.isPersistData()) {
+                loadStatistics(table);
+            }
             return table;
         } catch (MVStoreException e) {
             throw convertMVStoreException(e);
@@ -209,11 +250,82 @@ public MVTable createTable(CreateTableData data) {
     public void removeTable(MVTable table) {
         try {
             tableMap.remove(table.getMapName());
+            if (table.isPersistData()) {
+                removeStatistics(table.getId());
+            }
         } catch (MVStoreException e) {
             throw convertMVStoreException(e);
         }
     }
 
+    /**
+     * Persist the statistics of the columns of a table.
+     *
+     * @param table the table
+     */
+    public void saveStatistics(MVTable table) {
+        if (mvStore.isReadOnly()) {
+            return;
+        }
+        try {
+            MVMap<Long, Value> map = getStatisticsMap(true);
+            long tableKey = (long) table.getId() << 32;
+            for (Column column : table.getColumns()) {
+                long key = tableKey | column.getColumnId();
+                ColumnStatistics statistics = column.getStatistics();
+                if (statistics != null) {
+                    map.put(key, statistics.toValue());
+                } else {
+                    map.remove(key);
+                }
+            }
+        } catch (MVStoreException e) {
+            throw convertMVStoreException(e);
+        }
+    }
+
+    private void loadStatistics(MVTable table) {
+        MVMap<Long, Value> map = getStatisticsMap(false);
+        if (map == null) {
+            return;
+        }
+        long tableKey = (long) table.getId() << 32;
+        for (Column column : table.getColumns()) {
+            Value value = map.get(tableKey | column.getColumnId());
+            if (value != null) {
+                ColumnStatistics statistics = ColumnStatistics.fromValue(value);
+                // the data type of the column may be changed since ANALYZE
+                if (statistics.getValueType() == column.getType().getValueType()) {
+                    column.setStatistics(statistics);
+                }
+            }
+        }
+    }
+
+    private void removeStatistics(int tableId) {
+        MVMap<Long, Value> map = getStatisticsMap(false);
+        if (map == null || mvStore.isReadOnly()) {
+            return;
+        }
+        long tableKey = (long) tableId << 32;
+        for (Iterator<Long> it = map.keyIterator(tableKey); it.hasNext();) {
+            long key = it.next();
+            if (key >>> 32 != tableId) {
+                break;
+            }
+            map.remove(key);
+        }
+    }
+
+    private synchronized MVMap<Long, Value> getStatisticsMap(boolean create) {
+        MVMap<Long, Value> map = statisticsMap;
+        if (map == null && (create || mvStore.hasMap("statistics"))) {
+            statisticsMap = map = mvStore.openMap("statistics",
+                    new MVMap.Builder<Long, Value>().keyType(LongDataType.INSTANCE).valueType(statisticsType));
+        }
+        return map;
+    }
+
     /**
      * Store all pending changes.
      */
@@ -245,13 +357,23 @@ public void removeTemporaryMaps(BitSet objectIds) {
         for (String mapName : mvStore.getMapNames()) {
             if (mapName.startsWith("temp.")) {
                 mvStore.removeMap(mapName);
-            } else if (mapName.startsWith("table.") || mapName.startsWith("index.")) {
+            } else if (mapName.startsWith("table.") || mapName.startsWith("index.")
+                    || mapName.startsWith("hash.")) {
                 int id = StringUtils.parseUInt31(mapName, mapName.indexOf('.') + 1, mapName.length());
                 if (!objectIds.get(id)) {
                     mvStore.removeMap(mapName);
                 }
             }
         }
+        MVMap<Long, Value> map = getStatisticsMap(false);
+        if (map != null && !mvStore.isReadOnly()) {
+            for (Iterator<Long> it = map.keyIterator(null); it.hasNext();) {
+                long key = it.next();
+                if (!objectIds.get((int) (key >>> 32))) {
+                    map.remove(key);
+                }
+            }
+        }
     }
 
     /**
@@ -297,11 +419,32 @@ public void setCacheSize(int kb) {
     }
 
     public InputStream getInputStream() {
+        return new FileChannelInputStream(getFileChannel(), false);
+    }
+
+    /**
+     * Get the file channel with the data of the database file as it is stored
+     * on the disk. Data of encrypted files is not decrypted.
+     *
+     * @return the file channel
+     */
+    public FileChannel getFileChannel() {
         FileChannel fc = mvStore.getFileStore().getEncryptedFile();
         if (fc == null) {
             fc = mvStore.getFileStore().getFile();
         }
-        return new FileChannelInputStream(fc, false);
+        return fc;
+    }
+
+    /**
+     * Get the length of the header of the file channel returned by
+     * {@link #getFileChannel()}. Positions in the store are shifted by this
+     * length in the channel.
+     *
+     * @return the length of the header in bytes
+     */
+    public int getFileHeaderLength() {
+        return mvStore.getFileStore().getEncryptedFile() != null ? FileEncrypt.HEADER_LENGTH : 0;
     }
 
     /**
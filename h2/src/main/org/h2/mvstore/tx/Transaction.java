@@ -160,6 +160,12 @@ public final class Transaction {
      */
     private volatile boolean notificationRequested;
 
+    /**
+     * The total time this transaction waited for other transactions, in
+     * nanoseconds.
+     */
+    private long lockWaitTimeNanos;
+
     /**
      * RootReferences for undo log snapshots
      */
@@ -300,6 +306,16 @@ public boolean hasStatementDependencies() {
         return !transactionMaps.isEmpty();
     }
 
+    /**
+     * Get the total time this transaction waited for locks of other
+     * transactions.
+     *
+     * @return the time in nanoseconds
+     */
+    public long getLockWaitTimeNanos() {
+        return lockWaitTimeNanos;
+    }
+
     /**
      * Returns the isolation level of this transaction.
      *
@@ -673,7 +689,13 @@ public boolean waitFor(Transaction toWaitFor, String mapName, Object key) {
         if (isDeadlocked(toWaitFor)) {
             tryThrowDeadLockException(false);
         }
-        boolean result = toWaitFor.waitForThisToEnd(timeoutMillis, this);
+        long start = System.nanoTime();
+        boolean result;
+        try {
+            result = toWaitFor.waitForThisToEnd(timeoutMillis, this);
+        } finally {
+            lockWaitTimeNanos += System.nanoTime() - start;
+        }
         blockingMapName = null;
         blockingKey = null;
         blockingTransaction = null;
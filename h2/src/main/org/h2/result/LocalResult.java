@@ -7,8 +7,11 @@
 
 import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.Collection;
+import java.util.PriorityQueue;
 import java.util.TreeMap;
 
+import org.h2.engine.Constants;
 import org.h2.engine.Database;
 import org.h2.engine.Session;
 import org.h2.engine.SessionLocal;
@@ -58,6 +61,20 @@ public static LocalResult forTable(SessionLocal session, Table table) {
     }
 
     private int maxMemoryRows;
+    /**
+     * Whether the estimated size of rows in memory is accounted.
+     */
+    private boolean accountMemory;
+    /**
+     * The maximum estimated size of rows in memory in bytes.
+     */
+    private long maxMemory = Long.MAX_VALUE;
+    /**
+     * The estimated size of rows in memory reserved in the session. The
+     * reservation is kept until the rows are written to disk or the result is
+     * closed.
+     */
+    private long memory;
     private final SessionLocal session;
     private int visibleColumnCount;
     private int resultColumnCount;
@@ -68,6 +85,12 @@ public static LocalResult forTable(SessionLocal session, Table table) {
     // HashSet cannot be used here, because we need to compare values of
     // different type or scale properly.
     private TreeMap<ValueRow, Value[]> distinctRows;
+    /**
+     * The first rows in the sort order with the last row on the top, or
+     * {@code null} if all rows are kept.
+     */
+    private PriorityQueue<Value[]> topRows;
+    private int topRowCount;
     private Value[] currentRow;
     private long offset;
     private long limit = -1;
@@ -113,6 +136,13 @@ public LocalResult(SessionLocal session, Expression[] expressions, int visibleCo
             Database db = session.getDatabase();
             if (db.isPersistent() && !db.isReadOnly()) {
                 this.maxMemoryRows = session.getDatabase().getMaxMemoryRows();
+                if (db.isQueryMemoryAccounted()) {
+                    accountMemory = true;
+                    long maxQueryMemory = db.getMaxQueryMemory();
+                    if (maxQueryMemory > 0) {
+                        maxMemory = maxQueryMemory;
+                    }
+                }
             } else {
                 this.maxMemoryRows = Integer.MAX_VALUE;
             }
@@ -179,6 +209,12 @@ public LocalResult createShallowCopy(Session targetSession) {
         copy.limit = -1;
         copy.external = e2;
         copy.containsNull = containsNull;
+        if (targetSession == session) {
+            // the copy shares the rows and owns their reservation, the
+            // original result may be dropped without closing it
+            copy.memory = memory;
+            memory = 0;
+        }
         return copy;
     }
 
@@ -192,6 +228,20 @@ public void setSortOrder(SortOrder sort) {
         this.sort = sort;
     }
 
+    /**
+     * Keep only the specified number of first rows in the sort order. A heap
+     * with a limited number of rows is used instead of sorting of all added
+     * rows. The sort order must be set and rows must not be distinct.
+     *
+     * @param count the number of rows to keep, including rows that are
+     *            skipped by the offset
+     */
+    public void setTopRows(int count) {
+        assert sort != null && !isAnyDistinct() && count > 0;
+        topRowCount = count;
+        topRows = new PriorityQueue<>(Math.min(count, 1024), (a, b) -> sort.compare(b, a));
+    }
+
     /**
      * Remove duplicate rows.
      */
@@ -364,7 +414,7 @@ private ValueRow getDistinctRow(Value[] values) {
 
     private void createExternalResult() {
         external = MVTempResult.of(session.getDatabase(), expressions, distinct, distinctIndexes, visibleColumnCount,
-                resultColumnCount, sort);
+                resultColumnCount, sort, session.getParallelism());
     }
 
     /**
@@ -403,18 +453,29 @@ private void addRowInternal(Value... values) {
                     distinctRows.put(distinctRow, values);
                 }
                 rowCount = distinctRows.size();
-                if (rowCount > maxMemoryRows) {
+                boolean memoryExceeded = previous == null && reserveMemory(values);
+                if (rowCount > maxMemoryRows || memoryExceeded) {
                     createExternalResult();
+                    accountSpilledRows(distinctRows.values());
                     rowCount = external.addRows(distinctRows.values());
                     distinctRows = null;
+                    releaseMemory();
                 }
             } else {
                 rowCount = external.addRow(values);
             }
+        } else if (topRows != null) {
+            if (topRows.size() < topRowCount) {
+                topRows.offer(values);
+                rowCount++;
+            } else if (sort.compare(values, topRows.peek()) < 0) {
+                topRows.poll();
+                topRows.offer(values);
+            }
         } else {
             rows.add(values);
             rowCount++;
-            if (rows.size() > maxMemoryRows) {
+            if (reserveMemory(values) || rows.size() > maxMemoryRows) {
                 addRowsToDisk();
             }
         }
@@ -424,8 +485,51 @@ private void addRowsToDisk() {
         if (external == null) {
             createExternalResult();
         }
+        accountSpilledRows(rows);
         rowCount = external.addRows(rows);
         rows.clear();
+        releaseMemory();
+    }
+
+    private void accountSpilledRows(Collection<Value[]> rows) {
+        long bytes = memory;
+        if (!accountMemory && session.isQueryProfiling()) {
+            for (Value[] values : rows) {
+                bytes += getMemory(values);
+            }
+        }
+        session.addSpilledRows(rows.size(), bytes);
+    }
+
+    /**
+     * Reserve memory for a row kept in memory.
+     *
+     * @param values the row
+     * @return whether rows in memory should be written to disk
+     */
+    private boolean reserveMemory(Value[] values) {
+        if (!accountMemory) {
+            return false;
+        }
+        long m = getMemory(values);
+        memory += m;
+        boolean available = session.reserveQueryMemory(m);
+        return !available || memory > maxMemory;
+    }
+
+    private static long getMemory(Value[] values) {
+        long m = Constants.MEMORY_ARRAY + (values.length + 1) * Constants.MEMORY_POINTER;
+        for (Value v : values) {
+            m += v.getMemory();
+        }
+        return m;
+    }
+
+    private void releaseMemory() {
+        if (memory != 0) {
+            session.releaseQueryMemory(memory);
+            memory = 0;
+        }
     }
 
     @Override
@@ -442,6 +546,9 @@ public void done() {
         } else {
             if (isAnyDistinct()) {
                 rows = new ArrayList<>(distinctRows.values());
+            } else if (topRows != null) {
+                rows = new ArrayList<>(topRows);
+                topRows = null;
             }
             if (sort != null && limit != 0 && !limitsWereApplied) {
                 boolean withLimit = limit > 0 && withTiesSortOrder == null;
@@ -529,7 +636,7 @@ private void trimExternal(long offset, long limit) {
         while (--limit >= 0) {
             row = temp.next();
             rows.add(row);
-            if (rows.size() > maxMemoryRows) {
+            if (reserveMemory(row) || rows.size() > maxMemoryRows) {
                 addRowsToDisk();
             }
         }
@@ -538,7 +645,7 @@ private void trimExternal(long offset, long limit) {
             while ((row = temp.next()) != null && withTiesSortOrder.compare(expected, row) == 0) {
                 rows.add(row);
                 rowCount++;
-                if (rows.size() > maxMemoryRows) {
+                if (reserveMemory(row) || rows.size() > maxMemoryRows) {
                     addRowsToDisk();
                 }
             }
@@ -600,6 +707,7 @@ public boolean needToClose() {
 
     @Override
     public void close() {
+        releaseMemory();
         if (external != null) {
             external.close();
             external = null;
@@ -0,0 +1,535 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.server;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.SelectionKey;
+import java.nio.channels.Selector;
+import java.nio.channels.SocketChannel;
+import java.util.ArrayList;
+import java.util.Iterator;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.RejectedExecutionException;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+import org.h2.message.DbException;
+
+/**
+ * Serves client connections of a server with a fixed number of worker threads.
+ * A worker thread is used by a connection only while requests of the client
+ * are processed. Idle connections are watched by a single selector thread and
+ * don't need a thread of their own.
+ * <p>
+ * The selector thread reads the data of clients in non-blocking mode, and a
+ * connection is dispatched to a worker thread only when a complete request was
+ * received, so worker threads don't wait for slow clients. Only requests that
+ * are larger than the buffer of a connection are read by the worker thread in
+ * blocking mode.
+ * </p>
+ * <p>
+ * A request may also wait for a lock. A connection that keeps its worker
+ * thread for longer than the hand-off time is handed off: the thread stays
+ * with this connection until its requests are processed, and another worker
+ * thread is started, so the other connections aren't stalled. The number of
+ * these additional threads is limited.
+ * </p>
+ */
+public final class ConnectionSelector implements Runnable {
+
+    /**
+     * A connection that can be served by the selector.
+     */
+    public interface Connection {
+
+        /**
+         * Returns the channel of the connection.
+         *
+         * @return the socket channel
+         */
+        SocketChannel getChannel();
+
+        /**
+         * Returns the input of the connection. The protocol code should read
+         * all data of the client from this stream.
+         *
+         * @return the input
+         */
+        Input getInput();
+
+        /**
+         * Skip a request of the client. This method is called by the selector
+         * thread, it should only parse the data and must not change the state
+         * of the connection. Data that can't be parsed should be treated as a
+         * complete request, the worker thread reports the error then.
+         *
+         * @param buff
+         *            the received data, the position is at the start of the
+         *            request
+         * @return {@code true} if the whole request was received, the position
+         *         is after the request in this case, {@code false} if more
+         *         data is needed
+         */
+        boolean skipRequest(ByteBuffer buff);
+
+        /**
+         * Read and process the available requests of the client. This method
+         * is called by a worker thread when a complete request was received,
+         * the channel is in blocking mode during this call. Implementations
+         * should return as soon as the client waits for the response and no
+         * more complete requests are available.
+         *
+         * @return {@code true} if the connection is still open,
+         *         {@code false} if it was closed
+         */
+        boolean processRequests();
+
+        /**
+         * Close the connection.
+         */
+        void close();
+
+    }
+
+    /**
+     * The default time in milliseconds after that a worker thread processing
+     * the requests of a connection is replaced by a new one.
+     */
+    public static final int DEFAULT_HAND_OFF_MILLIS = 100;
+
+    private final Selector selector;
+
+    private final int handOffMillis;
+
+    private final int maxHandOffThreads;
+
+    /**
+     * The number of worker threads that were handed off to connections and
+     * replaced by new ones. Guarded by the selector.
+     */
+    private int handOffThreads;
+
+    private final ThreadPoolExecutor workers;
+
+    /**
+     * Connections whose requests are being processed by worker threads.
+     */
+    private final ConcurrentHashMap<Connection, Work> busy = new ConcurrentHashMap<>();
+
+    /**
+     * Connections that wait for registration with the selector.
+     */
+    private final ConcurrentLinkedQueue<Connection> pending = new ConcurrentLinkedQueue<>();
+
+    private final Thread thread;
+
+    private volatile boolean stop;
+
+    /**
+     * Creates a new selector with its pool of worker threads.
+     *
+     * @param name
+     *            the prefix of names of threads
+     * @param workerCount
+     *            the number of worker threads
+     * @param handOffMillis
+     *            the time in milliseconds after that a worker thread that is
+     *            still busy with requests of one connection is replaced by a
+     *            new one
+     * @param maxHandOffThreads
+     *            the maximum number of additional worker threads started for
+     *            replaced ones
+     * @param daemon
+     *            whether daemon threads should be used
+     */
+    public ConnectionSelector(String name, int workerCount, int handOffMillis, int maxHandOffThreads,
+            boolean daemon) {
+        this.handOffMillis = Math.max(handOffMillis, 1);
+        this.maxHandOffThreads = maxHandOffThreads;
+        try {
+            selector = Selector.open();
+        } catch (IOException e) {
+            throw DbException.convertIOException(e, name);
+        }
+        AtomicInteger nextWorkerId = new AtomicInteger();
+        workers = new ThreadPoolExecutor(workerCount, workerCount, 60L, TimeUnit.SECONDS,
+                new LinkedBlockingQueue<>(), r -> {
+                    Thread t = new Thread(r, name + " worker-" + nextWorkerId.incrementAndGet());
+                    t.setDaemon(daemon);
+                    return t;
+                });
+        thread = new Thread(this, name + " selector");
+        thread.setDaemon(daemon);
+        thread.start();
+    }
+
+    /**
+     * Add a new connection. Its requests will be processed when the client
+     * sends them.
+     *
+     * @param connection
+     *            the connection
+     */
+    public void add(Connection connection) {
+        park(connection);
+    }
+
+    private void park(Connection connection) {
+        if (stop) {
+            connection.close();
+            return;
+        }
+        try {
+            connection.getChannel().configureBlocking(false);
+        } catch (IOException e) {
+            DbException.traceThrowable(e);
+            connection.close();
+            return;
+        }
+        pending.add(connection);
+        selector.wakeup();
+    }
+
+    private void serve(Connection connection) {
+        Work work = new Work(System.nanoTime());
+        busy.put(connection, work);
+        boolean open;
+        try {
+            open = connection.processRequests();
+        } catch (Throwable e) {
+            DbException.traceThrowable(e);
+            connection.close();
+            open = false;
+        } finally {
+            busy.remove(connection);
+            finish(work);
+        }
+        if (open) {
+            park(connection);
+        }
+    }
+
+    /**
+     * Hand off the connections that keep their worker threads for too long,
+     * and start a new worker thread for each of them, up to the maximum number
+     * of additional worker threads.
+     */
+    private void handOffBlocked() {
+        long now = System.nanoTime(), handOffNanos = TimeUnit.MILLISECONDS.toNanos(handOffMillis);
+        for (Work work : busy.values()) {
+            if (now - work.start >= handOffNanos && !handOff(work)) {
+                break;
+            }
+        }
+    }
+
+    private synchronized boolean handOff(Work work) {
+        if (handOffThreads >= maxHandOffThreads) {
+            return false;
+        }
+        if (!work.handedOff && !work.finished) {
+            work.handedOff = true;
+            handOffThreads++;
+            resizeWorkers(1);
+        }
+        return true;
+    }
+
+    private synchronized void finish(Work work) {
+        work.finished = true;
+        if (work.handedOff) {
+            handOffThreads--;
+            resizeWorkers(-1);
+        }
+    }
+
+    private void resizeWorkers(int delta) {
+        if (stop) {
+            return;
+        }
+        int size = workers.getCorePoolSize() + delta;
+        // the maximum size may not be smaller than the core size
+        if (delta > 0) {
+            workers.setMaximumPoolSize(size);
+            workers.setCorePoolSize(size);
+        } else {
+            workers.setCorePoolSize(size);
+            workers.setMaximumPoolSize(size);
+        }
+    }
+
+    @Override
+    public void run() {
+        ArrayList<Connection> ready = new ArrayList<>();
+        try {
+            while (!stop) {
+                selector.select(handOffMillis);
+                handOffBlocked();
+                for (Connection c; (c = pending.poll()) != null;) {
+                    if (c.getInput().hasRequest()) {
+                        ready.add(c);
+                        continue;
+                    }
+                    try {
+                        c.getChannel().register(selector, SelectionKey.OP_READ, c);
+                    } catch (ClosedChannelException e) {
+                        // the connection was closed by the server
+                    }
+                }
+                for (Set<SelectionKey> keys = selector.selectedKeys(); !keys.isEmpty() || !ready.isEmpty();) {
+                    for (Iterator<SelectionKey> i = keys.iterator(); i.hasNext();) {
+                        SelectionKey key = i.next();
+                        i.remove();
+                        Connection c = (Connection) key.attachment();
+                        boolean readable;
+                        try {
+                            readable = c.getInput().readAvailable(c);
+                        } catch (IOException e) {
+                            key.cancel();
+                            c.close();
+                            continue;
+                        }
+                        if (readable) {
+                            key.cancel();
+                            ready.add(c);
+                        }
+                    }
+                    // deregister the cancelled keys, blocking mode can't be
+                    // enabled for registered channels
+                    selector.selectNow();
+                    for (Connection c : ready) {
+                        dispatch(c);
+                    }
+                    ready.clear();
+                }
+            }
+        } catch (Exception e) {
+            if (!stop) {
+                DbException.traceThrowable(e);
+            }
+        }
+    }
+
+    private void dispatch(Connection connection) {
+        try {
+            connection.getChannel().configureBlocking(true);
+            workers.execute(() -> serve(connection));
+        } catch (IOException | RejectedExecutionException e) {
+            connection.close();
+        }
+    }
+
+    /**
+     * Stop the selector and the worker threads. The connections should be
+     * closed by the server.
+     */
+    public void stop() {
+        stop = true;
+        selector.wakeup();
+        try {
+            thread.join(1000);
+        } catch (InterruptedException e) {
+            DbException.traceThrowable(e);
+        }
+        workers.shutdown();
+        try {
+            selector.close();
+        } catch (IOException e) {
+            DbException.traceThrowable(e);
+        }
+    }
+
+    /**
+     * The input of a connection. The data is read by the selector thread in
+     * non-blocking mode, and then by the protocol code in a worker thread.
+     * When the received data is exhausted, the protocol code reads the rest of
+     * a request directly from the channel in blocking mode.
+     */
+    public static final class Input extends InputStream {
+
+        private static final int INITIAL_BUFFER_SIZE = 4 * 1024;
+
+        private static final int MAX_BUFFER_SIZE = 64 * 1024;
+
+        private final SocketChannel channel;
+
+        private InputStream blockingIn;
+
+        private byte[] data = new byte[INITIAL_BUFFER_SIZE];
+
+        /**
+         * The position of the next byte to read by the protocol code.
+         */
+        private int start;
+
+        /**
+         * The end of the complete requests.
+         */
+        private int complete;
+
+        /**
+         * The end of the received data.
+         */
+        private int end;
+
+        /**
+         * Creates a new input of the specified channel.
+         *
+         * @param channel
+         *            the channel
+         */
+        public Input(SocketChannel channel) {
+            this.channel = channel;
+        }
+
+        /**
+         * Read the data that is available in the channel in non-blocking mode.
+         * Called by the selector thread.
+         *
+         * @param connection
+         *            the connection that owns this input
+         * @return whether the connection should be dispatched to a worker
+         *         thread, because a complete request was received, the buffer
+         *         is full, or the end of stream was reached
+         * @throws IOException
+         *             on failure
+         */
+        boolean readAvailable(Connection connection) throws IOException {
+            for (;;) {
+                if (end == data.length) {
+                    if (start > 0) {
+                        System.arraycopy(data, start, data, 0, end - start);
+                        complete -= start;
+                        end -= start;
+                        start = 0;
+                    } else if (data.length < MAX_BUFFER_SIZE) {
+                        byte[] d = new byte[Math.min(data.length * 2, MAX_BUFFER_SIZE)];
+                        System.arraycopy(data, 0, d, 0, end);
+                        data = d;
+                    } else {
+                        // the request is too large, the worker thread reads
+                        // the rest of it in blocking mode
+                        return true;
+                    }
+                }
+                int n = channel.read(ByteBuffer.wrap(data, end, data.length - end));
+                if (n < 0) {
+                    return true;
+                } else if (n == 0) {
+                    break;
+                }
+                end += n;
+            }
+            ByteBuffer buff = ByteBuffer.wrap(data, complete, end - complete);
+            while (buff.hasRemaining() && connection.skipRequest(buff)) {
+                complete = buff.position();
+            }
+            return hasRequest();
+        }
+
+        /**
+         * Returns whether a complete request was received.
+         *
+         * @return whether a complete request is available
+         */
+        boolean hasRequest() {
+            return complete > start;
+        }
+
+        @Override
+        public int read() throws IOException {
+            if (start < end) {
+                int b = data[start] & 0xff;
+                consumed(1);
+                return b;
+            }
+            return getBlockingInput().read();
+        }
+
+        @Override
+        public int read(byte[] b, int off, int len) throws IOException {
+            if (len == 0) {
+                return 0;
+            }
+            if (start < end) {
+                // don't read incomplete requests that follow the complete ones
+                // into buffers of the protocol code
+                int n = Math.min(len, (complete > start ? complete : end) - start);
+                System.arraycopy(data, start, b, off, n);
+                consumed(n);
+                return n;
+            }
+            return getBlockingInput().read(b, off, len);
+        }
+
+        private void consumed(int n) {
+            start += n;
+            if (start == end) {
+                start = complete = end = 0;
+                if (data.length > INITIAL_BUFFER_SIZE) {
+                    data = new byte[INITIAL_BUFFER_SIZE];
+                }
+            } else if (complete < start) {
+                complete = start;
+            }
+        }
+
+        private InputStream getBlockingInput() throws IOException {
+            if (blockingIn == null) {
+                blockingIn = channel.socket().getInputStream();
+            }
+            return blockingIn;
+        }
+
+        /**
+         * Returns the number of bytes of complete requests that can be read
+         * without blocking.
+         *
+         * @return the number of available bytes
+         */
+        @Override
+        public int available() {
+            return complete - start;
+        }
+
+    }
+
+    /**
+     * The processing of requests of a connection by a worker thread. The
+     * flags are guarded by the selector.
+     */
+    private static final class Work {
+
+        /**
+         * The time when processing was started, in nanoseconds.
+         */
+        final long start;
+
+        /**
+         * Whether the worker thread was handed off to the connection and
+         * replaced by a new one.
+         */
+        boolean handedOff;
+
+        /**
+         * Whether the processing is finished.
+         */
+        boolean finished;
+
+        Work(long start) {
+            this.start = start;
+        }
+
+    }
+
+}
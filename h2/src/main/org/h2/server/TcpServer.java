@@ -61,6 +61,10 @@ public class TcpServer implements Service {
     private String baseDir;
     private boolean allowOthers;
     private boolean isDaemon;
+    private int workerCount;
+    private int handOffMillis = ConnectionSelector.DEFAULT_HAND_OFF_MILLIS;
+    private int maxHandOffThreads = -1;
+    private ConnectionSelector connectionSelector;
     private boolean ifExists = true;
     private JdbcConnection managementDb;
     private PreparedStatement managementDbAdd;
@@ -181,6 +185,12 @@ public void init(String... args) {
                 allowOthers = true;
             } else if (Tool.isOption(a, "-tcpDaemon")) {
                 isDaemon = true;
+            } else if (Tool.isOption(a, "-tcpWorkers")) {
+                workerCount = Integer.decode(args[++i]);
+            } else if (Tool.isOption(a, "-tcpHandOffMillis")) {
+                handOffMillis = Integer.decode(args[++i]);
+            } else if (Tool.isOption(a, "-tcpMaxHandOffThreads")) {
+                maxHandOffThreads = Integer.decode(args[++i]);
             } else if (Tool.isOption(a, "-ifExists")) {
                 ifExists = true;
             } else if (Tool.isOption(a, "-ifNotExists")) {
@@ -231,17 +241,29 @@ boolean allow(Socket socket) {
     @Override
     public synchronized void start() throws SQLException {
         stop = false;
+        if (workerCount > 0 && ssl) {
+            throw DbException.getUnsupportedException("-tcpWorkers with -tcpSSL");
+        }
         try {
-            serverSocket = NetUtils.createServerSocket(port, ssl);
+            serverSocket = createServerSocket(port);
         } catch (DbException e) {
             if (!portIsSet) {
-                serverSocket = NetUtils.createServerSocket(0, ssl);
+                serverSocket = createServerSocket(0);
             } else {
                 throw e;
             }
         }
         port = serverSocket.getLocalPort();
         initManagementDb();
+        if (workerCount > 0) {
+            connectionSelector = new ConnectionSelector(getName(), workerCount, handOffMillis,
+                    maxHandOffThreads >= 0 ? maxHandOffThreads : workerCount, isDaemon);
+        }
+    }
+
+    private ServerSocket createServerSocket(int port) {
+        return workerCount > 0 ? NetUtils.createServerSocketWithChannel(port)
+                : NetUtils.createServerSocket(port, ssl);
     }
 
     @Override
@@ -255,10 +277,14 @@ public void listen() {
                 int id = nextThreadId++;
                 TcpServerThread c = new TcpServerThread(s, this, id);
                 running.add(c);
-                Thread thread = new Thread(c, threadName + " thread-" + id);
-                thread.setDaemon(isDaemon);
-                c.setThread(thread);
-                thread.start();
+                if (connectionSelector != null) {
+                    connectionSelector.add(c);
+                } else {
+                    Thread thread = new Thread(c, threadName + " thread-" + id);
+                    thread.setDaemon(isDaemon);
+                    c.setThread(thread);
+                    thread.start();
+                }
             }
             serverSocket = NetUtils.closeSilently(serverSocket);
         } catch (Exception e) {
@@ -317,13 +343,20 @@ public void stop() {
         for (TcpServerThread c : new ArrayList<>(running)) {
             if (c != null) {
                 c.close();
-                try {
-                    c.getThread().join(100);
-                } catch (Exception e) {
-                    DbException.traceThrowable(e);
+                Thread t = c.getThread();
+                if (t != null) {
+                    try {
+                        t.join(100);
+                    } catch (Exception e) {
+                        DbException.traceThrowable(e);
+                    }
                 }
             }
         }
+        if (connectionSelector != null) {
+            connectionSelector.stop();
+            connectionSelector = null;
+        }
     }
 
     /**
@@ -12,7 +12,11 @@
 import java.io.PrintWriter;
 import java.io.StringWriter;
 import java.net.Socket;
+import java.nio.BufferUnderflowException;
+import java.nio.ByteBuffer;
+import java.nio.channels.SocketChannel;
 import java.sql.SQLException;
+import java.sql.Statement;
 import java.util.ArrayList;
 import java.util.Objects;
 
@@ -48,12 +52,15 @@
 /**
  * One server thread is opened per client connection.
  */
-public class TcpServerThread implements Runnable {
+public class TcpServerThread implements Runnable, ConnectionSelector.Connection {
 
     protected final Transfer transfer;
     private final TcpServer server;
     private SessionLocal session;
+    private final SocketChannel channel;
+    private final ConnectionSelector.Input input;
     private boolean stop;
+    private boolean connected;
     private Thread thread;
     private Command commit;
     private final SmallMap cache =
@@ -62,6 +69,12 @@ public class TcpServerThread implements Runnable {
             SmallLRUCache.newInstance(Math.max(
                 SysProperties.SERVER_CACHED_OBJECTS,
                 SysProperties.SERVER_RESULT_SET_FETCH_SIZE * 5));
+    /**
+     * The buffer used to read LOB data. Only a buffer of at most 16 I/O
+     * buffers is kept between requests, larger blocks use a buffer of their
+     * own, so idle connections don't keep large buffers.
+     */
+    private byte[] lobBuffer;
     private final int threadId;
     private int clientVersion;
     private String sessionId;
@@ -70,6 +83,8 @@ public class TcpServerThread implements Runnable {
     TcpServerThread(Socket socket, TcpServer server, int id) {
         this.server = server;
         this.threadId = id;
+        channel = socket.getChannel();
+        input = channel != null ? new ConnectionSelector.Input(channel) : null;
         transfer = new Transfer(null, socket);
     }
 
@@ -80,117 +95,9 @@ private void trace(String s) {
     @Override
     public void run() {
         try {
-            transfer.init();
-            trace("Connect");
-            // TODO server: should support a list of allowed databases
-            // and a list of allowed clients
-            try {
-                Socket socket = transfer.getSocket();
-                if (socket == null) {
-                    // the transfer is already closed, prevent NPE in TcpServer#allow(Socket)
-                    return;
-                }
-                if (!server.allow(transfer.getSocket())) {
-                    throw DbException.get(ErrorCode.REMOTE_CONNECTION_NOT_ALLOWED);
-                }
-                int minClientVersion = transfer.readInt();
-                if (minClientVersion < 6) {
-                    throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
-                            Integer.toString(minClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED);
-                }
-                int maxClientVersion = transfer.readInt();
-                if (maxClientVersion < Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED) {
-                    throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
-                            Integer.toString(maxClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED);
-                } else if (minClientVersion > Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED) {
-                    throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
-                            Integer.toString(minClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED);
-                }
-                if (maxClientVersion >= Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED) {
-                    clientVersion = Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED;
-                } else {
-                    clientVersion = maxClientVersion;
-                }
-                transfer.setVersion(clientVersion);
-                String db = transfer.readString();
-                String originalURL = transfer.readString();
-                if (db == null && originalURL == null) {
-                    String targetSessionId = transfer.readString();
-                    int command = transfer.readInt();
-                    stop = true;
-                    if (command == SessionRemote.SESSION_CANCEL_STATEMENT) {
-                        // cancel a running statement
-                        int statementId = transfer.readInt();
-                        server.cancelStatement(targetSessionId, statementId);
-                    } else if (command == SessionRemote.SESSION_CHECK_KEY) {
-                        // check if this is the correct server
-                        db = server.checkKeyAndGetDatabaseName(targetSessionId);
-                        if (!targetSessionId.equals(db)) {
-                            transfer.writeInt(SessionRemote.STATUS_OK);
-                        } else {
-                            transfer.writeInt(SessionRemote.STATUS_ERROR);
-                        }
-                    }
-                }
-                String baseDir = server.getBaseDir();
-                if (baseDir == null) {
-                    baseDir = SysProperties.getBaseDir();
-                }
-                db = server.checkKeyAndGetDatabaseName(db);
-                ConnectionInfo ci = new ConnectionInfo(db);
-                ci.setOriginalURL(originalURL);
-                ci.setUserName(transfer.readString());
-                ci.setUserPasswordHash(transfer.readBytes());
-                ci.setFilePasswordHash(transfer.readBytes());
-                int len = transfer.readInt();
-                for (int i = 0; i < len; i++) {
-                    ci.setProperty(transfer.readString(), transfer.readString());
-                }
-                // override client's requested properties with server settings
-                if (baseDir != null) {
-                    ci.setBaseDir(baseDir);
-                }
-                if (server.getIfExists()) {
-                    ci.setProperty("FORBID_CREATION", "TRUE");
-                }
-                transfer.writeInt(SessionRemote.STATUS_OK);
-                transfer.writeInt(clientVersion);
-                transfer.flush();
-                if (ci.getFilePasswordHash() != null) {
-                    ci.setFileEncryptionKey(transfer.readBytes());
-                }
-                ci.setNetworkConnectionInfo(new NetworkConnectionInfo(
-                        NetUtils.ipToShortForm(new StringBuilder(server.getSSL() ? "ssl://" : "tcp://"),
-                                socket.getLocalAddress().getAddress(), true) //
-                                .append(':').append(socket.getLocalPort()).toString(), //
-                        socket.getInetAddress().getAddress(), socket.getPort(),
-                        new StringBuilder().append('P').append(clientVersion).toString()));
-                if (clientVersion < Constants.TCP_PROTOCOL_VERSION_20) {
-                    // For DatabaseMetaData
-                    ci.setProperty("OLD_INFORMATION_SCHEMA", "TRUE");
-                    // For H2 Console
-                    ci.setProperty("NON_KEYWORDS", "VALUE");
-                }
-                session = Engine.createSession(ci);
-                transfer.setSession(session);
-                server.addConnection(threadId, originalURL, ci.getUserName());
-                trace("Connected");
-                lastRemoteSettingsId = session.getDatabase().getRemoteSettingsId();
-            } catch (OutOfMemoryError e) {
-                // catch this separately otherwise such errors will never hit the console
-                server.traceError(e);
-                sendError(e, true);
-                stop = true;
-            } catch (Throwable e) {
-                sendError(e,true);
-                stop = true;
-            }
+            connect();
             while (!stop) {
-                try {
-                    process();
-                } catch (Throwable e) {
-                    sendError(e, true);
-                }
+                processRequest();
             }
             trace("Disconnect");
         } catch (Throwable e) {
@@ -200,6 +107,288 @@ public void run() {
         }
     }
 
+    @Override
+    public SocketChannel getChannel() {
+        return channel;
+    }
+
+    @Override
+    public ConnectionSelector.Input getInput() {
+        return input;
+    }
+
+    @Override
+    public boolean skipRequest(ByteBuffer buff) {
+        try {
+            if (!connected) {
+                skipConnect(buff);
+            } else {
+                skipProcess(buff);
+            }
+            return true;
+        } catch (BufferUnderflowException e) {
+            return false;
+        } catch (DbException e) {
+            // let the worker thread report the error
+            buff.position(buff.limit());
+            return true;
+        }
+    }
+
+    /**
+     * Skip the data of the client that is read by {@link #connect()} before
+     * the server responds.
+     */
+    private static void skipConnect(ByteBuffer buff) {
+        buff.getInt();
+        buff.getInt();
+        boolean db = Transfer.skipString(buff);
+        boolean originalURL = Transfer.skipString(buff);
+        if (!db && !originalURL) {
+            Transfer.skipString(buff);
+            if (buff.getInt() == SessionRemote.SESSION_CANCEL_STATEMENT) {
+                buff.getInt();
+            }
+            // the client closes the connection
+            return;
+        }
+        Transfer.skipString(buff);
+        Transfer.skipBytes(buff);
+        Transfer.skipBytes(buff);
+        for (int i = 0, len = buff.getInt(); i < len; i++) {
+            Transfer.skipString(buff);
+            Transfer.skipString(buff);
+        }
+    }
+
+    /**
+     * Skip a request that is read by {@link #process()}.
+     */
+    private void skipProcess(ByteBuffer buff) {
+        int operation = buff.getInt();
+        switch (operation) {
+        case SessionRemote.SESSION_PREPARE_READ_PARAMS:
+        case SessionRemote.SESSION_PREPARE_READ_PARAMS2:
+        case SessionRemote.SESSION_PREPARE:
+            buff.getInt();
+            Transfer.skipString(buff);
+            break;
+        case SessionRemote.COMMAND_EXECUTE_QUERY:
+            buff.getInt();
+            buff.getInt();
+            transfer.skipRowCount(buff);
+            buff.getInt();
+            skipValues(buff);
+            break;
+        case SessionRemote.COMMAND_EXECUTE_UPDATE:
+            buff.getInt();
+            skipValues(buff);
+            if (clientVersion >= Constants.TCP_PROTOCOL_VERSION_17) {
+                int mode = buff.getInt();
+                if (mode == GeneratedKeysMode.COLUMN_NUMBERS) {
+                    for (int i = 0, len = buff.getInt(); i < len; i++) {
+                        buff.getInt();
+                    }
+                } else if (mode == GeneratedKeysMode.COLUMN_NAMES) {
+                    for (int i = 0, len = buff.getInt(); i < len; i++) {
+                        Transfer.skipString(buff);
+                    }
+                }
+            }
+            break;
+        case SessionRemote.COMMAND_EXECUTE_BATCH_UPDATE:
+            buff.getInt();
+            for (int i = 0, size = buff.getInt(); i < size; i++) {
+                skipValues(buff);
+            }
+            break;
+        case SessionRemote.COMMAND_CLOSE:
+        case SessionRemote.RESULT_RESET:
+        case SessionRemote.RESULT_CLOSE:
+            buff.getInt();
+            break;
+        case SessionRemote.COMMAND_GET_META_DATA:
+        case SessionRemote.RESULT_FETCH_ROWS:
+        case SessionRemote.CHANGE_ID:
+            buff.getInt();
+            buff.getInt();
+            break;
+        case SessionRemote.SESSION_SET_ID:
+            Transfer.skipString(buff);
+            if (clientVersion >= Constants.TCP_PROTOCOL_VERSION_20) {
+                Transfer.skipString(buff);
+            }
+            break;
+        case SessionRemote.SESSION_SET_AUTOCOMMIT:
+            buff.get();
+            break;
+        case SessionRemote.LOB_READ:
+            buff.getLong();
+            Transfer.skipBytes(buff);
+            buff.getLong();
+            buff.getInt();
+            break;
+        case SessionRemote.GET_JDBC_META:
+            buff.getInt();
+            skipValues(buff);
+            break;
+        default:
+            // SESSION_CLOSE, COMMAND_COMMIT, SESSION_HAS_PENDING_TRANSACTION,
+            // and unknown operations don't have any data
+            break;
+        }
+    }
+
+    private void skipValues(ByteBuffer buff) {
+        for (int i = 0, len = buff.getInt(); i < len; i++) {
+            transfer.skipValue(buff);
+        }
+    }
+
+    @Override
+    public boolean processRequests() {
+        try {
+            if (!connected) {
+                connect();
+            } else {
+                processRequest();
+            }
+            while (!stop && transfer.isInputBuffered()) {
+                processRequest();
+            }
+            if (!stop) {
+                return true;
+            }
+            trace("Disconnect");
+        } catch (Throwable e) {
+            server.traceError(e);
+        }
+        close();
+        return false;
+    }
+
+    private void connect() throws IOException {
+        connected = true;
+        if (input != null) {
+            transfer.init(input);
+        } else {
+            transfer.init();
+        }
+        trace("Connect");
+        // TODO server: should support a list of allowed databases
+        // and a list of allowed clients
+        try {
+            Socket socket = transfer.getSocket();
+            if (socket == null) {
+                // the transfer is already closed, prevent NPE in TcpServer#allow(Socket)
+                stop = true;
+                return;
+            }
+            if (!server.allow(transfer.getSocket())) {
+                throw DbException.get(ErrorCode.REMOTE_CONNECTION_NOT_ALLOWED);
+            }
+            int minClientVersion = transfer.readInt();
+            if (minClientVersion < 6) {
+                throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
+                        Integer.toString(minClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED);
+            }
+            int maxClientVersion = transfer.readInt();
+            if (maxClientVersion < Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED) {
+                throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
+                        Integer.toString(maxClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MIN_SUPPORTED);
+            } else if (minClientVersion > Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED) {
+                throw DbException.get(ErrorCode.DRIVER_VERSION_ERROR_2,
+                        Integer.toString(minClientVersion), "" + Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED);
+            }
+            if (maxClientVersion >= Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED) {
+                clientVersion = Constants.TCP_PROTOCOL_VERSION_MAX_SUPPORTED;
+            } else {
+                clientVersion = maxClientVersion;
+            }
+            transfer.setVersion(clientVersion);
+            String db = transfer.readString();
+            String originalURL = transfer.readString();
+            if (db == null && originalURL == null) {
+                String targetSessionId = transfer.readString();
+                int command = transfer.readInt();
+                stop = true;
+                if (command == SessionRemote.SESSION_CANCEL_STATEMENT) {
+                    // cancel a running statement
+                    int statementId = transfer.readInt();
+                    server.cancelStatement(targetSessionId, statementId);
+                } else if (command == SessionRemote.SESSION_CHECK_KEY) {
+                    // check if this is the correct server
+                    db = server.checkKeyAndGetDatabaseName(targetSessionId);
+                    if (!targetSessionId.equals(db)) {
+                        transfer.writeInt(SessionRemote.STATUS_OK);
+                    } else {
+                        transfer.writeInt(SessionRemote.STATUS_ERROR);
+                    }
+                }
+            }
+            String baseDir = server.getBaseDir();
+            if (baseDir == null) {
+                baseDir = SysProperties.getBaseDir();
+            }
+            db = server.checkKeyAndGetDatabaseName(db);
+            ConnectionInfo ci = new ConnectionInfo(db);
+            ci.setOriginalURL(originalURL);
+            ci.setUserName(transfer.readString());
+            ci.setUserPasswordHash(transfer.readBytes());
+            ci.setFilePasswordHash(transfer.readBytes());
+            int len = transfer.readInt();
+            for (int i = 0; i < len; i++) {
+                ci.setProperty(transfer.readString(), transfer.readString());
+            }
+            // override client's requested properties with server settings
+            if (baseDir != null) {
+                ci.setBaseDir(baseDir);
+            }
+            if (server.getIfExists()) {
+                ci.setProperty("FORBID_CREATION", "TRUE");
+            }
+            transfer.writeInt(SessionRemote.STATUS_OK);
+            transfer.writeInt(clientVersion);
+            transfer.flush();
+            if (ci.getFilePasswordHash() != null) {
+                ci.setFileEncryptionKey(transfer.readBytes());
+            }
+            ci.setNetworkConnectionInfo(new NetworkConnectionInfo(
+                    NetUtils.ipToShortForm(new StringBuilder(server.getSSL() ? "ssl://" : "tcp://"),
+                            socket.getLocalAddress().getAddress(), true) //
+                            .append(':').append(socket.getLocalPort()).toString(), //
+                    socket.getInetAddress().getAddress(), socket.getPort(),
+                    new StringBuilder().append('P').append(clientVersion).toString()));
+            if (clientVersion < Constants.TCP_PROTOCOL_VERSION_20) {
+                // For DatabaseMetaData
+                ci.setProperty("OLD_INFORMATION_SCHEMA", "TRUE");
+                // For H2 Console
+                ci.setProperty("NON_KEYWORDS", "VALUE");
+            }
+            session = Engine.createSession(ci);
+            transfer.setSession(session);
+            server.addConnection(threadId, originalURL, ci.getUserName());
+            trace("Connected");
+            lastRemoteSettingsId = session.getDatabase().getRemoteSettingsId();
+        } catch (OutOfMemoryError e) {
+            // catch this separately otherwise such errors will never hit the console
+            server.traceError(e);
+            sendError(e, true);
+            stop = true;
+        } catch (Throwable e) {
+            sendError(e,true);
+            stop = true;
+        }
+    }
+
+    private void processRequest() {
+        try {
+            process();
+        } catch (Throwable e) {
+            sendError(e, true);
+        }
+    }
+
     private void closeSession() {
         if (session != null) {
             RuntimeException closeError = null;
@@ -223,7 +412,8 @@ private void closeSession() {
     /**
      * Close a connection.
      */
-    void close() {
+    @Override
+    public void close() {
         try {
             stop = true;
             closeSession();
@@ -238,26 +428,11 @@ void close() {
 
     private void sendError(Throwable t, boolean withStatus) {
         try {
-            SQLException e = DbException.convert(t).getSQLException();
-            StringWriter writer = new StringWriter();
-            e.printStackTrace(new PrintWriter(writer));
-            String trace = writer.toString();
-            String message;
-            String sql;
-            if (e instanceof JdbcException) {
-                JdbcException j = (JdbcException) e;
-                message = j.getOriginalMessage();
-                sql = j.getSQL();
-            } else {
-                message = e.getMessage();
-                sql = null;
-            }
             if (withStatus) {
                 transfer.writeInt(SessionRemote.STATUS_ERROR);
             }
-            transfer.
-                    writeString(e.getSQLState()).writeString(message).
-                    writeString(sql).writeInt(e.getErrorCode()).writeString(trace).flush();
+            writeError(t);
+            transfer.flush();
         } catch (Exception e2) {
             if (!transfer.isClosed()) {
                 server.traceError(e2);
@@ -267,6 +442,26 @@ private void sendError(Throwable t, boolean withStatus) {
         }
     }
 
+    private void writeError(Throwable t) throws IOException {
+        SQLException e = DbException.convert(t).getSQLException();
+        StringWriter writer = new StringWriter();
+        e.printStackTrace(new PrintWriter(writer));
+        String trace = writer.toString();
+        String message;
+        String sql;
+        if (e instanceof JdbcException) {
+            JdbcException j = (JdbcException) e;
+            message = j.getOriginalMessage();
+            sql = j.getSQL();
+        } else {
+            message = e.getMessage();
+            sql = null;
+        }
+        transfer.
+                writeString(e.getSQLState()).writeString(message).
+                writeString(sql).writeInt(e.getErrorCode()).writeString(trace);
+    }
+
     private void setParameters(Command command) throws IOException {
         int len = transfer.readInt();
         ArrayList<? extends ParameterInterface> params = command.getParameters();
@@ -437,6 +632,46 @@ private void process() throws IOException {
             transfer.flush();
             break;
         }
+        case SessionRemote.COMMAND_EXECUTE_BATCH_UPDATE: {
+            int id = transfer.readInt();
+            Command command = (Command) cache.getObject(id, false);
+            int size = transfer.readInt();
+            ArrayList<Value[]> batchParameters = new ArrayList<>(size);
+            for (int i = 0; i < size; i++) {
+                int len = transfer.readInt();
+                Value[] set = new Value[len];
+                for (int j = 0; j < len; j++) {
+                    set[j] = transfer.readValue(null);
+                }
+                batchParameters.add(set);
+            }
+            int old = session.getModificationId();
+            ArrayList<DbException> exceptions = new ArrayList<>();
+            long[] result;
+            synchronized (session) {
+                result = command.executeBatchUpdate(batchParameters, exceptions);
+            }
+            int status;
+            if (session.isClosed()) {
+                status = SessionRemote.STATUS_CLOSED;
+                stop = true;
+            } else {
+                status = getState(old);
+            }
+            transfer.writeInt(status);
+            for (int i = 0, e = 0; i < size; i++) {
+                long updateCount = result[i];
+                if (updateCount != Statement.EXECUTE_FAILED) {
+                    transfer.writeBoolean(true).writeRowCount(updateCount);
+                } else {
+                    transfer.writeBoolean(false);
+                    writeError(exceptions.get(e++));
+                }
+            }
+            transfer.writeBoolean(session.getAutoCommit());
+            transfer.flush();
+            break;
+        }
         case SessionRemote.COMMAND_CLOSE: {
             int id = transfer.readInt();
             Command command = (Command) cache.getObject(id, true);
@@ -517,8 +752,15 @@ private void process() throws IOException {
                 lobIn.skip(offset);
             }
             // limit the buffer size
-            length = Math.min(16 * Constants.IO_BUFFER_SIZE, length);
-            byte[] buff = new byte[length];
+            int maxCachedLength = 16 * Constants.IO_BUFFER_SIZE;
+            length = Math.min(Math.max(maxCachedLength, SysProperties.LOB_READ_BLOCK_SIZE), length);
+            byte[] buff = lobBuffer;
+            if (buff == null || buff.length < length) {
+                buff = new byte[length];
+                if (length <= maxCachedLength) {
+                    lobBuffer = buff;
+                }
+            }
             length = IOUtils.readFully(in, buff, length);
             transfer.writeInt(SessionRemote.STATUS_OK);
             transfer.writeInt(length);
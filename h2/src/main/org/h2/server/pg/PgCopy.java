@@ -0,0 +1,687 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.server.pg;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.io.PushbackReader;
+import java.nio.charset.Charset;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+
+import org.h2.api.ErrorCode;
+import org.h2.message.DbException;
+import org.h2.util.StringUtils;
+
+/**
+ * A COPY statement of the PostgreSQL protocol. Only COPY FROM STDIN and COPY
+ * TO STDOUT are supported, the rows are transferred with the CopyData
+ * messages of the connection in the text, CSV, or binary format.
+ */
+final class PgCopy {
+
+    /**
+     * The text format.
+     */
+    static final int FORMAT_TEXT = 0;
+
+    /**
+     * The CSV format.
+     */
+    static final int FORMAT_CSV = 1;
+
+    /**
+     * The binary format.
+     */
+    static final int FORMAT_BINARY = 2;
+
+    /**
+     * The signature at the start of data in the binary format.
+     */
+    static final byte[] BINARY_SIGNATURE = { 'P', 'G', 'C', 'O', 'P', 'Y', '\n', (byte) 0xff, '\r', '\n', 0 };
+
+    private final String sql;
+
+    private int pos;
+
+    /**
+     * Whether the rows are copied from the client into a table.
+     */
+    boolean from;
+
+    /**
+     * The SQL of the table name, or {@code null} if a query is copied.
+     */
+    String tableName;
+
+    /**
+     * The SQL of the list of columns without parentheses, or {@code null}.
+     */
+    String columns;
+
+    /**
+     * The SQL of the query, or {@code null} if a table is copied.
+     */
+    String query;
+
+    /**
+     * The format.
+     */
+    int format = FORMAT_TEXT;
+
+    /**
+     * The delimiter of fields.
+     */
+    char delimiter;
+
+    /**
+     * The string that represents the NULL value.
+     */
+    String nullString;
+
+    /**
+     * Whether the first line contains the names of columns.
+     */
+    boolean header;
+
+    /**
+     * The quote character of the CSV format.
+     */
+    char quote = '"';
+
+    /**
+     * The escape character of the CSV format.
+     */
+    char escape;
+
+    /**
+     * The encoding of data, or {@code null} to use the client encoding.
+     */
+    Charset encoding;
+
+    private PgCopy(String sql) {
+        this.sql = sql;
+    }
+
+    /**
+     * Parse a COPY statement.
+     *
+     * @param sql the SQL statement
+     * @return the parsed statement, or {@code null} if this is not a COPY
+     *         statement
+     */
+    static PgCopy parse(String sql) {
+        PgCopy copy = new PgCopy(sql);
+        if (!"COPY".equals(copy.readWord())) {
+            return null;
+        }
+        copy.parseStatement();
+        return copy;
+    }
+
+    private void parseStatement() {
+        if (readIf('(')) {
+            query = readParenthesized();
+        } else {
+            tableName = readName();
+            if (readIf('(')) {
+                columns = readParenthesized();
+            }
+        }
+        String direction = readWord();
+        if ("FROM".equals(direction)) {
+            from = true;
+            if (query != null) {
+                throw syntaxError();
+            }
+        } else if (!"TO".equals(direction)) {
+            throw syntaxError();
+        }
+        String target = readWord();
+        if (target == null || !target.equals(from ? "STDIN" : "STDOUT")) {
+            throw DbException.getUnsupportedException("COPY " + (from ? "FROM" : "TO") + " file or program");
+        }
+        char delimiter = 0, quote = 0, escape = 0;
+        String nullString = null;
+        String word = readWord();
+        if ("WITH".equals(word)) {
+            word = readWord();
+        }
+        if (word == null && readIf('(')) {
+            // COPY ... WITH (FORMAT CSV, HEADER, ...)
+            do {
+                String option = readWord();
+                if (option == null) {
+                    throw syntaxError();
+                }
+                switch (option) {
+                case "FORMAT": {
+                    String f = readWord();
+                    if ("TEXT".equals(f)) {
+                        format = FORMAT_TEXT;
+                    } else if ("CSV".equals(f)) {
+                        format = FORMAT_CSV;
+                    } else if ("BINARY".equals(f)) {
+                        format = FORMAT_BINARY;
+                    } else {
+                        throw DbException.getInvalidValueException("FORMAT", f);
+                    }
+                    break;
+                }
+                case "DELIMITER":
+                    delimiter = readCharacter(option);
+                    break;
+                case "NULL":
+                    nullString = readString();
+                    break;
+                case "HEADER":
+                    header = readBooleanOption();
+                    break;
+                case "QUOTE":
+                    quote = readCharacter(option);
+                    break;
+                case "ESCAPE":
+                    escape = readCharacter(option);
+                    break;
+                case "ENCODING":
+                    setEncoding(readString());
+                    break;
+                case "FREEZE":
+                    // rows are always visible after the commit
+                    readBooleanOption();
+                    break;
+                default:
+                    throw DbException.getUnsupportedException("COPY option " + option);
+                }
+            } while (readIf(','));
+            if (!readIf(')')) {
+                throw syntaxError();
+            }
+        } else {
+            // COPY ... [WITH] [BINARY] [DELIMITER [AS] 'c'] [NULL [AS] 's'] [CSV [HEADER] ...]
+            for (; word != null; word = readWord()) {
+                switch (word) {
+                case "BINARY":
+                    format = FORMAT_BINARY;
+                    break;
+                case "CSV":
+                    format = FORMAT_CSV;
+                    break;
+                case "HEADER":
+                    header = true;
+                    break;
+                case "DELIMITER":
+                    readAs();
+                    delimiter = readCharacter(word);
+                    break;
+                case "NULL":
+                    readAs();
+                    nullString = readString();
+                    break;
+                case "QUOTE":
+                    readAs();
+                    quote = readCharacter(word);
+                    break;
+                case "ESCAPE":
+                    readAs();
+                    escape = readCharacter(word);
+                    break;
+                default:
+                    throw DbException.getUnsupportedException("COPY option " + word);
+                }
+            }
+        }
+        skipWhitespace();
+        if (pos < sql.length()) {
+            throw syntaxError();
+        }
+        if (format == FORMAT_BINARY) {
+            if (delimiter != 0 || nullString != null || header || quote != 0 || escape != 0) {
+                throw DbException.getUnsupportedException("COPY option in the BINARY format");
+            }
+            return;
+        }
+        if (format == FORMAT_CSV) {
+            this.delimiter = delimiter != 0 ? delimiter : ',';
+            this.nullString = nullString != null ? nullString : "";
+            if (quote != 0) {
+                this.quote = quote;
+            }
+            this.escape = escape != 0 ? escape : this.quote;
+            if (this.delimiter == this.quote) {
+                throw DbException.getInvalidValueException("QUOTE", this.quote);
+            }
+        } else {
+            if (quote != 0 || escape != 0) {
+                throw DbException.getUnsupportedException("COPY option in the TEXT format");
+            }
+            this.delimiter = delimiter != 0 ? delimiter : '\t';
+            this.nullString = nullString != null ? nullString : "\\N";
+            if (this.delimiter == '\\') {
+                throw DbException.getInvalidValueException("DELIMITER", this.delimiter);
+            }
+        }
+        if (this.delimiter == '\r' || this.delimiter == '\n') {
+            throw DbException.getInvalidValueException("DELIMITER", this.delimiter);
+        }
+    }
+
+    /**
+     * Get the SQL of the query that returns the copied rows or the columns of
+     * the target table.
+     *
+     * @return the SQL of the query
+     */
+    String getSelectSQL() {
+        if (query != null) {
+            return query;
+        }
+        return "SELECT " + (columns != null ? columns : "*") + " FROM " + tableName;
+    }
+
+    private void setEncoding(String name) {
+        try {
+            encoding = "UNICODE".equalsIgnoreCase(name) ? StandardCharsets.UTF_8 : Charset.forName(name);
+        } catch (Exception e) {
+            throw DbException.getInvalidValueException("ENCODING", name);
+        }
+    }
+
+    private void readAs() {
+        int start = pos;
+        if (!"AS".equals(readWord())) {
+            pos = start;
+        }
+    }
+
+    private boolean readBooleanOption() {
+        int start = pos;
+        String word = readWord();
+        if (word == null) {
+            skipWhitespace();
+            if (pos < sql.length() && Character.isDigit(sql.charAt(pos))) {
+                return sql.charAt(pos++) != '0';
+            }
+            return true;
+        }
+        switch (word) {
+        case "TRUE":
+        case "ON":
+            return true;
+        case "FALSE":
+        case "OFF":
+            return false;
+        default:
+            pos = start;
+            return true;
+        }
+    }
+
+    private char readCharacter(String option) {
+        String s = readString();
+        if (s.length() != 1) {
+            throw DbException.getInvalidValueException(option, s);
+        }
+        return s.charAt(0);
+    }
+
+    private String readString() {
+        skipWhitespace();
+        int length = sql.length();
+        boolean escaped = false;
+        if (pos + 1 < length && (sql.charAt(pos) == 'E' || sql.charAt(pos) == 'e') && sql.charAt(pos + 1) == '\'') {
+            escaped = true;
+            pos++;
+        }
+        if (pos >= length || sql.charAt(pos) != '\'') {
+            throw syntaxError();
+        }
+        StringBuilder builder = new StringBuilder();
+        for (pos++;; pos++) {
+            if (pos >= length) {
+                throw syntaxError();
+            }
+            char c = sql.charAt(pos);
+            if (c == '\'') {
+                if (pos + 1 < length && sql.charAt(pos + 1) == '\'') {
+                    pos++;
+                } else {
+                    pos++;
+                    break;
+                }
+            } else if (escaped && c == '\\' && pos + 1 < length) {
+                c = unescape(sql.charAt(++pos));
+            }
+            builder.append(c);
+        }
+        return builder.toString();
+    }
+
+    private String readName() {
+        skipWhitespace();
+        int start = pos, length = sql.length();
+        while (pos < length) {
+            char c = sql.charAt(pos);
+            if (c == '"') {
+                int end = sql.indexOf('"', pos + 1);
+                while (end >= 0 && end + 1 < length && sql.charAt(end + 1) == '"') {
+                    end = sql.indexOf('"', end + 2);
+                }
+                if (end < 0) {
+                    throw syntaxError();
+                }
+                pos = end + 1;
+            } else if (Character.isJavaIdentifierPart(c) || c == '.') {
+                pos++;
+            } else {
+                break;
+            }
+        }
+        if (start == pos) {
+            throw syntaxError();
+        }
+        return sql.substring(start, pos);
+    }
+
+    private String readParenthesized() {
+        int start = pos, level = 1, length = sql.length();
+        while (pos < length) {
+            char c = sql.charAt(pos++);
+            if (c == '\'' || c == '"') {
+                int end = sql.indexOf(c, pos);
+                if (end < 0) {
+                    throw syntaxError();
+                }
+                pos = end + 1;
+            } else if (c == '(') {
+                level++;
+            } else if (c == ')' && --level == 0) {
+                return sql.substring(start, pos - 1).trim();
+            }
+        }
+        throw syntaxError();
+    }
+
+    private String readWord() {
+        skipWhitespace();
+        int start = pos, length = sql.length();
+        while (pos < length && Character.isLetter(sql.charAt(pos))) {
+            pos++;
+        }
+        if (pos < length && (sql.charAt(pos) == '_' || Character.isDigit(sql.charAt(pos)))) {
+            pos = start;
+        }
+        return start == pos ? null : StringUtils.toUpperEnglish(sql.substring(start, pos));
+    }
+
+    private boolean readIf(char c) {
+        skipWhitespace();
+        if (pos < sql.length() && sql.charAt(pos) == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    private void skipWhitespace() {
+        int length = sql.length();
+        while (pos < length && Character.isWhitespace(sql.charAt(pos))) {
+            pos++;
+        }
+    }
+
+    private DbException syntaxError() {
+        return DbException.getSyntaxError(sql, pos);
+    }
+
+    /**
+     * Append a field of a row in the text or CSV format.
+     *
+     * @param builder the target
+     * @param value the text representation of the value, or {@code null}
+     */
+    void appendField(StringBuilder builder, String value) {
+        if (value == null) {
+            builder.append(nullString);
+        } else if (format == FORMAT_CSV) {
+            if (!needsQuotes(value)) {
+                builder.append(value);
+                return;
+            }
+            builder.append(quote);
+            for (int i = 0, length = value.length(); i < length; i++) {
+                char c = value.charAt(i);
+                if (c == quote || c == escape) {
+                    builder.append(escape);
+                }
+                builder.append(c);
+            }
+            builder.append(quote);
+        } else {
+            for (int i = 0, length = value.length(); i < length; i++) {
+                char c = value.charAt(i);
+                switch (c) {
+                case '\\':
+                    builder.append("\\\\");
+                    break;
+                case '\b':
+                    builder.append("\\b");
+                    break;
+                case '\f':
+                    builder.append("\\f");
+                    break;
+                case '\n':
+                    builder.append("\\n");
+                    break;
+                case '\r':
+                    builder.append("\\r");
+                    break;
+                case '\t':
+                    builder.append("\\t");
+                    break;
+                case 11:
+                    builder.append("\\v");
+                    break;
+                default:
+                    if (c == delimiter) {
+                        builder.append('\\');
+                    }
+                    builder.append(c);
+                }
+            }
+        }
+    }
+
+    private boolean needsQuotes(String value) {
+        if (value.equals(nullString) || value.startsWith("\\.")) {
+            return true;
+        }
+        for (int i = 0, length = value.length(); i < length; i++) {
+            char c = value.charAt(i);
+            if (c == delimiter || c == quote || c == escape || c == '\r' || c == '\n') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read a row in the text or CSV format.
+     *
+     * @param reader the reader
+     * @return the fields, {@code null} elements for NULL values, or
+     *         {@code null} at the end of data
+     * @throws IOException on failure
+     */
+    ArrayList<String> readRecord(PushbackReader reader) throws IOException {
+        int ch = reader.read();
+        if (ch < 0) {
+            return null;
+        }
+        ArrayList<String> fields = new ArrayList<>();
+        StringBuilder builder = new StringBuilder();
+        boolean quoted = false;
+        while (true) {
+            if (ch < 0 || ch == '\n' || ch == '\r') {
+                if (ch == '\r') {
+                    ch = reader.read();
+                    if (ch != '\n' && ch >= 0) {
+                        reader.unread(ch);
+                    }
+                }
+                addField(fields, builder, quoted);
+                break;
+            } else if (ch == delimiter) {
+                addField(fields, builder, quoted);
+                builder.setLength(0);
+                quoted = false;
+            } else if (format == FORMAT_CSV && ch == quote) {
+                quoted = true;
+                readQuoted(reader, builder);
+            } else if (format == FORMAT_TEXT && ch == '\\') {
+                ch = reader.read();
+                if (ch < 0) {
+                    throw DbException.get(ErrorCode.IO_EXCEPTION_1, "Unexpected end of COPY data");
+                }
+                builder.append('\\').append((char) ch);
+            } else {
+                builder.append((char) ch);
+            }
+            ch = reader.read();
+        }
+        if (fields.size() == 1 && !quoted && "\\.".equals(fields.get(0))) {
+            // the end-of-data marker
+            return null;
+        }
+        return fields;
+    }
+
+    private void readQuoted(PushbackReader reader, StringBuilder builder) throws IOException {
+        while (true) {
+            int ch = reader.read();
+            if (ch < 0) {
+                throw DbException.get(ErrorCode.IO_EXCEPTION_1, "Unterminated CSV quoted field");
+            }
+            if (ch == escape && escape != quote) {
+                int next = reader.read();
+                if (next == quote || next == escape) {
+                    builder.append((char) next);
+                    continue;
+                }
+                if (next >= 0) {
+                    reader.unread(next);
+                }
+            } else if (ch == quote) {
+                if (escape == quote) {
+                    int next = reader.read();
+                    if (next == quote) {
+                        builder.append(quote);
+                        continue;
+                    }
+                    if (next >= 0) {
+                        reader.unread(next);
+                    }
+                }
+                return;
+            }
+            builder.append((char) ch);
+        }
+    }
+
+    private void addField(ArrayList<String> fields, StringBuilder builder, boolean quoted) {
+        String s = builder.toString();
+        if (!quoted && s.equals(nullString)) {
+            fields.add(null);
+        } else if (format == FORMAT_TEXT && s.indexOf('\\') >= 0 && !"\\.".equals(s)) {
+            fields.add(unescapeText(s));
+        } else {
+            fields.add(s);
+        }
+    }
+
+    private static String unescapeText(String s) {
+        int length = s.length();
+        StringBuilder builder = new StringBuilder(length);
+        for (int i = 0; i < length; i++) {
+            char c = s.charAt(i);
+            if (c != '\\' || i + 1 == length) {
+                builder.append(c);
+                continue;
+            }
+            c = s.charAt(++i);
+            if (c >= '0' && c <= '7') {
+                int v = c - '0';
+                for (int j = 0; j < 2 && i + 1 < length; j++) {
+                    char d = s.charAt(i + 1);
+                    if (d < '0' || d > '7') {
+                        break;
+                    }
+                    v = v * 8 + d - '0';
+                    i++;
+                }
+                builder.append((char) v);
+            } else if (c == 'x' && i + 1 < length && Character.digit(s.charAt(i + 1), 16) >= 0) {
+                int v = Character.digit(s.charAt(++i), 16);
+                if (i + 1 < length && Character.digit(s.charAt(i + 1), 16) >= 0) {
+                    v = v * 16 + Character.digit(s.charAt(++i), 16);
+                }
+                builder.append((char) v);
+            } else {
+                builder.append(unescape(c));
+            }
+        }
+        return builder.toString();
+    }
+
+    private static char unescape(char c) {
+        switch (c) {
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'v':
+            return 11;
+        default:
+            return c;
+        }
+    }
+
+    /**
+     * Decode a BYTEA value in the hex or in the escape format.
+     *
+     * @param s the text representation
+     * @return the bytes
+     */
+    static byte[] decodeBytea(String s) {
+        if (s.startsWith("\\x")) {
+            return StringUtils.convertHexToBytes(s.substring(2));
+        }
+        int length = s.length();
+        ByteArrayOutputStream out = new ByteArrayOutputStream(length);
+        for (int i = 0; i < length; i++) {
+            char c = s.charAt(i);
+            if (c == '\\' && i + 1 < length) {
+                c = s.charAt(++i);
+                if (c != '\\') {
+                    if (i + 2 >= length) {
+                        throw DbException.get(ErrorCode.DATA_CONVERSION_ERROR_1, s);
+                    }
+                    c = (char) Integer.parseInt(s.substring(i, i + 3), 8);
+                    i += 2;
+                }
+            }
+            out.write(c);
+        }
+        return out.toByteArray();
+    }
+
+}
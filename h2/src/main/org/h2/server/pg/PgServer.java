@@ -16,6 +16,7 @@
 import java.util.concurrent.atomic.AtomicInteger;
 import org.h2.api.ErrorCode;
 import org.h2.message.DbException;
+import org.h2.server.ConnectionSelector;
 import org.h2.server.Service;
 import org.h2.util.NetUtils;
 import org.h2.util.Tool;
@@ -78,6 +79,10 @@ public class PgServer implements Service {
     private String baseDir;
     private boolean allowOthers;
     private boolean isDaemon;
+    private int workerCount;
+    private int handOffMillis = ConnectionSelector.DEFAULT_HAND_OFF_MILLIS;
+    private int maxHandOffThreads = -1;
+    private ConnectionSelector connectionSelector;
     private boolean ifExists = true;
     private String key, keyDatabase;
 
@@ -97,6 +102,12 @@ public void init(String... args) {
                 allowOthers = true;
             } else if (Tool.isOption(a, "-pgDaemon")) {
                 isDaemon = true;
+            } else if (Tool.isOption(a, "-pgWorkers")) {
+                workerCount = Integer.decode(args[++i]);
+            } else if (Tool.isOption(a, "-pgHandOffMillis")) {
+                handOffMillis = Integer.decode(args[++i]);
+            } else if (Tool.isOption(a, "-pgMaxHandOffThreads")) {
+                maxHandOffThreads = Integer.decode(args[++i]);
             } else if (Tool.isOption(a, "-ifExists")) {
                 ifExists = true;
             } else if (Tool.isOption(a, "-ifNotExists")) {
@@ -171,15 +182,24 @@ private boolean allow(Socket socket) {
     public void start() {
         stop = false;
         try {
-            serverSocket = NetUtils.createServerSocket(port, false);
+            serverSocket = createServerSocket(port);
         } catch (DbException e) {
             if (!portIsSet) {
-                serverSocket = NetUtils.createServerSocket(0, false);
+                serverSocket = createServerSocket(0);
             } else {
                 throw e;
             }
         }
         port = serverSocket.getLocalPort();
+        if (workerCount > 0) {
+            connectionSelector = new ConnectionSelector(getName(), workerCount, handOffMillis,
+                    maxHandOffThreads >= 0 ? maxHandOffThreads : workerCount, isDaemon);
+        }
+    }
+
+    private ServerSocket createServerSocket(int port) {
+        return workerCount > 0 ? NetUtils.createServerSocketWithChannel(port)
+                : NetUtils.createServerSocket(port, false);
     }
 
     @Override
@@ -197,10 +217,14 @@ public void listen() {
                     running.add(c);
                     int id = pid.incrementAndGet();
                     c.setProcessId(id);
-                    Thread thread = new Thread(c, threadName + " thread-" + id);
-                    thread.setDaemon(isDaemon);
-                    c.setThread(thread);
-                    thread.start();
+                    if (connectionSelector != null) {
+                        connectionSelector.add(c);
+                    } else {
+                        Thread thread = new Thread(c, threadName + " thread-" + id);
+                        thread.setDaemon(isDaemon);
+                        c.setThread(thread);
+                        thread.start();
+                    }
                 }
             }
         } catch (Exception e) {
@@ -238,6 +262,10 @@ public void stop() {
                 e.printStackTrace();
             }
         }
+        if (connectionSelector != null) {
+            connectionSelector.stop();
+            connectionSelector = null;
+        }
     }
 
     @Override
@@ -5,6 +5,8 @@
  */
 package org.h2.server.pg;
 
+import java.io.BufferedInputStream;
+import java.io.BufferedReader;
 import java.io.ByteArrayInputStream;
 import java.io.ByteArrayOutputStream;
 import java.io.DataInputStream;
@@ -12,15 +14,20 @@
 import java.io.EOFException;
 import java.io.IOException;
 import java.io.InputStream;
+import java.io.InputStreamReader;
 import java.io.OutputStream;
+import java.io.PushbackReader;
 import java.io.StringReader;
 import java.math.BigDecimal;
 import java.math.BigInteger;
 import java.net.Socket;
+import java.nio.ByteBuffer;
+import java.nio.channels.SocketChannel;
 import java.nio.charset.Charset;
 import java.nio.charset.StandardCharsets;
 import java.sql.SQLException;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.HashMap;
 import java.util.HashSet;
 import java.util.List;
@@ -29,6 +36,7 @@
 
 import org.h2.api.ErrorCode;
 import org.h2.command.CommandInterface;
+import org.h2.command.dml.Insert;
 import org.h2.engine.ConnectionInfo;
 import org.h2.engine.Constants;
 import org.h2.engine.Database;
@@ -39,6 +47,7 @@
 import org.h2.message.DbException;
 import org.h2.result.ResultInterface;
 import org.h2.schema.Schema;
+import org.h2.server.ConnectionSelector;
 import org.h2.table.Column;
 import org.h2.table.Table;
 import org.h2.util.DateTimeUtils;
@@ -71,7 +80,7 @@
 /**
  * One server thread is opened for each client.
  */
-public final class PgServerThread implements Runnable {
+public final class PgServerThread implements Runnable, ConnectionSelector.Connection {
 
     private static final boolean INTEGER_DATE_TYPES = false;
 
@@ -98,6 +107,8 @@ private static String convertTimeZone(String value, String prefix) {
 
     private final PgServer server;
     private Socket socket;
+    private final SocketChannel channel;
+    private final ConnectionSelector.Input input;
     private SessionLocal session;
     private boolean stop;
     private DataInputStream dataInRaw;
@@ -124,16 +135,15 @@ private static String convertTimeZone(String value, String prefix) {
     PgServerThread(Socket socket, PgServer server) {
         this.server = server;
         this.socket = socket;
+        channel = socket.getChannel();
+        input = channel != null ? new ConnectionSelector.Input(channel) : null;
         this.secret = (int) MathUtils.secureRandomLong();
     }
 
     @Override
     public void run() {
         try {
-            server.trace("Connect");
-            InputStream ins = socket.getInputStream();
-            out = socket.getOutputStream();
-            dataInRaw = new DataInputStream(ins);
+            connect();
             while (!stop) {
                 process();
                 out.flush();
@@ -148,6 +158,68 @@ public void run() {
         }
     }
 
+    @Override
+    public SocketChannel getChannel() {
+        return channel;
+    }
+
+    @Override
+    public ConnectionSelector.Input getInput() {
+        return input;
+    }
+
+    @Override
+    public boolean skipRequest(ByteBuffer buff) {
+        // the type of message is missing in the startup message
+        int header = initDone ? 5 : 4;
+        int pos = buff.position();
+        if (buff.remaining() < header) {
+            return false;
+        }
+        int len = buff.getInt(pos + header - 4);
+        if (len < 4) {
+            // let the worker thread report the error
+            buff.position(buff.limit());
+            return true;
+        }
+        long size = header - 4 + (long) len;
+        if (buff.remaining() < size) {
+            return false;
+        }
+        buff.position(pos + (int) size);
+        return true;
+    }
+
+    @Override
+    public boolean processRequests() {
+        try {
+            if (dataInRaw == null) {
+                connect();
+            }
+            do {
+                process();
+                out.flush();
+            } while (!stop && dataInRaw.available() > 0);
+            if (!stop) {
+                return true;
+            }
+        } catch (EOFException e) {
+            // more or less normal disconnect
+        } catch (Exception e) {
+            server.traceError(e);
+        }
+        server.trace("Disconnect");
+        close();
+        return false;
+    }
+
+    private void connect() throws IOException {
+        server.trace("Connect");
+        InputStream ins = input != null ? input : socket.getInputStream();
+        out = socket.getOutputStream();
+        dataInRaw = new DataInputStream(ins);
+    }
+
     private String readString() throws IOException {
         ByteArrayOutputStream buff = new ByteArrayOutputStream();
         while (true) {
@@ -464,6 +536,20 @@ private void process() throws IOException {
                     break;
                 }
                 s = getSQL(s);
+                try {
+                    PgCopy copy = PgCopy.parse(s);
+                    if (copy != null) {
+                        if (copy.from) {
+                            copyFrom(copy);
+                        } else {
+                            copyTo(copy);
+                        }
+                        continue;
+                    }
+                } catch (Exception e) {
+                    sendErrorOrCancelResponse(e);
+                    break;
+                }
                 try (CommandInterface command = session.prepareLocal(s)) {
                     setActiveRequest(command);
                     if (command.isQuery()) {
@@ -528,6 +614,221 @@ private void executeQuery(Prepared prepared, CommandInterface prep, int[] result
         }
     }
 
+    /**
+     * Execute COPY ... TO STDOUT. The rows of a lazy result are sent as they
+     * are read.
+     *
+     * @param copy the COPY statement
+     */
+    private void copyTo(PgCopy copy) throws IOException {
+        boolean lazy = session.isLazyQueryExecution();
+        session.setLazyQueryExecution(true);
+        try (CommandInterface command = session.prepareLocal(copy.getSelectSQL())) {
+            if (!command.isQuery()) {
+                throw DbException.get(ErrorCode.METHOD_ONLY_ALLOWED_FOR_QUERY);
+            }
+            setActiveRequest(command);
+            try (ResultInterface result = command.executeQuery(0, false)) {
+                int columnCount = result.getVisibleColumnCount();
+                int[] pgTypes = new int[columnCount];
+                for (int i = 0; i < columnCount; i++) {
+                    pgTypes[i] = PgServer.convertType(result.getColumnType(i));
+                }
+                sendCopyResponse('H', copy.format, columnCount);
+                long count = 0;
+                if (copy.format == PgCopy.FORMAT_BINARY) {
+                    startMessage('d');
+                    write(PgCopy.BINARY_SIGNATURE);
+                    // flags and the length of the header extension
+                    writeInt(0);
+                    writeInt(0);
+                    sendMessage();
+                    while (result.next()) {
+                        Value[] row = result.currentRow();
+                        startMessage('d');
+                        writeShort(columnCount);
+                        for (int i = 0; i < columnCount; i++) {
+                            writeDataColumn(row[i], pgTypes[i], !hasBinaryFormat(pgTypes[i]));
+                        }
+                        sendMessage();
+                        count++;
+                    }
+                    startMessage('d');
+                    writeShort(-1);
+                    sendMessage();
+                } else {
+                    Charset encoding = copy.encoding != null ? copy.encoding : getEncoding();
+                    StringBuilder builder = new StringBuilder();
+                    if (copy.header) {
+                        for (int i = 0; i < columnCount; i++) {
+                            if (i > 0) {
+                                builder.append(copy.delimiter);
+                            }
+                            copy.appendField(builder, result.getColumnName(i));
+                        }
+                        sendCopyData(builder, encoding);
+                    }
+                    while (result.next()) {
+                        Value[] row = result.currentRow();
+                        builder.setLength(0);
+                        for (int i = 0; i < columnCount; i++) {
+                            if (i > 0) {
+                                builder.append(copy.delimiter);
+                            }
+                            Value v = row[i];
+                            copy.appendField(builder, v == ValueNull.INSTANCE ? null : getText(v, pgTypes[i]));
+                        }
+                        sendCopyData(builder, encoding);
+                        count++;
+                    }
+                }
+                startMessage('c');
+                sendMessage();
+                sendCopyComplete(count);
+            }
+        } finally {
+            setActiveRequest(null);
+            session.setLazyQueryExecution(lazy);
+        }
+    }
+
+    /**
+     * Execute COPY ... FROM STDIN. The rows are inserted as they are received
+     * in one transaction, or with a savepoint if the auto-commit mode is
+     * disabled. Rows are added with the bulk load of the table if possible.
+     *
+     * @param copy the COPY statement
+     */
+    private void copyFrom(PgCopy copy) throws IOException {
+        int[] pgTypes;
+        String insertSQL;
+        try (CommandInterface select = session.prepareLocal(copy.getSelectSQL())) {
+            ResultInterface meta = select.getMetaData();
+            int columnCount = meta.getVisibleColumnCount();
+            pgTypes = new int[columnCount];
+            StringBuilder builder = new StringBuilder("INSERT INTO ").append(copy.tableName).append('(');
+            for (int i = 0; i < columnCount; i++) {
+                if (i > 0) {
+                    builder.append(", ");
+                }
+                StringUtils.quoteIdentifier(builder, meta.getColumnName(i));
+                pgTypes[i] = PgServer.convertType(meta.getColumnType(i));
+            }
+            builder.append(") VALUES (");
+            for (int i = 0; i < columnCount; i++) {
+                if (i > 0) {
+                    builder.append(", ");
+                }
+                builder.append('?');
+            }
+            insertSQL = builder.append(')').toString();
+        }
+        try (CommandInterface insert = session.prepareLocal(insertSQL)) {
+            sendCopyResponse('G', copy.format, pgTypes.length);
+            CopyInputStream in = new CopyInputStream();
+            boolean autoCommit = session.getAutoCommit();
+            session.setAutoCommit(false);
+            SessionLocal.Savepoint savepoint = session.setSavepoint();
+            setActiveRequest(insert);
+            long count;
+            try {
+                Table table = null;
+                if (autoCommit || !session.isUndoLogEnabled()) {
+                    Table t = ((Insert) session.prepare(insertSQL)).getTable();
+                    if (!t.fireRow() && t.startBulkLoad(session)) {
+                        table = t;
+                    }
+                }
+                boolean success = false;
+                try {
+                    count = copy.format == PgCopy.FORMAT_BINARY ? insertBinaryRows(in, insert, pgTypes)
+                            : insertTextRows(copy, in, insert, pgTypes);
+                    success = true;
+                } finally {
+                    if (table != null) {
+                        table.finishBulkLoad(session, success);
+                    }
+                }
+                in.skipRemaining();
+                if (autoCommit) {
+                    session.commit(false);
+                }
+            } catch (Exception e) {
+                if (autoCommit) {
+                    session.rollback();
+                } else {
+                    session.rollbackTo(savepoint);
+                }
+                // the rest of data is discarded
+                in.skipRemaining();
+                throw e;
+            } finally {
+                setActiveRequest(null);
+                session.setAutoCommit(autoCommit);
+            }
+            sendCopyComplete(count);
+        }
+    }
+
+    private long insertTextRows(PgCopy copy, InputStream in, CommandInterface insert, int[] pgTypes)
+            throws IOException {
+        PushbackReader reader = new PushbackReader(new BufferedReader(
+                new InputStreamReader(in, copy.encoding != null ? copy.encoding : getEncoding())));
+        ArrayList<? extends ParameterInterface> parameters = insert.getParameters();
+        int columnCount = pgTypes.length;
+        if (copy.header) {
+            copy.readRecord(reader);
+        }
+        long count = 0;
+        for (ArrayList<String> fields; (fields = copy.readRecord(reader)) != null; count++) {
+            if (fields.size() != columnCount) {
+                throw DbException.get(ErrorCode.COLUMN_COUNT_DOES_NOT_MATCH);
+            }
+            for (int i = 0; i < columnCount; i++) {
+                String s = fields.get(i);
+                Value value;
+                if (s == null) {
+                    value = ValueNull.INSTANCE;
+                } else if (pgTypes[i] == PgServer.PG_TYPE_BYTEA) {
+                    value = ValueVarbinary.getNoCopy(PgCopy.decodeBytea(s));
+                } else {
+                    value = ValueVarchar.get(s, session);
+                }
+                parameters.get(i).setValue(value, true);
+            }
+            insert.executeUpdate(null);
+        }
+        return count;
+    }
+
+    private long insertBinaryRows(InputStream in, CommandInterface insert, int[] pgTypes) throws IOException {
+        DataInputStream data = new DataInputStream(new BufferedInputStream(in));
+        byte[] signature = new byte[PgCopy.BINARY_SIGNATURE.length];
+        data.readFully(signature);
+        if (!Arrays.equals(signature, PgCopy.BINARY_SIGNATURE)) {
+            throw DbException.get(ErrorCode.IO_EXCEPTION_1, "Invalid signature of the binary COPY data");
+        }
+        // flags
+        data.readInt();
+        // the header extension is skipped
+        data.readFully(Utils.newBytes(data.readInt()));
+        ArrayList<? extends ParameterInterface> parameters = insert.getParameters();
+        int columnCount = pgTypes.length;
+        long count = 0;
+        for (int fieldCount; (fieldCount = data.readShort()) != -1; count++) {
+            if (fieldCount != columnCount) {
+                throw DbException.get(ErrorCode.COLUMN_COUNT_DOES_NOT_MATCH);
+            }
+            for (int i = 0; i < columnCount; i++) {
+                int length = data.readInt();
+                Value value = length == -1 ? ValueNull.INSTANCE : readValue(data, pgTypes[i], false, length);
+                parameters.get(i).setValue(value, true);
+            }
+            insert.executeUpdate(null);
+        }
+        return count;
+    }
+
     private String getSQL(String s) {
         String lower = StringUtils.toLowerEnglish(s);
         if (lower.startsWith("show max_identifier_length")) {
@@ -572,6 +873,31 @@ private void sendCommandComplete(CommandInterface command, long updateCount) thr
         sendMessage();
     }
 
+    private void sendCopyResponse(int type, int format, int columnCount) throws IOException {
+        int columnFormat = format == PgCopy.FORMAT_BINARY ? 1 : 0;
+        startMessage(type);
+        write(columnFormat);
+        writeShort(columnCount);
+        for (int i = 0; i < columnCount; i++) {
+            writeShort(columnFormat);
+        }
+        sendMessage();
+    }
+
+    private void sendCopyData(StringBuilder builder, Charset encoding) throws IOException {
+        builder.append('\n');
+        startMessage('d');
+        write(builder.toString().getBytes(encoding));
+        sendMessage();
+    }
+
+    private void sendCopyComplete(long count) throws IOException {
+        startMessage('C');
+        writeStringPart("COPY ");
+        writeString(Long.toString(count));
+        sendMessage();
+    }
+
     private void sendCommandSuspended() throws IOException {
         startMessage('s');
         sendMessage();
@@ -601,72 +927,9 @@ private void writeDataColumn(Value v, int pgType, boolean text) throws IOExcepti
         }
         if (text) {
             // plain text
-            switch (pgType) {
-            case PgServer.PG_TYPE_BOOL:
-                writeInt(1);
-                dataOut.writeByte(v.getBoolean() ? 't' : 'f');
-                break;
-            case PgServer.PG_TYPE_BYTEA: {
-                byte[] bytes = v.getBytesNoCopy();
-                int length = bytes.length;
-                int cnt = length;
-                for (int i = 0; i < length; i++) {
-                    byte b = bytes[i];
-                    if (b < 32 || b > 126) {
-                        cnt += 3;
-                    } else if (b == 92) {
-                        cnt++;
-                    }
-                }
-                byte[] data = new byte[cnt];
-                for (int i = 0, j = 0; i < length; i++) {
-                    byte b = bytes[i];
-                    if (b < 32 || b > 126) {
-                        data[j++] = '\\';
-                        data[j++] = (byte) (((b >>> 6) & 3) + '0');
-                        data[j++] = (byte) (((b >>> 3) & 7) + '0');
-                        data[j++] = (byte) ((b & 7) + '0');
-                    } else if (b == 92) {
-                        data[j++] = '\\';
-                        data[j++] = '\\';
-                    } else {
-                        data[j++] = b;
-                    }
-                }
-                writeInt(data.length);
-                write(data);
-                break;
-            }
-            case PgServer.PG_TYPE_INT2_ARRAY:
-            case PgServer.PG_TYPE_INT4_ARRAY:
-            case PgServer.PG_TYPE_VARCHAR_ARRAY:
-                ByteArrayOutputStream baos = new ByteArrayOutputStream();
-                baos.write('{');
-                Value[] values = ((ValueArray) v).getList();
-                Charset encoding = getEncoding();
-                for (int i = 0; i < values.length; i++) {
-                    if (i > 0) {
-                        baos.write(',');
-                    }
-                    String s = values[i].getString();
-                    if (SHOULD_QUOTE.matcher(s).matches()) {
-                        List<String> ss = new ArrayList<>();
-                        for (String s0 : s.split("\\\\")) {
-                            ss.add(s0.replace("\"", "\\\""));
-                        }
-                        s = "\"" + String.join("\\\\", ss) + "\"";
-                    }
-                    baos.write(s.getBytes(encoding));
-                }
-                baos.write('}');
-                writeInt(baos.size());
-                write(baos);
-                break;
-            default:
-                byte[] data = v.getString().getBytes(getEncoding());
-                writeInt(data.length);
-                write(data);
-            }
+            byte[] data = getText(v, pgType).getBytes(getEncoding());
+            writeInt(data.length);
+            write(data);
         } else {
             // binary
             switch (pgType) {
@@ -740,6 +1003,88 @@ private void writeDataColumn(Value v, int pgType, boolean text) throws IOExcepti
         }
     }
 
+    /**
+     * Get the text representation of a value.
+     *
+     * @param v the value, not NULL
+     * @param pgType the PostgreSQL type
+     * @return the text representation
+     */
+    private static String getText(Value v, int pgType) {
+        switch (pgType) {
+        case PgServer.PG_TYPE_BOOL:
+            return v.getBoolean() ? "t" : "f";
+        case PgServer.PG_TYPE_BYTEA: {
+            byte[] bytes = v.getBytesNoCopy();
+            StringBuilder builder = new StringBuilder(bytes.length);
+            for (byte b : bytes) {
+                if (b < 32 || b > 126) {
+                    builder.append('\\')
+                            .append((char) (((b >>> 6) & 3) + '0'))
+                            .append((char) (((b >>> 3) & 7) + '0'))
+                            .append((char) ((b & 7) + '0'));
+                } else if (b == 92) {
+                    builder.append("\\\\");
+                } else {
+                    builder.append((char) b);
+                }
+            }
+            return builder.toString();
+        }
+        case PgServer.PG_TYPE_INT2_ARRAY:
+        case PgServer.PG_TYPE_INT4_ARRAY:
+        case PgServer.PG_TYPE_VARCHAR_ARRAY: {
+            StringBuilder builder = new StringBuilder().append('{');
+            Value[] values = ((ValueArray) v).getList();
+            for (int i = 0; i < values.length; i++) {
+                if (i > 0) {
+                    builder.append(',');
+                }
+                String s = values[i].getString();
+                if (SHOULD_QUOTE.matcher(s).matches()) {
+                    List<String> ss = new ArrayList<>();
+                    for (String s0 : s.split("\\\\")) {
+                        ss.add(s0.replace("\"", "\\\""));
+                    }
+                    s = "\"" + String.join("\\\\", ss) + "\"";
+                }
+                builder.append(s);
+            }
+            return builder.append('}').toString();
+        }
+        default:
+            return v.getString();
+        }
+    }
+
+    /**
+     * Check whether values of the specified type can be written in the binary
+     * format.
+     *
+     * @param pgType the PostgreSQL type
+     * @return whether the binary format is supported
+     */
+    private static boolean hasBinaryFormat(int pgType) {
+        switch (pgType) {
+        case PgServer.PG_TYPE_BOOL:
+        case PgServer.PG_TYPE_INT2:
+        case PgServer.PG_TYPE_INT4:
+        case PgServer.PG_TYPE_INT8:
+        case PgServer.PG_TYPE_FLOAT4:
+        case PgServer.PG_TYPE_FLOAT8:
+        case PgServer.PG_TYPE_NUMERIC:
+        case PgServer.PG_TYPE_BYTEA:
+        case PgServer.PG_TYPE_DATE:
+        case PgServer.PG_TYPE_TIME:
+        case PgServer.PG_TYPE_TIMETZ:
+        case PgServer.PG_TYPE_TIMESTAMP:
+        case PgServer.PG_TYPE_TIMESTAMPTZ:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     private static final int[] POWERS10 = {1, 10, 100, 1000, 10000};
     private static final int MAX_GROUP_SCALE = 4;
     private static final int MAX_GROUP_SIZE = POWERS10[4];
@@ -842,13 +1187,26 @@ private void setParameter(ArrayList<? extends ParameterInterface> parameters, in
             text = formatCodes[i] == 0;
         }
         int paramLen = readInt();
+        Value value = paramLen == -1 ? ValueNull.INSTANCE : readValue(dataIn, pgType, text, paramLen);
+        parameters.get(i).setValue(value, true);
+    }
+
+    /**
+     * Read a value in the text or in the binary format.
+     *
+     * @param in the input stream
+     * @param pgType the PostgreSQL type
+     * @param text whether the value is in the text format
+     * @param length the length of the value in bytes
+     * @return the value
+     * @throws IOException on failure
+     */
+    private Value readValue(DataInputStream in, int pgType, boolean text, int length) throws IOException {
         Value value;
-        if (paramLen == -1) {
-            value = ValueNull.INSTANCE;
-        } else if (text) {
+        if (text) {
             // plain text
-            byte[] data = Utils.newBytes(paramLen);
-            readFully(data);
+            byte[] data = Utils.newBytes(length);
+            in.readFully(data);
             String str = new String(data, getEncoding());
             switch (pgType) {
             case PgServer.PG_TYPE_DATE: {
@@ -876,38 +1234,38 @@ private void setParameter(ArrayList<? extends ParameterInterface> parameters, in
             // binary
             switch (pgType) {
             case PgServer.PG_TYPE_INT2:
-                checkParamLength(2, paramLen);
-                value = ValueSmallint.get(readShort());
+                checkParamLength(2, length);
+                value = ValueSmallint.get(in.readShort());
                 break;
             case PgServer.PG_TYPE_INT4:
-                checkParamLength(4, paramLen);
-                value = ValueInteger.get(readInt());
+                checkParamLength(4, length);
+                value = ValueInteger.get(in.readInt());
                 break;
             case PgServer.PG_TYPE_INT8:
-                checkParamLength(8, paramLen);
-                value = ValueBigint.get(dataIn.readLong());
+                checkParamLength(8, length);
+                value = ValueBigint.get(in.readLong());
                 break;
             case PgServer.PG_TYPE_FLOAT4:
-                checkParamLength(4, paramLen);
-                value = ValueReal.get(dataIn.readFloat());
+                checkParamLength(4, length);
+                value = ValueReal.get(in.readFloat());
                 break;
             case PgServer.PG_TYPE_FLOAT8:
-                checkParamLength(8, paramLen);
-                value = ValueDouble.get(dataIn.readDouble());
+                checkParamLength(8, length);
+                value = ValueDouble.get(in.readDouble());
                 break;
             case PgServer.PG_TYPE_BYTEA:
-                byte[] d1 = Utils.newBytes(paramLen);
-                readFully(d1);
+                byte[] d1 = Utils.newBytes(length);
+                in.readFully(d1);
                 value = ValueVarbinary.getNoCopy(d1);
                 break;
             default:
                 server.trace("Binary format for type: "+pgType+" is unsupported");
-                byte[] d2 = Utils.newBytes(paramLen);
-                readFully(d2);
+                byte[] d2 = Utils.newBytes(length);
+                in.readFully(d2);
                 value = ValueVarchar.get(new String(d2, getEncoding()), session);
             }
         }
-        parameters.get(i).setValue(value, true);
+        return value;
     }
 
     private static void checkParamLength(int expected, int got) {
@@ -1115,7 +1473,8 @@ private void initDb() {
     /**
      * Close this connection.
      */
-    void close() {
+    @Override
+    public void close() {
         for (Prepared prep : prepared.values()) {
             prep.close();
         }
@@ -1336,4 +1695,97 @@ static class Portal {
          */
         Prepared prep;
     }
+
+    /**
+     * The data of CopyData messages that are sent by the client during COPY
+     * FROM STDIN. The end of the stream is reached at the CopyDone message.
+     */
+    private final class CopyInputStream extends InputStream {
+
+        private byte[] buffer;
+
+        private int pos, length;
+
+        private boolean done;
+
+        CopyInputStream() {
+        }
+
+        @Override
+        public int read() throws IOException {
+            return fill() ? buffer[pos++] & 0xff : -1;
+        }
+
+        @Override
+        public int read(byte[] b, int off, int len) throws IOException {
+            if (len == 0) {
+                return 0;
+            }
+            if (!fill()) {
+                return -1;
+            }
+            len = Math.min(len, length - pos);
+            System.arraycopy(buffer, pos, b, off, len);
+            pos += len;
+            return len;
+        }
+
+        private boolean fill() throws IOException {
+            while (pos == length) {
+                if (done) {
+                    return false;
+                }
+                readMessage(true);
+            }
+            return true;
+        }
+
+        /**
+         * Read and discard the remaining messages up to the CopyDone or the
+         * CopyFail message.
+         *
+         * @throws IOException on failure
+         */
+        void skipRemaining() throws IOException {
+            while (!done) {
+                readMessage(false);
+            }
+            pos = length;
+        }
+
+        private void readMessage(boolean throwOnFail) throws IOException {
+            int x = dataInRaw.read();
+            if (x < 0) {
+                throw new EOFException();
+            }
+            int len = dataInRaw.readInt() - 4;
+            byte[] data = Utils.newBytes(len);
+            dataInRaw.readFully(data, 0, len);
+            switch (x) {
+            case 'd':
+                buffer = data;
+                pos = 0;
+                length = len;
+                break;
+            case 'c':
+                done = true;
+                break;
+            case 'f':
+                done = true;
+                if (throwOnFail) {
+                    throw DbException.get(ErrorCode.GENERAL_ERROR_1,
+                            "COPY from stdin failed: " + new String(data, 0, Math.max(len - 1, 0), getEncoding()));
+                }
+                break;
+            case 'H':
+            case 'S':
+                // Flush and Sync are ignored during COPY
+                break;
+            default:
+                done = true;
+                throw DbException.get(ErrorCode.CONNECTION_BROKEN_1,
+                        "Unexpected message during COPY: " + (char) x);
+            }
+        }
+    }
 }
@@ -7,13 +7,17 @@
 
 import java.io.IOException;
 import java.io.InputStream;
+import org.h2.engine.Constants;
 import org.h2.engine.SessionRemote;
+import org.h2.engine.SysProperties;
 import org.h2.message.DbException;
 import org.h2.mvstore.DataUtils;
 
 /**
  * An input stream used by the client side of a tcp connection to fetch LOB data
- * on demand from the server.
+ * on demand from the server. Small reads are buffered, the size of requests to
+ * the server grows while the stream is read, so that large LOBs are fetched
+ * with few round trips.
  */
 public class LobStorageRemoteInputStream extends InputStream {
 
@@ -27,10 +31,21 @@ public class LobStorageRemoteInputStream extends InputStream {
     private final byte[] hmac;
 
     /**
-     * The position.
+     * The position of the next data fetched from the server.
      */
     private long pos;
 
+    private byte[] buffer;
+
+    private int bufferPos;
+
+    private int bufferLength;
+
+    /**
+     * The number of bytes to request from the server with the next request.
+     */
+    private int readLength = 2 * Constants.IO_BUFFER_SIZE;
+
     public LobStorageRemoteInputStream(SessionRemote handler, long lobId, byte[] hmac) {
         this.sessionRemote = handler;
         this.lobId = lobId;
@@ -55,6 +70,36 @@ public int read(byte[] buff, int off, int length) throws IOException {
         if (length == 0) {
             return 0;
         }
+        int remaining = bufferLength - bufferPos;
+        if (remaining <= 0) {
+            if (length >= readLength) {
+                // read directly to the target
+                return fetch(buff, off, length);
+            }
+            byte[] b = buffer;
+            if (b == null || b.length < readLength) {
+                buffer = b = new byte[readLength];
+            }
+            bufferPos = 0;
+            bufferLength = 0;
+            remaining = fetch(b, 0, readLength);
+            if (remaining < 0) {
+                return -1;
+            }
+            bufferLength = remaining;
+        }
+        length = Math.min(length, remaining);
+        System.arraycopy(buffer, bufferPos, buff, off, length);
+        bufferPos += length;
+        return length;
+    }
+
+    @Override
+    public int available() {
+        return bufferLength - bufferPos;
+    }
+
+    private int fetch(byte[] buff, int off, int length) throws IOException {
         try {
             length = sessionRemote.readLob(lobId, hmac, pos, buff, off, length);
         } catch (DbException e) {
@@ -64,6 +109,9 @@ public int read(byte[] buff, int off, int length) throws IOException {
             return -1;
         }
         pos += length;
+        if (readLength < SysProperties.LOB_READ_BLOCK_SIZE) {
+            readLength = Math.min(readLength * 2, SysProperties.LOB_READ_BLOCK_SIZE);
+        }
         return length;
     }
 
@@ -12,6 +12,7 @@
 import java.nio.channels.FileLock;
 import java.nio.channels.ReadableByteChannel;
 import java.nio.channels.WritableByteChannel;
+import java.util.concurrent.CompletableFuture;
 
 /**
  * The base class for file implementations.
@@ -28,6 +29,26 @@ public synchronized int read(ByteBuffer dst, long position)
         return len;
     }
 
+    /**
+     * Read from the file asynchronously. The returned future is completed
+     * with the number of read bytes, or with -1 if the position is at the end
+     * of the file. Multiple reads may be outstanding at the same time. The
+     * default implementation reads synchronously.
+     *
+     * @param dst the destination buffer
+     * @param position the position in the file
+     * @return the future with the number of read bytes
+     */
+    public CompletableFuture<Integer> readAsync(ByteBuffer dst, long position) {
+        CompletableFuture<Integer> future = new CompletableFuture<>();
+        try {
+            future.complete(read(dst, position));
+        } catch (IOException e) {
+            future.completeExceptionally(e);
+        }
+        return future;
+    }
+
     @Override
     public synchronized int write(ByteBuffer src, long position)
             throws IOException {
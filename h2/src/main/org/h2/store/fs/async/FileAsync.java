@@ -8,8 +8,10 @@
 import java.io.IOException;
 import java.nio.ByteBuffer;
 import java.nio.channels.AsynchronousFileChannel;
+import java.nio.channels.CompletionHandler;
 import java.nio.channels.FileLock;
 import java.nio.file.Paths;
+import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.ExecutionException;
 import java.util.concurrent.Future;
 import org.h2.store.fs.FileBaseDefault;
@@ -20,6 +22,24 @@
  */
 class FileAsync extends FileBaseDefault {
 
+    /**
+     * Completes futures of asynchronous reads.
+     */
+    private static final CompletionHandler<Integer, CompletableFuture<Integer>> HANDLER =
+            new CompletionHandler<Integer, CompletableFuture<Integer>>() {
+
+        @Override
+        public void completed(Integer result, CompletableFuture<Integer> future) {
+            future.complete(result);
+        }
+
+        @Override
+        public void failed(Throwable exc, CompletableFuture<Integer> future) {
+            future.completeExceptionally(exc);
+        }
+
+    };
+
     private final String name;
     private final AsynchronousFileChannel channel;
 
@@ -61,6 +81,17 @@ public int read(ByteBuffer dst, long position) throws IOException {
         return complete(channel.read(dst, position));
     }
 
+    @Override
+    public CompletableFuture<Integer> readAsync(ByteBuffer dst, long position) {
+        CompletableFuture<Integer> future = new CompletableFuture<>();
+        try {
+            channel.read(dst, position, future, HANDLER);
+        } catch (RuntimeException e) {
+            future.completeExceptionally(e);
+        }
+        return future;
+    }
+
     @Override
     public int write(ByteBuffer src, long position) throws IOException {
         return complete(channel.write(src, position));
@@ -72,6 +72,7 @@ public final class Column implements HasSQL, Typed, ColumnTemplate {
     private boolean isGeneratedAlways;
     private GeneratedColumnResolver generatedTableFilter;
     private int selectivity;
+    private ColumnStatistics statistics;
     private String comment;
     private boolean primaryKey;
     private boolean visible = true;
@@ -684,6 +685,24 @@ public void setSelectivity(int selectivity) {
         this.selectivity = selectivity;
     }
 
+    /**
+     * Get the statistics of the values of this column collected by ANALYZE.
+     *
+     * @return the statistics, or {@code null} if not available
+     */
+    public ColumnStatistics getStatistics() {
+        return statistics;
+    }
+
+    /**
+     * Set the statistics of the values of this column.
+     *
+     * @param statistics the statistics, or {@code null}
+     */
+    public void setStatistics(ColumnStatistics statistics) {
+        this.statistics = statistics;
+    }
+
     @Override
     public String getDefaultSQL() {
         return defaultExpression == null ? null
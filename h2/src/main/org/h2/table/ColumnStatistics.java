@@ -0,0 +1,305 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.table;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Comparator;
+
+import org.h2.engine.SessionLocal;
+import org.h2.value.DataType;
+import org.h2.value.Value;
+import org.h2.value.ValueBigint;
+import org.h2.value.ValueInteger;
+import org.h2.value.ValueNull;
+import org.h2.value.ValueRow;
+
+/**
+ * The statistics of the values of a column collected by ANALYZE: the number of
+ * NULL and distinct values, the most common values, and an equi-depth
+ * histogram of the remaining values. The statistics are used to estimate the
+ * fraction of rows matched by conditions with constant values.
+ */
+public final class ColumnStatistics {
+
+    private final int valueType;
+
+    /**
+     * The number of analyzed rows.
+     */
+    private final long rowCount;
+
+    private final long nullCount;
+
+    /**
+     * The estimated number of distinct non-NULL values.
+     */
+    private final long distinctCount;
+
+    /**
+     * The most common values, sorted.
+     */
+    private final Value[] commonValues;
+
+    /**
+     * The estimated number of rows with each of the most common values.
+     */
+    private final long[] commonCounts;
+
+    /**
+     * The bounds of the histogram buckets, sorted. Each bucket contains about
+     * the same number of rows.
+     */
+    private final Value[] bounds;
+
+    /**
+     * The number of rows in the histogram: rows with a non-NULL value that is
+     * not one of the most common values.
+     */
+    private final long histogramCount;
+
+    private ColumnStatistics(int valueType, long rowCount, long nullCount, long distinctCount,
+            Value[] commonValues, long[] commonCounts, Value[] bounds) {
+        this.valueType = valueType;
+        this.rowCount = rowCount;
+        this.nullCount = nullCount;
+        this.distinctCount = distinctCount;
+        this.commonValues = commonValues;
+        this.commonCounts = commonCounts;
+        this.bounds = bounds;
+        long count = rowCount - nullCount;
+        for (long c : commonCounts) {
+            count -= c;
+        }
+        histogramCount = Math.max(count, 0);
+    }
+
+    /**
+     * Check whether statistics can be collected for values of the specified
+     * data type. Large objects and values without meaningful ordering are not
+     * supported.
+     *
+     * @param valueType the value type
+     * @return whether statistics are supported
+     */
+    public static boolean isSupported(int valueType) {
+        return valueType >= Value.CHAR && valueType <= Value.INTERVAL_MINUTE_TO_SECOND
+                && !DataType.isLargeObject(valueType) || valueType == Value.UUID;
+    }
+
+    /**
+     * Create statistics from a random sample of values.
+     *
+     * @param session the session
+     * @param valueType the value type of the column
+     * @param rowCount the number of analyzed rows
+     * @param nullCount the number of analyzed rows with NULL value
+     * @param distinctCount the estimated number of distinct non-NULL values
+     * @param sample the sample of non-NULL values, it will be sorted
+     * @param size the maximum number of most common values and of histogram
+     *            buckets
+     * @return the statistics
+     */
+    public static ColumnStatistics create(SessionLocal session, int valueType, long rowCount, long nullCount,
+            long distinctCount, Value[] sample, int size) {
+        Comparator<Value> comparator = getComparator(session);
+        Arrays.sort(sample, comparator);
+        int sampleSize = sample.length;
+        // the start of each run of equal values in the sample
+        int[] runs = new int[sampleSize + 1];
+        int runCount = 0;
+        for (int i = 0; i < sampleSize; i++) {
+            if (i == 0 || comparator.compare(sample[i - 1], sample[i]) != 0) {
+                runs[runCount++] = i;
+            }
+        }
+        runs[runCount] = sampleSize;
+        // values that occur more often than the average are the most common
+        ArrayList<Integer> common = new ArrayList<>();
+        for (int i = 0; i < runCount; i++) {
+            int length = runs[i + 1] - runs[i];
+            if (length > 1 && (long) length * runCount > sampleSize) {
+                common.add(i);
+            }
+        }
+        if (common.size() > size) {
+            common.sort((a, b) -> Integer.compare(runs[b + 1] - runs[b], runs[a + 1] - runs[a]));
+            common.subList(size, common.size()).clear();
+            common.sort(null);
+        }
+        int commonSize = common.size();
+        Value[] commonValues = new Value[commonSize];
+        long[] commonCounts = new long[commonSize];
+        double scale = sampleSize == 0 ? 0d : (double) (rowCount - nullCount) / sampleSize;
+        int commonSampleSize = 0;
+        for (int i = 0; i < commonSize; i++) {
+            int run = common.get(i);
+            int length = runs[run + 1] - runs[run];
+            commonValues[i] = sample[runs[run]];
+            commonCounts[i] = Math.round(length * scale);
+            commonSampleSize += length;
+        }
+        Value[] rest = new Value[sampleSize - commonSampleSize];
+        for (int i = 0, j = 0, k = 0; i < runCount; i++) {
+            int start = runs[i], end = runs[i + 1];
+            if (j < commonSize && common.get(j) == i) {
+                j++;
+            } else {
+                System.arraycopy(sample, start, rest, k, end - start);
+                k += end - start;
+            }
+        }
+        int restSize = rest.length;
+        Value[] bounds;
+        if (restSize == 0) {
+            bounds = new Value[0];
+        } else {
+            int bucketCount = Math.min(size, restSize - 1);
+            bounds = new Value[bucketCount + 1];
+            for (int i = 0; i <= bucketCount; i++) {
+                bounds[i] = rest[bucketCount == 0 ? 0 : (int) ((long) i * (restSize - 1) / bucketCount)];
+            }
+        }
+        return new ColumnStatistics(valueType, rowCount, nullCount, Math.max(distinctCount, runCount),
+                commonValues, commonCounts, bounds);
+    }
+
+    /**
+     * Estimate the fraction of rows with the specified value.
+     *
+     * @param session the session
+     * @param v the value, converted to the data type of the column
+     * @return the fraction of rows, between 0 and 1
+     */
+    public double getEqualFraction(SessionLocal session, Value v) {
+        if (rowCount == 0) {
+            return 0d;
+        }
+        if (v == ValueNull.INSTANCE) {
+            return (double) nullCount / rowCount;
+        }
+        Comparator<Value> comparator = getComparator(session);
+        int i = Arrays.binarySearch(commonValues, v, comparator);
+        if (i >= 0) {
+            return (double) commonCounts[i] / rowCount;
+        }
+        long otherCount = distinctCount - commonValues.length;
+        int last = bounds.length - 1;
+        if (otherCount <= 0 || last < 0 || comparator.compare(v, bounds[0]) < 0
+                || comparator.compare(v, bounds[last]) > 0) {
+            return 0d;
+        }
+        return (double) histogramCount / otherCount / rowCount;
+    }
+
+    /**
+     * Estimate the fraction of rows with values in the specified range.
+     *
+     * @param session the session
+     * @param min the lower bound, converted to the data type of the column, or
+     *            {@code null} if there is no lower bound
+     * @param max the upper bound, converted to the data type of the column, or
+     *            {@code null} if there is no upper bound
+     * @return the fraction of rows, between 0 and 1
+     */
+    public double getRangeFraction(SessionLocal session, Value min, Value max) {
+        if (rowCount == 0) {
+            return 0d;
+        }
+        Comparator<Value> comparator = getComparator(session);
+        double count = 0d;
+        for (int i = 0, l = commonValues.length; i < l; i++) {
+            Value v = commonValues[i];
+            if ((min == null || comparator.compare(v, min) >= 0) && (max == null || comparator.compare(v, max) <= 0)) {
+                count += commonCounts[i];
+            }
+        }
+        int bucketCount = bounds.length - 1;
+        if (bucketCount == 0) {
+            Value v = bounds[0];
+            if ((min == null || comparator.compare(v, min) >= 0) && (max == null || comparator.compare(v, max) <= 0)) {
+                count += histogramCount;
+            }
+        } else if (bucketCount > 0) {
+            double start = min == null ? 0d : getPosition(comparator, min);
+            double end = max == null ? bucketCount : getPosition(comparator, max);
+            if (end > start) {
+                count += histogramCount * (end - start) / bucketCount;
+            }
+        }
+        return Math.min(count / rowCount, 1d);
+    }
+
+    /**
+     * Get the position of the value in the histogram.
+     *
+     * @param comparator the comparator
+     * @param v the value
+     * @return the number of buckets below the value, the value is assumed to
+     *         be in the middle of its bucket
+     */
+    private double getPosition(Comparator<Value> comparator, Value v) {
+        int i = Arrays.binarySearch(bounds, v, comparator);
+        if (i >= 0) {
+            return i;
+        }
+        i = -i - 1;
+        if (i == 0) {
+            return 0d;
+        } else if (i == bounds.length) {
+            return bounds.length - 1;
+        }
+        return i - 0.5d;
+    }
+
+    private static Comparator<Value> getComparator(SessionLocal session) {
+        return (a, b) -> a.compareTo(b, session, session.getDatabase().getCompareMode());
+    }
+
+    /**
+     * Get the value type of the column when the statistics were collected.
+     *
+     * @return the value type
+     */
+    public int getValueType() {
+        return valueType;
+    }
+
+    /**
+     * Convert the statistics to a value to persist them.
+     *
+     * @return the value
+     */
+    public Value toValue() {
+        int commonSize = commonCounts.length;
+        Value[] counts = new Value[commonSize];
+        for (int i = 0; i < commonSize; i++) {
+            counts[i] = ValueBigint.get(commonCounts[i]);
+        }
+        return ValueRow.get(new Value[] { ValueInteger.get(valueType), ValueBigint.get(rowCount),
+                ValueBigint.get(nullCount), ValueBigint.get(distinctCount), ValueRow.get(commonValues),
+                ValueRow.get(counts), ValueRow.get(bounds) });
+    }
+
+    /**
+     * Read the statistics persisted with {@link #toValue()}.
+     *
+     * @param value the value
+     * @return the statistics
+     */
+    public static ColumnStatistics fromValue(Value value) {
+        Value[] list = ((ValueRow) value).getList();
+        Value[] counts = ((ValueRow) list[5]).getList();
+        int commonSize = counts.length;
+        long[] commonCounts = new long[commonSize];
+        for (int i = 0; i < commonSize; i++) {
+            commonCounts[i] = counts[i].getLong();
+        }
+        return new ColumnStatistics(list[0].getInt(), list[1].getLong(), list[2].getLong(), list[3].getLong(),
+                ((ValueRow) list[4]).getList(), commonCounts, ((ValueRow) list[6]).getList());
+    }
+
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.table;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+
+import org.h2.engine.SessionLocal;
+import org.h2.expression.Expression;
+import org.h2.expression.ExpressionColumn;
+import org.h2.expression.condition.Comparison;
+import org.h2.index.Cursor;
+import org.h2.index.IndexCondition;
+import org.h2.mvstore.db.MVHashJoinTempResult;
+import org.h2.result.DefaultRow;
+import org.h2.result.Row;
+import org.h2.value.CompareMode;
+import org.h2.value.TypeInfo;
+import org.h2.value.Value;
+import org.h2.value.ValueBigint;
+import org.h2.value.ValueNull;
+import org.h2.value.ValueRow;
+
+/**
+ * The build side of a hash join. All rows of the table are read once per
+ * query and grouped by the values of the columns used in the equality join
+ * conditions. Each row of the outer tables then probes only the matching group
+ * instead of scanning the whole table again. If the table has more rows than
+ * MAX_MEMORY_ROWS, the rows are written to a temporary map ordered by the
+ * values of the join columns, and each probe reads a range of this map.
+ */
+final class HashJoin {
+
+    private final Table table;
+
+    private final ArrayList<IndexCondition> conditions;
+
+    private final int[] columnIds;
+
+    private HashMap<Value, ArrayList<Row>> rows;
+
+    /**
+     * The rows of the table if they don't fit into the hash table.
+     */
+    private MVHashJoinTempResult spilledRows;
+
+    private ArrayList<Row> group;
+
+    private org.h2.mvstore.Cursor<ValueRow, ValueRow> spilledGroup;
+
+    private int groupIndex;
+
+    private Row current;
+
+    /**
+     * Create a new hash join.
+     *
+     * @param table the table
+     * @param conditions the equality conditions, see
+     *            {@link #isHashJoinCondition(TableFilter, IndexCondition)}
+     */
+    HashJoin(Table table, ArrayList<IndexCondition> conditions) {
+        this.table = table;
+        this.conditions = conditions;
+        int count = conditions.size();
+        int[] columnIds = new int[count];
+        for (int i = 0; i < count; i++) {
+            columnIds[i] = conditions.get(i).getColumn().getColumnId();
+        }
+        this.columnIds = columnIds;
+    }
+
+    /**
+     * Check whether the specified index condition can be used as a key of a
+     * hash join. Only equality conditions between a column of this filter and
+     * a column of another filter of the same data type are allowed, and only
+     * for data types where equal values also have equal hash codes.
+     *
+     * @param filter the table filter
+     * @param condition the index condition
+     * @return whether the condition can be used
+     */
+    static boolean isHashJoinCondition(TableFilter filter, IndexCondition condition) {
+        if (condition.getCompareType() != Comparison.EQUAL) {
+            return false;
+        }
+        Column column = condition.getColumn();
+        if (column == null || column.getColumnId() < 0) {
+            return false;
+        }
+        Expression expression = condition.getExpression();
+        if (!(expression instanceof ExpressionColumn)
+                || ((ExpressionColumn) expression).getTableFilter() == filter) {
+            return false;
+        }
+        int valueType = column.getType().getValueType();
+        if (expression.getType().getValueType() != valueType) {
+            return false;
+        }
+        switch (valueType) {
+        case Value.BOOLEAN:
+        case Value.TINYINT:
+        case Value.SMALLINT:
+        case Value.INTEGER:
+        case Value.BIGINT:
+        case Value.DATE:
+        case Value.TIME:
+        case Value.TIMESTAMP:
+        case Value.VARBINARY:
+        case Value.UUID:
+            return true;
+        case Value.VARCHAR:
+            // collations may treat different strings as equal
+            return CompareMode.OFF.equals(filter.getSession().getDatabase().getCompareMode().getName());
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Find the rows matching the current values of the outer tables. The hash
+     * table is built from the scan index of the table on the first invocation
+     * in the query.
+     *
+     * @param session the session
+     */
+    void find(SessionLocal session) {
+        if (rows == null && spilledRows == null) {
+            build(session);
+        }
+        current = null;
+        group = null;
+        spilledGroup = null;
+        groupIndex = 0;
+        int count = conditions.size();
+        Value[] values = new Value[count];
+        for (int i = 0; i < count; i++) {
+            Value v = conditions.get(i).getCurrentValue(session);
+            if (v == ValueNull.INSTANCE) {
+                return;
+            }
+            values[i] = v;
+        }
+        if (spilledRows != null) {
+            spilledGroup = spilledRows.find(values);
+        } else {
+            group = rows.get(count == 1 ? values[0] : ValueRow.get(values));
+        }
+    }
+
+    private void build(SessionLocal session) {
+        int maxRows = session.getDatabase().getMaxMemoryRows();
+        HashMap<Value, ArrayList<Row>> map = new HashMap<>();
+        Cursor cursor = table.getScanIndex(session).find(session, null, null);
+        int count = 0;
+        while (cursor.next()) {
+            if ((++count & 4095) == 0) {
+                session.checkCanceled();
+            }
+            Row row = cursor.get();
+            Value key = getKey(row);
+            if (key == null) {
+                continue;
+            }
+            if (spilledRows != null) {
+                spill(key, row);
+                continue;
+            }
+            ArrayList<Row> list = map.get(key);
+            if (list == null) {
+                map.put(key, list = new ArrayList<>(1));
+            }
+            list.add(row);
+            if (count > maxRows) {
+                spilledRows = createSpilledRows(session);
+                for (ArrayList<Row> l : map.values()) {
+                    for (Row r : l) {
+                        spill(getKey(r), r);
+                    }
+                }
+                map = null;
+            }
+        }
+        rows = map;
+    }
+
+    private MVHashJoinTempResult createSpilledRows(SessionLocal session) {
+        int keyCount = conditions.size();
+        TypeInfo[] keyTypes = new TypeInfo[keyCount];
+        for (int i = 0; i < keyCount; i++) {
+            keyTypes[i] = conditions.get(i).getColumn().getType();
+        }
+        Column[] columns = table.getColumns();
+        int columnCount = columns.length;
+        TypeInfo[] columnTypes = new TypeInfo[columnCount];
+        for (int i = 0; i < columnCount; i++) {
+            columnTypes[i] = columns[i].getType();
+        }
+        return new MVHashJoinTempResult(session.getDatabase(), keyTypes, columnTypes);
+    }
+
+    private void spill(Value key, Row row) {
+        spilledRows.add(columnIds.length == 1 ? new Value[] { key } : ((ValueRow) key).getList(),
+                row.getValueList(), row.getKey());
+    }
+
+    private Value getKey(Row row) {
+        int count = columnIds.length;
+        if (count == 1) {
+            Value v = row.getValue(columnIds[0]);
+            return v == ValueNull.INSTANCE ? null : v;
+        }
+        Value[] values = new Value[count];
+        for (int i = 0; i < count; i++) {
+            Value v = row.getValue(columnIds[i]);
+            if (v == ValueNull.INSTANCE) {
+                return null;
+            }
+            values[i] = v;
+        }
+        return ValueRow.get(values);
+    }
+
+    /**
+     * Move to the next matching row.
+     *
+     * @return whether there is a next row
+     */
+    boolean next() {
+        org.h2.mvstore.Cursor<ValueRow, ValueRow> spilledGroup = this.spilledGroup;
+        if (spilledGroup != null) {
+            if (spilledGroup.hasNext()) {
+                Value[] key = spilledGroup.next().getList();
+                current = table.createRow(spilledGroup.getValue().getList(), DefaultRow.MEMORY_CALCULATE,
+                        ((ValueBigint) key[key.length - 1]).getLong());
+                return true;
+            }
+            current = null;
+            return false;
+        }
+        ArrayList<Row> group = this.group;
+        if (group != null && groupIndex < group.size()) {
+            current = group.get(groupIndex++);
+            return true;
+        }
+        current = null;
+        return false;
+    }
+
+    /**
+     * Get the current row.
+     *
+     * @return the current row
+     */
+    Row get() {
+        return current;
+    }
+
+    /**
+     * Get the conditions used as keys.
+     *
+     * @return the conditions
+     */
+    ArrayList<IndexCondition> getConditions() {
+        return conditions;
+    }
+
+    /**
+     * Release the hash table. It will be built again on the next lookup.
+     */
+    void reset() {
+        rows = null;
+        if (spilledRows != null) {
+            spilledRows.close();
+            spilledRows = null;
+        }
+        group = null;
+        spilledGroup = null;
+        current = null;
+    }
+
+}
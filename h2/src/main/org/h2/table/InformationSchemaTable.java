@@ -31,6 +31,7 @@
 import org.h2.engine.SessionLocal;
 import org.h2.engine.SessionLocal.State;
 import org.h2.engine.Setting;
+import org.h2.engine.SharedQueryCache;
 import org.h2.engine.User;
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionVisitor;
@@ -154,7 +155,9 @@ public final class InformationSchemaTable extends MetaTable {
 
     private static final int SETTINGS = SESSION_STATE + 1;
 
-    private static final int SYNONYMS = SETTINGS + 1;
+    private static final int SLOW_QUERIES = SETTINGS + 1;
+
+    private static final int SYNONYMS = SLOW_QUERIES + 1;
 
     private static final int USERS = SYNONYMS + 1;
 
@@ -830,6 +833,17 @@ public InformationSchemaTable(Schema schema, int id, int type) {
                     column("SETTING_VALUE"), //
             };
             break;
+        case SLOW_QUERIES:
+            setMetaTableName("SLOW_QUERIES");
+            isView = false;
+            cols = new Column[] {
+                    column("SESSION_ID", TypeInfo.TYPE_INTEGER), //
+                    column("SQL_STATEMENT"), //
+                    column("EXECUTION_TIME", TypeInfo.TYPE_DOUBLE), //
+                    column("ROW_COUNT", TypeInfo.TYPE_BIGINT), //
+                    column("PLAN"), //
+            };
+            break;
         case SYNONYMS:
             setMetaTableName("SYNONYMS");
             isView = false;
@@ -986,6 +1000,9 @@ public ArrayList<Row> generateRows(SessionLocal session, SearchRow first, Search
         case SETTINGS:
             settings(session, rows);
             break;
+        case SLOW_QUERIES:
+            slowQueries(session, rows);
+            break;
         case SYNONYMS:
             synonyms(session, rows, catalog);
             break;
@@ -2753,6 +2770,30 @@ private void queryStatistics(SessionLocal session, ArrayList<Row> rows) {
         }
     }
 
+    private void slowQueries(SessionLocal session, ArrayList<Row> rows) {
+        QueryStatisticsData control = database.getQueryStatisticsData();
+        if (control != null) {
+            boolean admin = session.getUser().isAdmin();
+            int sessionId = session.getId();
+            for (QueryStatisticsData.SlowQueryEntry entry : control.getSlowQueries()) {
+                if (admin || entry.sessionId == sessionId) {
+                    add(session, rows,
+                            // SESSION_ID
+                            ValueInteger.get(entry.sessionId),
+                            // SQL_STATEMENT
+                            entry.sqlStatement,
+                            // EXECUTION_TIME
+                            ValueDouble.get(entry.executionTimeNanos / 1_000_000d),
+                            // ROW_COUNT
+                            ValueBigint.get(entry.rowCount),
+                            // PLAN
+                            entry.plan
+                    );
+                }
+            }
+        }
+    }
+
     private void rights(SessionLocal session, Value indexFrom, Value indexTo, ArrayList<Row> rows) {
         if (!session.getUser().isAdmin()) {
             return;
@@ -2955,6 +2996,7 @@ private void settings(SessionLocal session, ArrayList<Row> rows) {
         add(session, rows, "DEFAULT_NULL_ORDERING", database.getDefaultNullOrdering().name());
         add(session, rows, "EXCLUSIVE", database.getExclusiveSession() == null ? "FALSE" : "TRUE");
         add(session, rows, "MODE", database.getMode().getName());
+        add(session, rows, "PARALLELISM", Integer.toString(session.getParallelism()));
         add(session, rows, "QUERY_TIMEOUT", Integer.toString(session.getQueryTimeout()));
         add(session, rows, "TIME ZONE", session.currentTimeZone().getId());
         add(session, rows, "TRUNCATE_LARGE_LENGTH", session.isTruncateLargeLength() ? "TRUE" : "FALSE");
@@ -2965,6 +3007,12 @@ private void settings(SessionLocal session, ArrayList<Row> rows) {
             add(session, rows, "NON_KEYWORDS", Parser.formatNonKeywords(nonKeywords));
         }
         add(session, rows, "RETENTION_TIME", Integer.toString(database.getRetentionTime()));
+        SharedQueryCache sharedQueryCache = database.getSharedQueryCache();
+        if (sharedQueryCache != null) {
+            add(session, rows, "info.SHARED_QUERY_CACHE_SIZE", Integer.toString(sharedQueryCache.getSize()));
+            add(session, rows, "info.SHARED_QUERY_CACHE_HITS", Long.toString(sharedQueryCache.getHits()));
+            add(session, rows, "info.SHARED_QUERY_CACHE_MISSES", Long.toString(sharedQueryCache.getMisses()));
+        }
         // database settings
         for (Map.Entry<String, String> entry : database.getSettings().getSortedSettings()) {
             add(session, rows, entry.getKey(), entry.getValue());
@@ -2990,6 +3038,14 @@ private void settings(SessionLocal session, ArrayList<Row> rows) {
                     "info.CHUNKS_FILL_RATE", Integer.toString(mvStore.getChunksFillRate()));
             add(session, rows,
                     "info.CHUNKS_FILL_RATE_RW", Integer.toString(mvStore.getRewritableChunksFillRate()));
+            add(session, rows,
+                    "info.COMPACT_PENDING_BYTES", Long.toString(mvStore.getCompactPendingBytes()));
+            add(session, rows,
+                    "info.COMPACT_REWRITTEN_PAGES", Long.toString(mvStore.getCompactRewrittenPageCount()));
+            add(session, rows,
+                    "info.COMPACT_REWRITTEN_BYTES", Long.toString(mvStore.getCompactRewrittenBytes()));
+            add(session, rows,
+                    "info.COMPACT_MOVED_BYTES", Long.toString(mvStore.getCompactMovedBytes()));
             try {
                 add(session, rows,
                         "info.FILE_SIZE", Long.toString(fs.getFile().size()));
@@ -3008,6 +3064,12 @@ private void settings(SessionLocal session, ArrayList<Row> rows) {
                     "info.CACHE_SIZE", Integer.toString(mvStore.getCacheSizeUsed()));
             add(session, rows,
                     "info.CACHE_HIT_RATIO", Integer.toString(mvStore.getCacheHitRatio()));
+            add(session, rows,
+                    "info.CACHE_HITS", Long.toString(mvStore.getCacheHits()));
+            add(session, rows,
+                    "info.CACHE_MISSES", Long.toString(mvStore.getCacheMisses()));
+            add(session, rows,
+                    "info.CACHE_EVICTIONS", Long.toString(mvStore.getCacheEvictions()));
             add(session, rows, "info.TOC_CACHE_HIT_RATIO",
                     Integer.toString(mvStore.getTocCacheHitRatio()));
             add(session, rows,
@@ -3159,6 +3221,7 @@ public long getMaxDataModificationId() {
         case SESSIONS:
         case LOCKS:
         case SESSION_STATE:
+        case SLOW_QUERIES:
             return Long.MAX_VALUE;
         }
         return database.getModificationDataId();
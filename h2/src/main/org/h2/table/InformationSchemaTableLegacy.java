@@ -36,6 +36,7 @@
 import org.h2.engine.SessionLocal;
 import org.h2.engine.SessionLocal.State;
 import org.h2.engine.Setting;
+import org.h2.engine.SharedQueryCache;
 import org.h2.engine.User;
 import org.h2.expression.Expression;
 import org.h2.expression.ExpressionVisitor;
@@ -1111,6 +1112,12 @@ public ArrayList<Row> generateRows(SessionLocal session, SearchRow first, Search
                 add(session, rows, "NON_KEYWORDS", Parser.formatNonKeywords(nonKeywords));
             }
             add(session, rows, "RETENTION_TIME", Integer.toString(database.getRetentionTime()));
+            SharedQueryCache sharedQueryCache = database.getSharedQueryCache();
+            if (sharedQueryCache != null) {
+                add(session, rows, "info.SHARED_QUERY_CACHE_SIZE", Integer.toString(sharedQueryCache.getSize()));
+                add(session, rows, "info.SHARED_QUERY_CACHE_HITS", Long.toString(sharedQueryCache.getHits()));
+                add(session, rows, "info.SHARED_QUERY_CACHE_MISSES", Long.toString(sharedQueryCache.getMisses()));
+            }
             // database settings
             for (Map.Entry<String, String> entry : database.getSettings().getSortedSettings()) {
                 add(session, rows, entry.getKey(), entry.getValue());
@@ -1136,6 +1143,14 @@ public ArrayList<Row> generateRows(SessionLocal session, SearchRow first, Search
                         "info.CHUNKS_FILL_RATE", Integer.toString(mvStore.getChunksFillRate()));
                 add(session, rows,
                         "info.CHUNKS_FILL_RATE_RW", Integer.toString(mvStore.getRewritableChunksFillRate()));
+                add(session, rows,
+                        "info.COMPACT_PENDING_BYTES", Long.toString(mvStore.getCompactPendingBytes()));
+                add(session, rows,
+                        "info.COMPACT_REWRITTEN_PAGES", Long.toString(mvStore.getCompactRewrittenPageCount()));
+                add(session, rows,
+                        "info.COMPACT_REWRITTEN_BYTES", Long.toString(mvStore.getCompactRewrittenBytes()));
+                add(session, rows,
+                        "info.COMPACT_MOVED_BYTES", Long.toString(mvStore.getCompactMovedBytes()));
                 try {
                     add(session, rows,
                             "info.FILE_SIZE", Long.toString(fs.getFile().size()));
@@ -1154,6 +1169,12 @@ public ArrayList<Row> generateRows(SessionLocal session, SearchRow first, Search
                         "info.CACHE_SIZE", Integer.toString(mvStore.getCacheSizeUsed()));
                 add(session, rows,
                         "info.CACHE_HIT_RATIO", Integer.toString(mvStore.getCacheHitRatio()));
+                add(session, rows,
+                        "info.CACHE_HITS", Long.toString(mvStore.getCacheHits()));
+                add(session, rows,
+                        "info.CACHE_MISSES", Long.toString(mvStore.getCacheMisses()));
+                add(session, rows,
+                        "info.CACHE_EVICTIONS", Long.toString(mvStore.getCacheEvictions()));
                 add(session, rows, "info.TOC_CACHE_HIT_RATIO",
                         Integer.toString(mvStore.getTocCacheHitRatio()));
                 add(session, rows,
@@ -118,7 +118,8 @@ public double calculateCost(SessionLocal session, AllColumnsForPlan allColumnsSe
                 t.debug("Plan       :   best plan item cost {0} index {1}",
                         item.cost, item.getIndex().getPlanSQL());
             }
-            cost += cost * item.cost;
+            chooseJoinMethod(item, cost);
+            cost += item.getCost(cost);
             setEvaluatable(tableFilter, true);
             Expression on = tableFilter.getJoinCondition();
             if (on != null) {
@@ -140,6 +141,20 @@ public double calculateCost(SessionLocal session, AllColumnsForPlan allColumnsSe
         return cost;
     }
 
+    /**
+     * Use a hash join for the specified plan item if building the hash table
+     * once and probing it for each row of the outer tables is cheaper than the
+     * nested loop join with the index of the item.
+     *
+     * @param item the plan item
+     * @param outerCost the cost of the outer tables
+     */
+    static void chooseJoinMethod(PlanItem item, double outerCost) {
+        if (!item.isHashJoin() && item.getHashJoinCost(outerCost) < item.getCost(outerCost)) {
+            item.useHashJoin();
+        }
+    }
+
     private void setEvaluatable(TableFilter filter, boolean b) {
         filter.setEvaluatable(filter, b);
         for (Expression e : allConditions) {
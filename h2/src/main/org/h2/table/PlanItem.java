@@ -22,6 +22,11 @@ public class PlanItem {
     private Index index;
     private PlanItem joinPlan;
     private PlanItem nestedJoinPlan;
+    private boolean hashJoin;
+    private Index hashJoinIndex;
+    private double hashJoinLookupCost;
+    private double hashJoinBuildCost;
+    private double indexLookupCost;
 
     void setMasks(int[] masks) {
         this.masks = masks;
@@ -39,6 +44,71 @@ public Index getIndex() {
         return index;
     }
 
+    /**
+     * Set a hash join as an alternative to the index of this item. Whether it
+     * is used is decided with {@link Plan#chooseJoinMethod(PlanItem, double)}
+     * for the cost of the outer tables. This method must be invoked before the
+     * costs of joined tables are added to the cost of this item.
+     *
+     * @param scanIndex the scan index to build the hash table from
+     * @param lookupCost the cost of a lookup in the hash table
+     * @param buildCost the cost of building the hash table once per query
+     */
+    void setHashJoinCandidate(Index scanIndex, double lookupCost, double buildCost) {
+        hashJoinIndex = scanIndex;
+        hashJoinLookupCost = lookupCost;
+        hashJoinBuildCost = buildCost;
+        indexLookupCost = cost;
+    }
+
+    /**
+     * Get the cost of a hash join for all rows of the outer tables.
+     *
+     * @param outerCost the cost of the outer tables
+     * @return the cost, or {@link Double#POSITIVE_INFINITY} if a hash join
+     *         can't be used
+     */
+    double getHashJoinCost(double outerCost) {
+        if (hashJoinIndex == null) {
+            return Double.POSITIVE_INFINITY;
+        }
+        return outerCost * (cost - indexLookupCost + hashJoinLookupCost) + hashJoinBuildCost;
+    }
+
+    /**
+     * Read the rows of the table from a hash table built from the scan index
+     * instead of the index of this item.
+     */
+    void useHashJoin() {
+        hashJoin = true;
+        index = hashJoinIndex;
+        cost += hashJoinLookupCost - indexLookupCost;
+    }
+
+    /**
+     * Whether the rows of the table should be looked up through a hash table
+     * built from the scan index.
+     *
+     * @return whether a hash join is used
+     */
+    boolean isHashJoin() {
+        return hashJoin;
+    }
+
+    /**
+     * Get the cost of this item for all rows of the outer tables.
+     *
+     * @param outerCost the cost of the outer tables
+     * @return the cost
+     */
+    double getCost(double outerCost) {
+        double c = outerCost * cost;
+        if (hashJoin) {
+            c += hashJoinBuildCost;
+        }
+        return c;
+    }
+
     PlanItem getJoinPlan() {
         return joinPlan;
     }
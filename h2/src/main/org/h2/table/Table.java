@@ -217,6 +217,33 @@ public Row lockRow(SessionLocal session, Row row) {
      */
     public abstract void addRow(SessionLocal session, Row row);
 
+    /**
+     * Start adding rows in bulk. This is only possible if the table is empty
+     * and the added rows don't need to be visible to the session before the
+     * end of the statement. If the bulk load is started, the table is locked
+     * exclusively and the rows added by this session are collected without
+     * undo log until {@link #finishBulkLoad(SessionLocal, boolean)} is called.
+     *
+     * @param session the session
+     * @return whether the bulk load was started
+     */
+    public boolean startBulkLoad(SessionLocal session) {
+        return false;
+    }
+
+    /**
+     * Finish adding rows in bulk, if the bulk load was started by the
+     * specified session. If the statement failed, the added rows are
+     * discarded. Otherwise they become visible when the transaction is
+     * committed, or immediately if the undo log of the session is disabled.
+     *
+     * @param session the session
+     * @param success whether the statement added all rows successfully
+     */
+    public void finishBulkLoad(SessionLocal session, boolean success) {
+        // nothing to do
+    }
+
     /**
      * Update a row to the table and all indexes.
      *
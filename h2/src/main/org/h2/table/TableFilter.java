@@ -14,6 +14,7 @@
 import org.h2.api.ErrorCode;
 import org.h2.command.query.AllColumnsForPlan;
 import org.h2.command.query.Select;
+import org.h2.engine.Constants;
 import org.h2.engine.Database;
 import org.h2.engine.Right;
 import org.h2.engine.SessionLocal;
@@ -59,6 +60,16 @@ public class TableFilter implements ColumnResolver {
      */
     private static final TableFilterVisitor JOI_VISITOR = f -> f.joinOuterIndirect = true;
 
+    /**
+     * A visitor that releases hash tables of hash joins.
+     */
+    private static final TableFilterVisitor RESET_HASH_JOIN_VISITOR = f -> {
+        HashJoin hashJoin = f.hashJoin;
+        if (hashJoin != null) {
+            hashJoin.reset();
+        }
+    };
+
     /**
      * Whether this is a direct or indirect (nested) outer join
      */
@@ -73,6 +84,28 @@ public class TableFilter implements ColumnResolver {
     private final IndexHints indexHints;
     private int[] masks;
     private int scanCount;
+
+    /**
+     * Whether the number of rows is collected.
+     */
+    private boolean profiling;
+
+    /**
+     * Whether the time spent reading rows is measured.
+     */
+    private boolean timeProfiling;
+
+    /**
+     * The number of rows that passed the conditions of this filter.
+     */
+    private long rowCount;
+
+    /**
+     * The time spent in {@link #next()}, including the time of joined
+     * filters, in nanoseconds.
+     */
+    private long timeNanos;
+
     private boolean evaluatable;
 
     /**
@@ -85,6 +118,16 @@ public class TableFilter implements ColumnResolver {
      */
     private final IndexCursor cursor;
 
+    /**
+     * Whether the plan uses a hash join for this table.
+     */
+    private boolean useHashJoin;
+
+    /**
+     * The hash join, or {@code null} if rows are read using the index cursor.
+     */
+    private HashJoin hashJoin;
+
     /**
      * The index conditions used for direct index lookup (start or end).
      */
@@ -249,26 +292,74 @@ public PlanItem getBestPlanItem(SessionLocal s, TableFilter[] filters, int filte
             item = item1;
         }
 
+        if (nestedJoin == null && filter > 0 && masks != null && s.getDatabase().getSettings().optimizeHashJoin) {
+            double cost = getHashJoinCost(s);
+            if (cost < item.cost) {
+                // the hash table is built from the scan index
+                Index scanIndex = table.getScanIndex(s);
+                item.setHashJoinCandidate(scanIndex, cost,
+                        scanIndex.getCost(s, null, filters, filter, null, allColumnsSet));
+            }
+        }
+
         if (nestedJoin != null) {
             setEvaluatable(true);
-            item.setNestedJoinPlan(nestedJoin.getBestPlanItem(s, filters, filter, allColumnsSet));
+            PlanItem nestedJoinPlan = nestedJoin.getBestPlanItem(s, filters, filter, allColumnsSet);
+            item.setNestedJoinPlan(nestedJoinPlan);
+            Plan.chooseJoinMethod(nestedJoinPlan, item.cost);
             // TODO optimizer: calculate cost of a join: should use separate
             // expected row number and lookup cost
-            item.cost += item.cost * item.getNestedJoinPlan().cost;
+            item.cost += nestedJoinPlan.getCost(item.cost);
         }
         if (join != null) {
             setEvaluatable(true);
             do {
                 filter++;
             } while (filters[filter] != join);
-            item.setJoinPlan(join.getBestPlanItem(s, filters, filter, allColumnsSet));
+            PlanItem joinPlan = join.getBestPlanItem(s, filters, filter, allColumnsSet);
+            item.setJoinPlan(joinPlan);
+            Plan.chooseJoinMethod(joinPlan, item.cost);
             // TODO optimizer: calculate cost of a join: should use separate
             // expected row number and lookup cost
-            item.cost += item.cost * item.getJoinPlan().cost;
+            item.cost += joinPlan.getCost(item.cost);
         }
         return item;
     }
 
+    /**
+     * Get the estimated cost of a lookup in a hash table built from all rows of
+     * this table, or {@link Double#POSITIVE_INFINITY} if a hash join can't be
+     * used with the current index conditions.
+     *
+     * @param s the session
+     * @return the estimated cost
+     */
+    private double getHashJoinCost(SessionLocal s) {
+        if (table.getTableType() != TableType.TABLE) {
+            return Double.POSITIVE_INFINITY;
+        }
+        int totalSelectivity = 0;
+        boolean found = false;
+        for (IndexCondition condition : indexConditions) {
+            if (condition.isEvaluatable() && HashJoin.isHashJoinCondition(this, condition)) {
+                found = true;
+                totalSelectivity = 100 - ((100 - totalSelectivity) *
+                        (100 - condition.getColumn().getSelectivity()) / 100);
+            }
+        }
+        if (!found) {
+            return Double.POSITIVE_INFINITY;
+        }
+        long rowCount = table.getRowCountApproximation(s) + Constants.COST_ROW_OFFSET;
+        long distinctRows = rowCount * totalSelectivity / 100;
+        if (distinctRows <= 0) {
+            distinctRows = 1;
+        }
+        // slightly more expensive than an equality lookup in a regular index,
+        // the hash table needs to be built first
+        return 3 + Math.max(rowCount / distinctRows, 1);
+    }
+
     /**
      * Set what plan item (index, cost, masks) to use.
      *
@@ -282,6 +373,7 @@ public void setPlanItem(PlanItem item) {
         }
         setIndex(item.getIndex());
         masks = item.getMasks();
+        useHashJoin = item.isHashJoin();
         if (nestedJoin != null) {
             if (item.getNestedJoinPlan() != null) {
                 nestedJoin.setPlanItem(item.getNestedJoinPlan());
@@ -318,10 +410,16 @@ private void setScanIndexes() {
      * can not be used, and optimize the conditions.
      */
     public void prepare() {
+        ArrayList<IndexCondition> hashJoinConditions = useHashJoin ? Utils.newSmallArrayList() : null;
         // forget all unused index conditions
         // the indexConditions list may be modified here
         for (int i = 0; i < indexConditions.size(); i++) {
             IndexCondition condition = indexConditions.get(i);
+            if (hashJoinConditions != null && HashJoin.isHashJoinCondition(this, condition)) {
+                // hash join reads all rows from the scan index, all conditions
+                // are checked later with the filter and join conditions
+                hashJoinConditions.add(condition);
+            }
             if (!condition.isAlwaysFalse()) {
                 Column col = condition.getColumn();
                 if (col.getColumnId() >= 0) {
@@ -332,6 +430,8 @@ public void prepare() {
                 }
             }
         }
+        hashJoin = hashJoinConditions != null && !hashJoinConditions.isEmpty() ? new HashJoin(table, hashJoinConditions)
+                : null;
         if (nestedJoin != null) {
             if (nestedJoin == this) {
                 throw DbException.getInternalError("self join");
@@ -360,6 +460,13 @@ public void prepare() {
     public void startQuery(SessionLocal s) {
         this.session = s;
         scanCount = 0;
+        profiling = s.isQueryProfiling();
+        timeProfiling = profiling && s.isQueryTimeProfiling();
+        rowCount = 0L;
+        timeNanos = 0L;
+        if (hashJoin != null) {
+            hashJoin.reset();
+        }
         if (nestedJoin != null) {
             nestedJoin.startQuery(s);
         }
@@ -388,11 +495,27 @@ public void reset() {
      * @return true if there are
      */
     public boolean next() {
+        if (!timeProfiling) {
+            return nextRow();
+        }
+        long start = System.nanoTime();
+        try {
+            return nextRow();
+        } finally {
+            timeNanos += System.nanoTime() - start;
+        }
+    }
+
+    private boolean nextRow() {
         if (state == AFTER_LAST) {
             return false;
         } else if (state == BEFORE_FIRST) {
-            cursor.find(session, indexConditions);
-            if (!cursor.isAlwaysFalse()) {
+            if (hashJoin != null) {
+                hashJoin.find(session);
+            } else {
+                cursor.find(session, indexConditions);
+            }
+            if (hashJoin != null || !cursor.isAlwaysFalse()) {
                 if (nestedJoin != null) {
                     nestedJoin.reset();
                 }
@@ -412,7 +535,7 @@ public boolean next() {
             if (state == NULL_ROW) {
                 break;
             }
-            if (cursor.isAlwaysFalse()) {
+            if (hashJoin == null && cursor.isAlwaysFalse()) {
                 state = AFTER_LAST;
             } else if (nestedJoin != null) {
                 if (state == BEFORE_FIRST) {
@@ -422,7 +545,15 @@ public boolean next() {
                 if ((++scanCount & 4095) == 0) {
                     checkTimeout();
                 }
-                if (cursor.next()) {
+                if (hashJoin != null) {
+                    if (hashJoin.next()) {
+                        current = hashJoin.get();
+                        currentSearchRow = current;
+                        state = FOUND;
+                    } else {
+                        state = AFTER_LAST;
+                    }
+                } else if (cursor.next()) {
                     currentSearchRow = cursor.getSearchRow();
                     current = null;
                     state = FOUND;
@@ -459,6 +590,7 @@ public boolean next() {
                     continue;
                 }
             }
+            rowCount++;
             if (join != null) {
                 join.reset();
                 if (!join.next()) {
@@ -471,9 +603,24 @@ public boolean next() {
             }
         }
         state = AFTER_LAST;
+        if (select != null && select.getTopTableFilter() == this) {
+            // release hash tables as soon as the whole join was read
+            visit(RESET_HASH_JOIN_VISITOR);
+        }
         return false;
     }
 
+    /**
+     * Get the time spent reading rows of this filter and of joined filters
+     * during the last execution. The time is only collected in EXPLAIN ANALYZE
+     * VERBOSE.
+     *
+     * @return the time in nanoseconds
+     */
+    public long getTimeNanos() {
+        return timeNanos;
+    }
+
     public boolean isNullRow() {
         return state == NULL_ROW;
     }
@@ -757,13 +904,18 @@ public StringBuilder getPlanSQL(StringBuilder builder, boolean isJoin, int sqlFl
         if (index != null && (sqlFlags & HasSQL.ADD_PLAN_INFORMATION) != 0) {
             builder.append('\n');
             StringBuilder planBuilder = new StringBuilder().append("/* ").append(index.getPlanSQL());
-            if (!indexConditions.isEmpty()) {
+            ArrayList<IndexCondition> conditions = indexConditions;
+            if (hashJoin != null) {
+                planBuilder.append(", hash join");
+                conditions = hashJoin.getConditions();
+            }
+            if (!conditions.isEmpty()) {
                 planBuilder.append(": ");
-                for (int i = 0, size = indexConditions.size(); i < size; i++) {
+                for (int i = 0, size = conditions.size(); i < size; i++) {
                     if (i > 0) {
                         planBuilder.append("\n    AND ");
                     }
-                    planBuilder.append(indexConditions.get(i).getSQL(
+                    planBuilder.append(conditions.get(i).getSQL(
                             HasSQL.TRACE_SQL_FLAGS | HasSQL.ADD_PLAN_INFORMATION));
                 }
             }
@@ -790,7 +942,13 @@ public StringBuilder getPlanSQL(StringBuilder builder, boolean isJoin, int sqlFl
                 condition = "/* WHERE " + condition + "\n*/";
                 StringUtils.indent(builder, condition, 4, false);
             }
-            if (scanCount > 0) {
+            if (profiling) {
+                builder.append("\n    /* scanCount: ").append(scanCount).append(", rows: ").append(rowCount);
+                if (timeProfiling) {
+                    StringUtils.appendMillis(builder.append(", time: "), timeNanos);
+                }
+                builder.append(" */");
+            } else if (scanCount > 0) {
                 builder.append("\n    /* scanCount: ").append(scanCount).append(" */");
             }
         }
@@ -150,6 +150,12 @@ public void runTool(String... args) throws SQLException {
                     tcpShutdownServer = args[++i];
                 } else if ("-tcpShutdownForce".equals(arg)) {
                     tcpShutdownForce = true;
+                } else if ("-tcpWorkers".equals(arg)) {
+                    i++;
+                } else if ("-tcpHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-tcpMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     showUsageAndThrowUnsupportedOption(arg);
                 }
@@ -163,6 +169,12 @@ public void runTool(String... args) throws SQLException {
                     // no parameters
                 } else if ("-pgPort".equals(arg)) {
                     i++;
+                } else if ("-pgWorkers".equals(arg)) {
+                    i++;
+                } else if ("-pgHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-pgMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     showUsageAndThrowUnsupportedOption(arg);
                 }
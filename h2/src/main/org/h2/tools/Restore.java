@@ -5,10 +5,13 @@
  */
 package org.h2.tools;
 
+import java.io.DataInputStream;
 import java.io.File;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
 import java.sql.SQLException;
 import java.util.zip.ZipEntry;
 import java.util.zip.ZipInputStream;
@@ -20,6 +23,8 @@
 
 /**
  * Restores a H2 database by extracting the database files from a .zip file.
+ * The chunks from an incremental backup are written to the database files
+ * restored from the previous backups.
  * @h2.resource
  */
 public class Restore extends Tool {
@@ -117,6 +122,9 @@ private static String getOriginalDbName(String fileName, String db)
      * @return the database name or null
      */
     private static String getDatabaseNameFromFileName(String fileName) {
+        if (fileName.endsWith(Constants.SUFFIX_BACKUP_INCREMENT)) {
+            fileName = fileName.substring(0, fileName.length() - Constants.SUFFIX_BACKUP_INCREMENT.length());
+        }
         if (fileName.endsWith(Constants.SUFFIX_MV_FILE)) {
             return fileName.substring(0,
                     fileName.length() - Constants.SUFFIX_MV_FILE.length());
@@ -170,7 +178,12 @@ public static void execute(String zipFileName, String directory, String db) {
                         fileName = db + fileName.substring(originalDbLen);
                         copy = true;
                     }
-                    if (copy) {
+                    if (fileName.endsWith(Constants.SUFFIX_BACKUP_CHUNKS)) {
+                        // only used to create incremental backups
+                    } else if (copy && fileName.endsWith(Constants.SUFFIX_BACKUP_INCREMENT)) {
+                        restoreIncrement(zipIn, directory + File.separatorChar + fileName.substring(0,
+                                fileName.length() - Constants.SUFFIX_BACKUP_INCREMENT.length()));
+                    } else if (copy) {
                         OutputStream o = null;
                         try {
                             o = FileUtils.newOutputStream(directory + File.separatorChar + fileName, false);
@@ -191,4 +204,34 @@ public static void execute(String zipFileName, String directory, String db) {
         }
     }
 
+    /**
+     * Write the chunks of an incremental backup to a database file.
+     *
+     * @param in the input stream of the entry
+     * @param fileName the name of the database file
+     */
+    private static void restoreIncrement(InputStream in, String fileName) throws IOException {
+        if (!FileUtils.exists(fileName)) {
+            throw new IOException("File not found: " + fileName + ", restore the previous backups first");
+        }
+        DataInputStream data = new DataInputStream(in);
+        try (FileChannel fc = FileUtils.open(fileName, "rw")) {
+            long length = data.readLong();
+            ByteBuffer buff = ByteBuffer.allocate(64 * 1024);
+            for (long pos; (pos = data.readLong()) >= 0;) {
+                for (int len = data.readInt(), l; len > 0; len -= l, pos += l) {
+                    l = Math.min(buff.capacity(), len);
+                    data.readFully(buff.array(), 0, l);
+                    buff.clear().limit(l);
+                    for (long p = pos; buff.hasRemaining();) {
+                        p += fc.write(buff, p);
+                    }
+                }
+            }
+            if (fc.size() > length) {
+                fc.truncate(length);
+            }
+        }
+    }
+
 }
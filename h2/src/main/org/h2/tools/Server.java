@@ -90,6 +90,12 @@ public Server(Service service, String... args) throws SQLException {
      * <td>Stop the TCP server; example: tcp://localhost</td></tr>
      * <tr><td>[-tcpShutdownForce]</td>
      * <td>Do not wait until all connections are closed</td></tr>
+     * <tr><td>[-tcpWorkers &lt;count&gt;]</td>
+     * <td>Use a pool of worker threads instead of a thread per connection</td></tr>
+     * <tr><td>[-tcpHandOffMillis &lt;ms&gt;]</td>
+     * <td>Replace busy worker threads after this time (default: 100)</td></tr>
+     * <tr><td>[-tcpMaxHandOffThreads &lt;count&gt;]</td>
+     * <td>The maximum number of replacing worker threads (default: workers)</td></tr>
      * <tr><td>[-pg]</td>
      * <td>Start the PG server</td></tr>
      * <tr><td>[-pgAllowOthers]</td>
@@ -98,6 +104,12 @@ public Server(Service service, String... args) throws SQLException {
      * <td>Use a daemon thread</td></tr>
      * <tr><td>[-pgPort &lt;port&gt;]</td>
      * <td>The port (default: 5435)</td></tr>
+     * <tr><td>[-pgWorkers &lt;count&gt;]</td>
+     * <td>Use a pool of worker threads instead of a thread per connection</td></tr>
+     * <tr><td>[-pgHandOffMillis &lt;ms&gt;]</td>
+     * <td>Replace busy worker threads after this time (default: 100)</td></tr>
+     * <tr><td>[-pgMaxHandOffThreads &lt;count&gt;]</td>
+     * <td>The maximum number of replacing worker threads (default: workers)</td></tr>
      * <tr><td>[-properties "&lt;dir&gt;"]</td>
      * <td>Server properties (default: ~, disable: null)</td></tr>
      * <tr><td>[-baseDir &lt;dir&gt;]</td>
@@ -163,6 +175,12 @@ private void verifyArgs(String... args) throws SQLException {
                     i++;
                 } else if ("-tcpShutdownForce".equals(arg)) {
                     // ok
+                } else if ("-tcpWorkers".equals(arg)) {
+                    i++;
+                } else if ("-tcpHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-tcpMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     throwUnsupportedOption(arg);
                 }
@@ -175,6 +193,12 @@ private void verifyArgs(String... args) throws SQLException {
                     // no parameters
                 } else if ("-pgPort".equals(arg)) {
                     i++;
+                } else if ("-pgWorkers".equals(arg)) {
+                    i++;
+                } else if ("-pgHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-pgMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     throwUnsupportedOption(arg);
                 }
@@ -268,6 +292,12 @@ public void runTool(String... args) throws SQLException {
                     tcpShutdownServer = args[++i];
                 } else if ("-tcpShutdownForce".equals(arg)) {
                     tcpShutdownForce = true;
+                } else if ("-tcpWorkers".equals(arg)) {
+                    i++;
+                } else if ("-tcpHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-tcpMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     showUsageAndThrowUnsupportedOption(arg);
                 }
@@ -281,6 +311,12 @@ public void runTool(String... args) throws SQLException {
                     // no parameters
                 } else if ("-pgPort".equals(arg)) {
                     i++;
+                } else if ("-pgWorkers".equals(arg)) {
+                    i++;
+                } else if ("-pgHandOffMillis".equals(arg)) {
+                    i++;
+                } else if ("-pgMaxHandOffThreads".equals(arg)) {
+                    i++;
                 } else {
                     showUsageAndThrowUnsupportedOption(arg);
                 }
@@ -458,6 +494,7 @@ static Server createWebServer(String[] args, String key, boolean allowSecureCrea
      * </pre>
      * Supported options are:
      * -tcpPort, -tcpSSL, -tcpPassword, -tcpAllowOthers, -tcpDaemon,
+     * -tcpWorkers, -tcpHandOffMillis, -tcpMaxHandOffThreads,
      * -trace, -ifExists, -ifNotExists, -baseDir, -key.
      * See the main method for details.
      * <p>
@@ -484,8 +521,8 @@ public static Server createTcpServer(String... args) throws SQLException {
      *     Server.createPgServer("-pgAllowOthers").start();
      * </pre>
      * Supported options are:
-     * -pgPort, -pgAllowOthers, -pgDaemon,
-     * -trace, -ifExists, -ifNotExists, -baseDir, -key.
+     * -pgPort, -pgAllowOthers, -pgDaemon, -pgWorkers, -pgHandOffMillis,
+     * -pgMaxHandOffThreads, -trace, -ifExists, -ifNotExists, -baseDir, -key.
      * See the main method for details.
      * <p>
      * If no port is specified, the default port is used if possible,
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.util;
+
+/**
+ * An estimator of the number of distinct values using the HyperLogLog
+ * algorithm. It needs 16 KB of memory regardless of the number of values, the
+ * typical error of estimation is below 1%. Linear counting is used for small
+ * numbers of distinct values, the estimate is nearly exact in this case.
+ */
+public final class HyperLogLog {
+
+    private static final int BITS = 14;
+
+    private static final int SIZE = 1 << BITS;
+
+    private static final double ALPHA = 0.7213 / (1 + 1.079 / SIZE);
+
+    private final byte[] registers = new byte[SIZE];
+
+    /**
+     * Add a value.
+     *
+     * @param hash the hash code of the value
+     */
+    public void add(int hash) {
+        long h = hash;
+        // finalization mix of MurmurHash3
+        h = (h ^ (h >>> 33)) * 0xff51afd7ed558ccdL;
+        h = (h ^ (h >>> 33)) * 0xc4ceb9fe1a85ec53L;
+        h ^= h >>> 33;
+        int index = (int) (h >>> (64 - BITS));
+        byte rank = (byte) (Long.numberOfLeadingZeros(h << BITS | 1L << (BITS - 1)) + 1);
+        if (rank > registers[index]) {
+            registers[index] = rank;
+        }
+    }
+
+    /**
+     * Get the estimated number of distinct values.
+     *
+     * @return the estimated number of distinct values
+     */
+    public long getCount() {
+        double sum = 0;
+        int zeros = 0;
+        for (byte r : registers) {
+            sum += 1d / (1L << r);
+            if (r == 0) {
+                zeros++;
+            }
+        }
+        double estimate = ALPHA * SIZE * SIZE / sum;
+        if (estimate <= 2.5 * SIZE && zeros != 0) {
+            estimate = SIZE * Math.log((double) SIZE / zeros);
+        }
+        return Math.round(estimate);
+    }
+
+}
@@ -13,6 +13,7 @@
 import java.net.ServerSocket;
 import java.net.Socket;
 import java.net.UnknownHostException;
+import java.nio.channels.ServerSocketChannel;
 
 import org.h2.api.ErrorCode;
 import org.h2.engine.SysProperties;
@@ -166,10 +167,27 @@ public static Socket createSocket(InetAddress address, int port, boolean ssl, in
      */
     public static ServerSocket createServerSocket(int port, boolean ssl) {
         try {
-            return createServerSocketTry(port, ssl);
+            return createServerSocketTry(port, ssl, false);
         } catch (Exception e) {
             // try again
-            return createServerSocketTry(port, ssl);
+            return createServerSocketTry(port, ssl, false);
+        }
+    }
+
+    /**
+     * Create a server socket with an associated channel. Accepted sockets
+     * have channels too and can be used with a selector. The system property
+     * h2.bindAddress is used if set.
+     *
+     * @param port the port to listen on
+     * @return the server socket
+     */
+    public static ServerSocket createServerSocketWithChannel(int port) {
+        try {
+            return createServerSocketTry(port, false, true);
+        } catch (Exception e) {
+            // try again
+            return createServerSocketTry(port, false, true);
         }
     }
 
@@ -192,12 +210,22 @@ private static InetAddress getBindAddress() throws UnknownHostException {
         return cachedBindAddress;
     }
 
-    private static ServerSocket createServerSocketTry(int port, boolean ssl) {
+    private static ServerSocket createServerSocketTry(int port, boolean ssl, boolean channel) {
         try {
             InetAddress bindAddress = getBindAddress();
             if (ssl) {
                 return CipherFactory.createServerSocket(port, bindAddress);
             }
+            if (channel) {
+                ServerSocketChannel serverChannel = ServerSocketChannel.open();
+                try {
+                    serverChannel.bind(new InetSocketAddress(bindAddress, port));
+                } catch (IOException e) {
+                    serverChannel.close();
+                    throw e;
+                }
+                return serverChannel.socket();
+            }
             if (bindAddress == null) {
                 return new ServerSocket(port);
             }
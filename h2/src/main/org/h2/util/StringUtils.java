@@ -1309,6 +1309,20 @@ public static StringBuilder appendZeroPadded(StringBuilder builder, int length,
         return builder.append(s);
     }
 
+    /**
+     * Append a duration in milliseconds with three fractional digits to a
+     * string builder, for example {@code 12.345 ms}.
+     *
+     * @param builder the string builder
+     * @param nanos the non-negative duration in nanoseconds
+     * @return the specified string builder
+     */
+    public static StringBuilder appendMillis(StringBuilder builder, long nanos) {
+        long micros = nanos / 1_000L;
+        builder.append(micros / 1_000L).append('.');
+        return appendZeroPadded(builder, 3, micros % 1_000L).append(" ms");
+    }
+
     /**
      * Escape table or schema patterns used for DatabaseMetaData functions.
      *
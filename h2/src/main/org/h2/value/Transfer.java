@@ -10,10 +10,13 @@
 import java.io.DataInputStream;
 import java.io.DataOutputStream;
 import java.io.IOException;
+import java.io.InputStream;
 import java.io.Reader;
 import java.math.BigDecimal;
 import java.net.InetAddress;
 import java.net.Socket;
+import java.nio.BufferUnderflowException;
+import java.nio.ByteBuffer;
 import java.util.Iterator;
 import java.util.LinkedHashMap;
 import java.util.Map;
@@ -163,16 +166,38 @@ public Transfer(Session session, Socket s) {
      * output stream.
      */
     public synchronized void init() throws IOException {
+        if (socket != null) {
+            init(socket.getInputStream());
+        }
+    }
+
+    /**
+     * Initialize the transfer object with the specified input stream instead
+     * of the input stream of the socket.
+     *
+     * @param input the input stream
+     */
+    public synchronized void init(InputStream input) throws IOException {
         if (socket != null) {
             in = new DataInputStream(
                     new BufferedInputStream(
-                            socket.getInputStream(), Transfer.BUFFER_SIZE));
+                            input, Transfer.BUFFER_SIZE));
             out = new DataOutputStream(
                     new BufferedOutputStream(
                             socket.getOutputStream(), Transfer.BUFFER_SIZE));
         }
     }
 
+    /**
+     * Returns whether some input data can be read without blocking.
+     *
+     * @return whether input data is available
+     * @throws IOException on failure
+     */
+    public boolean isInputBuffered() throws IOException {
+        return in.available() > 0;
+    }
+
     /**
      * Write pending changes.
      */
@@ -1180,6 +1205,177 @@ public Value readValue(TypeInfo columnType) throws IOException {
         }
     }
 
+    /**
+     * Skip a string in the specified buffer with received data.
+     *
+     * @param buff the buffer
+     * @return whether the string isn't {@code null}
+     * @throws BufferUnderflowException if the string wasn't received completely
+     */
+    public static boolean skipString(ByteBuffer buff) {
+        int len = buff.getInt();
+        if (len == -1) {
+            return false;
+        }
+        skip(buff, len * 2L);
+        return true;
+    }
+
+    /**
+     * Skip a byte array in the specified buffer with received data.
+     *
+     * @param buff the buffer
+     * @throws BufferUnderflowException if the array wasn't received completely
+     */
+    public static void skipBytes(ByteBuffer buff) {
+        int len = buff.getInt();
+        if (len != -1) {
+            skip(buff, len);
+        }
+    }
+
+    /**
+     * Skip a row count in the specified buffer with received data.
+     *
+     * @param buff the buffer
+     * @throws BufferUnderflowException if the row count wasn't received
+     *             completely
+     */
+    public void skipRowCount(ByteBuffer buff) {
+        skip(buff, version >= Constants.TCP_PROTOCOL_VERSION_20 ? 8 : 4);
+    }
+
+    /**
+     * Skip a value in the specified buffer with received data. The format is
+     * the same as in {@link #readValue(TypeInfo)}, but no value is created.
+     *
+     * @param buff the buffer
+     * @throws BufferUnderflowException if the value wasn't received completely
+     */
+    public void skipValue(ByteBuffer buff) {
+        int type = buff.getInt();
+        switch (type) {
+        case NULL:
+            break;
+        case VARBINARY:
+        case BINARY:
+        case JAVA_OBJECT:
+        case GEOMETRY:
+        case JSON:
+            skipBytes(buff);
+            break;
+        case BOOLEAN:
+        case TINYINT:
+            skip(buff, 1);
+            break;
+        case SMALLINT:
+            skip(buff, version >= Constants.TCP_PROTOCOL_VERSION_20 ? 2 : 4);
+            break;
+        case INTEGER:
+        case REAL:
+            skip(buff, 4);
+            break;
+        case BIGINT:
+        case DOUBLE:
+        case DATE:
+        case TIME:
+            skip(buff, 8);
+            break;
+        case TIME_TZ:
+            skip(buff, 12);
+            break;
+        case UUID:
+        case TIMESTAMP:
+            skip(buff, 16);
+            break;
+        case TIMESTAMP_TZ:
+            skip(buff, 20);
+            break;
+        case NUMERIC:
+        case VARCHAR:
+        case VARCHAR_IGNORECASE:
+        case CHAR:
+        case DECFLOAT:
+            skipString(buff);
+            break;
+        case ENUM:
+            skip(buff, 4);
+            if (version < Constants.TCP_PROTOCOL_VERSION_20) {
+                skipString(buff);
+            }
+            break;
+        case BLOB: {
+            long length = buff.getLong();
+            if (length == -1) {
+                skip(buff, 12);
+                skipBytes(buff);
+                skip(buff, 8);
+            } else {
+                skip(buff, length);
+                skip(buff, 4);
+            }
+            break;
+        }
+        case CLOB: {
+            long charLength = buff.getLong();
+            if (charLength == -1) {
+                skip(buff, 12);
+                skipBytes(buff);
+                skip(buff, version >= Constants.TCP_PROTOCOL_VERSION_20 ? 16 : 8);
+            } else {
+                // characters are encoded as in DataReader
+                for (; charLength > 0; charLength--) {
+                    int x = buff.get() & 0xff;
+                    if (x >= 0xe0) {
+                        skip(buff, 2);
+                    } else if (x >= 0x80) {
+                        skip(buff, 1);
+                    }
+                }
+                skip(buff, 4);
+            }
+            break;
+        }
+        case ARRAY: {
+            int len = buff.getInt();
+            if (len < 0) {
+                len = ~len;
+                skipString(buff);
+            }
+            for (int i = 0; i < len; i++) {
+                skipValue(buff);
+            }
+            break;
+        }
+        case ROW: {
+            int len = buff.getInt();
+            for (int i = 0; i < len; i++) {
+                skipValue(buff);
+            }
+            break;
+        }
+        case INTERVAL: {
+            int ordinal = buff.get();
+            if (ordinal < 0) {
+                ordinal = ~ordinal;
+            }
+            skip(buff, ordinal < 5 ? 8 : 16);
+            break;
+        }
+        default:
+            throw DbException.get(ErrorCode.CONNECTION_BROKEN_1, "type=" + type);
+        }
+    }
+
+    private static void skip(ByteBuffer buff, long length) {
+        if (length < 0) {
+            throw DbException.get(ErrorCode.CONNECTION_BROKEN_1, "length=" + length);
+        } else if (length > buff.remaining()) {
+            throw new BufferUnderflowException();
+        }
+        buff.position(buff.position() + (int) length);
+    }
+
     private Value[] readArrayElements(int len, TypeInfo elementType) throws IOException {
         Value[] list = new Value[len];
         for (int i = 0; i < len; i++) {
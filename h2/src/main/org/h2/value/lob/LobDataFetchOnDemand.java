@@ -5,7 +5,6 @@
  */
 package org.h2.value.lob;
 
-import java.io.BufferedInputStream;
 import java.io.InputStream;
 
 import org.h2.engine.SessionRemote;
@@ -68,7 +67,7 @@ public long getLobId() {
 
     @Override
     public InputStream getInputStream(long precision) {
-        return new BufferedInputStream(new LobStorageRemoteInputStream(handler, lobId, hmac));
+        return new LobStorageRemoteInputStream(handler, lobId, hmac);
     }
 
     @Override
@@ -6,6 +6,7 @@
 package org.h2.test.bench;
 
 import java.math.BigDecimal;
+import java.sql.Connection;
 import java.sql.PreparedStatement;
 import java.sql.SQLException;
 import java.sql.Timestamp;
@@ -13,8 +14,10 @@
 
 /**
  * This test is similar to the TPC-C test of the Transaction Processing Council
- * (TPC). Only one connection and one thread is used. Referential integrity is
- * not implemented.
+ * (TPC). One connection and one thread is used, unless multiple threads are
+ * configured for the database. Then the terminals are distributed over the
+ * threads, each with its own connection. Referential integrity is not
+ * implemented.
  * <p>
  * See also http://www.tpc.org
  */
@@ -22,6 +25,11 @@ public class BenchC implements Bench {
 
     private static final int COMMIT_EVERY = 1000;
 
+    /**
+     * The number of terminals that process transactions.
+     */
+    private static final int TERMINALS = 70;
+
     private static final String[] TABLES = { "WAREHOUSE", "DISTRICT",
             "CUSTOMER", "HISTORY", "ORDERS", "NEW_ORDER", "ITEM", "STOCK",
             "ORDER_LINE", "RESULTS" };
@@ -544,14 +552,19 @@ private void loadDistrict(int wId) throws SQLException {
     }
 
     @Override
-    public void runTest() throws SQLException {
+    public void runTest() throws Exception {
+        int threadCount = database.getThreadsCount();
         database.start(this, "Transactions");
-        database.openConnection();
-        for (int i = 0; i < 70; i++) {
-            BenchCThread process = new BenchCThread(database, this, random, i);
-            process.process();
+        if (threadCount > 1) {
+            processTerminals(threadCount);
+        } else {
+            database.openConnection();
+            for (int i = 0; i < TERMINALS; i++) {
+                BenchCThread process = new BenchCThread(database, this, random, i);
+                process.process();
+            }
+            database.closeConnection();
         }
-        database.closeConnection();
         database.end();
 
         database.openConnection();
@@ -561,6 +574,41 @@ public void runTest() throws SQLException {
         database.closeConnection();
     }
 
+    /**
+     * Process the terminals with multiple threads. Each thread uses its own
+     * connection and random data generator.
+     *
+     * @param threadCount the number of threads
+     */
+    private void processTerminals(int threadCount) throws Exception {
+        Thread[] threads = new Thread[threadCount];
+        Exception[] exceptions = new Exception[threadCount];
+        for (int i = 0; i < threadCount; i++) {
+            int threadId = i;
+            threads[i] = new Thread(() -> {
+                try (Connection conn = database.openNewConnection()) {
+                    BenchCRandom threadRandom = new BenchCRandom(threadId);
+                    for (int t = threadId; t < TERMINALS; t += threadCount) {
+                        new BenchCThread(database, this, threadRandom, t, conn).process();
+                    }
+                } catch (Exception e) {
+                    exceptions[threadId] = e;
+                }
+            }, "BenchC-" + i);
+        }
+        for (Thread t : threads) {
+            t.start();
+        }
+        for (Thread t : threads) {
+            t.join();
+        }
+        for (Exception e : exceptions) {
+            if (e != null) {
+                throw e;
+            }
+        }
+    }
+
     @Override
     public String getName() {
         return "BenchC";
@@ -14,7 +14,20 @@
  */
 public class BenchCRandom {
 
-    private final Random random = new Random(10);
+    private final Random random;
+
+    BenchCRandom() {
+        this(10);
+    }
+
+    /**
+     * Create a random data generator with the given seed.
+     *
+     * @param seed the seed
+     */
+    BenchCRandom(long seed) {
+        random = new Random(seed);
+    }
 
     /**
      * Get a non-uniform random integer value between min and max.
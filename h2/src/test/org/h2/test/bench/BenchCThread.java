@@ -7,6 +7,7 @@
 
 import java.math.BigDecimal;
 import java.math.RoundingMode;
+import java.sql.Connection;
 import java.sql.PreparedStatement;
 import java.sql.ResultSet;
 import java.sql.SQLException;
@@ -31,12 +32,38 @@ public class BenchCThread {
     private final BenchCRandom random;
     private final BenchC bench;
 
+    /**
+     * The own connection of this terminal, or null if the connection of the
+     * database object is used.
+     */
+    private final Connection conn;
+
     BenchCThread(Database db, BenchC bench, BenchCRandom random, int terminal)
             throws SQLException {
+        this(db, bench, random, terminal, null);
+    }
+
+    /**
+     * Create a terminal.
+     *
+     * @param db the database object
+     * @param bench the benchmark
+     * @param random the random data generator
+     * @param terminal the terminal id
+     * @param conn the own connection of the terminal, or null to use the
+     *            connection of the database object
+     */
+    BenchCThread(Database db, BenchC bench, BenchCRandom random, int terminal,
+            Connection conn) throws SQLException {
         this.db = db;
         this.bench = bench;
         this.terminalId = terminal;
-        db.setAutoCommit(false);
+        this.conn = conn;
+        if (conn == null) {
+            db.setAutoCommit(false);
+        } else {
+            conn.setAutoCommit(false);
+        }
         this.random = random;
         warehouseId = random.getInt(1, bench.warehouses);
     }
@@ -59,28 +86,61 @@ void process() throws SQLException {
             deck[j] = temp;
         }
         for (int op : deck) {
-            switch (op) {
-            case OP_NEW_ORDER:
-                processNewOrder();
-                break;
-            case OP_PAYMENT:
-                processPayment();
-                break;
-            case OP_ORDER_STATUS:
-                processOrderStatus();
-                break;
-            case OP_DELIVERY:
-                processDelivery();
-                break;
-            case OP_STOCK_LEVEL:
-                processStockLevel();
-                break;
-            default:
-                throw new AssertionError("op=" + op);
+            try {
+                process(op);
+            } catch (SQLException e) {
+                if (conn == null || !isConflict(e)) {
+                    throw e;
+                }
+                // concurrent terminals may deadlock or time out
+                rollback();
             }
         }
     }
 
+    private void process(int op) throws SQLException {
+        switch (op) {
+        case OP_NEW_ORDER:
+            processNewOrder();
+            break;
+        case OP_PAYMENT:
+            processPayment();
+            break;
+        case OP_ORDER_STATUS:
+            processOrderStatus();
+            break;
+        case OP_DELIVERY:
+            processDelivery();
+            break;
+        case OP_STOCK_LEVEL:
+            processStockLevel();
+            break;
+        default:
+            throw new AssertionError("op=" + op);
+        }
+    }
+
+    private static boolean isConflict(SQLException e) {
+        String state = e.getSQLState();
+        return state != null && (state.startsWith("40") || state.equals("HYT00"));
+    }
+
+    private void commit() throws SQLException {
+        if (conn == null) {
+            db.commit();
+        } else {
+            conn.commit();
+        }
+    }
+
+    private void rollback() throws SQLException {
+        if (conn == null) {
+            db.rollback();
+        } else {
+            conn.rollback();
+        }
+    }
+
     private void processNewOrder() throws SQLException {
         int dId = random.getInt(1, bench.districtsPerWarehouse);
         int cId = random.getNonUniform(1023, 1, bench.customersPerDistrict);
@@ -159,7 +219,7 @@ private void processNewOrder() throws SQLException {
             if (!rs.next()) {
                 if (rollback) {
                     // item not found - correct behavior
-                    db.rollback();
+                    rollback();
                     return;
                 }
                 throw new SQLException("item not found: " + olId + " "
@@ -180,7 +240,7 @@ private void processNewOrder() throws SQLException {
             if (!rs.next()) {
                 if (rollback) {
                     // item not found - correct behavior
-                    db.rollback();
+                    rollback();
                     return;
                 }
                 throw new SQLException("item not found: " + olId + " "
@@ -250,7 +310,7 @@ private void processNewOrder() throws SQLException {
         prep.setInt(2, dId);
         prep.setInt(3, warehouseId);
         db.update(prep, "insertNewOrder");
-        db.commit();
+        commit();
     }
 
     private void processPayment() throws SQLException {
@@ -341,7 +401,7 @@ private void processPayment() throws SQLException {
             rs.close();
             if (namecnt == 0) {
                 // TODO TPC-C: check if this can happen
-                db.rollback();
+                rollback();
                 return;
             }
             prep = prepare("SELECT C_FIRST, C_MIDDLE, C_ID, "
@@ -475,7 +535,7 @@ private void processPayment() throws SQLException {
         prep.setBigDecimal(7, amount);
         prep.setString(8, hData);
         db.update(prep, "insertHistory");
-        db.commit();
+        commit();
     }
 
     private void processOrderStatus() throws SQLException {
@@ -507,7 +567,7 @@ private void processOrderStatus() throws SQLException {
             rs.close();
             if (namecnt == 0) {
                 // TODO TPC-C: check if this can happen
-                db.rollback();
+                rollback();
                 return;
             }
             prep = prepare("SELECT C_BALANCE, C_FIRST, C_MIDDLE, C_ID "
@@ -597,7 +657,7 @@ private void processOrderStatus() throws SQLException {
             }
             rs.close();
         }
-        db.commit();
+        commit();
     }
 
     private void processDelivery() throws SQLException {
@@ -671,7 +731,7 @@ private void processDelivery() throws SQLException {
                 db.update(prep, "updateCustomer");
             }
         }
-        db.commit();
+        commit();
     }
 
     private void processStockLevel() throws SQLException {
@@ -711,13 +771,13 @@ private void processStockLevel() throws SQLException {
         // stockCount
         rs.getInt(1);
         rs.close();
-        db.commit();
+        commit();
     }
 
     private PreparedStatement prepare(String sql) throws SQLException {
         PreparedStatement prep = prepared.get(sql);
         if (prep == null) {
-            prep = db.prepare(sql);
+            prep = conn == null ? db.prepare(sql) : db.prepare(conn, sql);
             prepared.put(sql, prep);
         }
         return prep;
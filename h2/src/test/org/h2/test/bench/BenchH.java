@@ -0,0 +1,431 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.test.bench;
+
+import java.math.BigDecimal;
+import java.math.RoundingMode;
+import java.sql.Date;
+import java.sql.PreparedStatement;
+import java.sql.SQLException;
+import java.time.LocalDate;
+import java.util.Random;
+
+/**
+ * This test is similar to the TPC-H test of the Transaction Processing Council
+ * (TPC). The tables are filled with generated data, the number of rows is
+ * proportional to the size, and a subset of the analytic queries is executed
+ * with random parameters. Only one connection and one thread is used. The
+ * generated data does not follow the specification exactly, so the results
+ * can only be compared between runs of this test.
+ * <p>
+ * See also http://www.tpc.org
+ */
+public class BenchH implements Bench {
+
+    private static final int COMMIT_EVERY = 1000;
+
+    /**
+     * The number of times each query is executed.
+     */
+    private static final int RUNS = 3;
+
+    private static final String[] TABLES = { "REGION", "NATION", "SUPPLIER",
+            "CUSTOMER", "PART", "ORDERS", "LINEITEM" };
+
+    private static final String[] CREATE_SQL = {
+            "CREATE TABLE REGION(\n" +
+            " R_REGIONKEY INT NOT NULL PRIMARY KEY,\n" +
+            " R_NAME VARCHAR(25))",
+            "CREATE TABLE NATION(\n" +
+            " N_NATIONKEY INT NOT NULL PRIMARY KEY,\n" +
+            " N_NAME VARCHAR(25),\n" +
+            " N_REGIONKEY INT)",
+            "CREATE TABLE SUPPLIER(\n" +
+            " S_SUPPKEY INT NOT NULL PRIMARY KEY,\n" +
+            " S_NAME VARCHAR(25),\n" +
+            " S_NATIONKEY INT,\n" +
+            " S_ACCTBAL DECIMAL(15, 2))",
+            "CREATE TABLE CUSTOMER(\n" +
+            " C_CUSTKEY INT NOT NULL PRIMARY KEY,\n" +
+            " C_NAME VARCHAR(25),\n" +
+            " C_NATIONKEY INT,\n" +
+            " C_ACCTBAL DECIMAL(15, 2),\n" +
+            " C_MKTSEGMENT VARCHAR(10))",
+            "CREATE TABLE PART(\n" +
+            " P_PARTKEY INT NOT NULL PRIMARY KEY,\n" +
+            " P_NAME VARCHAR(55),\n" +
+            " P_TYPE VARCHAR(25),\n" +
+            " P_SIZE INT,\n" +
+            " P_RETAILPRICE DECIMAL(15, 2))",
+            "CREATE TABLE ORDERS(\n" +
+            " O_ORDERKEY INT NOT NULL PRIMARY KEY,\n" +
+            " O_CUSTKEY INT,\n" +
+            " O_ORDERSTATUS CHAR(1),\n" +
+            " O_TOTALPRICE DECIMAL(15, 2),\n" +
+            " O_ORDERDATE DATE,\n" +
+            " O_ORDERPRIORITY VARCHAR(15),\n" +
+            " O_SHIPPRIORITY INT)",
+            "CREATE TABLE LINEITEM(\n" +
+            " L_ORDERKEY INT NOT NULL,\n" +
+            " L_LINENUMBER INT NOT NULL,\n" +
+            " L_PARTKEY INT,\n" +
+            " L_SUPPKEY INT,\n" +
+            " L_QUANTITY DECIMAL(15, 2),\n" +
+            " L_EXTENDEDPRICE DECIMAL(15, 2),\n" +
+            " L_DISCOUNT DECIMAL(15, 2),\n" +
+            " L_TAX DECIMAL(15, 2),\n" +
+            " L_RETURNFLAG CHAR(1),\n" +
+            " L_LINESTATUS CHAR(1),\n" +
+            " L_SHIPDATE DATE,\n" +
+            " L_COMMITDATE DATE,\n" +
+            " L_RECEIPTDATE DATE,\n" +
+            " L_SHIPMODE VARCHAR(10),\n" +
+            " PRIMARY KEY(L_ORDERKEY, L_LINENUMBER))",
+            "CREATE INDEX ORDERS_CUSTKEY ON ORDERS(O_CUSTKEY)",
+            "CREATE INDEX ORDERS_ORDERDATE ON ORDERS(O_ORDERDATE)",
+            "CREATE INDEX LINEITEM_SHIPDATE ON LINEITEM(L_SHIPDATE)",
+            "CREATE INDEX CUSTOMER_NATIONKEY ON CUSTOMER(C_NATIONKEY)",
+            "CREATE INDEX SUPPLIER_NATIONKEY ON SUPPLIER(S_NATIONKEY)" };
+
+    private static final String[] REGIONS = { "AFRICA", "AMERICA", "ASIA",
+            "EUROPE", "MIDDLE EAST" };
+
+    private static final String[] NATIONS = { "ALGERIA", "ARGENTINA",
+            "BRAZIL", "CANADA", "EGYPT", "ETHIOPIA", "FRANCE", "GERMANY",
+            "INDIA", "INDONESIA", "IRAN", "IRAQ", "JAPAN", "JORDAN", "KENYA",
+            "MOROCCO", "MOZAMBIQUE", "PERU", "CHINA", "ROMANIA",
+            "SAUDI ARABIA", "VIETNAM", "RUSSIA", "UNITED KINGDOM",
+            "UNITED STATES" };
+
+    private static final int[] NATION_REGIONS = { 0, 1, 1, 1, 4, 0, 3, 3,
+            2, 2, 4, 4, 2, 4, 0, 0, 0, 1, 2, 3, 4, 2, 3, 3, 1 };
+
+    private static final String[] SEGMENTS = { "AUTOMOBILE", "BUILDING",
+            "FURNITURE", "HOUSEHOLD", "MACHINERY" };
+
+    private static final String[] PRIORITIES = { "1-URGENT", "2-HIGH",
+            "3-MEDIUM", "4-NOT SPECIFIED", "5-LOW" };
+
+    private static final String[] SHIP_MODES = { "REG AIR", "AIR", "RAIL",
+            "SHIP", "TRUCK", "MAIL", "FOB" };
+
+    private static final String[] TYPES_1 = { "STANDARD", "SMALL", "MEDIUM",
+            "LARGE", "ECONOMY", "PROMO" };
+
+    private static final String[] TYPES_2 = { "ANODIZED", "BURNISHED",
+            "PLATED", "POLISHED", "BRUSHED" };
+
+    private static final String[] TYPES_3 = { "TIN", "NICKEL", "BRASS",
+            "STEEL", "COPPER" };
+
+    private static final LocalDate START_DATE = LocalDate.of(1992, 1, 1);
+
+    /**
+     * The last order date is 151 days before the end of 1998.
+     */
+    private static final int ORDER_DAYS = 2405;
+
+    /**
+     * The date that separates shipped line items from open line items.
+     */
+    private static final LocalDate CURRENT_DATE = LocalDate.of(1995, 6, 17);
+
+    private Database database;
+
+    private int suppliers;
+    private int customers;
+    private int parts;
+    private int orders;
+
+    @Override
+    public void init(Database db, int size) throws SQLException {
+        this.database = db;
+        suppliers = Math.max(1, size / 50);
+        customers = Math.max(1, size);
+        parts = Math.max(1, size * 2);
+        orders = Math.max(1, size * 10);
+
+        db.start(this, "Init");
+        db.openConnection();
+        for (String table : TABLES) {
+            db.dropTable(table);
+        }
+        for (String sql : CREATE_SQL) {
+            db.update(sql);
+        }
+        db.setAutoCommit(false);
+        load();
+        db.commit();
+        db.closeConnection();
+        db.end();
+    }
+
+    private void load() throws SQLException {
+        Random random = database.getRandom();
+        PreparedStatement prep = database.prepare(
+                "INSERT INTO REGION VALUES(?, ?)");
+        for (int i = 0; i < REGIONS.length; i++) {
+            prep.setInt(1, i);
+            prep.setString(2, REGIONS[i]);
+            database.update(prep, "insertRegion");
+        }
+        prep = database.prepare("INSERT INTO NATION VALUES(?, ?, ?)");
+        for (int i = 0; i < NATIONS.length; i++) {
+            prep.setInt(1, i);
+            prep.setString(2, NATIONS[i]);
+            prep.setInt(3, NATION_REGIONS[i]);
+            database.update(prep, "insertNation");
+        }
+        prep = database.prepare("INSERT INTO SUPPLIER VALUES(?, ?, ?, ?)");
+        for (int i = 1; i <= suppliers; i++) {
+            prep.setInt(1, i);
+            prep.setString(2, "Supplier#" + i);
+            prep.setInt(3, random.nextInt(NATIONS.length));
+            prep.setBigDecimal(4, getMoney(random, -99_999, 999_999));
+            database.update(prep, "insertSupplier");
+        }
+        database.commit();
+        prep = database.prepare("INSERT INTO CUSTOMER VALUES(?, ?, ?, ?, ?)");
+        for (int i = 1; i <= customers; i++) {
+            prep.setInt(1, i);
+            prep.setString(2, "Customer#" + i);
+            prep.setInt(3, random.nextInt(NATIONS.length));
+            prep.setBigDecimal(4, getMoney(random, -99_999, 999_999));
+            prep.setString(5, SEGMENTS[random.nextInt(SEGMENTS.length)]);
+            database.update(prep, "insertCustomer");
+            if (i % COMMIT_EVERY == 0) {
+                database.commit();
+            }
+        }
+        database.commit();
+        prep = database.prepare("INSERT INTO PART VALUES(?, ?, ?, ?, ?)");
+        for (int i = 1; i <= parts; i++) {
+            prep.setInt(1, i);
+            prep.setString(2, "Part#" + i);
+            prep.setString(3, TYPES_1[random.nextInt(TYPES_1.length)] + ' '
+                    + TYPES_2[random.nextInt(TYPES_2.length)] + ' '
+                    + TYPES_3[random.nextInt(TYPES_3.length)]);
+            prep.setInt(4, 1 + random.nextInt(50));
+            prep.setBigDecimal(5, getRetailPrice(i));
+            database.update(prep, "insertPart");
+            if (i % COMMIT_EVERY == 0) {
+                database.commit();
+            }
+        }
+        database.commit();
+        PreparedStatement prepOrder = database.prepare(
+                "INSERT INTO ORDERS VALUES(?, ?, ?, ?, ?, ?, ?)");
+        PreparedStatement prepLine = database.prepare(
+                "INSERT INTO LINEITEM VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        for (int i = 1; i <= orders; i++) {
+            database.trace("Load ORDERS", i, orders);
+            LocalDate orderDate = START_DATE.plusDays(random.nextInt(ORDER_DAYS));
+            int lineCount = 1 + random.nextInt(7);
+            BigDecimal total = BigDecimal.ZERO;
+            int shipped = 0;
+            for (int line = 1; line <= lineCount; line++) {
+                int partKey = 1 + random.nextInt(parts);
+                int quantity = 1 + random.nextInt(50);
+                BigDecimal price = getRetailPrice(partKey).multiply(BigDecimal.valueOf(quantity));
+                BigDecimal discount = BigDecimal.valueOf(random.nextInt(11), 2);
+                BigDecimal tax = BigDecimal.valueOf(random.nextInt(9), 2);
+                LocalDate shipDate = orderDate.plusDays(1 + random.nextInt(121));
+                LocalDate commitDate = orderDate.plusDays(30 + random.nextInt(61));
+                LocalDate receiptDate = shipDate.plusDays(1 + random.nextInt(30));
+                String returnFlag = receiptDate.isAfter(CURRENT_DATE) ? "N" : random.nextBoolean() ? "R" : "A";
+                boolean open = shipDate.isAfter(CURRENT_DATE);
+                if (!open) {
+                    shipped++;
+                }
+                prepLine.setInt(1, i);
+                prepLine.setInt(2, line);
+                prepLine.setInt(3, partKey);
+                prepLine.setInt(4, 1 + random.nextInt(suppliers));
+                prepLine.setBigDecimal(5, BigDecimal.valueOf(quantity));
+                prepLine.setBigDecimal(6, price);
+                prepLine.setBigDecimal(7, discount);
+                prepLine.setBigDecimal(8, tax);
+                prepLine.setString(9, returnFlag);
+                prepLine.setString(10, open ? "O" : "F");
+                prepLine.setDate(11, Date.valueOf(shipDate));
+                prepLine.setDate(12, Date.valueOf(commitDate));
+                prepLine.setDate(13, Date.valueOf(receiptDate));
+                prepLine.setString(14, SHIP_MODES[random.nextInt(SHIP_MODES.length)]);
+                database.update(prepLine, "insertLineItem");
+                total = total.add(price.multiply(BigDecimal.ONE.add(tax))
+                        .multiply(BigDecimal.ONE.subtract(discount)));
+            }
+            prepOrder.setInt(1, i);
+            prepOrder.setInt(2, 1 + random.nextInt(customers));
+            prepOrder.setString(3, shipped == lineCount ? "F" : shipped == 0 ? "O" : "P");
+            prepOrder.setBigDecimal(4, total.setScale(2, RoundingMode.HALF_UP));
+            prepOrder.setDate(5, Date.valueOf(orderDate));
+            prepOrder.setString(6, PRIORITIES[random.nextInt(PRIORITIES.length)]);
+            prepOrder.setInt(7, 0);
+            database.update(prepOrder, "insertOrders");
+            if (i % COMMIT_EVERY == 0) {
+                database.commit();
+            }
+        }
+    }
+
+    private static BigDecimal getMoney(Random random, int min, int max) {
+        return BigDecimal.valueOf(min + random.nextInt(max - min + 1), 2);
+    }
+
+    private static BigDecimal getRetailPrice(int partKey) {
+        return BigDecimal.valueOf(90_000 + partKey / 10 % 20_001 + 100 * (partKey % 1_000), 2);
+    }
+
+    @Override
+    public void runTest() throws SQLException {
+        Database db = database;
+        Random random = db.getRandom();
+        db.openConnection();
+
+        // Q1: pricing summary report
+        PreparedStatement prep = db.prepare(
+                "SELECT L_RETURNFLAG, L_LINESTATUS, SUM(L_QUANTITY), "
+                + "SUM(L_EXTENDEDPRICE), "
+                + "SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT)), "
+                + "SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT) * (1 + L_TAX)), "
+                + "AVG(L_QUANTITY), AVG(L_EXTENDEDPRICE), AVG(L_DISCOUNT), "
+                + "COUNT(*) FROM LINEITEM WHERE L_SHIPDATE <= ? "
+                + "GROUP BY L_RETURNFLAG, L_LINESTATUS "
+                + "ORDER BY L_RETURNFLAG, L_LINESTATUS");
+        db.start(this, "Q1 (pricing summary)");
+        for (int i = 0; i < RUNS; i++) {
+            prep.setDate(1, Date.valueOf(LocalDate.of(1998, 12, 1).minusDays(60 + random.nextInt(61))));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q3: shipping priority
+        prep = db.prepare(
+                "SELECT L_ORDERKEY, SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT)) AS REVENUE, "
+                + "O_ORDERDATE, O_SHIPPRIORITY FROM CUSTOMER, ORDERS, LINEITEM "
+                + "WHERE C_MKTSEGMENT = ? AND C_CUSTKEY = O_CUSTKEY "
+                + "AND L_ORDERKEY = O_ORDERKEY AND O_ORDERDATE < ? AND L_SHIPDATE > ? "
+                + "GROUP BY L_ORDERKEY, O_ORDERDATE, O_SHIPPRIORITY "
+                + "ORDER BY REVENUE DESC, O_ORDERDATE");
+        prep.setMaxRows(10);
+        db.start(this, "Q3 (shipping priority)");
+        for (int i = 0; i < RUNS; i++) {
+            Date date = Date.valueOf(LocalDate.of(1995, 3, 1).plusDays(random.nextInt(31)));
+            prep.setString(1, SEGMENTS[random.nextInt(SEGMENTS.length)]);
+            prep.setDate(2, date);
+            prep.setDate(3, date);
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q5: local supplier volume
+        prep = db.prepare(
+                "SELECT N_NAME, SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT)) AS REVENUE "
+                + "FROM CUSTOMER, ORDERS, LINEITEM, SUPPLIER, NATION, REGION "
+                + "WHERE C_CUSTKEY = O_CUSTKEY AND L_ORDERKEY = O_ORDERKEY "
+                + "AND L_SUPPKEY = S_SUPPKEY AND C_NATIONKEY = S_NATIONKEY "
+                + "AND S_NATIONKEY = N_NATIONKEY AND N_REGIONKEY = R_REGIONKEY "
+                + "AND R_NAME = ? AND O_ORDERDATE >= ? AND O_ORDERDATE < ? "
+                + "GROUP BY N_NAME ORDER BY REVENUE DESC");
+        db.start(this, "Q5 (local supplier volume)");
+        for (int i = 0; i < RUNS; i++) {
+            LocalDate date = LocalDate.of(1993 + random.nextInt(5), 1, 1);
+            prep.setString(1, REGIONS[random.nextInt(REGIONS.length)]);
+            prep.setDate(2, Date.valueOf(date));
+            prep.setDate(3, Date.valueOf(date.plusYears(1)));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q6: forecasting revenue change
+        prep = db.prepare(
+                "SELECT SUM(L_EXTENDEDPRICE * L_DISCOUNT) AS REVENUE FROM LINEITEM "
+                + "WHERE L_SHIPDATE >= ? AND L_SHIPDATE < ? "
+                + "AND L_DISCOUNT BETWEEN ? AND ? AND L_QUANTITY < ?");
+        db.start(this, "Q6 (forecasting revenue change)");
+        for (int i = 0; i < RUNS; i++) {
+            LocalDate date = LocalDate.of(1993 + random.nextInt(5), 1, 1);
+            int discount = 2 + random.nextInt(8);
+            prep.setDate(1, Date.valueOf(date));
+            prep.setDate(2, Date.valueOf(date.plusYears(1)));
+            prep.setBigDecimal(3, BigDecimal.valueOf(discount - 1, 2));
+            prep.setBigDecimal(4, BigDecimal.valueOf(discount + 1, 2));
+            prep.setInt(5, 24 + random.nextInt(2));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q10: returned item reporting
+        prep = db.prepare(
+                "SELECT C_CUSTKEY, C_NAME, "
+                + "SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT)) AS REVENUE, "
+                + "C_ACCTBAL, N_NAME FROM CUSTOMER, ORDERS, LINEITEM, NATION "
+                + "WHERE C_CUSTKEY = O_CUSTKEY AND L_ORDERKEY = O_ORDERKEY "
+                + "AND O_ORDERDATE >= ? AND O_ORDERDATE < ? "
+                + "AND L_RETURNFLAG = 'R' AND C_NATIONKEY = N_NATIONKEY "
+                + "GROUP BY C_CUSTKEY, C_NAME, C_ACCTBAL, N_NAME "
+                + "ORDER BY REVENUE DESC");
+        prep.setMaxRows(20);
+        db.start(this, "Q10 (returned item reporting)");
+        for (int i = 0; i < RUNS; i++) {
+            LocalDate date = LocalDate.of(1993, 2, 1).plusMonths(random.nextInt(24));
+            prep.setDate(1, Date.valueOf(date));
+            prep.setDate(2, Date.valueOf(date.plusMonths(3)));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q12: shipping modes and order priority
+        prep = db.prepare(
+                "SELECT L_SHIPMODE, "
+                + "SUM(CASE WHEN O_ORDERPRIORITY = '1-URGENT' "
+                + "OR O_ORDERPRIORITY = '2-HIGH' THEN 1 ELSE 0 END), "
+                + "SUM(CASE WHEN O_ORDERPRIORITY <> '1-URGENT' "
+                + "AND O_ORDERPRIORITY <> '2-HIGH' THEN 1 ELSE 0 END) "
+                + "FROM ORDERS, LINEITEM WHERE O_ORDERKEY = L_ORDERKEY "
+                + "AND L_SHIPMODE IN (?, ?) AND L_COMMITDATE < L_RECEIPTDATE "
+                + "AND L_SHIPDATE < L_COMMITDATE "
+                + "AND L_RECEIPTDATE >= ? AND L_RECEIPTDATE < ? "
+                + "GROUP BY L_SHIPMODE ORDER BY L_SHIPMODE");
+        db.start(this, "Q12 (shipping modes)");
+        for (int i = 0; i < RUNS; i++) {
+            LocalDate date = LocalDate.of(1993 + random.nextInt(5), 1, 1);
+            int mode = random.nextInt(SHIP_MODES.length);
+            prep.setString(1, SHIP_MODES[mode]);
+            prep.setString(2, SHIP_MODES[(mode + 1 + random.nextInt(SHIP_MODES.length - 1)) % SHIP_MODES.length]);
+            prep.setDate(3, Date.valueOf(date));
+            prep.setDate(4, Date.valueOf(date.plusYears(1)));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        // Q14: promotion effect
+        prep = db.prepare(
+                "SELECT 100.00 * SUM(CASE WHEN P_TYPE LIKE 'PROMO%' "
+                + "THEN L_EXTENDEDPRICE * (1 - L_DISCOUNT) ELSE 0 END) "
+                + "/ SUM(L_EXTENDEDPRICE * (1 - L_DISCOUNT)) "
+                + "FROM LINEITEM, PART WHERE L_PARTKEY = P_PARTKEY "
+                + "AND L_SHIPDATE >= ? AND L_SHIPDATE < ?");
+        db.start(this, "Q14 (promotion effect)");
+        for (int i = 0; i < RUNS; i++) {
+            LocalDate date = LocalDate.of(1993, 1, 1).plusMonths(random.nextInt(60));
+            prep.setDate(1, Date.valueOf(date));
+            prep.setDate(2, Date.valueOf(date.plusMonths(1)));
+            db.queryReadResult(prep);
+        }
+        db.end();
+
+        db.logMemory(this, "Memory Usage");
+        db.closeConnection();
+    }
+
+    @Override
+    public String getName() {
+        return "BenchH";
+    }
+
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2004-2021 H2 Group. Multiple-Licensed under the MPL 2.0,
+ * and the EPL 1.0 (https://h2database.com/html/license.html).
+ * Initial Developer: H2 Group
+ */
+package org.h2.test.bench;
+
+import java.sql.SQLException;
+import java.sql.Types;
+import java.util.ArrayList;
+import java.util.Random;
+import java.util.concurrent.TimeUnit;
+import org.h2.mvstore.Cursor;
+import org.h2.mvstore.MVMap;
+import org.h2.mvstore.MVStore;
+import org.h2.mvstore.cache.CacheLongKeyLIRS;
+import org.h2.store.fs.FileUtils;
+import org.h2.tools.Csv;
+import org.h2.tools.SimpleResultSet;
+
+/**
+ * Micro-benchmarks of the MVStore: operations of a map in memory, writing and
+ * reading chunks of a file store, and the LIRS cache. Each benchmark is run
+ * once to warm up and then measured. The results can be written in CSV
+ * format to compare them between releases.
+ */
+public class BenchMVStore {
+
+    private static final String FILE_NAME = "data/benchMVStore.mv.db";
+
+    private final ArrayList<Object[]> results = new ArrayList<>();
+
+    private int size = 1_000_000;
+
+    private boolean collect;
+
+    private long startTimeNs;
+
+    /**
+     * This method is called when executing this sample application.
+     * Supported options are -size (the number of entries) and -csv (the name
+     * of the result file).
+     *
+     * @param args the command line parameters
+     */
+    public static void main(String... args) throws Exception {
+        new BenchMVStore().test(args);
+    }
+
+    private void test(String... args) throws SQLException {
+        String csv = null;
+        for (int i = 0; i < args.length; i++) {
+            String arg = args[i];
+            if ("-size".equals(arg)) {
+                size = Integer.parseInt(args[++i]);
+            } else if ("-csv".equals(arg)) {
+                csv = args[++i];
+            }
+        }
+        runAll();
+        collect = true;
+        runAll();
+        if (csv != null) {
+            SimpleResultSet rs = new SimpleResultSet();
+            rs.addColumn("TEST", Types.VARCHAR, 255, 0);
+            rs.addColumn("UNIT", Types.VARCHAR, 255, 0);
+            rs.addColumn("RESULT", Types.BIGINT, 19, 0);
+            for (Object[] res : results) {
+                rs.addRow(res);
+            }
+            new Csv().write(csv, rs, null);
+        }
+    }
+
+    private void runAll() {
+        testMap();
+        testChunkStore();
+        testCache();
+    }
+
+    private void testMap() {
+        MVStore s = MVStore.open(null);
+        MVMap<Integer, String> map = s.openMap("test");
+        start();
+        for (int i = 0; i < size; i++) {
+            map.put(i, "Hello World");
+        }
+        end("MVMap: put (sequential)");
+        Random random = new Random(1);
+        start();
+        for (int i = 0; i < size; i++) {
+            map.get(random.nextInt(size));
+        }
+        end("MVMap: get (random)");
+        start();
+        int count = 0;
+        for (Cursor<Integer, String> c = map.cursor(null); c.hasNext();) {
+            c.next();
+            count++;
+        }
+        end("MVMap: cursor");
+        check(count);
+        start();
+        for (int i = 0; i < size; i++) {
+            map.remove(i);
+        }
+        end("MVMap: remove (sequential)");
+        start();
+        for (int i = 0; i < size; i++) {
+            map.put(random.nextInt(), "Hello World");
+        }
+        end("MVMap: put (random)");
+        s.close();
+    }
+
+    private void testChunkStore() {
+        FileUtils.delete(FILE_NAME);
+        FileUtils.createDirectories(FileUtils.getParent(FILE_NAME));
+        MVStore s = new MVStore.Builder().fileName(FILE_NAME).autoCommitDisabled().open();
+        MVMap<Integer, String> map = s.openMap("test");
+        Random random = new Random(1);
+        start();
+        for (int i = 0; i < size; i++) {
+            map.put(random.nextInt(size), "Hello World " + i);
+            if ((i + 1) % 100_000 == 0) {
+                s.commit();
+            }
+        }
+        s.commit();
+        end("Chunk store: put and commit");
+        start();
+        s.close();
+        end("Chunk store: close");
+        start();
+        s = new MVStore.Builder().fileName(FILE_NAME).readOnly().open();
+        map = s.openMap("test");
+        int count = 0;
+        for (Cursor<Integer, String> c = map.cursor(null); c.hasNext();) {
+            c.next();
+            count++;
+        }
+        end("Chunk store: open and read");
+        check(count);
+        start();
+        for (int i = 0; i < size; i++) {
+            map.get(random.nextInt(size));
+        }
+        end("Chunk store: get (random)");
+        s.close();
+        FileUtils.delete(FILE_NAME);
+    }
+
+    private void testCache() {
+        CacheLongKeyLIRS.Config config = new CacheLongKeyLIRS.Config();
+        config.maxMemory = Math.max(1, size / 10);
+        CacheLongKeyLIRS<Integer> cache = new CacheLongKeyLIRS<>(config);
+        Random random = new Random(1);
+        Integer value = 1;
+        start();
+        for (int i = 0; i < size; i++) {
+            // most accesses go to a small set of hot keys
+            long key = random.nextInt(4) == 0 ? random.nextInt(size) : random.nextInt(size / 20 + 1);
+            if (cache.get(key) == null) {
+                cache.put(key, value);
+            }
+        }
+        end("LIRS cache: get and put");
+        long hits = cache.getHits(), misses = cache.getMisses();
+        log("LIRS cache: hit ratio", "%", hits * 100 / Math.max(hits + misses, 1));
+    }
+
+    private void check(int count) {
+        if (count <= 0) {
+            throw new AssertionError("count=" + count);
+        }
+    }
+
+    private void start() {
+        startTimeNs = System.nanoTime();
+    }
+
+    private void end(String test) {
+        log(test, "ms", TimeUnit.NANOSECONDS.toMillis(System.nanoTime() - startTimeNs));
+    }
+
+    private void log(String test, String unit, long value) {
+        if (collect) {
+            System.out.println(test + ": " + value + " " + unit);
+            results.add(new Object[] { test, unit, value });
+        }
+    }
+
+}
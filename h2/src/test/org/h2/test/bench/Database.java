@@ -262,8 +262,19 @@ void setTranslations(Properties prop) {
      * @return the prepared statement
      */
     PreparedStatement prepare(String sql) throws SQLException {
+        return prepare(conn, sql);
+    }
+
+    /**
+     * Prepare an SQL statement with the given connection.
+     *
+     * @param connection the connection
+     * @param sql the SQL statement
+     * @return the prepared statement
+     */
+    PreparedStatement prepare(Connection connection, String sql) throws SQLException {
         sql = getSQL(sql);
-        return conn.prepareStatement(sql);
+        return connection.prepareStatement(sql);
     }
 
     private String getSQL(String sql) {
@@ -15,10 +15,13 @@
 import java.sql.ResultSet;
 import java.sql.SQLException;
 import java.sql.Statement;
+import java.sql.Types;
 import java.util.ArrayList;
 import java.util.Properties;
 import org.h2.store.fs.FileUtils;
 import org.h2.test.TestBase;
+import org.h2.tools.Csv;
+import org.h2.tools.SimpleResultSet;
 import org.h2.util.IOUtils;
 import org.h2.util.JdbcUtils;
 
@@ -77,6 +80,8 @@ private void test(String... args) throws Exception {
         prop.load(in);
         in.close();
         int size = Integer.parseInt(prop.getProperty("size"));
+        int threadCount = 1;
+        String csv = null;
         for (int i = 0; i < args.length; i++) {
             String arg = args[i];
             if ("-db".equals(arg)) {
@@ -91,6 +96,10 @@ private void test(String... args) throws Exception {
                 exit = true;
             } else if ("-size".equals(arg)) {
                 size = Integer.parseInt(args[++i]);
+            } else if ("-threads".equals(arg)) {
+                threadCount = Integer.parseInt(args[++i]);
+            } else if ("-csv".equals(arg)) {
+                csv = args[++i];
             }
         }
         ArrayList<Database> dbs = new ArrayList<>();
@@ -100,7 +109,7 @@ private void test(String... args) throws Exception {
             }
             String dbString = prop.getProperty("db" + i);
             if (dbString != null) {
-                Database db = Database.parse(this, i, dbString, 1);
+                Database db = Database.parse(this, i, dbString, threadCount);
                 if (db != null) {
                     db.setTranslations(prop);
                     dbs.add(db);
@@ -121,6 +130,9 @@ private void test(String... args) throws Exception {
             return;
         }
         ArrayList<Object[]> results = dbs.get(0).getResults();
+        if (csv != null) {
+            writeCsv(csv, dbs, results);
+        }
         Connection conn = null;
         PreparedStatement prep = null;
         Statement stat = null;
@@ -217,6 +229,34 @@ private void test(String... args) throws Exception {
         }
     }
 
+    /**
+     * Write the results of this run in CSV format, one row for each test
+     * case and database.
+     *
+     * @param fileName the file name
+     * @param dbs the databases
+     * @param results the results of the first database
+     */
+    private static void writeCsv(String fileName, ArrayList<Database> dbs,
+            ArrayList<Object[]> results) throws SQLException {
+        SimpleResultSet rs = new SimpleResultSet();
+        rs.addColumn("TESTID", Types.INTEGER, 10, 0);
+        rs.addColumn("TEST", Types.VARCHAR, 255, 0);
+        rs.addColumn("UNIT", Types.VARCHAR, 255, 0);
+        rs.addColumn("DBID", Types.INTEGER, 10, 0);
+        rs.addColumn("DB", Types.VARCHAR, 255, 0);
+        rs.addColumn("THREADS", Types.INTEGER, 10, 0);
+        rs.addColumn("RESULT", Types.INTEGER, 10, 0);
+        for (int i = 0; i < results.size(); i++) {
+            Object[] res = results.get(i);
+            for (Database db : dbs) {
+                Object[] v = db.getResults().get(i);
+                rs.addRow(i, res[0], res[1], db.getId(), db.getName(), db.getThreadsCount(), v[2]);
+            }
+        }
+        new Csv().write(fileName, rs, null);
+    }
+
     private void testAll(ArrayList<Database> dbs, ArrayList<Bench> tests,
             int size) throws Exception {
         for (int i = 0; i < dbs.size(); i++) {
@@ -13,6 +13,7 @@
 import java.util.concurrent.atomic.AtomicLong;
 
 import org.h2.api.DatabaseEventListener;
+import org.h2.api.ErrorCode;
 import org.h2.store.fs.FileUtils;
 import org.h2.test.TestBase;
 import org.h2.test.TestDb;
@@ -48,6 +49,7 @@ public void test() throws SQLException {
         testBackupRestoreLobStatement();
         testBackupRestoreLob();
         testBackup();
+        testIncrementalBackup();
         deleteDb("backup");
         FileUtils.delete(getBaseDir() + "/backup.zip");
     }
@@ -192,4 +194,36 @@ private void testBackup() throws SQLException {
         deleteDb("restored");
     }
 
+    private void testIncrementalBackup() throws SQLException {
+        deleteDb("backup");
+        deleteDb("restored");
+        String dir = getBaseDir();
+        Connection conn1 = getConnection("backup");
+        Statement stat1 = conn1.createStatement();
+        stat1.execute("create table test(id int primary key, name varchar)");
+        stat1.execute("insert into test select x, repeat('Hello', 20) from system_range(1, 10000)");
+        stat1.execute("backup to '" + dir + "/backup.zip'");
+        stat1.execute("update test set name = 'World' where id = 10");
+        stat1.execute("insert into test values (10001, 'Hi')");
+        stat1.execute("backup to '" + dir + "/backup-1.zip' incremental from '" + dir + "/backup.zip'");
+        assertTrue(FileUtils.size(dir + "/backup-1.zip") < FileUtils.size(dir + "/backup.zip") / 2);
+        stat1.execute("delete from test where id < 100");
+        stat1.execute("create table test2(id int) as select x from system_range(1, 10)");
+        stat1.execute("backup to '" + dir + "/backup-2.zip' incremental from '" + dir + "/backup-1.zip'");
+        assertThrows(ErrorCode.FILE_NOT_FOUND_1, stat1).execute(
+                "backup to '" + dir + "/backup-3.zip' incremental from '" + dir + "/backup-missing.zip'");
+
+        Restore.execute(dir + "/backup.zip", dir, "restored");
+        Restore.execute(dir + "/backup-1.zip", dir, "restored");
+        Restore.execute(dir + "/backup-2.zip", dir, "restored");
+        Connection conn2 = getConnection("restored");
+        Statement stat2 = conn2.createStatement();
+        assertEqualDatabases(stat1, stat2);
+        conn2.close();
+        conn1.close();
+        deleteDb("restored");
+        FileUtils.delete(dir + "/backup-1.zip");
+        FileUtils.delete(dir + "/backup-2.zip");
+    }
+
 }
@@ -62,6 +62,7 @@ public void test() throws Exception {
         testPerformance(false);
         testReopen(false);
         testDropIndex(false);
+        testMVStore();
         if (!config.reopen) {
             try {
                 Class.forName(LUCENE_FULLTEXT_CLASS_NAME);
@@ -372,6 +373,81 @@ private void testCreateDropNative() throws SQLException {
         FileUtils.deleteRecursive(getBaseDir() + "/fullText", false);
     }
 
+    private void testMVStore() throws SQLException {
+        deleteDb("fullTextMVStore");
+        ArrayList<Connection> connList = new ArrayList<>();
+        Connection conn = getConnection("fullTextMVStore", connList);
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE ALIAS IF NOT EXISTS FTM_INIT FOR 'org.h2.fulltext.FullTextMVStore.init'");
+        stat.execute("CALL FTM_INIT()");
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, NAME VARCHAR)");
+        stat.execute("INSERT INTO TEST VALUES(1, 'Hello World'), (2, 'Hello Hello Moon'), (3, 'World Peace')");
+        stat.execute("CALL FTM_CREATE_INDEX('PUBLIC', 'TEST', NULL)");
+        ResultSet rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Hello', 0, 0)");
+        assertTrue(rs.next());
+        assertEquals("\"PUBLIC\".\"TEST\" WHERE \"ID\"=2", rs.getString(1));
+        double score = rs.getDouble(2);
+        assertTrue(rs.next());
+        assertEquals("\"PUBLIC\".\"TEST\" WHERE \"ID\"=1", rs.getString(1));
+        assertTrue(score > rs.getDouble(2));
+        assertFalse(rs.next());
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('world hello', 0, 0)");
+        assertTrue(rs.next());
+        assertEquals("\"PUBLIC\".\"TEST\" WHERE \"ID\"=1", rs.getString(1));
+        assertFalse(rs.next());
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Hello', 1, 1)");
+        assertTrue(rs.next());
+        assertEquals("\"PUBLIC\".\"TEST\" WHERE \"ID\"=1", rs.getString(1));
+        assertFalse(rs.next());
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH_DATA('Peace', 0, 0)");
+        assertTrue(rs.next());
+        assertEquals("PUBLIC", rs.getString(1));
+        assertEquals("TEST", rs.getString(2));
+        assertEquals("3", ((Object[]) rs.getArray(4).getArray())[0].toString());
+        assertFalse(rs.next());
+
+        conn.setAutoCommit(false);
+        stat.execute("INSERT INTO TEST VALUES(4, 'Hello Mars')");
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Mars', 0, 0)");
+        assertTrue(rs.next());
+        Connection conn2 = getConnection("fullTextMVStore", connList);
+        Statement stat2 = conn2.createStatement();
+        rs = stat2.executeQuery("SELECT * FROM FTM_SEARCH('Mars', 0, 0)");
+        assertFalse(rs.next());
+        conn.rollback();
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Mars', 0, 0)");
+        assertFalse(rs.next());
+        conn.setAutoCommit(true);
+
+        stat.execute("UPDATE TEST SET NAME='Good Bye' WHERE ID=1");
+        stat.execute("DELETE FROM TEST WHERE ID=2");
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Hello', 0, 0)");
+        assertFalse(rs.next());
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('World', 0, 0)");
+        assertTrue(rs.next());
+        assertEquals("\"PUBLIC\".\"TEST\" WHERE \"ID\"=3", rs.getString(1));
+        assertFalse(rs.next());
+        if (!config.memory) {
+            close(connList);
+            connList.clear();
+            conn = getConnection("fullTextMVStore", connList);
+            stat = conn.createStatement();
+        }
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Bye', 0, 0)");
+        assertTrue(rs.next());
+        assertFalse(rs.next());
+        stat.execute("CALL FTM_REINDEX()");
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Bye', 0, 0)");
+        assertTrue(rs.next());
+        assertFalse(rs.next());
+        stat.execute("CALL FTM_DROP_INDEX('PUBLIC', 'TEST')");
+        rs = stat.executeQuery("SELECT * FROM FTM_SEARCH('Bye', 0, 0)");
+        assertFalse(rs.next());
+        stat.execute("CALL FTM_DROP_ALL()");
+        close(connList);
+        deleteDb("fullTextMVStore");
+    }
+
     private void testCreateDropLucene() throws SQLException, SecurityException,
             NoSuchMethodException, ClassNotFoundException,
             IllegalArgumentException, IllegalAccessException,
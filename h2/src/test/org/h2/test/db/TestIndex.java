@@ -109,6 +109,7 @@ public void test() throws SQLException {
 
         // This test uses own connection
         testEnumIndex();
+        testParallelCreateIndex();
     }
 
     private void testOrderIndex() throws SQLException {
@@ -568,6 +569,47 @@ private void testLargeIndex() throws SQLException {
         stat.execute("DROP TABLE IF EXISTS TEST");
     }
 
+    private void testParallelCreateIndex() throws SQLException {
+        deleteDb("indexParallel");
+        Connection conn = getConnection("indexParallel");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, V INT, U INT)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X * 7919, 1000), X FROM SYSTEM_RANGE(1, 10000)");
+        // sorted runs are built by multiple threads
+        stat.execute("SET MAX_MEMORY_ROWS 500");
+        stat.execute("SET PARALLELISM 4");
+        stat.execute("CREATE INDEX IDX_V ON TEST(V)");
+        stat.execute("CREATE UNIQUE INDEX IDX_U ON TEST(U)");
+        ResultSet rs = stat.executeQuery("SELECT COUNT(*) FROM TEST WHERE V BETWEEN 10 AND 19");
+        rs.next();
+        assertEquals(100, rs.getInt(1));
+        rs = stat.executeQuery("SELECT COUNT(*), SUM(ID) FROM TEST WHERE U > 9000");
+        rs.next();
+        assertEquals(1000, rs.getInt(1));
+        assertEquals(9_500_500, rs.getLong(2));
+        stat.execute("DROP INDEX IDX_U");
+        stat.execute("UPDATE TEST SET U = 1 WHERE ID = 9999");
+        assertThrows(ErrorCode.DUPLICATE_KEY_1, stat).execute("CREATE UNIQUE INDEX IDX_U ON TEST(U)");
+        stat.execute("UPDATE TEST SET U = NULL WHERE ID = 9999");
+        stat.execute("UPDATE TEST SET U = NULL WHERE ID = 1");
+        stat.execute("CREATE UNIQUE INDEX IDX_U ON TEST(U)");
+        rs = stat.executeQuery("SELECT COUNT(*) FROM TEST WHERE U IS NULL");
+        rs.next();
+        assertEquals(2, rs.getInt(1));
+        // the range of the session thread has only one row, all other rows
+        // are read by a worker thread that is still running after that
+        stat.execute("DROP TABLE TEST");
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, V INT)");
+        stat.execute("INSERT INTO TEST VALUES (1, 1)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X, 1000) FROM SYSTEM_RANGE(1000001, 1020000)");
+        stat.execute("CREATE INDEX IDX_V ON TEST(V)");
+        rs = stat.executeQuery("SELECT COUNT(*) FROM TEST USE INDEX (IDX_V) WHERE V >= 0");
+        rs.next();
+        assertEquals(20_001, rs.getInt(1));
+        conn.close();
+        deleteDb("indexParallel");
+    }
+
     private void testHashIndex(boolean primaryKey, boolean hash)
             throws SQLException {
         if (config.memory) {
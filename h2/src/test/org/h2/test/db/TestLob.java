@@ -80,6 +80,7 @@ public void test() throws Exception {
         testReadManyLobs();
         testLobSkip();
         testLobSkipPastEnd();
+        testLobBlockSize();
         testCreateIndexOnLob();
         testBlobInputStreamSeek(true);
         testBlobInputStreamSeek(false);
@@ -329,6 +330,56 @@ private void testLobSkip() throws Exception {
         conn.close();
     }
 
+    private void testLobBlockSize() throws Exception {
+        if (config.memory) {
+            return;
+        }
+        deleteDb("lob");
+        Connection conn = getConnection("lob;LOB_BLOCK_SIZE=1048576");
+        Statement stat = conn.createStatement();
+        stat.execute("create table test(id int, data blob)");
+        byte[] data = new byte[3_000_000];
+        new Random(1).nextBytes(data);
+        PreparedStatement prep = conn.prepareStatement("insert into test values(1, ?)");
+        prep.setBytes(1, data);
+        prep.execute();
+        ResultSet rs = stat.executeQuery("select data from test");
+        assertTrue(rs.next());
+        InputStream in = rs.getBinaryStream(1);
+        byte[] d2 = new byte[data.length];
+        Random random = new Random(2);
+        int pos = 0;
+        while (true) {
+            int len;
+            switch (random.nextInt(3)) {
+            case 0:
+                int x = in.read();
+                if (x >= 0) {
+                    d2[pos] = (byte) x;
+                    len = 1;
+                } else {
+                    len = -1;
+                }
+                break;
+            case 1:
+                len = in.read(d2, pos, Math.min(100, d2.length - pos));
+                break;
+            default:
+                len = in.read(d2, pos, Math.min(300_000, d2.length - pos));
+            }
+            if (len <= 0) {
+                assertEquals(data.length, pos);
+                break;
+            }
+            pos += len;
+        }
+        assertEquals(-1, in.read());
+        in.close();
+        assertEquals(data, d2);
+        stat.execute("drop table test");
+        conn.close();
+    }
+
     private void testLobSkipPastEnd() throws Exception {
         if (config.memory) {
             return;
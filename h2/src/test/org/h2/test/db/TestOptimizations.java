@@ -17,6 +17,8 @@
 import java.util.TreeSet;
 import java.util.concurrent.TimeUnit;
 import org.h2.api.ErrorCode;
+import org.h2.engine.SessionLocal;
+import org.h2.jdbc.JdbcConnection;
 import org.h2.test.TestBase;
 import org.h2.test.TestDb;
 import org.h2.tools.SimpleResultSet;
@@ -43,6 +45,7 @@ public void test() throws Exception {
         testConditionsStackOverflow();
         testIdentityIndexUsage();
         testFastRowIdCondition();
+        testExplainAnalyzeVerbose();
         testExplainRoundTrip();
         testOrderByExpression();
         testGroupSubquery();
@@ -54,6 +57,7 @@ public void test() throws Exception {
         testRowId();
         testSortIndex();
         testAutoAnalyze();
+        testColumnStatistics();
         testInAndBetween();
         testNestedIn();
         testConstantIn1();
@@ -64,10 +68,15 @@ public void test() throws Exception {
         testInSelectJoin();
         testMinMaxNullOptimization();
         testUseCoveringIndex();
+        testHashJoin();
+        testParallelAggregation();
+        testBatchEvaluation();
+        testExternalSort();
         // testUseIndexWhenAllColumnsNotInOrderBy();
         if (config.networked) {
             return;
         }
+        testQueryMemory();
         testOptimizeInJoinSelect();
         testOptimizeInJoin();
         testMultiColumnRangeQuery();
@@ -112,6 +121,54 @@ private void testFastRowIdCondition() throws Exception {
         conn.close();
     }
 
+    private void testExplainAnalyzeVerbose() throws SQLException {
+        deleteDb("optimizations");
+        Connection conn = getConnection("optimizations");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, G INT)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X, 10) FROM SYSTEM_RANGE(1, 1000)");
+        String sql = "SELECT G, COUNT(*) FROM TEST WHERE G < 5 GROUP BY G ORDER BY 2 DESC, 1";
+        ResultSet rs = stat.executeQuery("EXPLAIN ANALYZE " + sql);
+        rs.next();
+        String plan = rs.getString(1);
+        assertContains(plan, "/* scanCount: 1001 */");
+        assertFalse(plan.contains("time: "));
+        rs = stat.executeQuery("EXPLAIN ANALYZE VERBOSE " + sql);
+        rs.next();
+        plan = rs.getString(1);
+        assertContains(plan, "/* scanCount: 1001, rows: 500, time: ");
+        assertContains(plan, "/* group: rows: 5, time: ");
+        assertContains(plan, "/* sort: time: ");
+        assertContains(plan, "cache hits: ");
+        assertContains(plan, "lock wait: ");
+        assertContains(plan, "spilled rows: 0, bytes: 0");
+        // the instrumentation is only enabled for EXPLAIN ANALYZE VERBOSE
+        rs = stat.executeQuery("EXPLAIN ANALYZE " + sql);
+        rs.next();
+        assertFalse(rs.getString(1).contains("time: "));
+        // query statistics don't change the plans and don't measure the time
+        // of table filters
+        stat.execute("SET QUERY_STATISTICS TRUE");
+        rs = stat.executeQuery("EXPLAIN ANALYZE " + sql);
+        rs.next();
+        assertContains(rs.getString(1), "/* scanCount: 1001 */");
+        assertFalse(rs.getString(1).contains("time: "));
+        rs = stat.executeQuery("EXPLAIN ANALYZE VERBOSE " + sql);
+        rs.next();
+        assertContains(rs.getString(1), "/* scanCount: 1001, rows: 500, time: ");
+        stat.execute("SET QUERY_STATISTICS FALSE");
+        if (!config.memory) {
+            stat.execute("SET MAX_MEMORY_ROWS 100");
+            rs = stat.executeQuery("EXPLAIN ANALYZE VERBOSE SELECT ID FROM TEST ORDER BY G, ID");
+            rs.next();
+            plan = rs.getString(1);
+            assertContains(plan, "/* select: rows: 1000, time: ");
+            assertFalse(plan.contains("spilled rows: 0,"));
+        }
+        conn.close();
+        deleteDb("optimizations");
+    }
+
     private void testExplainRoundTrip() throws Exception {
         Connection conn = getConnection("optimizations");
         assertExplainRoundTrip(conn, "SELECT \"X\" FROM SYSTEM_RANGE(1, 1)"
@@ -379,6 +436,43 @@ private void testAutoAnalyze() throws SQLException {
         conn.close();
     }
 
+    private void testColumnStatistics() throws SQLException {
+        deleteDb("optimizations");
+        Connection conn = getConnection("optimizations");
+        Statement stat = conn.createStatement();
+        stat.execute("create table test(id int primary key, a int, b int)");
+        stat.execute("create index idx_a on test(a)");
+        stat.execute("create index idx_b on test(b)");
+        // both columns have the same selectivity, but values of A are skewed
+        stat.execute("insert into test select x, case when x <= 9900 then 0 else x end, mod(x, 100) "
+                + "from system_range(1, 10000)");
+        stat.execute("analyze");
+        assertColumnStatistics(stat);
+        if (!config.memory) {
+            conn.close();
+            conn = getConnection("optimizations");
+            stat = conn.createStatement();
+            assertColumnStatistics(stat);
+        }
+        stat.execute("drop table test");
+        conn.close();
+    }
+
+    private void assertColumnStatistics(Statement stat) throws SQLException {
+        ResultSet rs = stat.executeQuery("explain select * from test where a = 0 and b = 3");
+        rs.next();
+        assertContains(rs.getString(1), "IDX_B");
+        rs = stat.executeQuery("explain select * from test where a = 9950 and b = 3");
+        rs.next();
+        assertContains(rs.getString(1), "IDX_A");
+        rs = stat.executeQuery("explain select * from test where a in (0, 1) and b = 3");
+        rs.next();
+        assertContains(rs.getString(1), "IDX_B");
+        rs = stat.executeQuery("explain select * from test where a > 9990 and b = 3");
+        rs.next();
+        assertContains(rs.getString(1), "IDX_A");
+    }
+
     private void testInAndBetween() throws SQLException {
         deleteDb("optimizations");
         Connection conn = getConnection("optimizations");
@@ -1162,6 +1256,261 @@ private void testUseCoveringIndex() throws SQLException {
         conn.close();
     }
 
+    private void testHashJoin() throws SQLException {
+        deleteDb("optimizationsHashJoin");
+        Connection conn = getConnection("optimizationsHashJoin;OPTIMIZE_HASH_JOIN=TRUE");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE A(ID INT PRIMARY KEY, X INT)");
+        stat.execute("CREATE TABLE B(ID INT PRIMARY KEY, Y INT, NAME VARCHAR)");
+        stat.execute("INSERT INTO A SELECT X, MOD(X, 100) FROM SYSTEM_RANGE(1, 1000)");
+        stat.execute("INSERT INTO B SELECT X, X, 'b' || X FROM SYSTEM_RANGE(1, 200)");
+        stat.execute("INSERT INTO B VALUES (201, NULL, 'null')");
+        ResultSet rs = stat.executeQuery("EXPLAIN SELECT COUNT(*) FROM A LEFT JOIN B ON A.X = B.Y");
+        rs.next();
+        assertContains(rs.getString(1), "/* PUBLIC.B.tableScan, hash join: Y = A.X */");
+        rs = stat.executeQuery("EXPLAIN SELECT COUNT(*) FROM A INNER JOIN B ON A.X = B.Y");
+        rs.next();
+        assertContains(rs.getString(1), "hash join: ");
+        rs = stat.executeQuery("SELECT COUNT(*), SUM(B.ID) FROM A INNER JOIN B ON A.X = B.Y");
+        rs.next();
+        assertEquals(990, rs.getInt(1));
+        assertEquals(49_500, rs.getInt(2));
+        rs = stat.executeQuery("SELECT COUNT(*), COUNT(B.ID) FROM A LEFT JOIN B ON A.X = B.Y AND B.ID < 50");
+        rs.next();
+        assertEquals(1000, rs.getInt(1));
+        assertEquals(490, rs.getInt(2));
+        // a table that doesn't fit into memory is written to a temporary map
+        stat.execute("SET MAX_MEMORY_ROWS 10");
+        rs = stat.executeQuery("SELECT COUNT(*), SUM(B.ID) FROM B INNER JOIN A ON B.Y = A.X");
+        rs.next();
+        assertEquals(990, rs.getInt(1));
+        assertEquals(49_500, rs.getInt(2));
+        rs = stat.executeQuery("SELECT COUNT(*), COUNT(B.ID), MAX(B.NAME) FROM A LEFT JOIN B ON A.X = B.Y");
+        rs.next();
+        assertEquals(1000, rs.getInt(1));
+        assertEquals(990, rs.getInt(2));
+        assertEquals("b99", rs.getString(3));
+        stat.execute("SET MAX_MEMORY_ROWS 10000");
+        // an index is preferred
+        stat.execute("CREATE INDEX B_Y ON B(Y)");
+        rs = stat.executeQuery("EXPLAIN SELECT COUNT(*) FROM A LEFT JOIN B ON A.X = B.Y");
+        rs.next();
+        assertContains(rs.getString(1), "/* PUBLIC.B_Y: Y = A.X */");
+        // the hash table is built from the scan index, not from the index
+        // with the remaining conditions
+        stat.execute("CREATE TABLE C(ID INT PRIMARY KEY, Y INT, K INT)");
+        stat.execute("INSERT INTO C SELECT X, X, MOD(X, 2) FROM SYSTEM_RANGE(1, 200)");
+        stat.execute("CREATE INDEX C_K ON C(K)");
+        stat.execute("ANALYZE");
+        String sql = "SELECT COUNT(*), COUNT(C.ID), SUM(C.ID) FROM A LEFT JOIN C ON A.X = C.Y AND C.K = MOD(A.ID, 2)";
+        rs = stat.executeQuery("EXPLAIN " + sql);
+        rs.next();
+        assertContains(rs.getString(1), "/* PUBLIC.C.tableScan, hash join: Y = A.X */");
+        for (int maxMemoryRows : new int[] { 10, 10_000 }) {
+            stat.execute("SET MAX_MEMORY_ROWS " + maxMemoryRows);
+            rs = stat.executeQuery(sql);
+            rs.next();
+            assertEquals(1000, rs.getInt(1));
+            assertEquals(990, rs.getInt(2));
+            assertEquals(49_500, rs.getInt(3));
+        }
+        conn.close();
+        deleteDb("optimizationsHashJoin");
+    }
+
+    private void testParallelAggregation() throws SQLException {
+        deleteDb("optimizations");
+        Connection conn = getConnection("optimizations");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID BIGINT PRIMARY KEY, G INT, V INT, D DOUBLE)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X, 7), CASEWHEN(MOD(X, 11) = 0, NULL, X), X / 3.0 "
+                + "FROM SYSTEM_RANGE(1, 100000)");
+        String[] queries = {
+                "SELECT COUNT(*), COUNT(V), SUM(V), MIN(V), MAX(V), AVG(V) FROM TEST",
+                "SELECT G, COUNT(*), SUM(V), MIN(D), MAX(D), BIT_XOR_AGG(V), EVERY(V > 10) "
+                        + "FROM TEST GROUP BY G ORDER BY G",
+                // partial results of floating point aggregates are merged
+                // with a different rounding error
+                "SELECT G + 1, ROUND(STDDEV_POP(D), 6), ROUND(VAR_SAMP(V), 3), ROUND(COVAR_SAMP(D, V), 3), "
+                        + "ROUND(CORR(D, V), 9), ROUND(REGR_SLOPE(V, D), 9) FROM TEST GROUP BY G ORDER BY G",
+                "SELECT G, SUM(V) / COUNT(*) FROM TEST GROUP BY G HAVING G > 2 AND SUM(V) > 0 ORDER BY 2 DESC",
+                "SELECT COUNT(*) FROM TEST WHERE G = 1",
+                "SELECT COUNT(*), SUM(V) FROM TEST WHERE ID < 0" };
+        String[] expected = new String[queries.length];
+        for (int i = 0; i < queries.length; i++) {
+            expected[i] = getResult(stat, queries[i]);
+        }
+        stat.execute("SET PARALLELISM 4");
+        for (int i = 0; i < queries.length; i++) {
+            assertEquals(queries[i], expected[i], getResult(stat, queries[i]));
+        }
+        conn.close();
+        // partitions without a free worker thread are read by the session
+        conn = getConnection("optimizations;MAX_PARALLEL_THREADS=1;PARALLELISM=4");
+        stat = conn.createStatement();
+        for (int i = 0; i < queries.length; i++) {
+            assertEquals(queries[i], expected[i], getResult(stat, queries[i]));
+        }
+        stat.execute("DELETE FROM TEST");
+        assertEquals("0 null\n", getResult(stat, "SELECT COUNT(*), SUM(V) FROM TEST"));
+        assertEquals("", getResult(stat, "SELECT G, COUNT(*) FROM TEST GROUP BY G"));
+        assertThrows(ErrorCode.INVALID_VALUE_2, stat).execute("SET PARALLELISM 0");
+        conn.close();
+        deleteDb("optimizations");
+    }
+
+    private void testBatchEvaluation() throws SQLException {
+        String[] queries = {
+                "SELECT ID, A, B FROM TEST WHERE A > 10 AND B < 2000 ORDER BY ID",
+                "SELECT ID, A + B, A * 2 - B, F FROM TEST WHERE A IS NOT DISTINCT FROM B OR F ORDER BY ID",
+                "SELECT ID, NAME FROM TEST WHERE A = 1 OR B IS NULL AND F ORDER BY ID",
+                "SELECT ID FROM TEST WHERE NOT (A <> 5) OR (A < B) = F AND ID > 2990 ORDER BY ID",
+                // division is evaluated only for rows with non-zero A
+                "SELECT ID, 100 / A FROM TEST WHERE A <> 0 AND 100 / A > 5 ORDER BY ID",
+                "SELECT ID FROM TEST WHERE A = 1 AND B = 2 AND F AND ID > 0 "
+                        + "OR A = 2 OR B = 3 OR F IS NULL ORDER BY ID",
+                "SELECT COUNT(*), COUNT(B), SUM(A), SUM(B), MIN(B), MAX(A), MIN(F) FROM TEST",
+                "SELECT COUNT(*), SUM(A + B), MAX(A * B) FROM TEST WHERE A > 50 AND B IS NOT NULL",
+                "SELECT SUM(L), MIN(L), MAX(L) FROM TEST WHERE ID <= 3",
+                "SELECT COUNT(*), SUM(A) FROM TEST WHERE ID < 0",
+                "SELECT ID FROM TEST WHERE A > 1000",
+                // the index covers these queries
+                "SELECT G, A FROM TEST WHERE G > 30 AND A < 50 ORDER BY G, A",
+                "SELECT COUNT(*), SUM(A), MAX(G) FROM TEST WHERE G BETWEEN 10 AND 20 AND A > 5" };
+        String[] expected = getBatchEvaluationResults("optimizations;OPTIMIZE_BATCH_EVALUATION=FALSE", queries);
+        String[] actual = getBatchEvaluationResults("optimizations", queries);
+        for (int i = 0; i < queries.length; i++) {
+            assertEquals(queries[i], expected[i], actual[i]);
+        }
+        deleteDb("optimizations");
+        Connection conn = getConnection("optimizations");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, A INT, L BIGINT)");
+        stat.execute("INSERT INTO TEST VALUES (1, 0, 0), (2, 2147483647, 9223372036854775807)");
+        assertThrows(ErrorCode.DIVISION_BY_ZERO_1, stat).executeQuery("SELECT ID FROM TEST WHERE 1 / A > 0");
+        assertThrows(ErrorCode.NUMERIC_VALUE_OUT_OF_RANGE_1, stat).executeQuery("SELECT A + 1 FROM TEST WHERE ID > 0");
+        assertThrows(ErrorCode.NUMERIC_VALUE_OUT_OF_RANGE_1, stat)
+                .executeQuery("SELECT ID FROM TEST WHERE L * 2 > 0");
+        assertEquals("9223372036854775807\n", getResult(stat, "SELECT SUM(L) FROM TEST"));
+        conn.close();
+        deleteDb("optimizations");
+    }
+
+    private String[] getBatchEvaluationResults(String url, String[] queries) throws SQLException {
+        deleteDb("optimizations");
+        Connection conn = getConnection(url);
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, A INT, B SMALLINT, F BOOLEAN, L BIGINT, NAME VARCHAR, "
+                + "G INT)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X, 100), CASEWHEN(MOD(X, 7) = 0, NULL, X), "
+                + "CASEWHEN(MOD(X, 5) = 0, NULL, MOD(X, 3) = 0), 4611686018427387904, 'N' || X, MOD(X, 37) "
+                + "FROM SYSTEM_RANGE(1, 3000)");
+        stat.execute("CREATE INDEX TEST_G_A ON TEST(G, A)");
+        String[] results = new String[queries.length];
+        for (int i = 0; i < queries.length; i++) {
+            results[i] = getResult(stat, queries[i]);
+        }
+        conn.close();
+        return results;
+    }
+
+    private void testExternalSort() throws SQLException {
+        deleteDb("optimizations");
+        Connection conn = getConnection("optimizations");
+        Statement stat = conn.createStatement();
+        stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, G INT, V VARCHAR)");
+        stat.execute("INSERT INTO TEST SELECT X, MOD(X * 7919, 1000), 'v' || MOD(X * 104729, 20011) "
+                + "FROM SYSTEM_RANGE(1, 20000)");
+        String[] queries = {
+                "SELECT ID, G FROM TEST ORDER BY G, ID DESC",
+                "SELECT V, ID FROM TEST ORDER BY V DESC NULLS LAST, ID",
+                "SELECT G, COUNT(*) FROM TEST GROUP BY G ORDER BY 2 DESC, G",
+                "SELECT ID FROM TEST ORDER BY V, ID FETCH FIRST 10 ROWS ONLY",
+                "SELECT ID, G FROM TEST ORDER BY G DESC, ID OFFSET 100 ROWS FETCH NEXT 7 ROWS ONLY",
+                "SELECT ID FROM TEST ORDER BY V, ID OFFSET 19990 ROWS FETCH NEXT 20 ROWS ONLY" };
+        String[] expected = new String[queries.length];
+        for (int i = 0; i < queries.length; i++) {
+            expected[i] = getResult(stat, queries[i]);
+        }
+        // sorted runs are written to disk and merged, large batches of rows
+        // are sorted by multiple threads
+        for (int maxMemoryRows : new int[] { 500, 10_000 }) {
+            stat.execute("SET MAX_MEMORY_ROWS " + maxMemoryRows);
+            for (int parallelism : new int[] { 1, 4 }) {
+                stat.execute("SET PARALLELISM " + parallelism);
+                for (int i = 0; i < queries.length; i++) {
+                    assertEquals(queries[i], expected[i], getResult(stat, queries[i]));
+                }
+            }
+        }
+        stat.execute("SET PARALLELISM 1");
+        // more runs than can be merged at once
+        stat.execute("SET MAX_MEMORY_ROWS 50");
+        assertEquals(queries[1], expected[1], getResult(stat, queries[1]));
+        conn.close();
+        deleteDb("optimizations");
+    }
+
+    private void testQueryMemory() throws SQLException {
+        String[] queries = {
+                "SELECT ID, V FROM TEST ORDER BY V DESC, ID",
+                "SELECT DISTINCT V FROM TEST ORDER BY V",
+                "SELECT ID FROM TEST ORDER BY V, ID OFFSET 10 ROWS FETCH FIRST 100 ROWS ONLY",
+                "SELECT V, COUNT(*) FROM TEST GROUP BY V ORDER BY 2 DESC, 1" };
+        String[] expected = null;
+        // results are written to disk when the size of rows in memory exceeds
+        // the limit of a result or the pool of the database
+        for (String settings : new String[] { "", ";MAX_QUERY_MEMORY=16", ";QUERY_MEMORY_POOL=16" }) {
+            deleteDb("optimizationsMemory");
+            Connection conn = getConnection("optimizationsMemory" + settings);
+            Statement stat = conn.createStatement();
+            stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, V VARCHAR)");
+            stat.execute("INSERT INTO TEST SELECT X, SPACE(100) || MOD(X, 500) FROM SYSTEM_RANGE(1, 2000)");
+            String[] results = new String[queries.length];
+            for (int i = 0; i < queries.length; i++) {
+                results[i] = getResult(stat, queries[i]);
+            }
+            if (expected == null) {
+                expected = results;
+            } else {
+                for (int i = 0; i < queries.length; i++) {
+                    assertEquals(queries[i], expected[i], results[i]);
+                }
+            }
+            SessionLocal session = (SessionLocal) ((JdbcConnection) conn).getSession();
+            // rows kept in memory stay reserved after the end of the statement
+            Statement stat2 = conn.createStatement();
+            ResultSet rs = stat2.executeQuery("SELECT ID FROM TEST WHERE ID <= 10 ORDER BY ID DESC");
+            stat.execute("SELECT 1");
+            long reserved = session.getQueryMemory();
+            assertEquals(settings.isEmpty(), reserved == 0L);
+            assertEquals(reserved, session.getDatabase().getQueryMemory());
+            rs.close();
+            stat.close();
+            assertEquals(0L, session.getQueryMemory());
+            assertEquals(0L, session.getDatabase().getQueryMemory());
+            stat2.close();
+            conn.close();
+        }
+        deleteDb("optimizationsMemory");
+    }
+
+    private static String getResult(Statement stat, String sql) throws SQLException {
+        ResultSet rs = stat.executeQuery(sql);
+        int columnCount = rs.getMetaData().getColumnCount();
+        StringBuilder builder = new StringBuilder();
+        while (rs.next()) {
+            for (int i = 1; i <= columnCount; i++) {
+                if (i > 1) {
+                    builder.append(' ');
+                }
+                builder.append(rs.getString(i));
+            }
+            builder.append('\n');
+        }
+        return builder.toString();
+    }
+
     private void testConditionAndOrDistributiveLaw() throws SQLException {
         deleteDb("optimizations");
         Connection conn = getConnection("optimizations");
@@ -34,6 +34,10 @@ public void test() throws Exception {
         test1();
         testClearingCacheWithTableStructureChanges();
         deleteDb("queryCache");
+        testSharedQueryCache();
+        deleteDb("queryCache");
+        testSharedQueryCacheTimeZone();
+        deleteDb("queryCache");
     }
 
     private void test1() throws Exception {
@@ -107,4 +111,86 @@ private void testClearingCacheWithTableStructureChanges() throws Exception {
                     prepareStatement("SELECT * FROM TEST");
         }
     }
+
+    private void testSharedQueryCache() throws Exception {
+        String url = "queryCache;QUERY_CACHE_SIZE=1;SHARED_QUERY_CACHE_SIZE=10";
+        try (Connection conn = getConnection(url); Connection conn2 = getConnection(url)) {
+            Statement stat = conn.createStatement();
+            stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, NAME VARCHAR)");
+            stat.execute("INSERT INTO TEST VALUES (1, 'Hello'), (2, 'World')");
+            conn.setAutoCommit(false);
+            stat.execute("INSERT INTO TEST VALUES (3, 'Uncommitted')");
+            String sql = "SELECT COUNT(*) FROM TEST WHERE ID > ?";
+            PreparedStatement prep = conn.prepareStatement(sql);
+            prep.setInt(1, 0);
+            ResultSet rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(3, rs.getInt(1));
+            prep.close();
+            // evicts the query from the cache of the session
+            conn.prepareStatement("SELECT NAME FROM TEST").close();
+            // the query is taken from the shared cache, the cached result of
+            // the first session is not used
+            prep = conn2.prepareStatement(sql);
+            prep.setInt(1, 0);
+            rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(2, rs.getInt(1));
+            prep.close();
+            conn.commit();
+            rs = conn2.createStatement().executeQuery("SELECT SETTING_VALUE FROM INFORMATION_SCHEMA.SETTINGS "
+                    + "WHERE SETTING_NAME = 'info.SHARED_QUERY_CACHE_HITS'");
+            assertTrue(rs.next());
+            assertEquals(1, rs.getInt(1));
+            // the shared cache is cleared when the schema is changed
+            stat.execute("ALTER TABLE TEST ADD COLUMN DATA INT DEFAULT 10");
+            prep = conn.prepareStatement(sql.replace("COUNT(*)", "SUM(DATA)"));
+            prep.setInt(1, 1);
+            rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(20, rs.getInt(1));
+            prep.close();
+            prep = conn2.prepareStatement(sql);
+            prep.setInt(1, 2);
+            rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(1, rs.getInt(1));
+        }
+    }
+
+    private void testSharedQueryCacheTimeZone() throws Exception {
+        String url = "queryCache;QUERY_CACHE_SIZE=1;SHARED_QUERY_CACHE_SIZE=10";
+        try (Connection conn = getConnection(url); Connection conn2 = getConnection(url)) {
+            Statement stat = conn.createStatement();
+            stat.execute("CREATE TABLE TEST(ID INT PRIMARY KEY, T TIMESTAMP WITH TIME ZONE)");
+            stat.execute("INSERT INTO TEST VALUES (1, TIMESTAMP WITH TIME ZONE '2020-01-01 10:00:00+00'), "
+                    + "(2, TIMESTAMP WITH TIME ZONE '2020-01-01 14:00:00+00')");
+            stat.execute("SET TIME ZONE 'UTC'");
+            conn2.createStatement().execute("SET TIME ZONE '+05:00'");
+            // the constant is converted with the time zone of the session
+            String sql = "SELECT COUNT(*) FROM TEST WHERE T > TIMESTAMP '2020-01-01 12:00:00'";
+            PreparedStatement prep = conn.prepareStatement(sql);
+            ResultSet rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(1, rs.getInt(1));
+            prep.close();
+            // evicts the query from the cache of the session
+            conn.prepareStatement("SELECT ID FROM TEST").close();
+            // the query of the first session is not used by a session with
+            // another time zone
+            prep = conn2.prepareStatement(sql);
+            rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(2, rs.getInt(1));
+            prep.close();
+            // the cache of the session is cleared when its time zone is changed
+            prep = conn.prepareStatement(sql);
+            prep.close();
+            stat.execute("SET TIME ZONE '+05:00'");
+            prep = conn.prepareStatement(sql);
+            rs = prep.executeQuery();
+            assertTrue(rs.next());
+            assertEquals(2, rs.getInt(1));
+        }
+    }
 }
@@ -13,6 +13,7 @@
 import java.sql.ResultSet;
 import java.sql.SQLException;
 import java.sql.Statement;
+import java.util.Arrays;
 
 import org.h2.api.ErrorCode;
 import org.h2.test.TestBase;
@@ -65,6 +66,7 @@ public void test() throws SQLException {
         testRootCause();
         testExecuteCall();
         testException();
+        testPartialFailure();
         testCoffee();
         deleteDb("batchUpdates");
     }
@@ -157,6 +159,47 @@ private void testException() throws SQLException {
         conn.close();
     }
 
+    private void testPartialFailure() throws SQLException {
+        deleteDb("batchUpdates");
+        conn = getConnection("batchUpdates");
+        stat = conn.createStatement();
+        stat.execute("create table test(id int primary key, v int)");
+        prep = conn.prepareStatement("insert into test values(?, ?)");
+        int[] ids = { 1, 2, 1, 3, 2, 4 };
+        for (int id : ids) {
+            prep.setInt(1, id);
+            prep.setInt(2, id * 10);
+            prep.addBatch();
+        }
+        try {
+            prep.executeBatch();
+            fail();
+        } catch (BatchUpdateException e) {
+            assertEquals(Arrays.toString(
+                    new int[] { 1, 1, Statement.EXECUTE_FAILED, 1, Statement.EXECUTE_FAILED, 1 }),
+                    Arrays.toString(e.getUpdateCounts()));
+            SQLException next = e.getNextException();
+            assertEquals(ErrorCode.DUPLICATE_KEY_1, next.getErrorCode());
+            next = next.getNextException();
+            assertEquals(ErrorCode.DUPLICATE_KEY_1, next.getErrorCode());
+            assertNull(next.getNextException());
+        }
+        prep = conn.prepareStatement("update test set v = v + ? where id = ?");
+        prep.setInt(1, 1);
+        prep.setInt(2, 1);
+        prep.addBatch();
+        prep.setInt(1, 2);
+        prep.setInt(2, 5);
+        prep.addBatch();
+        assertEquals("[1, 0]", Arrays.toString(prep.executeLargeBatch()));
+        ResultSet rs = stat.executeQuery("select sum(v), count(*) from test");
+        rs.next();
+        assertEquals(101, rs.getInt(1));
+        assertEquals(4, rs.getInt(2));
+        stat.execute("drop table test");
+        conn.close();
+    }
+
     private void testCoffee() throws SQLException {
         deleteDb("batchUpdates");
         conn = getConnection("batchUpdates");
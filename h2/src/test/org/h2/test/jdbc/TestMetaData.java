@@ -63,6 +63,7 @@ public void test() throws SQLException {
         testClientInfo();
         testQueryStatistics();
         testQueryStatisticsLimit();
+        testSlowQueries();
     }
 
     private void testUnwrap() throws SQLException {
@@ -1195,8 +1196,8 @@ private void testGeneral() throws SQLException {
         rs = meta.getTables(null, "INFORMATION_SCHEMA", null, new String[] { "BASE TABLE", "VIEW" });
         for (String name : new String[] { "CONSTANTS", "ENUM_VALUES",
                 "INDEXES", "INDEX_COLUMNS", "INFORMATION_SCHEMA_CATALOG_NAME", "IN_DOUBT", "LOCKS",
-                "QUERY_STATISTICS", "RIGHTS", "ROLES", "SESSIONS", "SESSION_STATE", "SETTINGS", "SYNONYMS",
-                "USERS", "CHECK_CONSTRAINTS", "COLLATIONS", "COLUMNS", "COLUMN_PRIVILEGES",
+                "QUERY_STATISTICS", "RIGHTS", "ROLES", "SESSIONS", "SESSION_STATE", "SETTINGS", "SLOW_QUERIES",
+                "SYNONYMS", "USERS", "CHECK_CONSTRAINTS", "COLLATIONS", "COLUMNS", "COLUMN_PRIVILEGES",
                 "CONSTRAINT_COLUMN_USAGE", "DOMAINS", "DOMAIN_CONSTRAINTS", "ELEMENT_TYPES", "FIELDS",
                 "KEY_COLUMN_USAGE", "PARAMETERS",
                 "REFERENTIAL_CONSTRAINTS", "ROUTINES", "SCHEMATA", "SEQUENCES", "TABLES", "TABLE_CONSTRAINTS",
@@ -1365,6 +1366,32 @@ private void testQueryStatistics() throws SQLException {
         deleteDb("metaData");
     }
 
+    private void testSlowQueries() throws SQLException {
+        deleteDb("metaData");
+        Connection conn = getConnection("metaData;SLOW_QUERY_TIME=0");
+        Statement stat = conn.createStatement();
+        stat.execute("create table test(id int primary key, name varchar) as " +
+                "select x, space(10) from system_range(1, 100)");
+        stat.execute("SET QUERY_STATISTICS TRUE");
+        execute(stat, "select count(*) from test where id > 10");
+        ResultSet rs = stat.executeQuery("select * from INFORMATION_SCHEMA.SLOW_QUERIES " +
+                "where SQL_STATEMENT = 'select count(*) from test where id > 10'");
+        assertTrue(rs.next());
+        assertEquals(1L, rs.getLong("ROW_COUNT"));
+        assertTrue(rs.getDouble("EXECUTION_TIME") >= 0d);
+        String plan = rs.getString("PLAN");
+        assertContains(plan, "rows: 90 */");
+        assertContains(plan, "/* group: rows: 1, time: ");
+        assertFalse(rs.next());
+        rs.close();
+        stat.execute("SET QUERY_STATISTICS FALSE");
+        rs = stat.executeQuery("select * from INFORMATION_SCHEMA.SLOW_QUERIES");
+        assertFalse(rs.next());
+        rs.close();
+        conn.close();
+        deleteDb("metaData");
+    }
+
     private void testQueryStatisticsLimit() throws SQLException {
         Connection conn = getConnection("metaData");
         Statement stat = conn.createStatement();
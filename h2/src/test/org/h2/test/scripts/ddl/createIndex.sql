@@ -21,7 +21,10 @@ DROP TABLE TEST;
 CREATE TABLE TEST(A INT, B INT, C INT);
 > ok
 
-CREATE INDEX TEST_IDX ON TEST(C) INCLUDE(B);
+CREATE HASH INDEX TEST_IDX ON TEST(C) INCLUDE(B);
+> exception SYNTAX_ERROR_1
+
+CREATE MINMAX INDEX TEST_IDX ON TEST(C) INCLUDE(B);
 > exception SYNTAX_ERROR_1
 
 CREATE UNIQUE INDEX TEST_IDX ON TEST(C) INCLUDE(B);
@@ -30,5 +33,175 @@ CREATE UNIQUE INDEX TEST_IDX ON TEST(C) INCLUDE(B);
 DROP INDEX TEST_IDX;
 > ok
 
+INSERT INTO TEST SELECT X, X * 2, MOD(X, 10) FROM SYSTEM_RANGE(1, 100);
+> update count: 100
+
+CREATE INDEX TEST_IDX ON TEST(C) INCLUDE(B);
+> ok
+
+SELECT SQL FROM INFORMATION_SCHEMA.INDEXES WHERE INDEX_NAME = 'TEST_IDX';
+>> CREATE INDEX "PUBLIC"."TEST_IDX" ON "PUBLIC"."TEST"("C" NULLS FIRST) INCLUDE("B" NULLS FIRST)
+
+SELECT COLUMN_NAME, ORDINAL_POSITION, IS_UNIQUE FROM INFORMATION_SCHEMA.INDEX_COLUMNS
+    WHERE INDEX_NAME = 'TEST_IDX' ORDER BY ORDINAL_POSITION;
+> COLUMN_NAME ORDINAL_POSITION IS_UNIQUE
+> ----------- ---------------- ---------
+> C           1                FALSE
+> B           2                FALSE
+> rows (ordered): 2
+
+EXPLAIN SELECT SUM(B) FROM TEST WHERE C = 3;
+>> SELECT SUM("B") FROM "PUBLIC"."TEST" /* PUBLIC.TEST_IDX: C = 3 */ WHERE "C" = 3
+
+SELECT SUM(B) FROM TEST WHERE C = 3;
+>> 960
+
+INSERT INTO TEST VALUES (101, 202, 3);
+> update count: 1
+
+SELECT SUM(B) FROM TEST WHERE C = 3;
+>> 1162
+
+DROP INDEX TEST_IDX;
+> ok
+
+DROP TABLE TEST;
+> ok
+
+CREATE TABLE TEST(ID BIGINT PRIMARY KEY, T INT, V INT) AS SELECT X, X / 10, MOD(X, 7) FROM SYSTEM_RANGE(1, 10000);
+> ok
+
+CREATE UNIQUE MINMAX INDEX TEST_IDX ON TEST(T);
+> exception SYNTAX_ERROR_2
+
+CREATE MINMAX INDEX TEST_IDX ON TEST(T);
+> ok
+
+SELECT INDEX_TYPE_NAME FROM INFORMATION_SCHEMA.INDEXES WHERE INDEX_NAME = 'TEST_IDX';
+>> MINMAX INDEX
+
+EXPLAIN SELECT ID FROM TEST WHERE T = 500;
+>> SELECT "ID" FROM "PUBLIC"."TEST" /* PUBLIC.TEST_IDX: T = 500 */ WHERE "T" = 500
+
+SELECT COUNT(*), MIN(ID), MAX(ID) FROM TEST WHERE T BETWEEN 500 AND 502;
+> COUNT(*) MIN(ID) MAX(ID)
+> -------- ------- -------
+> 30       5000    5029
+> rows: 1
+
+UPDATE TEST SET T = 100000 WHERE ID = 1;
+> update count: 1
+
+INSERT INTO TEST VALUES (20000, NULL, 0);
+> update count: 1
+
+SELECT ID FROM TEST WHERE T = 100000;
+>> 1
+
+SELECT ID FROM TEST WHERE T IS NULL;
+>> 20000
+
+SELECT ID FROM TEST WHERE T < 1 ORDER BY ID;
+> ID
+> --
+> 2
+> 3
+> 4
+> 5
+> 6
+> 7
+> 8
+> 9
+> rows (ordered): 8
+
+SELECT COUNT(*) FROM TEST WHERE T IN (500, 501);
+>> 20
+
+SELECT COUNT(*) FROM TEST USE INDEX (TEST_IDX) WHERE T IN (500, 501);
+>> 20
+
+DROP TABLE TEST;
+> ok
+
+CREATE TABLE TEST(ID INT PRIMARY KEY, A VARCHAR(100), B VARCHAR(100), C INT, D NUMERIC(10, 2));
+> ok
+
+INSERT INTO TEST SELECT X, 'first name ' || MOD(X, 10), 'last name ' || X, MOD(X, 7), X FROM SYSTEM_RANGE(1, 100);
+> update count: 100
+
+CREATE UNIQUE HASH INDEX TEST_IDX_AB ON TEST(A, B);
+> ok
+
+CREATE HASH INDEX TEST_IDX_C ON TEST(C);
+> ok
+
+CREATE HASH INDEX TEST_IDX_D ON TEST(D);
+> ok
+
+EXPLAIN SELECT ID FROM TEST WHERE A = 'first name 3' AND B = 'last name 23';
+>> SELECT "ID" FROM "PUBLIC"."TEST" /* PUBLIC.TEST_IDX_AB: A = 'first name 3' AND B = 'last name 23' */ WHERE ("A" = 'first name 3') AND ("B" = 'last name 23')
+
+SELECT ID FROM TEST WHERE A = 'first name 3' AND B = 'last name 23';
+>> 23
+
+SELECT ID FROM TEST WHERE A = 'first name 3' AND B = 'last name 24';
+> ID
+> --
+> rows: 0
+
+EXPLAIN SELECT ID FROM TEST WHERE A = 'first name 3';
+>> SELECT "ID" FROM "PUBLIC"."TEST" /* PUBLIC.TEST.tableScan */ WHERE "A" = 'first name 3'
+
+INSERT INTO TEST VALUES (101, 'first name 3', 'last name 23', 0, 101);
+> exception DUPLICATE_KEY_1
+
+INSERT INTO TEST VALUES (101, 'first name 3', NULL, 0, 101), (102, 'first name 3', NULL, 0, 102);
+> update count: 2
+
+SELECT ID FROM TEST WHERE A = 'first name 3' AND B IS NULL ORDER BY ID;
+> ID
+> ---
+> 101
+> 102
+> rows (ordered): 2
+
+UPDATE TEST SET B = 'updated' WHERE ID = 23;
+> update count: 1
+
+SELECT ID FROM TEST WHERE A = 'first name 3' AND B = 'updated';
+>> 23
+
+SELECT COUNT(*) FROM TEST WHERE A = 'first name 3' AND B = 'last name 23';
+>> 0
+
+EXPLAIN SELECT ID FROM TEST WHERE C IN (1, 2);
+>> SELECT "ID" FROM "PUBLIC"."TEST" /* PUBLIC.TEST_IDX_C: C IN(1, 2) */ WHERE "C" IN(1, 2)
+
+SELECT COUNT(*) FROM TEST WHERE C IN (1, 2);
+>> 30
+
+SELECT COUNT(*) FROM TEST WHERE C = 10000000000;
+>> 0
+
+SELECT COUNT(*) FROM TEST WHERE C > 5;
+>> 14
+
+SELECT INDEX_NAME, INDEX_TYPE_NAME FROM INFORMATION_SCHEMA.INDEXES WHERE TABLE_NAME = 'TEST' AND INDEX_NAME LIKE 'TEST_IDX_%';
+> INDEX_NAME  INDEX_TYPE_NAME
+> ----------- -----------------
+> TEST_IDX_AB UNIQUE HASH INDEX
+> TEST_IDX_C  HASH INDEX
+> TEST_IDX_D  HASH INDEX
+> rows: 3
+
+DELETE FROM TEST WHERE C = 0;
+> update count: 16
+
+SELECT COUNT(*) FROM TEST WHERE C = 0;
+>> 0
+
+SELECT ID FROM TEST WHERE D = 50;
+>> 50
+
 DROP TABLE TEST;
 > ok
@@ -28,12 +28,14 @@ public static void main(String... a) throws Exception {
 
     @Override
     public void test() throws Exception {
-        testConcurrent();
+        testConcurrent(0);
+        testConcurrent(16);
     }
 
-    private void testConcurrent() {
+    private void testConcurrent(int readBufferSize) {
         CacheLongKeyLIRS.Config cc = new CacheLongKeyLIRS.Config();
         cc.maxMemory = 100;
+        cc.readBufferSize = readBufferSize;
         final CacheLongKeyLIRS<Integer> test = new CacheLongKeyLIRS<>(cc);
         int threadCount = 8;
         final CountDownLatch wait = new CountDownLatch(1);
@@ -89,6 +91,8 @@ public void call() throws Exception {
             totalCount += x;
         }
         trace("requests: " + totalCount);
+        assertEquals(totalCount, test.getHits() + test.getMisses());
+        assertTrue(test.size() <= 100);
     }
 
 }
@@ -44,6 +44,7 @@ private void testCache() {
         testLimitMemory();
         testScanResistance();
         testRandomOperations();
+        testReadBuffer();
     }
 
     private void testRandomSmallCache() {
@@ -451,6 +452,48 @@ private void testRandomOperations() {
         }
     }
 
+    private void testReadBuffer() {
+        int size = 10;
+        Random r = new Random(1);
+        for (int j = 0; j < 20; j++) {
+            CacheLongKeyLIRS<Integer> expected = createCache(size / 2);
+            CacheLongKeyLIRS<Integer> test = createCache(size / 2, 4);
+            for (int i = 0; i < 1000; i++) {
+                // small values are always reachable, weak references of
+                // non-resident entries are not cleared
+                int key = r.nextInt(size);
+                switch (r.nextInt(4)) {
+                case 0:
+                    expected.put(key, key);
+                    test.put(key, key);
+                    break;
+                case 1:
+                    expected.remove(key);
+                    test.remove(key);
+                    break;
+                default:
+                    assertEquals(expected.get(key), test.get(key));
+                }
+                // apply the recorded accesses before the memory is checked,
+                // they are applied in the same order in a single thread
+                test.keys(false, false);
+                assertEquals(toString(expected), toString(test));
+            }
+            assertEquals(expected.getHits(), test.getHits());
+            assertEquals(expected.getMisses(), test.getMisses());
+            assertEquals(expected.getEvictions(), test.getEvictions());
+            verify(test, null);
+        }
+        CacheLongKeyLIRS<Integer> test = createCache(4, 4);
+        for (int i = 0; i < 8; i++) {
+            test.put(i, i);
+        }
+        assertEquals(4, test.getEvictions());
+        assertNull(test.get(100));
+        assertEquals(0, test.getHits());
+        assertEquals(1, test.getMisses());
+    }
+
     private static <V> String toString(CacheLongKeyLIRS<V> cache) {
         StringBuilder buff = new StringBuilder();
         buff.append("mem: " + cache.getUsedMemory());
@@ -495,10 +538,15 @@ private <V> void verify(CacheLongKeyLIRS<V> cache, String expected) {
     }
 
     private static <V> CacheLongKeyLIRS<V> createCache(int maxSize) {
+        return createCache(maxSize, 0);
+    }
+
+    private static <V> CacheLongKeyLIRS<V> createCache(int maxSize, int readBufferSize) {
         CacheLongKeyLIRS.Config cc = new CacheLongKeyLIRS.Config();
         cc.maxMemory = maxSize;
         cc.segmentCount = 1;
         cc.stackMoveDistance = 0;
+        cc.readBufferSize = readBufferSize;
         return new CacheLongKeyLIRS<>(cc);
     }
 
@@ -8,6 +8,7 @@
 import java.nio.ByteBuffer;
 import java.nio.channels.FileChannel;
 import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.Iterator;
 import java.util.Map;
 import java.util.Map.Entry;
@@ -17,6 +18,8 @@
 import java.util.concurrent.TimeUnit;
 import java.util.concurrent.atomic.AtomicInteger;
 import java.util.concurrent.atomic.AtomicReference;
+import org.h2.compress.CompressDeflate;
+import org.h2.mvstore.BulkLoader;
 import org.h2.mvstore.Chunk;
 import org.h2.mvstore.Cursor;
 import org.h2.mvstore.DataUtils;
@@ -25,6 +28,7 @@
 import org.h2.mvstore.MVStore;
 import org.h2.mvstore.MVStoreException;
 import org.h2.mvstore.OffHeapStore;
+import org.h2.mvstore.cache.OffHeapPageCache;
 import org.h2.mvstore.type.DataType;
 import org.h2.mvstore.type.ObjectDataType;
 import org.h2.mvstore.type.StringDataType;
@@ -58,6 +62,13 @@ public void test() throws Exception {
         testEntrySet();
         testCompressEmptyPage();
         testCompressed();
+        testParallelSerialization();
+        testPageCodec();
+        testReadAhead();
+        testChunkCheckpoint();
+        testThrottledCompaction();
+        testOffHeapCache();
+        testBulkLoader();
         testFileFormatExample();
         testMaxChunkLength();
         testCacheInfo();
@@ -260,6 +271,364 @@ private void testCompressed() {
         }
     }
 
+    private void testParallelSerialization() {
+        String fileName = getBaseDir() + "/" + getTestName();
+        for (int level = 0; level <= 2; level++) {
+            FileUtils.delete(fileName);
+            MVStore.Builder builder = new MVStore.Builder().fileName(fileName).serializationThreads(4)
+                    .keysPerPage(8).autoCommitDisabled();
+            if (level == 1) {
+                builder.compress();
+            } else if (level == 2) {
+                builder.compressHigh();
+            }
+            try (MVStore s = builder.open()) {
+                for (int round = 0; round < 3; round++) {
+                    for (int m = 0; m < 3; m++) {
+                        MVMap<Integer, String> map = s.openMap("data" + m);
+                        for (int i = round; i < 5000; i += 2) {
+                            map.put(i, "value " + m + ' ' + i + ' ' + round);
+                        }
+                    }
+                    s.commit();
+                }
+            }
+            try (MVStore s = new MVStore.Builder().fileName(fileName).open()) {
+                for (int m = 0; m < 3; m++) {
+                    MVMap<Integer, String> map = s.openMap("data" + m);
+                    assertEquals(5000, map.size());
+                    for (int i = 0; i < 5000; i++) {
+                        int round = (i & 1) == 0 ? 2 : 1;
+                        assertEquals("value " + m + ' ' + i + ' ' + round, map.get(i));
+                    }
+                }
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private void testReadAhead() {
+        testReadAhead(getBaseDir() + "/" + getTestName());
+        testReadAhead("async:" + getBaseDir() + "/" + getTestName());
+    }
+
+    private void testReadAhead(String fileName) {
+        FileUtils.delete(fileName);
+        try (MVStore s = new MVStore.Builder().fileName(fileName).keysPerPage(8).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            for (int i = 0; i < 10_000; i++) {
+                map.put(i, "value " + i);
+            }
+        }
+        try (MVStore s = new MVStore.Builder().fileName(fileName).readAhead(16).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            int expected = 0;
+            for (Cursor<Integer, String> c = map.cursor(null); c.hasNext(); expected++) {
+                assertEquals(expected, c.next().intValue());
+                assertEquals("value " + expected, c.getValue());
+            }
+            assertEquals(10_000, expected);
+            s.getCache().clear();
+            expected = 9_000;
+            for (Cursor<Integer, String> c = map.cursor(9_000, null, true); c.hasNext(); expected--) {
+                assertEquals(expected, c.next().intValue());
+                assertEquals("value " + expected, c.getValue());
+            }
+            assertEquals(-1, expected);
+            s.getCache().clear();
+            expected = 2_000;
+            for (Cursor<Integer, String> c = map.cursor(2_000, 3_000, false); c.hasNext(); expected++) {
+                assertEquals(expected, c.next().intValue());
+            }
+            assertEquals(3_001, expected);
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private void testChunkCheckpoint() {
+        String fileName = getBaseDir() + "/" + getTestName();
+        FileUtils.delete(fileName);
+        try (MVStore s = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open()) {
+            // each chunk keeps the only page of its map
+            for (int i = 0; i < 300; i++) {
+                s.openMap("data" + i).put(0, "value " + i);
+                s.commit();
+            }
+            assertTrue(s.getChunkCount() >= 256);
+        }
+        long size = FileUtils.size(fileName);
+        MVStore s = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open();
+        Map<String, Long> times = s.getStartupTimes();
+        assertTrue(times.toString(), times.containsKey("header"));
+        assertTrue(times.toString(), times.containsKey("checkpoint"));
+        assertFalse(times.toString(), times.containsKey("layout"));
+        assertFalse(times.toString(), times.containsKey("recovery"));
+        assertTrue(FileUtils.size(fileName) < size);
+        for (int i = 0; i < 300; i++) {
+            assertEquals("value " + i, s.openMap("data" + i).get(0));
+        }
+        s.openMap("data300").put(0, "value 300");
+        s.commit();
+        s.closeImmediately();
+
+        try (MVStore s2 = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open()) {
+            times = s2.getStartupTimes();
+            assertFalse(times.toString(), times.containsKey("checkpoint"));
+            for (int i = 0; i <= 300; i++) {
+                assertEquals("value " + i, s2.openMap("data" + i).get(0));
+            }
+        }
+        FileUtils.delete(fileName);
+
+        // the checkpoint is written when the store becomes idle
+        s = new MVStore.Builder().fileName(fileName).autoCompactFillRate(0).open();
+        for (int i = 0; i < 300; i++) {
+            s.openMap("data" + i).put(0, "value " + i);
+            s.commit();
+        }
+        for (int i = 0; i < 1_000 && !s.getStoreHeader().containsKey("checkpoint"); i++) {
+            sleep(10);
+        }
+        assertTrue(s.getStoreHeader().containsKey("checkpoint"));
+        s.closeImmediately();
+        size = FileUtils.size(fileName);
+        try (MVStore s2 = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open()) {
+            times = s2.getStartupTimes();
+            assertTrue(times.toString(), times.containsKey("recovery"));
+            // the checkpoint was loaded and removed
+            assertTrue(FileUtils.size(fileName) < size);
+            for (int i = 0; i < 300; i++) {
+                assertEquals("value " + i, s2.openMap("data" + i).get(0));
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private void testPageCodec() {
+        String fileName = getBaseDir() + "/" + getTestName();
+        ArrayList<byte[]> samples = new ArrayList<>();
+        for (int i = 0; i < 100; i++) {
+            samples.add(getCodecTestValue(i).getBytes(StandardCharsets.UTF_8));
+        }
+        byte[] dictionary = CompressDeflate.trainDictionary(samples, 4096);
+        assertTrue(dictionary.length > 0 && dictionary.length <= 4096);
+        long uncompressedSize = 0;
+        for (int codec = 0; codec <= 2; codec++) {
+            FileUtils.delete(fileName);
+            MVStore.Builder builder = new MVStore.Builder().fileName(fileName)
+                    .pageCodec(1, CompressDeflate::new)
+                    .pageCodec(2, () -> new CompressDeflate(dictionary));
+            try (MVStore s = builder.open()) {
+                assertThrows(IllegalArgumentException.class,
+                        () -> s.openMap("other", new MVMap.Builder<Integer, String>().pageCodec(3)));
+                MVMap.Builder<Integer, String> mapBuilder = new MVMap.Builder<>();
+                if (codec > 0) {
+                    mapBuilder.pageCodec(codec);
+                }
+                MVMap<Integer, String> map = s.openMap("data", mapBuilder);
+                for (int i = 0; i < 2000; i++) {
+                    map.put(i, getCodecTestValue(i));
+                }
+            }
+            long size = FileUtils.size(fileName);
+            if (codec == 0) {
+                uncompressedSize = size;
+            } else {
+                assertTrue(size < uncompressedSize);
+            }
+            try (MVStore s = builder.open()) {
+                // older versions can't read pages of page codecs
+                Object formatRead = s.getStoreHeader().get("formatRead");
+                if (codec > 0) {
+                    assertEquals("3", formatRead.toString());
+                } else {
+                    assertNull(formatRead);
+                }
+                // the codec is saved in the configuration of the map
+                MVMap<Integer, String> map = s.openMap("data");
+                for (int i = 0; i < 2000; i++) {
+                    assertEquals(getCodecTestValue(i), map.get(i));
+                }
+            }
+            if (codec > 0) {
+                // the codec is required to open the map
+                try (MVStore s = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open()) {
+                    assertThrows(IllegalArgumentException.class, () -> s.openMap("data"));
+                }
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private static String getCodecTestValue(int i) {
+        return "{\"id\": " + i + ", \"name\": \"customer " + i % 37 + "\", \"status\": \""
+                + (i % 3 == 0 ? "active" : "inactive") + "\"}";
+    }
+
+    private void testThrottledCompaction() {
+        String fileName = getBaseDir() + "/" + getTestName();
+        FileUtils.delete(fileName);
+        int bandwidth = 16;
+        try (MVStore s = new MVStore.Builder().fileName(fileName).keysPerPage(16).
+                autoCompactBandwidth(bandwidth).open()) {
+            s.setRetentionTime(0);
+            s.setVersionsToKeep(0);
+            MVMap<Integer, String> map = s.openMap("data");
+            for (int i = 0; i < 20_000; i++) {
+                map.put(i, "value " + i);
+                if (i % 1_000 == 999) {
+                    s.commit();
+                }
+            }
+            for (int i = 0; i < 20_000; i++) {
+                if (i / 100 % 4 != 0) {
+                    map.put(i, "new value " + i);
+                }
+            }
+            s.commit();
+            assertTrue(s.getCompactPendingBytes() > 0);
+            long start = System.nanoTime();
+            for (int i = 0; i < 1_000 && s.getCompactRewrittenPageCount() == 0; i++) {
+                sleep(10);
+            }
+            long elapsed = (System.nanoTime() - start) / 1_000_000;
+            assertTrue(s.getCompactRewrittenPageCount() > 0);
+            long rewrittenBytes = s.getCompactRewrittenBytes();
+            // the allowance may be accumulated for one second, the last
+            // page may exceed it
+            long limit = bandwidth * 1024L * (elapsed / 1_000 + 2);
+            assertTrue(rewrittenBytes + " > " + limit, rewrittenBytes <= limit);
+        }
+        try (MVStore s = new MVStore.Builder().fileName(fileName).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            for (int i = 0; i < 20_000; i++) {
+                assertEquals(i / 100 % 4 != 0 ? "new value " + i : "value " + i, map.get(i));
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private void testOffHeapCache() {
+        OffHeapPageCache cache = new OffHeapPageCache(4 * 1024 * 1024, false);
+        for (long i = 0; i < 10_000; i++) {
+            ByteBuffer buff = ByteBuffer.allocate(1_000);
+            buff.putLong(0, i);
+            cache.put(i, buff);
+        }
+        // the oldest entries are evicted
+        assertNull(cache.get(0));
+        assertEquals(9_999L, cache.get(9_999).getLong(0));
+        assertTrue(cache.getUsedMemory() <= cache.getMaxMemory());
+        cache.remove(9_999);
+        assertNull(cache.get(9_999));
+        cache.clear();
+        assertEquals(0, cache.getUsedMemory());
+        // all pages of a dropped chunk are removed
+        ByteBuffer page = ByteBuffer.allocate(100);
+        for (int offset = 0; offset < 10; offset++) {
+            cache.put(DataUtils.getPagePos(1, offset * 100, 100, 0), page);
+            cache.put(DataUtils.getPagePos(2, offset * 100, 100, 0), page);
+        }
+        cache.removeChunk(1);
+        for (int offset = 0; offset < 10; offset++) {
+            assertFalse(cache.containsKey(DataUtils.getPagePos(1, offset * 100, 100, 0)));
+            assertTrue(cache.containsKey(DataUtils.getPagePos(2, offset * 100, 100, 0)));
+        }
+        cache.clear();
+
+        String fileName = getBaseDir() + "/" + getTestName();
+        FileUtils.delete(fileName);
+        try (MVStore s = new MVStore.Builder().fileName(fileName).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            for (int i = 0; i < 10_000; i++) {
+                map.put(i, "value " + i);
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            MVStore.Builder builder = new MVStore.Builder().fileName(fileName).cacheSize(0).offHeapCacheSize(4);
+            if (i == 1) {
+                builder.compressOffHeapCache();
+            }
+            try (MVStore s = builder.open()) {
+                MVMap<Integer, String> map = s.openMap("data");
+                long readCount = 0;
+                for (int j = 0; j < 3; j++) {
+                    for (int k = 0; k < 10_000; k++) {
+                        assertEquals("value " + k, map.get(k));
+                    }
+                    if (j == 0) {
+                        readCount = s.getFileStore().getReadCount();
+                    }
+                }
+                // all pages are read from the off-heap cache, there is no
+                // page cache on the heap
+                assertEquals(readCount, s.getFileStore().getReadCount());
+                assertTrue(s.getOffHeapCache().getHits() > 0);
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
+    private void testBulkLoader() {
+        String fileName = getBaseDir() + "/" + getTestName();
+        FileUtils.delete(fileName);
+        try (MVStore s = new MVStore.Builder().fileName(fileName).keysPerPage(8).autoCommitBufferSize(16).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            BulkLoader<Integer, String> loader = new BulkLoader<>(map);
+            for (int i = 0; i < 20_000; i++) {
+                loader.add(i * 2, "value " + i);
+            }
+            // the entries are not visible until the tree is published
+            assertEquals(0, map.size());
+            assertTrue(loader.getMemory() > 0);
+            try {
+                loader.add(1, "error");
+                fail();
+            } catch (IllegalArgumentException e) {
+                // expected
+            }
+            int expected = 0;
+            for (Cursor<Integer, String> c = loader.cursor(); c.hasNext(); expected += 2) {
+                assertEquals(expected, c.next().intValue());
+            }
+            assertEquals(40_000, expected);
+            assertEquals(0, map.size());
+            assertTrue(loader.publish());
+            assertEquals(20_000, map.size());
+            assertEquals(39_998, map.lastKey().intValue());
+            try {
+                new BulkLoader<>(map);
+                fail();
+            } catch (IllegalArgumentException e) {
+                // expected
+            }
+            map.put(1, "one");
+            assertEquals(20_001, map.size());
+
+            // a discarded tree is not visible
+            MVMap<Integer, String> map2 = s.openMap("data2");
+            loader = new BulkLoader<>(map2);
+            loader.add(1, "one");
+            loader.finish();
+            assertTrue(map2.isEmpty());
+            // the tree is not published if the map is not empty
+            map2.put(2, "two");
+            assertFalse(loader.publish());
+            assertEquals(1, map2.size());
+        }
+        try (MVStore s = new MVStore.Builder().fileName(fileName).open()) {
+            MVMap<Integer, String> map = s.openMap("data");
+            assertEquals(20_001, map.size());
+            for (int i = 0; i < 20_000; i++) {
+                assertEquals("value " + i, map.get(i * 2));
+                assertNull(map.get(i * 2 + 3));
+            }
+            assertEquals("one", map.get(1));
+            assertEquals(10_001, (long) map.getKeyIndex(20_000));
+        }
+        FileUtils.delete(fileName);
+    }
+
     private void testFileFormatExample() {
         String fileName = getBaseDir() + "/" + getTestName();
         FileUtils.delete(fileName);
@@ -426,7 +795,7 @@ private void testNewerWriteVersion() {
         Map<String, Object> header = s.getStoreHeader();
         assertEquals("2", header.get("format").toString());
         header.put("formatRead", "2");
-        header.put("format", "3");
+        header.put("format", "4");
         forceWriteStoreHeader(s);
         MVMap<Integer, String> m = s.openMap("data");
         forceWriteStoreHeader(s);
@@ -718,7 +1087,8 @@ private void testFileFormatChange() {
             Map<String, Object> header = s.getStoreHeader();
             int format = Integer.parseInt(header.get("format").toString());
             assertEquals(2, format);
-            header.put("format", Integer.toString(format + 1));
+            // newer than the format of files with page codecs
+            header.put("format", Integer.toString(format + 2));
             forceWriteStoreHeader(s);
         }
         assertThrows(DataUtils.ERROR_UNSUPPORTED_FORMAT, () -> openStore(fileName).close());
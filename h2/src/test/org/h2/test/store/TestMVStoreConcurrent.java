@@ -53,6 +53,7 @@ public void test() throws Exception {
         testConcurrentSaveCompact();
         testConcurrentDataType();
         testConcurrentAutoCommitAndChange();
+        testConcurrentCommit();
         testConcurrentReplaceAndRead();
         testConcurrentChangeAndCompact();
         testConcurrentChangeAndGetVersion();
@@ -252,6 +253,43 @@ public void call() {
         }
     }
 
+    private void testConcurrentCommit() throws Exception {
+        String fileName = "memFS:" + getTestName();
+        FileUtils.delete(fileName);
+        int threadCount = 4, count = 500;
+        MVStore s = new MVStore.Builder().fileName(fileName).autoCommitDisabled().open();
+        s.setGroupCommitDelay(100);
+        MVMap<Integer, Integer> map = s.openMap("data");
+        Task[] tasks = new Task[threadCount];
+        for (int i = 0; i < threadCount; i++) {
+            int t = i;
+            tasks[i] = new Task() {
+                @Override
+                public void call() {
+                    for (int j = 0; j < count; j++) {
+                        int key = j * threadCount + t;
+                        map.put(key, key * 10);
+                        s.commit();
+                    }
+                }
+            };
+            tasks[i].execute();
+        }
+        for (Task t : tasks) {
+            t.get();
+        }
+        // all changes must be stored after the last commit of each thread
+        s.closeImmediately();
+        try (MVStore s2 = new MVStore.Builder().fileName(fileName).open()) {
+            MVMap<Integer, Integer> map2 = s2.openMap("data");
+            assertEquals(threadCount * count, map2.size());
+            for (int i = 0; i < threadCount * count; i++) {
+                assertEquals(i * 10, map2.get(i).intValue());
+            }
+        }
+        FileUtils.delete(fileName);
+    }
+
     private void testConcurrentReplaceAndRead() throws InterruptedException {
         final MVStore s = new MVStore.Builder().open();
         final MVMap<Integer, Integer> map = s.openMap("data");
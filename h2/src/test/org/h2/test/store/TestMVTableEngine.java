@@ -98,6 +98,7 @@ public void test() throws Exception {
         testReuseDiskSpace();
 */
         testDataTypes();
+        testBulkInsert();
 //        testSimple();
 //        if (!config.travis) {
 //            testReverseDeletePerformance();
@@ -1001,6 +1002,75 @@ private void testAutoCommit() throws SQLException {
         conn.close();
     }
 
+    private void testBulkInsert() throws SQLException {
+        if (config.memory) {
+            return;
+        }
+        deleteDb(getTestName());
+        String dbName = getTestName() + ";MV_STORE=TRUE";
+        Connection conn = getConnection(dbName);
+        Statement stat = conn.createStatement();
+        stat.execute("create table test(id int primary key, name varchar)");
+        stat.execute("set undo_log 0");
+        // rows with ascending keys are added in bulk
+        stat.execute("insert into test select x, 'Hello ' || x from system_range(1, 50000)");
+        stat.execute("create table test2 as select x id, space(100) data from system_range(1, 20000)");
+        stat.execute("insert into test2 values (0, 'next')");
+        ResultSet rs = stat.executeQuery("select max(_rowid_) from test2");
+        assertTrue(rs.next());
+        assertEquals(20001, rs.getInt(1));
+        // rows are added normally once a key is not ascending
+        stat.execute("create table test3(id int primary key)");
+        stat.execute("insert into test3 select x from system_range(1, 100) "
+                + "union all select x from system_range(200, 101, -1)");
+        stat.execute("create table test4(id int primary key)");
+        assertThrows(ErrorCode.DUPLICATE_KEY_1, stat).
+                execute("insert into test4 select x from system_range(1, 100) union all select 50");
+        stat.execute("set undo_log 1");
+        // in auto-commit mode rows are added in bulk and discarded on failure
+        stat.execute("create table test5(id int primary key, name varchar)");
+        stat.execute("insert into test5 select x, 'Hello ' || x from system_range(1, 30000)");
+        stat.execute("create table test6(id int primary key)");
+        assertThrows(ErrorCode.DIVISION_BY_ZERO_1, stat).execute(
+                "insert into test6 select case when x < 100 then x else x / (x - 100) end from system_range(1, 100)");
+        rs = stat.executeQuery("select count(*) from test6");
+        assertTrue(rs.next());
+        assertEquals(0, rs.getInt(1));
+        conn.setAutoCommit(false);
+        stat.execute("insert into test6 select x from system_range(1, 100)");
+        conn.rollback();
+        conn.setAutoCommit(true);
+        rs = stat.executeQuery("select count(*) from test6");
+        assertTrue(rs.next());
+        assertEquals(0, rs.getInt(1));
+        conn.close();
+        conn = getConnection(dbName);
+        stat = conn.createStatement();
+        rs = stat.executeQuery("select count(*), sum(id) from test5");
+        assertTrue(rs.next());
+        assertEquals(30000, rs.getInt(1));
+        assertEquals(450015000L, rs.getLong(2));
+        rs = stat.executeQuery("select count(*), sum(id), min(name), max(name) from test");
+        assertTrue(rs.next());
+        assertEquals(50000, rs.getInt(1));
+        assertEquals(1250025000L, rs.getLong(2));
+        assertEquals("Hello 1", rs.getString(3));
+        assertEquals("Hello 9999", rs.getString(4));
+        rs = stat.executeQuery("select name from test where id = 25000");
+        assertTrue(rs.next());
+        assertEquals("Hello 25000", rs.getString(1));
+        rs = stat.executeQuery("select count(*), sum(id) from test2");
+        assertTrue(rs.next());
+        assertEquals(20001, rs.getInt(1));
+        assertEquals(200010000L, rs.getLong(2));
+        rs = stat.executeQuery("select count(*), sum(id) from test3");
+        assertTrue(rs.next());
+        assertEquals(200, rs.getInt(1));
+        assertEquals(20100L, rs.getLong(2));
+        stat.execute("drop all objects");
+        conn.close();
+    }
+
     private void testReopen() throws SQLException {
         if (config.memory) {
             return;
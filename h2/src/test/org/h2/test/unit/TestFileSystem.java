@@ -21,6 +21,7 @@
 import java.sql.Statement;
 import java.util.List;
 import java.util.Random;
+import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.atomic.AtomicIntegerArray;
 import java.util.zip.ZipEntry;
 import java.util.zip.ZipOutputStream;
@@ -28,6 +29,7 @@
 import org.h2.message.DbException;
 import org.h2.mvstore.DataUtils;
 import org.h2.mvstore.cache.FilePathCache;
+import org.h2.store.fs.FileBase;
 import org.h2.store.fs.FilePath;
 import org.h2.store.fs.FileUtils;
 import org.h2.store.fs.encrypt.FilePathEncrypt;
@@ -569,6 +571,23 @@ private void testPositionedReadWrite(String fsBase) throws IOException {
         assertEquals(1, fc.read(buff, 4000));
         buff.flip();
         assertEquals(1, fc.read(buff, 2000));
+        if (fc instanceof FileBase) {
+            FileBase f = (FileBase) fc;
+            ByteBuffer[] buffers = new ByteBuffer[4];
+            @SuppressWarnings("unchecked")
+            CompletableFuture<Integer>[] futures = new CompletableFuture[4];
+            for (int i = 0; i < 4; i++) {
+                buffers[i] = ByteBuffer.allocate(1000);
+                futures[i] = f.readAsync(buffers[i], 96 + i * 1000);
+            }
+            for (int i = 0; i < 4; i++) {
+                assertEquals(1000, futures[i].join().intValue());
+                for (int j = 0; j < 1000; j++) {
+                    assertEquals((byte) (i * 1000 + j), buffers[i].get(j));
+                }
+            }
+            assertEquals(-1, f.readAsync(ByteBuffer.allocate(1), 8000).join().intValue());
+        }
         fc.close();
     }
 
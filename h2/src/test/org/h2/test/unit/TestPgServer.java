@@ -5,7 +5,17 @@
  */
 package org.h2.test.unit;
 
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.io.Reader;
+import java.io.StringReader;
+import java.io.StringWriter;
+import java.io.Writer;
 import java.lang.reflect.Field;
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
 import java.math.BigDecimal;
 import java.sql.Connection;
 import java.sql.DatabaseMetaData;
@@ -64,6 +74,7 @@ public void test() throws Exception {
         // testPgAdapter() starts server by itself without a wait so run it first
         testPgAdapter();
         testKeyAlias();
+        testWorkers();
         testCancelQuery();
         testTextualAndBinaryTypes();
         testBinaryNumeric();
@@ -71,6 +82,7 @@ public void test() throws Exception {
         testPrepareWithUnspecifiedType();
         testOtherPgClients();
         testArray();
+        testCopy();
     }
 
     private boolean getPgJdbcDriver() {
@@ -419,6 +431,40 @@ private void testKeyAlias() throws SQLException {
         }
     }
 
+    private void testWorkers() throws SQLException {
+        if (!getPgJdbcDriver()) {
+            return;
+        }
+        Server server = createPgServer(
+                "-ifNotExists", "-pgPort", "5535", "-pgDaemon", "-pgWorkers", "2", "-key", "pgserver", "mem:pgserver");
+        try {
+            // more connections than worker threads
+            Connection[] connections = new Connection[5];
+            for (int i = 0; i < connections.length; i++) {
+                connections[i] = DriverManager.getConnection("jdbc:postgresql://localhost:5535/pgserver", "sa", "sa");
+            }
+            Statement stat = connections[0].createStatement();
+            stat.execute("create table test(id int primary key, name varchar)");
+            for (int i = 0; i < connections.length; i++) {
+                PreparedStatement prep = connections[i].prepareStatement("insert into test values (?, ?)");
+                prep.setInt(1, i);
+                prep.setString(2, "Hello " + i);
+                prep.execute();
+            }
+            for (Connection conn : connections) {
+                ResultSet rs = conn.createStatement().executeQuery("select count(*) from test");
+                assertTrue(rs.next());
+                assertEquals(connections.length, rs.getInt(1));
+            }
+            stat.execute("drop table test");
+            for (Connection conn : connections) {
+                conn.close();
+            }
+        } finally {
+            server.stop();
+        }
+    }
+
     private static Set<Integer> supportedBinaryOids;
 
     static {
@@ -910,4 +956,87 @@ private void testArray() throws Exception {
         }
     }
 
+
+    private void testCopy() throws Exception {
+        if (!getPgJdbcDriver()) {
+            return;
+        }
+
+        Server server = createPgServer(
+                "-ifNotExists", "-pgPort", "5535", "-pgDaemon", "-key", "pgserver", "mem:pgserver");
+        try (
+                Connection conn = DriverManager.getConnection(
+                        "jdbc:postgresql://localhost:5535/pgserver", "sa", "sa");
+                Statement stat = conn.createStatement();
+        ) {
+            Class<?> pgConnection = Class.forName("org.postgresql.PGConnection");
+            Object copyManager = pgConnection.getMethod("getCopyAPI").invoke(conn.unwrap(pgConnection));
+            Class<?> copyManagerClass = copyManager.getClass();
+            Method copyInText = copyManagerClass.getMethod("copyIn", String.class, Reader.class);
+            Method copyOutText = copyManagerClass.getMethod("copyOut", String.class, Writer.class);
+            Method copyIn = copyManagerClass.getMethod("copyIn", String.class, InputStream.class);
+            Method copyOut = copyManagerClass.getMethod("copyOut", String.class, OutputStream.class);
+
+            stat.execute("CREATE TABLE test (id int primary key, name varchar, data bytea)");
+            assertEquals(3L, copyInText.invoke(copyManager, "COPY test FROM STDIN",
+                    new StringReader("1\tHello\t\\\\x0102\n2\t\\N\t\\N\n3\tTab\\there\t\\N\n")));
+            try (ResultSet rs = stat.executeQuery("SELECT name, data FROM test ORDER BY id")) {
+                assertTrue(rs.next());
+                assertEquals("Hello", rs.getString(1));
+                assertEquals(new byte[] { 1, 2 }, rs.getBytes(2));
+                assertTrue(rs.next());
+                assertNull(rs.getString(1));
+                assertTrue(rs.next());
+                assertEquals("Tab\there", rs.getString(1));
+                assertFalse(rs.next());
+            }
+            StringWriter writer = new StringWriter();
+            assertEquals(3L, copyOutText.invoke(copyManager, "COPY test (id, name) TO STDOUT", writer));
+            assertEquals("1\tHello\n2\t\\N\n3\tTab\\there\n", writer.toString());
+            writer = new StringWriter();
+            assertEquals(2L, copyOutText.invoke(copyManager,
+                    "COPY (SELECT id, name FROM test WHERE id < 3 ORDER BY id) TO STDOUT (FORMAT CSV)", writer));
+            assertEquals("1,Hello\n2,\n", writer.toString());
+
+            // the COPY is atomic
+            try {
+                copyInText.invoke(copyManager, "COPY test FROM STDIN", new StringReader("4\tx\t\\N\n1\ty\t\\N\n"));
+                fail();
+            } catch (InvocationTargetException e) {
+                assertTrue(e.getCause() instanceof SQLException);
+            }
+            try (ResultSet rs = stat.executeQuery("SELECT COUNT(*) FROM test")) {
+                assertTrue(rs.next());
+                assertEquals(3, rs.getInt(1));
+            }
+
+            stat.execute("CREATE TABLE test2 (id int, name varchar)");
+            assertEquals(3L, copyInText.invoke(copyManager, "COPY test2 FROM STDIN WITH CSV HEADER",
+                    new StringReader("id,name\n1,\"a,b\"\n2,\"\"\n3,\n")));
+            try (ResultSet rs = stat.executeQuery("SELECT name FROM test2 ORDER BY id")) {
+                assertTrue(rs.next());
+                assertEquals("a,b", rs.getString(1));
+                assertTrue(rs.next());
+                assertEquals("", rs.getString(1));
+                assertTrue(rs.next());
+                assertNull(rs.getString(1));
+                assertFalse(rs.next());
+            }
+
+            ByteArrayOutputStream out = new ByteArrayOutputStream();
+            assertEquals(3L, copyOut.invoke(copyManager, "COPY test (id, name) TO STDOUT (FORMAT BINARY)", out));
+            stat.execute("CREATE TABLE test3 (id int primary key, name varchar)");
+            assertEquals(3L, copyIn.invoke(copyManager, "COPY test3 FROM STDIN (FORMAT BINARY)",
+                    new ByteArrayInputStream(out.toByteArray())));
+            try (ResultSet rs = stat.executeQuery(
+                    "SELECT COUNT(*) FROM test JOIN test3 USING (id) " +
+                    "WHERE test.name IS NOT DISTINCT FROM test3.name")) {
+                assertTrue(rs.next());
+                assertEquals(3, rs.getInt(1));
+            }
+        } finally {
+            server.stop();
+        }
+    }
+
 }
@@ -14,6 +14,7 @@
 import java.io.OutputStream;
 import java.io.PrintStream;
 import java.io.Reader;
+import java.io.StringReader;
 import java.io.Writer;
 import java.lang.reflect.InvocationTargetException;
 import java.lang.reflect.Method;
@@ -38,6 +39,7 @@
 import java.util.List;
 import java.util.Random;
 import java.util.UUID;
+import java.util.concurrent.atomic.AtomicLong;
 import org.h2.api.ErrorCode;
 import org.h2.engine.SysProperties;
 import org.h2.store.FileLister;
@@ -95,6 +97,7 @@ public void test() throws Exception {
         org.h2.Driver.load();
         testSimpleResultSet();
         testTcpServerWithoutPort();
+        testTcpServerWorkers();
         testConsole();
         testJdbcDriverUtils();
         testWrongServer();
@@ -129,6 +132,114 @@ private void testTcpServerWithoutPort() throws Exception {
         s1.stop();
     }
 
+    private void testTcpServerWorkers() throws Exception {
+        assertThrows(ErrorCode.FEATURE_NOT_SUPPORTED_1,
+                () -> Server.createTcpServer("-tcpWorkers", "2", "-tcpSSL").start());
+        Server tcpServer = Server.createTcpServer("-tcpWorkers", "2", "-ifNotExists").start();
+        try {
+            String url = "jdbc:h2:tcp://localhost:" + tcpServer.getPort() + "/mem:workers";
+            // more connections than worker threads
+            Connection[] connections = new Connection[8];
+            for (int i = 0; i < connections.length; i++) {
+                connections[i] = getConnection(url, "sa", "");
+            }
+            connections[0].createStatement().execute("CREATE TABLE TEST(ID INT PRIMARY KEY, V INT)");
+            for (int i = 0; i < connections.length; i++) {
+                PreparedStatement prep = connections[i].prepareStatement("INSERT INTO TEST VALUES(?, ?)");
+                for (int j = 0; j < 10; j++) {
+                    prep.setInt(1, i * 10 + j);
+                    prep.setInt(2, i);
+                    prep.addBatch();
+                }
+                prep.executeBatch();
+            }
+            AtomicLong total = new AtomicLong();
+            Task[] tasks = new Task[connections.length];
+            for (int i = 0; i < tasks.length; i++) {
+                Connection conn = connections[i];
+                tasks[i] = new Task() {
+                    @Override
+                    public void call() throws Exception {
+                        PreparedStatement prep = conn.prepareStatement("SELECT COUNT(*) FROM TEST WHERE V = ?");
+                        for (int j = 0; j < 100; j++) {
+                            prep.setInt(1, j % connections.length);
+                            try (ResultSet rs = prep.executeQuery()) {
+                                rs.next();
+                                total.addAndGet(rs.getLong(1));
+                            }
+                        }
+                    }
+                }.execute();
+            }
+            for (Task task : tasks) {
+                task.get();
+            }
+            assertEquals(tasks.length * 100 * 10, total.get());
+            // connections waiting for a lock don't block the other ones
+            connections[0].setAutoCommit(false);
+            connections[0].createStatement().executeUpdate("UPDATE TEST SET V = V WHERE ID = 0");
+            Task[] waiting = new Task[2];
+            for (int i = 0; i < waiting.length; i++) {
+                Connection conn = connections[i + 1];
+                waiting[i] = new Task() {
+                    @Override
+                    public void call() throws Exception {
+                        Statement stat = conn.createStatement();
+                        stat.execute("SET LOCK_TIMEOUT 10000");
+                        stat.executeUpdate("UPDATE TEST SET V = V WHERE ID = 0");
+                    }
+                }.execute();
+            }
+            Thread.sleep(200);
+            try (ResultSet rs = connections[3].createStatement().executeQuery("SELECT COUNT(*) FROM TEST")) {
+                rs.next();
+                assertEquals(connections.length * 10, rs.getInt(1));
+            }
+            connections[0].commit();
+            for (Task task : waiting) {
+                task.get();
+            }
+            for (Connection conn : connections) {
+                conn.close();
+            }
+        } finally {
+            tcpServer.stop();
+        }
+        tcpServer = Server.createTcpServer("-tcpWorkers", "1", "-tcpMaxHandOffThreads", "0", "-ifNotExists")
+                .start();
+        try (Socket socket = new Socket("localhost", tcpServer.getPort())) {
+            // an incomplete request must not take the only worker thread
+            OutputStream out = socket.getOutputStream();
+            out.write(new byte[] { 0, 0, 0 });
+            out.flush();
+            Thread.sleep(200);
+            String url = "jdbc:h2:tcp://localhost:" + tcpServer.getPort() + "/mem:workers";
+            try (Connection conn = getConnection(url, "sa", "")) {
+                conn.createStatement().execute("CREATE TABLE TEST(ID INT PRIMARY KEY, C CLOB)");
+                PreparedStatement prep = conn.prepareStatement("INSERT INTO TEST VALUES(?, ?)");
+                // requests with inline LOBs, the second one is larger than
+                // the buffer of the selector
+                for (int length : new int[] { 100, 100_000 }) {
+                    StringBuilder builder = new StringBuilder(length);
+                    for (int i = 0; i < length; i++) {
+                        builder.append((char) ('a' + i % 3 * 0x400));
+                    }
+                    String s = builder.toString();
+                    prep.setInt(1, length);
+                    prep.setCharacterStream(2, new StringReader(s), -1);
+                    prep.executeUpdate();
+                    try (ResultSet rs = conn.createStatement().executeQuery(
+                            "SELECT C FROM TEST WHERE ID = " + length)) {
+                        assertTrue(rs.next());
+                        assertEquals(s, rs.getString(1));
+                    }
+                }
+            }
+        } finally {
+            tcpServer.stop();
+        }
+    }
+
     private void testConsole() throws Exception {
         String old = System.getProperty(SysProperties.H2_BROWSER);
         GUIConsole c = new GUIConsole();